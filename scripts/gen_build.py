@@ -18,6 +18,9 @@ import build.backend_win32 as win32
 import build.backend_linux as linux
 import build.backend_macos as apple
 
+# "python gen_build.py --profiling" builds every target with M_ENABLE_PROFILING
+enable_profiling = "--profiling" in sys.argv
+
 #-----------------------------------------------------------------------------
 # [SECTION] project
 #-----------------------------------------------------------------------------
@@ -83,6 +86,8 @@ with pl.project("monopoly"):
     # configs
     pl.add_profile(configuration_filter=["debug"], definitions=["_DEBUG", "PL_CONFIG_DEBUG"])
     pl.add_profile(configuration_filter=["release"], definitions=["NDEBUG", "PL_CONFIG_RELEASE"])
+    if enable_profiling:
+        pl.add_profile(definitions=["M_ENABLE_PROFILING"])
 
     #-----------------------------------------------------------------------------
     # [SECTION] monopoly app
@@ -95,7 +100,9 @@ with pl.project("monopoly"):
             "../src/app.c",
             "../src/monopoly.c",
             "../src/monopoly_init.c",
-
+            "../src/monopoly_ai.c",
+            "../src/monopoly_platform.c",
+            "../src/monopoly_profile.c",
         )
         
         pl.set_output_binary("monopoly")
@@ -136,6 +143,188 @@ with pl.project("monopoly"):
                 with pl.compiler("clang"):
                     pass
                
+    #-----------------------------------------------------------------------------
+    # [SECTION] core library
+    #-----------------------------------------------------------------------------
+
+    # game rules only, loads game data with the built in json reader instead of pl_json
+    with pl.target("monopoly_core", pl.TargetType.STATIC_LIBRARY, False):
+
+        pl.add_source_files(
+            "../src/monopoly.c",
+            "../src/monopoly_init.c",
+            "../src/monopoly_json.c",
+            "../src/monopoly_ai.c",
+            "../src/monopoly_platform.c",
+            "../src/monopoly_profile.c",
+            "../src/monopoly_stats.c",
+            "../src/monopoly_history.c",
+        )
+
+        pl.set_output_binary("monopoly_core")
+
+        pl.add_definitions("M_USE_BUILTIN_JSON")
+
+        for config in ("debug", "release"):
+            with pl.configuration(config):
+
+                # win32
+                with pl.platform("Windows"):
+                    with pl.compiler("msvc"):
+                        pass
+
+                # linux
+                with pl.platform("Linux"):
+                    with pl.compiler("gcc"):
+                        pass
+
+                # mac os
+                with pl.platform("Darwin"):
+                    with pl.compiler("clang"):
+                        pass
+
+    #-----------------------------------------------------------------------------
+    # [SECTION] headless server
+    #-----------------------------------------------------------------------------
+
+    with pl.target("monopoly_server", pl.TargetType.EXECUTABLE, False):
+
+        pl.add_source_files(
+            "../src/server_app.c",
+            "../src/monopoly_server.c",
+            "../src/monopoly_platform.c",
+            "../src/monopoly_net.c",
+            "../src/monopoly.c",
+            "../src/monopoly_init.c",
+            "../src/monopoly_json.c",
+            "../src/monopoly_ai.c",
+            "../src/monopoly_profile.c",
+        )
+
+        pl.set_output_binary("monopoly_server")
+
+        pl.add_definitions("M_USE_BUILTIN_JSON")
+
+        for config in ("debug", "release"):
+            with pl.configuration(config):
+
+                # win32
+                with pl.platform("Windows"):
+                    with pl.compiler("msvc"):
+                        pass
+
+                # linux
+                with pl.platform("Linux"):
+                    with pl.compiler("gcc"):
+                        pl.add_linker_flags("-lpthread")
+
+                # mac os
+                with pl.platform("Darwin"):
+                    with pl.compiler("clang"):
+                        pass
+
+    #-----------------------------------------------------------------------------
+    # [SECTION] benchmarks
+    #-----------------------------------------------------------------------------
+
+    with pl.target("monopoly_bench", pl.TargetType.EXECUTABLE, False):
+
+        pl.add_source_files(
+            "../src/bench_app.c",
+            "../src/monopoly_platform.c",
+            "../src/monopoly.c",
+            "../src/monopoly_init.c",
+            "../src/monopoly_json.c",
+            "../src/monopoly_profile.c",
+        )
+
+        pl.set_output_binary("monopoly_bench")
+
+        pl.add_definitions("M_USE_BUILTIN_JSON")
+
+        for config in ("debug", "release"):
+            with pl.configuration(config):
+
+                # win32
+                with pl.platform("Windows"):
+                    with pl.compiler("msvc"):
+                        pass
+
+                # linux
+                with pl.platform("Linux"):
+                    with pl.compiler("gcc"):
+                        pl.add_linker_flags("-lpthread")
+
+                # mac os
+                with pl.platform("Darwin"):
+                    with pl.compiler("clang"):
+                        pass
+
+    with pl.target("monopoly_games_bench", pl.TargetType.EXECUTABLE, False):
+
+        pl.add_source_files(
+            "../src/games_bench_app.c",
+            "../src/monopoly_platform.c",
+            "../src/monopoly.c",
+            "../src/monopoly_init.c",
+            "../src/monopoly_json.c",
+            "../src/monopoly_profile.c",
+            "../src/monopoly_stats.c",
+            "../src/monopoly_history.c",
+        )
+
+        pl.set_output_binary("monopoly_games_bench")
+
+        # counts every allocation the core makes
+        pl.add_definitions("M_CUSTOM_ALLOCATOR", "M_USE_BUILTIN_JSON")
+
+        for config in ("debug", "release"):
+            with pl.configuration(config):
+
+                # win32
+                with pl.platform("Windows"):
+                    with pl.compiler("msvc"):
+                        pass
+
+                # linux
+                with pl.platform("Linux"):
+                    with pl.compiler("gcc"):
+                        pl.add_linker_flags("-lpthread")
+
+                # mac os
+                with pl.platform("Darwin"):
+                    with pl.compiler("clang"):
+                        pass
+
+    #-----------------------------------------------------------------------------
+    # [SECTION] tools
+    #-----------------------------------------------------------------------------
+
+    # offline texture cooker, run it on assets/*.png to produce assets/cooked/*.mtex
+    with pl.target("monopoly_cook", pl.TargetType.EXECUTABLE, False):
+
+        pl.add_source_files("../src/cook_app.c")
+
+        pl.set_output_binary("monopoly_cook")
+
+        for config in ("debug", "release"):
+            with pl.configuration(config):
+
+                # win32
+                with pl.platform("Windows"):
+                    with pl.compiler("msvc"):
+                        pass
+
+                # linux
+                with pl.platform("Linux"):
+                    with pl.compiler("gcc"):
+                        pass
+
+                # mac os
+                with pl.platform("Darwin"):
+                    with pl.compiler("clang"):
+                        pass
+
 #-----------------------------------------------------------------------------
 # [SECTION] generate scripts
 #-----------------------------------------------------------------------------
@@ -2,6 +2,7 @@
 #version 450
 
 layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec4 inColor;
 
 layout(set = 0, binding = 0) uniform texture2D texSampler;
 layout(set = 0, binding = 1) uniform sampler samp;
@@ -10,5 +11,5 @@ layout(set = 0, binding = 1) uniform sampler samp;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = texture(sampler2D(texSampler, samp), inUV);
+    outColor = texture(sampler2D(texSampler, samp), inUV) * inColor;
 }
\ No newline at end of file
@@ -1,15 +1,29 @@
 #version 450
 
-layout(location = 0) in vec2 inPosition;
-layout(location = 1) in vec2 inUV;
+layout(location = 0) in vec2 inCorner; // unit quad, (0, 0) top left
+
+// one per sprite, mSpriteInstance in app.c
+struct SpriteInstance {
+    vec4 positionScale; // top left in xy, size in zw
+    vec4 uvRect;        // atlas min in xy, max in zw
+    vec4 tint;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer InstanceData {
+    SpriteInstance instances[];
+} uInstances;
 
 layout(set = 3, binding = 0) uniform DynamicData {
     mat4 mvp;
 } uDynamic;
 
 layout(location = 0) out vec2 outUV;
+layout(location = 1) out vec4 outColor;
 
 void main() {
-    gl_Position = uDynamic.mvp * vec4(inPosition, 0.0, 1.0);
-    outUV = vec2(inUV.x, 1.0 - inUV.y);  // flip V coordinate
+    SpriteInstance instance = uInstances.instances[gl_InstanceIndex];
+    vec2 position = instance.positionScale.xy + inCorner * instance.positionScale.zw;
+    gl_Position = uDynamic.mvp * vec4(position, 0.0, 1.0);
+    outUV = mix(instance.uvRect.xy, instance.uvRect.zw, inCorner);
+    outColor = instance.tint;
 }
\ No newline at end of file
@@ -78,6 +78,9 @@
 // monopoly game logic
 #include "monopoly.h"
 #include "monopoly_init.h"
+#include "monopoly_ai.h"
+#include "monopoly_platform.h"
+#include "monopoly_texture.h"
 
 // libraries
 #define STB_IMAGE_IMPLEMENTATION
@@ -86,6 +89,56 @@
 #define SCREEN_WIDTH 1280
 #define SCREEN_HEIGHT 720
 
+// performance overlay, the histogram is drawn over the bottom of the window
+#define PERF_HISTORY_SIZE  120   // frames kept
+#define PERF_WINDOW_X      10.0f
+#define PERF_WINDOW_Y      10.0f
+#define PERF_WINDOW_WIDTH  330.0f
+#define PERF_WINDOW_HEIGHT 300.0f
+#define PERF_GRAPH_HEIGHT  80.0f
+#define PERF_GRAPH_MAX_MS  33.3f // top of the graph, two 60hz frames
+
+// staging ring every upload goes through
+#define STAGING_RING_SIZE        (16 << 20) // every image must fit, the sprite atlas is the biggest (2048x1384 + 3 mips, ~15.1 MB)
+#define STAGING_RING_MAX_BATCHES 64         // submissions in flight
+#define STAGING_RING_ALIGNMENT   256        // same as cooked mips, so copy offsets stay aligned
+
+// texture streaming, decoded on worker threads and uploaded through the staging ring
+#define TEXTURE_STREAM_MAX_REQUESTS 32
+#define TEXTURE_STREAM_MAX_WORKERS  4
+
+// every board sprite lives in one atlas so the whole board is a single draw
+#define SPRITE_ATLAS_WIDTH      2048
+#define SPRITE_ATLAS_MAX_HEIGHT 1472 // taller layouts are rejected so the atlas always fits the staging ring
+#define SPRITE_ATLAS_MIPS       4
+#define SPRITE_ATLAS_PADDING    8    // gutter around each sprite, still a texel at the smallest mip
+#define SPRITE_BATCH_MAX        256  // sprites per frame (board, tokens, 32 houses, 12 hotels, ...)
+
+// whole mip chain at the tallest layout (each mip is at most a quarter of the one above, plus alignment)
+#define SPRITE_ATLAS_MAX_BYTES ((size_t)SPRITE_ATLAS_WIDTH * SPRITE_ATLAS_MAX_HEIGHT * 4 * 4 / 3 + SPRITE_ATLAS_MIPS * M_TEXTURE_FILE_ALIGNMENT)
+_Static_assert(SPRITE_ATLAS_MAX_BYTES <= STAGING_RING_SIZE, "sprite atlas doesn't fit the staging ring");
+
+// board layout, in fractions so it scales with the window
+#define BOARD_MARGIN         (10.0f / 720.0f) // above and below the board, of the window height
+#define BOARD_LEFT           (50.0f / 720.0f) // of the window height
+#define BOARD_CORNER         (95.0f / 700.0f) // corner squares, of the board size
+#define BOARD_REFERENCE_SIZE 700.0f           // piece sizes are in pixels at this board size
+#define BOARD_PANEL_GAP      50.0f            // between the board and the menus on its right
+
+// animation, stepped at a fixed rate from the measured frame time
+#define ANIM_STEP           (1.0f / 120.0f)
+#define ANIM_MAX_STEPS      12     // catch-up limit after a stall, the rest is dropped
+#define ANIM_HOP_TIME       0.15f  // seconds per square
+#define ANIM_MAX_HOPS       12     // longer moves (cards, going to jail) jump straight there
+#define ANIM_HOP_HEIGHT     10.0f  // at BOARD_REFERENCE_SIZE
+#define ANIM_DICE_TIME      0.6f   // tumble before the roll shows
+#define ANIM_DICE_FACE_TIME 0.06f  // random face shown this long while tumbling
+
+// frame pacing, nothing is drawn while the game waits on a decision and nothing moves
+#define FRAME_IDLE_DELAY_MS   500  // quiet time before going idle
+#define FRAME_IDLE_POLL_MS    10   // how often input is checked while idle
+#define FRAME_IDLE_REFRESH_MS 1000 // keep-alive redraw while idle, 0 presents nothing until woken
+
 //-----------------------------------------------------------------------------
 // [SECTION] helper macros
 //-----------------------------------------------------------------------------
@@ -103,16 +156,253 @@ typedef struct _mPropertyBounds
     plVec2 tCenter; // center point (for drawing tokens)
 } mPropertyBounds;
 
+typedef enum _eSprite
+{
+    SPRITE_BOARD,
+    SPRITE_DIE_1, // faces in order, SPRITE_DIE_1 + value - 1
+    SPRITE_DIE_2,
+    SPRITE_DIE_3,
+    SPRITE_DIE_4,
+    SPRITE_DIE_5,
+    SPRITE_DIE_6,
+    SPRITE_TOKEN, // white shapes, tinted when drawn
+    SPRITE_HOUSE,
+    SPRITE_HOTEL,
+    SPRITE_SOLID,
+
+    SPRITE_COUNT
+} eSprite;
+
+// uv rects are filled in by the worker that packs the atlas, read once bLoaded is set
+typedef struct _mSpriteAtlas
+{
+    plVec4                   atUvs[SPRITE_COUNT]; // min in xy, max in zw
+    plTextureHandle          tTexture;
+    plDeviceMemoryAllocation tMemory;
+    plBindGroupHandle        tBindGroup;
+    bool                     bLoaded;
+} mSpriteAtlas;
+
+// image the atlas takes sprites from, the first uCellCount cells of a uColumns x uRows grid
+typedef struct _mSpriteImage
+{
+    const char* pcFilePath;
+    const char* pcCookedPath;
+    eSprite     eFirst;
+    uint32_t    uColumns;
+    uint32_t    uRows;
+    uint32_t    uCellCount;
+} mSpriteImage;
+
+// per instance attributes, same layout as SpriteInstance in textured_quad.vert (std430)
+typedef struct _mSpriteInstance
+{
+    plVec2 tPosition; // top left
+    plVec2 tScale;    // size in pixels
+    plVec4 tUv;       // atlas rect, min in xy, max in zw
+    plVec4 tTint;
+} mSpriteInstance;
+
+// retained sprites drawn as instances of one unit quad, so draw calls don't grow with the
+// number of pieces on the board. an instance buffer is only rewritten when it's out of date
+typedef struct _mSpriteBatch
+{
+    // unit quad, uploaded once
+    plBufferHandle           tQuadVertexBuffer;
+    plBufferHandle           tQuadIndexBuffer;
+    plDeviceMemoryAllocation tQuadVertexMemory;
+    plDeviceMemoryAllocation tQuadIndexMemory;
+
+    // one instance buffer per frame in flight, read by the vertex shader as a storage buffer
+    plBindGroupLayoutDesc    tInstanceLayoutDesc;
+    plBindGroupLayoutHandle  tInstanceLayout;
+    plBufferHandle           atInstanceBuffers[PL_MAX_FRAMES_IN_FLIGHT];
+    plDeviceMemoryAllocation atInstanceMemory[PL_MAX_FRAMES_IN_FLIGHT];
+    plBindGroupHandle        atInstanceBindGroups[PL_MAX_FRAMES_IN_FLIGHT];
+
+    // sprites since the last sprite_batch_begin
+    mSpriteInstance atInstances[SPRITE_BATCH_MAX];
+    uint32_t        uCount;
+    uint64_t        uVersion;                                  // bumped by every rebuild
+    uint64_t        auBufferVersion[PL_MAX_FRAMES_IN_FLIGHT]; // what each instance buffer holds
+} mSpriteBatch;
+
+// board sprites are rebuilt only when the game state they show changes
+typedef struct _mBoardLayer
+{
+    bool     bValid;
+    uint64_t uStateVersion; // of the game state the batch shows
+    mDice    tDice;         // shown dice, rolls don't bump the version
+    plVec2   atTokenPositions[MAX_PLAYERS]; // slot layout on each player's square
+} mBoardLayer;
+
+// last trade preview, redone only when the trade is edited or the game changes
+typedef struct _mTradePreview
+{
+    bool       bValid;
+    bool       bAvailable;    // trade was valid and the game rolled back cleanly
+    uint64_t   uStateVersion; // of the game state the preview was taken from
+    uint8_t    uFromPlayer;
+    mTradeData tTrade;        // as it was when previewed
+    int32_t    iFromNetWorth;
+    int32_t    iToNetWorth;
+} mTradePreview;
+
+// a token walking square by square to its game position
+typedef struct _mTokenWalk
+{
+    uint8_t uFrom;       // square the walk started on
+    uint8_t uTo;         // game position it's heading to
+    uint8_t uSquares;    // from uFrom to uTo
+    float   fTravel;     // squares walked
+    float   fPrevTravel; // at the previous step, drawn positions blend the two
+} mTokenWalk;
+
+// follows the game state and never changes it, so the game runs the same without it (the
+// headless simulators don't have one)
+typedef struct _mAnimator
+{
+    bool     bInitialized;
+    bool     bActive;      // something moved this frame
+    float    fAccumulator; // time not stepped yet
+    float    fAlpha;       // how far this frame is between the last two steps
+    uint32_t uRng;         // own generator so tumbling dice don't change game rolls
+
+    mTokenWalk atWalks[MAX_PLAYERS];
+
+    mDice tTargetDice;   // last roll the game made
+    mDice tShownDice;
+    float fDiceTime;     // tumble left
+    float fDiceFaceTime; // until the next random face
+} mAnimator;
+
 typedef struct _plTextureLoadConfig
 {
     const char*               pcFilePath;
+    const char*               pcCookedPath; // optional .mtex from monopoly_cook, used instead when present
     plSamplerHandle           tSampler;
     plTextureHandle*          ptOutTexture;
     plDeviceMemoryAllocation* ptOutMemory;
     plBindGroupHandle*        ptOutBindGroup;
     bool*                     pbOutLoaded;
+    mSpriteAtlas*             ptAtlas; // optional, packs the sprite images instead of loading pcFilePath
 } plTextureLoadConfig;
 
+typedef enum _eTextureRequestState
+{
+    TEXTURE_REQUEST_QUEUED,
+    TEXTURE_REQUEST_DECODING,
+    TEXTURE_REQUEST_DECODED,   // pixels ready for upload
+    TEXTURE_REQUEST_UPLOADING, // copy submitted, waiting on the gpu
+    TEXTURE_REQUEST_READY,
+    TEXTURE_REQUEST_FAILED
+} eTextureRequestState;
+
+typedef struct _mStagingBatch
+{
+    size_t   szEnd;  // ring space is released up to here
+    uint64_t uValue; // semaphore value signalled by the submission reading it
+} mStagingBatch;
+
+// one host visible buffer, mapped for the lifetime of the app, that uploads are copied through.
+// space is handed out in order and released once the submission reading it has signalled the
+// semaphore, so uploads never allocate device memory or wait on the gpu
+typedef struct _mStagingRing
+{
+    plBufferHandle           tBuffer;
+    plDeviceMemoryAllocation tMemory;
+    size_t                   szHead;
+    size_t                   szTail;
+
+    // allocations grouped by submission, oldest first
+    mStagingBatch atBatches[STAGING_RING_MAX_BATCHES];
+    uint32_t      uFirstBatch;
+    uint32_t      uBatchCount;
+
+    plTimelineSemaphore* ptSemaphore;
+    uint64_t             uSubmittedValue; // last value submitted
+    uint64_t             uCompletedValue; // last value seen signalled
+    uint64_t             uWaitedValue;    // last value a frame waited on
+} mStagingRing;
+
+typedef struct _mTextureRequest
+{
+    plTextureLoadConfig tConfig;
+    volatile int64_t    iState; // eTextureRequestState, written by workers until decoded
+
+    // filled in by the decoding worker, cooked textures keep the whole file in pPixels
+    unsigned char*  pPixels;
+    int             iWidth;
+    int             iHeight;
+    bool            bCooked;
+    size_t          szDataOffset; // mip data within pPixels
+    size_t          szDataSize;
+    uint32_t        uMipCount;
+    mTextureFileMip atMips[M_TEXTURE_MAX_MIPS];
+
+    uint64_t uUploadValue; // staging ring semaphore value signalled by the upload
+} mTextureRequest;
+
+typedef struct _mTextureStreamer
+{
+    mTextureRequest atRequests[TEXTURE_STREAM_MAX_REQUESTS];
+    uint32_t        uRequestCount;
+
+    // decoding workers
+    mThread*   aptWorkers[TEXTURE_STREAM_MAX_WORKERS];
+    uint32_t   uWorkerCount;
+    mMutex     tMutex; // guards the two below
+    mCondition tWake;
+    uint32_t   uNextDecode;
+    bool       bStop;
+} mTextureStreamer;
+
+// cpu timings of the last PERF_HISTORY_SIZE frames, in milliseconds
+typedef struct _mPerfStats
+{
+    bool     bShowOverlay;
+    uint32_t uNextSample;  // ring position
+    uint32_t uSampleCount;
+
+    // current frame
+    uint64_t uFrameStartNs;
+    uint64_t uLastFrameStartNs;
+    float    fPhaseMs;
+    float    fUiMs;
+    float    fDrawMs;
+
+    // history
+    float afIntervalMs[PERF_HISTORY_SIZE]; // start to start, includes waiting on present
+    float afCpuMs[PERF_HISTORY_SIZE];      // work inside pl_app_update
+    float afPhaseMs[PERF_HISTORY_SIZE];
+    float afUiMs[PERF_HISTORY_SIZE];
+    float afDrawMs[PERF_HISTORY_SIZE];
+
+    // histogram is drawn on top of the ui
+    plDrawList2D*  ptDrawlist;
+    plDrawLayer2D* ptLayer;
+} mPerfStats;
+
+// where things go in the window, recomputed on resize
+typedef struct _mScreenLayout
+{
+    plVec2 tViewportSize;
+    plVec2 tBoardMin;   // top-left corner of the board
+    float  fBoardSize;
+    float  fBoardScale; // fBoardSize / BOARD_REFERENCE_SIZE
+    float  fPanelX;     // left edge of the menus
+    float  fCenterX;    // popups are centered on this
+} mScreenLayout;
+
+// decides each frame whether anything on screen can change
+typedef struct _mFrameScheduler
+{
+    uint64_t uLastActiveNs;  // last input, running phase, timer or upload
+    uint64_t uLastPresentNs;
+    plVec2   tLastMousePos;
+    float    fFrameTime;     // io delta time since the last drawn frame, skipped frames included
+} mFrameScheduler;
+
 typedef struct _plAppData
 {
     // window & device
@@ -122,6 +412,7 @@ typedef struct _plAppData
 
     // command infrastructure
     plCommandPool* ptCommandPool;
+    mStagingRing   tStagingRing;
 
     // bind groups
     plBindGroupPool*        tBindGroupPoolTexAndSamp;
@@ -143,27 +434,34 @@ typedef struct _plAppData
     // shaders
     plShaderHandle tTexturedQuadShader;
 
-    // geometry
-    plBufferHandle           tQuadVertexBuffer;
-    plBufferHandle           tQuadIndexBuffer;
-    plDeviceMemoryAllocation tQuadVertexMemory;
-    plDeviceMemoryAllocation tQuadIndexMemory;
-
-    // textures
-    plTextureHandle          tBoardTexture;
-    plDeviceMemoryAllocation tBoardTextureMemory;
-    plBindGroupHandle        tBoardBindGroup;
-    bool                     bBoardTextureLoaded;
+    // sprites
+    mSpriteAtlas     tSpriteAtlas;
+    mSpriteBatch     tSpriteBatch;
+    mTextureStreamer tTextureStreamer;
 
-    // player token drawing
-    plDrawList2D*   ptTokenDrawlist;
-    plDrawLayer2D*  ptTokenLayer;
+    // board drawing
+    mScreenLayout   tLayout;
+    mBoardLayer     tBoardLayer;
+    mAnimator       tAnimator;
     mPropertyBounds atPropertyBounds[40]; 
 
     // monopoly game state
     mGameData* pGameData;
     mGameFlow  tGameFlow;
 
+    // what-if previews (attached only while a preview is applied)
+    mChangeJournal* pPreviewJournal;
+    mTradePreview   tTradePreview;
+
+    // trade advice
+    mAiModel tAiModel;
+
+    // performance overlay (F3)
+    mPerfStats tPerf;
+
+    // frame pacing
+    mFrameScheduler tFrameScheduler;
+
 } plAppData;
 
 //-----------------------------------------------------------------------------
@@ -171,12 +469,44 @@ typedef struct _plAppData
 //-----------------------------------------------------------------------------
 
 void   handle_keyboard_input(plAppData* ptAppData);
+void   staging_ring_init(plAppData* ptAppData);
+void*  staging_ring_alloc(mStagingRing* ptRing, size_t szSize, size_t* pszOffset);
+void   staging_ring_submit(mStagingRing* ptRing, plCommandBuffer* ptCmd);
+void   staging_ring_retire(plAppData* ptAppData);
+void   staging_ring_cleanup(plAppData* ptAppData);
 void   load_texture(plAppData* ptAppData, const plTextureLoadConfig* ptConfig);
+void   texture_stream_start(plAppData* ptAppData);
+void   texture_stream_worker(void* pData);
+bool   texture_stream_read_cooked(mTextureRequest* ptRequest);
+bool   texture_stream_decode(mTextureRequest* ptRequest);
+void   texture_stream_free_pixels(mTextureRequest* ptRequest);
+void   texture_stream_create_texture(plAppData* ptAppData, mTextureRequest* ptRequest);
+void   texture_stream_update(plAppData* ptAppData);
+void   texture_stream_cleanup(plAppData* ptAppData);
+bool   texture_stream_busy(const mTextureStreamer* ptStreamer);
+void   animator_update(plAppData* ptAppData, float fDeltaTime);
+bool   animator_step(mAnimator* ptAnim);
+void   animator_start_walk(mTokenWalk* ptWalk, uint8_t uTo);
+uint8_t animator_random_face(mAnimator* ptAnim);
+bool   frame_input_received(mFrameScheduler* ptScheduler);
+bool   frame_should_render(plAppData* ptAppData);
 plMat4 create_orthographic_projection(float fScreenWidth, float fScreenHeight);
-void   show_player_status(mGameData* pGameData);
+void   show_player_status(plAppData* ptAppData);
 void   draw_dice_result(plAppData* ptAppData);
-void   init_property_bounds(mPropertyBounds* atBounds);
-void   draw_player_tokens(plAppData* ptAppData, plRenderEncoder* ptRender);
+void   update_screen_layout(plAppData* ptAppData, plVec2 tViewportSize);
+void   init_property_bounds(mPropertyBounds* atBounds, plVec2 tBoardMin, float fBoardSize);
+bool   update_board_layer(plAppData* ptAppData);
+void   layout_player_tokens(plAppData* ptAppData);
+void   draw_board(plAppData* ptAppData);
+void   draw_player_tokens(plAppData* ptAppData);
+bool   sprite_atlas_build(mTextureRequest* ptRequest);
+bool   sprite_shape_covers(eSprite eSpriteId, float fX, float fY);
+void   sprite_shape_draw(eSprite eSpriteId, uint8_t* puTexels, uint32_t uWidth, uint32_t uHeight, uint32_t uStride);
+void   sprite_batch_init(plAppData* ptAppData);
+void   sprite_batch_begin(mSpriteBatch* ptBatch);
+void   sprite_batch_add(mSpriteBatch* ptBatch, const mSpriteAtlas* ptAtlas, eSprite eSpriteId, plVec2 tMin, plVec2 tMax, plVec4 tColor);
+void   sprite_batch_submit(plAppData* ptAppData, plRenderEncoder* ptRender);
+void   sprite_batch_cleanup(plAppData* ptAppData);
 void   draw_preroll_menu(plAppData* ptAppData);
 void   draw_postroll_menu(plAppData* ptAppData);
 void   draw_jail_menu(plAppData* ptAppData);
@@ -184,6 +514,12 @@ void   draw_notification(plAppData* ptAppData);
 void   draw_property_management_menu(plAppData* ptAppData);
 void   draw_auction_menu(plAppData* ptAppData);
 void   draw_trade_menu(plAppData* ptAppData);
+bool   preview_trade(plAppData* ptAppData, const mTradeData* pTrade, int32_t* piFromNetWorthOut, int32_t* piToNetWorthOut);
+bool   trade_matches(const mTradeData* pA, const mTradeData* pB);
+float  perf_ms_since(uint64_t uStartNs);
+void   record_perf_frame(plAppData* ptAppData);
+void   draw_perf_overlay(plAppData* ptAppData);
+void   draw_perf_histogram(plAppData* ptAppData, plRenderEncoder* ptRender);
 
 
 //-----------------------------------------------------------------------------
@@ -220,6 +556,9 @@ pl_app_load(plApiRegistryI* ptApiRegistry, plAppData* ptAppData)
     ptAppData = malloc(sizeof(plAppData));
     memset(ptAppData, 0, sizeof(plAppData));
 
+    // trace buffer, only exists in M_ENABLE_PROFILING builds (~30 minutes of frames)
+    M_PROFILE_INIT(1 << 20);
+
     // load extensions
     const plExtensionRegistryI* ptExtensionRegistry = pl_get_api_latest(ptApiRegistry, plExtensionRegistryI);
     ptExtensionRegistry->load("pl_unity_ext", NULL, NULL, true);
@@ -318,7 +657,7 @@ pl_app_load(plApiRegistryI* ptApiRegistry, plAppData* ptAppData)
         .tUAddressMode = PL_ADDRESS_MODE_CLAMP_TO_EDGE,
         .tVAddressMode = PL_ADDRESS_MODE_CLAMP_TO_EDGE,
         .fMinMip       = 0.0f,
-        .fMaxMip       = 1.0f,
+        .fMaxMip       = (float)M_TEXTURE_MAX_MIPS, // cooked textures carry full mip chains
         .pcDebugName   = "sampler_linear" 
     };
     ptAppData->tLinearSampler = gptGfx->create_sampler(ptAppData->ptDevice, &tLinearSamplerDesc);
@@ -339,20 +678,28 @@ pl_app_load(plApiRegistryI* ptApiRegistry, plAppData* ptAppData)
     // create bind group pool
     const plBindGroupPoolDesc tBindGroupPoolTexAndSampDesc = {
         .szSampledTextureBindings = 100,
-        .szSamplerBindings = 100
+        .szSamplerBindings = 100,
+        .szStorageBufferBindings = 8 // sprite instances
     };
     ptAppData->tBindGroupPoolTexAndSamp = gptGfx->create_bind_group_pool(ptAppData->ptDevice, &tBindGroupPoolTexAndSampDesc);
 
-    // load board texture
-    plTextureLoadConfig tBoardConfig = {
-        .pcFilePath     = "../../monopoly/assets/monopoly-board.png",
+    // every upload goes through one persistent staging buffer
+    staging_ring_init(ptAppData);
+
+    // decoding starts right away, uploads happen from pl_app_update so the window shows up first
+    texture_stream_start(ptAppData);
+
+    // pack the board, dice and piece sprites into one atlas
+    plTextureLoadConfig tAtlasConfig = {
+        .pcFilePath     = "sprite atlas",
         .tSampler       = ptAppData->tLinearSampler,
-        .ptOutTexture   = &ptAppData->tBoardTexture,
-        .ptOutMemory    = &ptAppData->tBoardTextureMemory,
-        .ptOutBindGroup = &ptAppData->tBoardBindGroup,
-        .pbOutLoaded    = &ptAppData->bBoardTextureLoaded
+        .ptOutTexture   = &ptAppData->tSpriteAtlas.tTexture,
+        .ptOutMemory    = &ptAppData->tSpriteAtlas.tMemory,
+        .ptOutBindGroup = &ptAppData->tSpriteAtlas.tBindGroup,
+        .pbOutLoaded    = &ptAppData->tSpriteAtlas.bLoaded,
+        .ptAtlas        = &ptAppData->tSpriteAtlas
     };
-    load_texture(ptAppData, &tBoardConfig);
+    load_texture(ptAppData, &tAtlasConfig);
 
     // create render pass layout
     const plRenderPassLayoutDesc tMainRenderPassLayoutDesc = {
@@ -366,14 +713,17 @@ pl_app_load(plApiRegistryI* ptApiRegistry, plAppData* ptAppData)
     };
     ptAppData->tMainPassLayout = gptGfx->create_render_pass_layout(ptAppData->ptDevice, &tMainRenderPassLayoutDesc);
 
+    // unit quad and per frame instance buffers
+    sprite_batch_init(ptAppData);
+
     // load shaders
     plShaderModule tVertModule = gptShader->load_glsl("textured_quad.vert", "main", NULL, NULL);
     plShaderModule tFragModule = gptShader->load_glsl("textured_quad.frag", "main", NULL, NULL);
 
+    // quad corner, everything else comes from the instance buffer
     plVertexBufferLayout tVertexLayout = {
         .uByteStride = 0,
         .atAttributes = {
-            { .tFormat = PL_VERTEX_FORMAT_FLOAT2 },
             { .tFormat = PL_VERTEX_FORMAT_FLOAT2 }
         }
     };
@@ -384,6 +734,7 @@ pl_app_load(plApiRegistryI* ptApiRegistry, plAppData* ptAppData)
         .tFragmentShader          = tFragModule,
         .atVertexBufferLayouts[0] = tVertexLayout,
         .atBindGroupLayouts[0]    = ptAppData->tTextureBindGroupLayoutDesc,
+        .atBindGroupLayouts[1]    = ptAppData->tSpriteBatch.tInstanceLayoutDesc,
         .tRenderPassLayout        = ptAppData->tMainPassLayout,
         .pcDebugName              = "textured quad shader"
     };
@@ -415,71 +766,6 @@ pl_app_load(plApiRegistryI* ptApiRegistry, plAppData* ptAppData)
     ptAppData->tRenderPass = gptGfx->create_render_pass(ptAppData->ptDevice, &tMainPassDesc, atAttachments);
     free(atAttachments);
 
-    // create quad geometry
-    const float atVertices[] = {
-        0.0f,   0.0f,   0.0f, 0.0f,
-        700.0f, 0.0f,   1.0f, 0.0f,
-        700.0f, 700.0f, 1.0f, 1.0f,
-        0.0f,   700.0f, 0.0f, 1.0f
-    };
-
-    const plBufferDesc tVertexDesc = {
-        .tUsage      = PL_BUFFER_USAGE_VERTEX | PL_BUFFER_USAGE_TRANSFER_DESTINATION,
-        .szByteSize  = sizeof(atVertices),
-        .pcDebugName = "quad vertices"
-    };
-    ptAppData->tQuadVertexBuffer = gptGfx->create_buffer(ptAppData->ptDevice, &tVertexDesc, NULL);
-    plBuffer* ptVertexBuffer = gptGfx->get_buffer(ptAppData->ptDevice, ptAppData->tQuadVertexBuffer);
-
-    ptAppData->tQuadVertexMemory = gptGfx->allocate_memory(ptAppData->ptDevice, ptVertexBuffer->tMemoryRequirements.ulSize, 
-        PL_MEMORY_FLAGS_DEVICE_LOCAL, ptVertexBuffer->tMemoryRequirements.uMemoryTypeBits, "vertex buffer memory");
-    gptGfx->bind_buffer_to_memory(ptAppData->ptDevice, ptAppData->tQuadVertexBuffer, &ptAppData->tQuadVertexMemory);
-
-    uint32_t auIndices[] = { 0, 1, 2, 0, 2, 3 };
-
-    plBufferDesc tIndexDesc = {
-        .tUsage = PL_BUFFER_USAGE_INDEX | PL_BUFFER_USAGE_TRANSFER_DESTINATION,
-        .szByteSize = sizeof(auIndices),
-        .pcDebugName = "quad indices"
-    };
-    ptAppData->tQuadIndexBuffer = gptGfx->create_buffer(ptAppData->ptDevice, &tIndexDesc, NULL);
-    plBuffer* ptIndexBuffer = gptGfx->get_buffer(ptAppData->ptDevice, ptAppData->tQuadIndexBuffer);
-
-    ptAppData->tQuadIndexMemory = gptGfx->allocate_memory(ptAppData->ptDevice, ptIndexBuffer->tMemoryRequirements.ulSize, 
-        PL_MEMORY_FLAGS_DEVICE_LOCAL, ptIndexBuffer->tMemoryRequirements.uMemoryTypeBits, "index buffer memory");
-    gptGfx->bind_buffer_to_memory(ptAppData->ptDevice, ptAppData->tQuadIndexBuffer, &ptAppData->tQuadIndexMemory);
-
-    // upload geometry
-    plBufferDesc tStagingDesc = {
-        .tUsage      = PL_BUFFER_USAGE_STAGING,
-        .szByteSize  = 4096,
-        .pcDebugName = "staging buffer"
-    };
-    plBufferHandle tStagingHandle = gptGfx->create_buffer(ptAppData->ptDevice, &tStagingDesc, NULL);
-    plBuffer* ptStagingBuffer = gptGfx->get_buffer(ptAppData->ptDevice, tStagingHandle);
-
-    plDeviceMemoryAllocation tStagingMem = gptGfx->allocate_memory(ptAppData->ptDevice, ptStagingBuffer->tMemoryRequirements.ulSize, 
-        PL_MEMORY_FLAGS_HOST_VISIBLE | PL_MEMORY_FLAGS_HOST_COHERENT, ptStagingBuffer->tMemoryRequirements.uMemoryTypeBits, "staging memory");
-    gptGfx->bind_buffer_to_memory(ptAppData->ptDevice, tStagingHandle, &tStagingMem);
-
-    memcpy(ptStagingBuffer->tMemoryAllocation.pHostMapped, atVertices, sizeof(atVertices));
-    memcpy(&ptStagingBuffer->tMemoryAllocation.pHostMapped[1024], auIndices, sizeof(auIndices));
-
-    plCommandBuffer* ptCmd = gptGfx->request_command_buffer(ptAppData->ptCommandPool, "upload geometry");
-    gptGfx->begin_command_recording(ptCmd, NULL);
-
-    plBlitEncoder* ptBlit = gptGfx->begin_blit_pass(ptCmd);
-    gptGfx->copy_buffer(ptBlit, tStagingHandle, ptAppData->tQuadVertexBuffer, 0, 0, sizeof(atVertices));
-    gptGfx->copy_buffer(ptBlit, tStagingHandle, ptAppData->tQuadIndexBuffer, 1024, 0, sizeof(auIndices));
-    gptGfx->end_blit_pass(ptBlit);
-
-    gptGfx->end_command_recording(ptCmd);
-    gptGfx->submit_command_buffer(ptCmd, NULL);
-    gptGfx->wait_on_command_buffer(ptCmd);
-    gptGfx->return_command_buffer(ptCmd);
-
-    gptGfx->destroy_buffer(ptAppData->ptDevice, tStagingHandle);
-
     // TODO: create menu system so player can adjust these before game starts
     // initialize monopoly game
     mGameSettings tSettings = {
@@ -489,13 +775,15 @@ pl_app_load(plApiRegistryI* ptApiRegistry, plAppData* ptAppData)
     };
     ptAppData->pGameData = m_init_game(tSettings);
     m_init_game_flow(&ptAppData->tGameFlow, ptAppData->pGameData, ptAppData->ptWindow);
+    ptAppData->pPreviewJournal = m_create_change_journal(256); // a full trade is < 100 changes
+    m_ai_init_model(&ptAppData->tAiModel);
 
-    // create persistent drawlist and layer for player tokens
-    ptAppData->ptTokenDrawlist = gptDraw->request_2d_drawlist();
-    ptAppData->ptTokenLayer = gptDraw->request_2d_layer(ptAppData->ptTokenDrawlist);
+    // create persistent drawlist and layer for the performance histogram
+    ptAppData->tPerf.ptDrawlist = gptDraw->request_2d_drawlist();
+    ptAppData->tPerf.ptLayer = gptDraw->request_2d_layer(ptAppData->tPerf.ptDrawlist);
 
-    // init bounding boxes for properties 
-    init_property_bounds(ptAppData->atPropertyBounds);
+    // board placement and bounding boxes for properties
+    update_screen_layout(ptAppData, (plVec2){(float)SCREEN_WIDTH, (float)SCREEN_HEIGHT});
 
     return ptAppData;
 }
@@ -509,12 +797,14 @@ pl_app_shutdown(plAppData* ptAppData)
 {
     // wait for GPU to finish
     gptGfx->flush_device(ptAppData->ptDevice);
+    texture_stream_cleanup(ptAppData);
+    staging_ring_cleanup(ptAppData);
 
     // return persistent drawing resources 
-    if(ptAppData->ptTokenLayer)
-        gptDraw->return_2d_layer(ptAppData->ptTokenLayer);
-    if(ptAppData->ptTokenDrawlist)
-        gptDraw->return_2d_drawlist(ptAppData->ptTokenDrawlist);
+    if(ptAppData->tPerf.ptLayer)
+        gptDraw->return_2d_layer(ptAppData->tPerf.ptLayer);
+    if(ptAppData->tPerf.ptDrawlist)
+        gptDraw->return_2d_drawlist(ptAppData->tPerf.ptDrawlist);
 
     // cleanup font atlas 
     gptDraw->cleanup_font_atlas(gptDraw->get_current_font_atlas());
@@ -524,15 +814,14 @@ pl_app_shutdown(plAppData* ptAppData)
     gptUi->cleanup();
 
     // cleanup textures (NOT swapchain textures)
-    if(ptAppData->bBoardTextureLoaded)
+    if(ptAppData->tSpriteAtlas.bLoaded)
     {
-        gptGfx->destroy_texture(ptAppData->ptDevice, ptAppData->tBoardTexture);
-        gptGfx->destroy_bind_group(ptAppData->ptDevice, ptAppData->tBoardBindGroup);
+        gptGfx->destroy_texture(ptAppData->ptDevice, ptAppData->tSpriteAtlas.tTexture);
+        gptGfx->destroy_bind_group(ptAppData->ptDevice, ptAppData->tSpriteAtlas.tBindGroup);
     }
 
-    // cleanup geometry buffers
-    gptGfx->destroy_buffer(ptAppData->ptDevice, ptAppData->tQuadVertexBuffer);
-    gptGfx->destroy_buffer(ptAppData->ptDevice, ptAppData->tQuadIndexBuffer);
+    // cleanup sprite buffers
+    sprite_batch_cleanup(ptAppData);
 
     // cleanup shader, bind group pool, layout, and sampler
     gptGfx->destroy_shader(ptAppData->ptDevice, ptAppData->tTexturedQuadShader);
@@ -561,6 +850,11 @@ pl_app_shutdown(plAppData* ptAppData)
     // cleanup game data
     if(ptAppData->pGameData)
         m_free_game(ptAppData->pGameData);
+    m_free_change_journal(ptAppData->pPreviewJournal);
+
+    // save the trace next to the executable (no-op unless profiling is compiled in)
+    M_PROFILE_WRITE_TRACE("monopoly_trace.json");
+    M_PROFILE_CLEANUP();
 
     // cleanup window
     gptWindows->destroy(ptAppData->ptWindow);
@@ -576,7 +870,34 @@ pl_app_shutdown(plAppData* ptAppData)
 PL_EXPORT void
 pl_app_resize(plWindow* ptWindow, plAppData* ptAppData)
 {
-    // handle window resizing if needed
+    plVec2 tViewportSize = gptIO->get_io()->tMainViewportSize;
+    if(tViewportSize.x < 1.0f || tViewportSize.y < 1.0f)
+        return; // minimized, the swapchain is recreated when it comes back
+
+    // only the swapchain and what draws into it depend on the window size
+    plSwapchainInit tSwapchainInit = {
+        .bVSync = true,
+        .tSampleCount = PL_SAMPLE_COUNT_1,
+        .uWidth = (uint32_t)tViewportSize.x,
+        .uHeight = (uint32_t)tViewportSize.y
+    };
+    gptGfx->recreate_swapchain(ptAppData->ptSwapchain, &tSwapchainInit);
+
+    uint32_t uImageCount = 0;
+    ptAppData->atSwapchainImages = gptGfx->get_swapchain_images(ptAppData->ptSwapchain, &uImageCount);
+    ptAppData->uSwapchainImageCount = uImageCount;
+
+    plRenderPassAttachments* atAttachments = malloc(sizeof(plRenderPassAttachments) * uImageCount);
+    for(uint32_t i = 0; i < uImageCount; i++)
+    {
+        atAttachments[i].atViewAttachments[0] = ptAppData->atSwapchainImages[i];
+    }
+    gptGfx->update_render_pass_attachments(ptAppData->ptDevice, ptAppData->tRenderPass, tViewportSize, atAttachments);
+    free(atAttachments);
+
+    // board and menus follow the new size, draw it even if the game is idle
+    update_screen_layout(ptAppData, tViewportSize);
+    ptAppData->tFrameScheduler.uLastActiveNs = m_get_time_ns();
 }
 
 //-----------------------------------------------------------------------------
@@ -586,15 +907,32 @@ pl_app_resize(plWindow* ptWindow, plAppData* ptAppData)
 PL_EXPORT void
 pl_app_update(plAppData* ptAppData)
 {
+    mPerfStats* ptPerf = &ptAppData->tPerf;
+    ptPerf->uFrameStartNs = m_get_time_ns();
 
-    // process input events and start frame calls
+    // release staging space the gpu is done with, then finish and start texture uploads
+    staging_ring_retire(ptAppData);
+    texture_stream_update(ptAppData);
+
+    // process input events, then skip the frame if nothing on screen can change
     gptIO->new_frame();
+    mFrameScheduler* ptScheduler = &ptAppData->tFrameScheduler;
+    ptScheduler->fFrameTime += gptIO->get_io()->fDeltaTime;
+    if(!frame_should_render(ptAppData))
+    {
+        m_sleep_ms(FRAME_IDLE_POLL_MS);
+        return;
+    }
+    const float fDeltaTime = ptScheduler->fFrameTime;
+    ptScheduler->fFrameTime = 0.0f;
+
+    // start frame calls
     gptDraw->new_frame();
     gptUi->new_frame();
     handle_keyboard_input(ptAppData);
 
     // show ui windows
-    show_player_status(ptAppData->pGameData);
+    show_player_status(ptAppData);
     draw_dice_result(ptAppData);
         
     // show phase-specific menus
@@ -630,69 +968,94 @@ pl_app_update(plAppData* ptAppData)
     // show notification popup (on top of everything)
     draw_notification(ptAppData);
 
+    if(ptPerf->bShowOverlay)
+        draw_perf_overlay(ptAppData);
+
+    // input handling and ui building so far
+    ptPerf->fUiMs = perf_ms_since(ptPerf->uFrameStartNs);
+
     // run game phase
-    m_run_current_phase(&ptAppData->tGameFlow, 0.016f);
+    uint64_t uPhaseStartNs = m_get_time_ns();
+    m_run_current_phase(&ptAppData->tGameFlow, fDeltaTime);
+    ptPerf->fPhaseMs = perf_ms_since(uPhaseStartNs);
     if(m_check_game_over(ptAppData->pGameData))
     {
         //  TODO: add some shutdown screen
     }
 
+    // dice and tokens catch up with what the phase just did, at the same time scale
+    animator_update(ptAppData, ptAppData->tGameFlow.fDeltaTime);
+
     // end ui frame
+    uint64_t uEndFrameStartNs = m_get_time_ns();
     gptUi->end_frame();
+    ptPerf->fUiMs += perf_ms_since(uEndFrameStartNs);
 
     // begin frame
+    uint64_t uDrawStartNs = m_get_time_ns();
     gptGfx->begin_frame(ptAppData->ptDevice);
 
     if(!gptGfx->acquire_swapchain_image(ptAppData->ptSwapchain))
+    {
+        pl_app_resize(ptAppData->ptWindow, ptAppData);
+        ptPerf->fDrawMs = perf_ms_since(uDrawStartNs);
+        record_perf_frame(ptAppData);
         return;
+    }
+
+    M_PROFILE_BEGIN("draw submission");
 
     plCommandBuffer* ptCmd = gptGfx->request_command_buffer(ptAppData->ptCommandPool, "main");
-    const plBeginCommandInfo tBeginInfo = { .uWaitSemaphoreCount = 0 };
+    plBeginCommandInfo tBeginInfo = { .uWaitSemaphoreCount = 0 };
+
+    // anything uploaded since the last frame has to land before it's drawn
+    mStagingRing* ptStagingRing = &ptAppData->tStagingRing;
+    if(ptStagingRing->uWaitedValue < ptStagingRing->uSubmittedValue)
+    {
+        tBeginInfo.uWaitSemaphoreCount      = 1;
+        tBeginInfo.atWaitSempahores[0]      = ptStagingRing->ptSemaphore;
+        tBeginInfo.auWaitSemaphoreValues[0] = ptStagingRing->uSubmittedValue;
+        ptStagingRing->uWaitedValue = ptStagingRing->uSubmittedValue;
+    }
     gptGfx->begin_command_recording(ptCmd, &tBeginInfo);
 
     plRenderEncoder* ptRender = gptGfx->begin_render_pass(ptCmd, ptAppData->tRenderPass, NULL);
 
-    plRenderViewport tViewport = {.fWidth = 1280, .fHeight = 720, .fMaxDepth = 1.0f};
+    const plVec2 tViewportSize = ptAppData->tLayout.tViewportSize;
+    plRenderViewport tViewport = {.fWidth = tViewportSize.x, .fHeight = tViewportSize.y, .fMaxDepth = 1.0f};
     gptGfx->set_viewport(ptRender, &tViewport);
 
-    plScissor tScissor = {.uWidth = 1280, .uHeight = 720};
+    plScissor tScissor = {.uWidth = (uint32_t)tViewportSize.x, .uHeight = (uint32_t)tViewportSize.y};
     gptGfx->set_scissor_region(ptRender, &tScissor);
 
-    gptGfx->bind_shader(ptRender, ptAppData->tTexturedQuadShader);
-    gptGfx->bind_vertex_buffer(ptRender, ptAppData->tQuadVertexBuffer);
-
-    plDynamicDataBlock tBlock = gptGfx->allocate_dynamic_data_block(ptAppData->ptDevice);
-    plDynamicBinding tBinding = pl_allocate_dynamic_data(gptGfx, ptAppData->ptDevice, &tBlock);
-
-    plMat4* pMVP = (plMat4*)tBinding.pcData;
-    plMat4 m4Projection = create_orthographic_projection((float)SCREEN_WIDTH, (float)SCREEN_HEIGHT);
-    plMat4 m4Translate = pl_mat4_translate_xyz(50.0f, 10.0f, 0.0f);
-    *pMVP = pl_mul_mat4(&m4Projection, &m4Translate);
-
-    gptGfx->bind_graphics_bind_groups(ptRender, ptAppData->tTexturedQuadShader, 0, 1, &ptAppData->tBoardBindGroup, 1, &tBinding);
-
-    plDrawIndex tDraw = {
-        .uIndexCount = 6,
-        .tIndexBuffer = ptAppData->tQuadIndexBuffer,
-        .uInstanceCount = 1
-    };
-    gptGfx->draw_indexed(ptRender, 1, &tDraw);
-
-    // draw player tokens on the board
-    draw_player_tokens(ptAppData, ptRender);
+    // board, buildings, tokens and dice in a single draw, once the atlas has streamed in
+    if(ptAppData->tSpriteAtlas.bLoaded)
+    {
+        update_board_layer(ptAppData);
+        sprite_batch_submit(ptAppData, ptRender);
+    }
 
     // submit ui drawlist
     plDrawList2D* ptDrawlist = gptUi->get_draw_list();
     if(ptDrawlist)
     {
-        gptDraw->submit_2d_drawlist(ptDrawlist, ptRender, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT, 1);
-        gptDraw->submit_2d_drawlist(gptUi->get_debug_draw_list(), ptRender, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT, 1);
+        gptDraw->submit_2d_drawlist(ptDrawlist, ptRender, tViewportSize.x, tViewportSize.y, 1);
+        gptDraw->submit_2d_drawlist(gptUi->get_debug_draw_list(), ptRender, tViewportSize.x, tViewportSize.y, 1);
     }
 
+    if(ptPerf->bShowOverlay)
+        draw_perf_histogram(ptAppData, ptRender);
+
     gptGfx->end_render_pass(ptRender);
     gptGfx->end_command_recording(ptCmd);
-    gptGfx->present(ptCmd, NULL, &ptAppData->ptSwapchain, 1);
+    if(!gptGfx->present(ptCmd, NULL, &ptAppData->ptSwapchain, 1))
+        pl_app_resize(ptAppData->ptWindow, ptAppData);
     gptGfx->return_command_buffer(ptCmd);
+    ptAppData->tFrameScheduler.uLastPresentNs = m_get_time_ns();
+    M_PROFILE_END();
+
+    ptPerf->fDrawMs = perf_ms_since(uDrawStartNs);
+    record_perf_frame(ptAppData);
 }
 
 //-----------------------------------------------------------------------------
@@ -702,6 +1065,10 @@ pl_app_update(plAppData* ptAppData)
 void
 handle_keyboard_input(plAppData* ptAppData)
 {
+    // toggle performance overlay
+    if(gptIO->is_key_pressed(PL_KEY_F3, false))
+        ptAppData->tPerf.bShowOverlay = !ptAppData->tPerf.bShowOverlay;
+
     if(!m_is_waiting_input(&ptAppData->tGameFlow))
         return;
     
@@ -716,122 +1083,6 @@ handle_keyboard_input(plAppData* ptAppData)
 // [SECTION] helper functions
 //-----------------------------------------------------------------------------
 
-void
-load_texture(plAppData* ptAppData, const plTextureLoadConfig* ptConfig)
-{
-    plDevice* ptDevice = ptAppData->ptDevice;
-
-    int iWidth, iHeight, iChannels;
-    unsigned char* pImageData = stbi_load(ptConfig->pcFilePath, &iWidth, &iHeight, &iChannels, 4);
-
-    if(!pImageData)
-    {
-        printf("ERROR: Failed to load %s\n", ptConfig->pcFilePath);
-        if(ptConfig->pbOutLoaded)
-            *ptConfig->pbOutLoaded = false;
-        return;
-    }
-
-    plTextureDesc tTexDesc = {
-        .tDimensions = {(float)iWidth, (float)iHeight, 1.0f},
-        .tFormat = PL_FORMAT_R8G8B8A8_UNORM,
-        .uLayers = 1,
-        .uMips = 1,
-        .tType = PL_TEXTURE_TYPE_2D,
-        .tUsage = PL_TEXTURE_USAGE_SAMPLED,
-        .pcDebugName = ptConfig->pcFilePath
-    };
-
-    plTexture* ptTexture = NULL;
-    *ptConfig->ptOutTexture = gptGfx->create_texture(ptDevice, &tTexDesc, &ptTexture);
-    *ptConfig->ptOutMemory = gptGfx->allocate_memory(ptDevice, ptTexture->tMemoryRequirements.ulSize, PL_MEMORY_FLAGS_DEVICE_LOCAL, 
-        ptTexture->tMemoryRequirements.uMemoryTypeBits, "texture memory");
-    gptGfx->bind_texture_to_memory(ptDevice, *ptConfig->ptOutTexture, ptConfig->ptOutMemory);
-
-    size_t szImageSize = iWidth * iHeight * 4;
-    plBufferDesc tStagingDesc = {
-        .tUsage = PL_BUFFER_USAGE_STAGING,
-        .szByteSize = szImageSize,
-        .pcDebugName = "texture staging"
-    };
-
-    plBuffer* ptStaging = NULL;
-    plBufferHandle tStagingHandle = gptGfx->create_buffer(ptDevice, &tStagingDesc, &ptStaging);
-    plDeviceMemoryAllocation tStagingMem = gptGfx->allocate_memory(ptDevice, ptStaging->tMemoryRequirements.ulSize, 
-        PL_MEMORY_FLAGS_HOST_VISIBLE | PL_MEMORY_FLAGS_HOST_COHERENT, ptStaging->tMemoryRequirements.uMemoryTypeBits, "staging memory");
-    gptGfx->bind_buffer_to_memory(ptDevice, tStagingHandle, &tStagingMem);
-
-    memcpy(tStagingMem.pHostMapped, pImageData, szImageSize);
-    stbi_image_free(pImageData);
-
-    plCommandBuffer* ptCmdbuff = gptGfx->request_command_buffer(ptAppData->ptCommandPool, "upload texture");
-    gptGfx->begin_command_recording(ptCmdbuff, NULL);
-    plBlitEncoder* ptBlit = gptGfx->begin_blit_pass(ptCmdbuff);
-
-    gptGfx->pipeline_barrier_blit(ptBlit, 
-        PL_PIPELINE_STAGE_VERTEX_SHADER | PL_PIPELINE_STAGE_TRANSFER, 
-        PL_ACCESS_SHADER_READ | PL_ACCESS_TRANSFER_READ, 
-        PL_PIPELINE_STAGE_TRANSFER, 
-        PL_ACCESS_TRANSFER_WRITE);
-
-    gptGfx->set_texture_usage(ptBlit, *ptConfig->ptOutTexture, PL_TEXTURE_USAGE_SAMPLED, 0);
-
-    plBufferImageCopy tCopy = {
-        .szBufferOffset = 0,
-        .uImageWidth = iWidth,
-        .uImageHeight = iHeight,
-        .uImageDepth = 1,
-        .uMipLevel = 0,
-        .uBaseArrayLayer = 0,
-        .uLayerCount = 1,
-        .tCurrentImageUsage = PL_TEXTURE_USAGE_SAMPLED
-    };
-    gptGfx->copy_buffer_to_texture(ptBlit, tStagingHandle, *ptConfig->ptOutTexture, 1, &tCopy);
-
-    gptGfx->pipeline_barrier_blit(ptBlit, 
-        PL_PIPELINE_STAGE_TRANSFER, 
-        PL_ACCESS_TRANSFER_WRITE, 
-        PL_PIPELINE_STAGE_VERTEX_SHADER | PL_PIPELINE_STAGE_TRANSFER, 
-        PL_ACCESS_SHADER_READ | PL_ACCESS_TRANSFER_READ);
-
-    gptGfx->end_blit_pass(ptBlit);
-    gptGfx->end_command_recording(ptCmdbuff);
-    gptGfx->submit_command_buffer(ptCmdbuff, NULL);
-    gptGfx->wait_on_command_buffer(ptCmdbuff);
-    gptGfx->return_command_buffer(ptCmdbuff);
-
-    gptGfx->destroy_buffer(ptDevice, tStagingHandle);
-
-    plBindGroupDesc tBGDesc = {
-        .tLayout = ptAppData->tTextureBindGroupLayout,
-        .ptPool = ptAppData->tBindGroupPoolTexAndSamp,
-        .pcDebugName = "texture bind group"
-    };
-    *ptConfig->ptOutBindGroup = gptGfx->create_bind_group(ptDevice, &tBGDesc);
-
-    plBindGroupUpdateTextureData tTexUpdate = {
-        .tTexture = *ptConfig->ptOutTexture,
-        .uSlot = 0,
-        .tType = PL_TEXTURE_BINDING_TYPE_SAMPLED,
-        .tCurrentUsage = PL_TEXTURE_USAGE_SAMPLED
-    };
-    plBindGroupUpdateSamplerData tSamplerUpdate = {
-        .tSampler = ptConfig->tSampler,
-        .uSlot = 1
-    };
-    plBindGroupUpdateData tUpdateData = {
-        .uTextureCount = 1,
-        .atTextureBindings = &tTexUpdate,
-        .uSamplerCount = 1,
-        .atSamplerBindings = &tSamplerUpdate
-    };
-
-    gptGfx->update_bind_group(ptDevice, *ptConfig->ptOutBindGroup, &tUpdateData);
-
-    if(ptConfig->pbOutLoaded)
-        *ptConfig->pbOutLoaded = true;
-}
-
 plMat4 
 create_orthographic_projection(float fScreenWidth, float fScreenHeight)
 {
@@ -841,9 +1092,10 @@ create_orthographic_projection(float fScreenWidth, float fScreenHeight)
     result.col[0].x = 2.0f / fScreenWidth;
     result.col[3].x = -1.0f;
 
-    // maps (0, fScreenHeight) to (1, -1) for y (flipped)
-    result.col[1].y = -2.0f / fScreenHeight;
-    result.col[3].y = 1.0f;
+    // maps (0, fScreenHeight) to (-1, 1) for y, clip space y points down so the origin is
+    // top left like the ui and the property bounds
+    result.col[1].y = 2.0f / fScreenHeight;
+    result.col[3].y = -1.0f;
 
     // z and w
     result.col[2].z = -1.0f;
@@ -852,175 +1104,271 @@ create_orthographic_projection(float fScreenWidth, float fScreenHeight)
     return result;
 }
 
+// board sized from the window height, menus to its right
 void
-init_property_bounds(mPropertyBounds* atBounds)
-{
-    // corners are larger than standard property pieces 
-    // bottom right corner (GO) - position 0
-    atBounds[0] = (mPropertyBounds){
-        .tMin = {655.0f, 615.0f},
-        .tMax = {750.0f, 710.0f},
-        .tCenter = {702.5f, 662.5f}
-    };
-    
-    // bottom row properties (positions 1-9)
-    float fBottomY = 615.0f;
-    float fBottomHeight = 95.0f; // 710 - 615
-    float afBottomX[] = {145.0f, 201.67f, 258.33f, 315.0f, 371.67f, 428.33f, 485.0f, 541.67f, 598.33f, 655.0f};
-    
-    for(uint8_t i = 0; i < 9; i++)
+update_screen_layout(plAppData* ptAppData, plVec2 tViewportSize)
+{
+    mScreenLayout* ptLayout = &ptAppData->tLayout;
+    ptLayout->tViewportSize = tViewportSize;
+    ptLayout->fBoardSize    = tViewportSize.y * (1.0f - 2.0f * BOARD_MARGIN);
+    ptLayout->tBoardMin     = (plVec2){tViewportSize.y * BOARD_LEFT, tViewportSize.y * BOARD_MARGIN};
+    ptLayout->fBoardScale   = ptLayout->fBoardSize / BOARD_REFERENCE_SIZE;
+    ptLayout->fPanelX       = ptLayout->tBoardMin.x + ptLayout->fBoardSize + BOARD_PANEL_GAP;
+    ptLayout->fCenterX      = tViewportSize.x * 0.5f;
+
+    init_property_bounds(ptAppData->atPropertyBounds, ptLayout->tBoardMin, ptLayout->fBoardSize);
+    ptAppData->tBoardLayer.bValid = false;
+}
+
+// squares in board space (0 to 1 from the top-left corner), GO is bottom right and positions
+// run clockwise. corners are BOARD_CORNER square, the 9 properties on a side share the rest
+void
+init_property_bounds(mPropertyBounds* atBounds, plVec2 tBoardMin, float fBoardSize)
+{
+    const float fCorner = BOARD_CORNER;
+    const float fFar = 1.0f - BOARD_CORNER;
+    const float fProperty = (1.0f - 2.0f * BOARD_CORNER) / 9.0f;
+
+    for(uint8_t i = 0; i < 40; i++)
     {
-        atBounds[i + 1] = (mPropertyBounds)
+        uint8_t uSide = i / 10; // 0 bottom, 1 left, 2 top, 3 right
+        uint8_t uIndex = i % 10;
+        plVec2 tMin = {0};
+        plVec2 tMax = {0};
+
+        if(uIndex == 0)
         {
-            .tMin = {afBottomX[i], fBottomY},
-            .tMax = {afBottomX[i + 1], fBottomY + fBottomHeight},
-            .tCenter = {(afBottomX[i] + afBottomX[i + 1]) / 2.0f, fBottomY + fBottomHeight / 2.0f}
-        };
-    }
-    
-    // bottom left corner (jail) - position 10
-    atBounds[10] = (mPropertyBounds)
-    {
-        .tMin = {50.0f, 615.0f},
-        .tMax = {145.0f, 710.0f},
-        .tCenter = {97.5f, 662.5f}
-    };
-    
-    // left column properties (positions 11-19)
-    float fLeftX = 50.0f;
-    float fLeftWidth = 95.0f; // 145 - 50
-    float afLeftY[] = {615.0f, 558.33f, 501.67f, 445.0f, 388.33f, 331.67f, 275.0f, 218.33f, 161.67f, 105.0f};
-    
-    for(uint8_t i = 0; i < 9; i++)
-    {
-        atBounds[i + 11] = (mPropertyBounds){
-            .tMin = {fLeftX, afLeftY[i + 1]},
-            .tMax = {fLeftX + fLeftWidth, afLeftY[i]},
-            .tCenter = {fLeftX + fLeftWidth / 2.0f, (afLeftY[i] + afLeftY[i + 1]) / 2.0f}
-        };
+            // corners
+            tMin.x = (uSide == 0 || uSide == 3) ? fFar : 0.0f;
+            tMin.y = (uSide == 0 || uSide == 1) ? fFar : 0.0f;
+            tMax = (plVec2){tMin.x + fCorner, tMin.y + fCorner};
+        }
+        else if(uSide == 0)
+        {
+            // bottom row, right to left from GO
+            tMin = (plVec2){fFar - fProperty * (float)uIndex, fFar};
+            tMax = (plVec2){tMin.x + fProperty, 1.0f};
+        }
+        else if(uSide == 1)
+        {
+            // left column, bottom to top from jail
+            tMin = (plVec2){0.0f, fFar - fProperty * (float)uIndex};
+            tMax = (plVec2){fCorner, tMin.y + fProperty};
+        }
+        else if(uSide == 2)
+        {
+            // top row, left to right from free parking
+            tMin = (plVec2){fCorner + fProperty * (float)(uIndex - 1), 0.0f};
+            tMax = (plVec2){tMin.x + fProperty, fCorner};
+        }
+        else
+        {
+            // right column, top to bottom from go to jail
+            tMin = (plVec2){fFar, fCorner + fProperty * (float)(uIndex - 1)};
+            tMax = (plVec2){1.0f, tMin.y + fProperty};
+        }
+
+        atBounds[i].tMin = (plVec2){tBoardMin.x + tMin.x * fBoardSize, tBoardMin.y + tMin.y * fBoardSize};
+        atBounds[i].tMax = (plVec2){tBoardMin.x + tMax.x * fBoardSize, tBoardMin.y + tMax.y * fBoardSize};
+        atBounds[i].tCenter = (plVec2){(atBounds[i].tMin.x + atBounds[i].tMax.x) * 0.5f, (atBounds[i].tMin.y + atBounds[i].tMax.y) * 0.5f};
     }
-    
-    // top left corner (free parking) - position 20
-    atBounds[20] = (mPropertyBounds){
-        .tMin = {50.0f, 10.0f},
-        .tMax = {145.0f, 105.0f},
-        .tCenter = {97.5f, 57.5f}
-    };
-    
-    // top row properties (positions 21-29)
-    float fTopY = 10.0f;
-    float fTopHeight = 95.0f; // 105 - 10
-    float afTopX[] = {145.0f, 201.67f, 258.33f, 315.0f, 371.67f, 428.33f, 485.0f, 541.67f, 598.33f, 655.0f};
-    
-    for(uint8_t i = 0; i < 9; i++)
+}
+
+// rebuilds the board sprites if the game changed since they were built, true if it did
+bool
+update_board_layer(plAppData* ptAppData)
+{
+    mBoardLayer* ptLayer = &ptAppData->tBoardLayer;
+    const mGameData* pGame = ptAppData->pGameData;
+    const mAnimator* ptAnim = &ptAppData->tAnimator;
+    if(ptLayer->bValid && !ptAnim->bActive && ptLayer->uStateVersion == pGame->uStateVersion 
+        && ptLayer->tDice.uDie1 == ptAnim->tShownDice.uDie1 && ptLayer->tDice.uDie2 == ptAnim->tShownDice.uDie2)
+        return false;
+
+    M_PROFILE_BEGIN("board layer rebuild");
+    ptLayer->bValid        = true;
+    ptLayer->uStateVersion = pGame->uStateVersion;
+    ptLayer->tDice         = ptAnim->tShownDice;
+
+    layout_player_tokens(ptAppData);
+    sprite_batch_begin(&ptAppData->tSpriteBatch);
+    draw_board(ptAppData);
+    draw_player_tokens(ptAppData);
+    M_PROFILE_END();
+    return true;
+}
+
+// where each token is drawn. walking tokens hop between square centers, the rest sit on their
+// square and players sharing one are spread on a circle
+void
+layout_player_tokens(plAppData* ptAppData)
+{
+    const mGameData* pGame = ptAppData->pGameData;
+    const mAnimator* ptAnim = &ptAppData->tAnimator;
+    mBoardLayer* ptLayer = &ptAppData->tBoardLayer;
+
+    // square each token sits on, TOTAL_BOARD_SQUARES while it's between squares
+    uint8_t auSquare[MAX_PLAYERS] = {0};
+    float afTravel[MAX_PLAYERS] = {0};
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
     {
-        atBounds[i + 21] = (mPropertyBounds){
-            .tMin = {afTopX[i], fTopY},
-            .tMax = {afTopX[i + 1], fTopY + fTopHeight},
-            .tCenter = {(afTopX[i] + afTopX[i + 1]) / 2.0f, fTopY + fTopHeight / 2.0f}
-        };
+        const mTokenWalk* ptWalk = &ptAnim->atWalks[i];
+        afTravel[i] = ptWalk->fPrevTravel + (ptWalk->fTravel - ptWalk->fPrevTravel) * ptAnim->fAlpha;
+        if(afTravel[i] <= 0.0f)
+            auSquare[i] = ptWalk->uFrom;
+        else if(afTravel[i] >= (float)ptWalk->uSquares)
+            auSquare[i] = ptWalk->uTo;
+        else
+            auSquare[i] = TOTAL_BOARD_SQUARES;
     }
-    
-    // top right corner (go to jail) - position 30
-    atBounds[30] = (mPropertyBounds){
-        .tMin = {655.0f, 10.0f},
-        .tMax = {750.0f, 105.0f},
-        .tCenter = {702.5f, 57.5f}
-    };
-    
-    // right column properties (positions 31-39)
-    float fRightX = 655.0f;
-    float fRightWidth = 95.0f; // 750 - 655
-    float afRightY[] = {105.0f, 161.67f, 218.33f, 275.0f, 331.67f, 388.33f, 445.0f, 501.67f, 558.33f, 615.0f};
-    
-    for(uint8_t i = 0; i < 9; i++)
+
+    // one pass to count players per square, one to hand out slots
+    uint8_t auPlayersOnSpace[40] = {0};
+    uint8_t auNextSlot[40] = {0};
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
     {
-        atBounds[i + 31] = (mPropertyBounds){
-            .tMin = {fRightX, afRightY[i]},
-            .tMax = {fRightX + fRightWidth, afRightY[i + 1]},
-            .tCenter = {fRightX + fRightWidth / 2.0f, (afRightY[i] + afRightY[i + 1]) / 2.0f}
-        };
+        if(!pGame->amPlayers[i].bIsBankrupt && auSquare[i] < TOTAL_BOARD_SQUARES)
+            auPlayersOnSpace[auSquare[i]]++;
     }
-}
 
-void
-draw_player_tokens(plAppData* ptAppData, plRenderEncoder* ptRender)
-{
-    plDrawList2D* ptDrawlist = ptAppData->ptTokenDrawlist;
-    plDrawLayer2D* ptLayer = ptAppData->ptTokenLayer;
-    
-    const uint32_t atPlayerColors[6] = {
-        {PL_COLOR_32_RED},
-        {PL_COLOR_32_BLUE},
-        {PL_COLOR_32_GREEN},
-        {PL_COLOR_32_YELLOW},
-        {PL_COLOR_32_MAGENTA},
-        {PL_COLOR_32_ORANGE}
-    };
-    
-    for(uint8_t i = 0; i < ptAppData->pGameData->uPlayerCount; i++)
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
     {
-        // get player to draw this iteration/ skip bankrupts
-        mPlayer* pPlayer = &ptAppData->pGameData->amPlayers[i];
+        const mPlayer* pPlayer = &pGame->amPlayers[i];
         if(pPlayer->bIsBankrupt)
             continue;
-        
-        // count how many players are on this same space
-        uint8_t uPlayersOnSpace = 0;
-        for(uint8_t j = 0; j < ptAppData->pGameData->uPlayerCount; j++)
+
+        // hop from one square center to the next
+        if(auSquare[i] == TOTAL_BOARD_SQUARES)
         {
-            if(ptAppData->pGameData->amPlayers[j].uPosition == pPlayer->uPosition && !ptAppData->pGameData->amPlayers[j].bIsBankrupt)
-            {
-                uPlayersOnSpace++;
-            }
+            const mTokenWalk* ptWalk = &ptAnim->atWalks[i];
+            uint8_t uHop = (uint8_t)afTravel[i];
+            float fT = afTravel[i] - (float)uHop;
+            plVec2 tFrom = ptAppData->atPropertyBounds[(ptWalk->uFrom + uHop) % TOTAL_BOARD_SQUARES].tCenter;
+            plVec2 tTo = ptAppData->atPropertyBounds[(ptWalk->uFrom + uHop + 1) % TOTAL_BOARD_SQUARES].tCenter;
+            ptLayer->atTokenPositions[i].x = tFrom.x + (tTo.x - tFrom.x) * fT;
+            ptLayer->atTokenPositions[i].y = tFrom.y + (tTo.y - tFrom.y) * fT - sinf(fT * PL_PI) * ANIM_HOP_HEIGHT * ptAppData->tLayout.fBoardScale;
+            continue;
         }
-        
-        // get bounds for this position
-        mPropertyBounds* pBounds = &ptAppData->atPropertyBounds[pPlayer->uPosition];
-        plVec2 tCenter = pBounds->tCenter;
 
-        plVec2 tTokenPos;
+        const mPropertyBounds* pBounds = &ptAppData->atPropertyBounds[auSquare[i]];
+        uint8_t uPlayersOnSpace = auPlayersOnSpace[auSquare[i]];
+        uint8_t uPlayerSlot = auNextSlot[auSquare[i]]++;
 
         // if only one player, just center them
         if(uPlayersOnSpace == 1)
         {
-            tTokenPos = tCenter;
-        }
-        else
-        {
-            // calculate radius based on property size (corners not same as props)
-            float fWidth = pBounds->tMax.x - pBounds->tMin.x;
-            float fHeight = pBounds->tMax.y - pBounds->tMin.y;
-            float fSmallestDim = (fWidth < fHeight) ? fWidth : fHeight; // smallest to fit weather side prop or top/ bottom prop
-            float fRadius = (fSmallestDim / 2.0f) * 0.6f; // 60% for some padding
-            
-            // figure out player 1, player 2, etc..
-            uint8_t uPlayerSlot = 0;
-            for(uint8_t j = 0; j < i; j++)
-            {
-                if(ptAppData->pGameData->amPlayers[j].uPosition == pPlayer->uPosition && !ptAppData->pGameData->amPlayers[j].bIsBankrupt)
-                {
-                    uPlayerSlot++;
-                }
-            }
-            
-            // calculate angle for this player (where to draw on the circle inside square)
-            float fAnglePerPlayer = (2.0f * PL_PI) / (float)uPlayersOnSpace;
-            float fAngle = fAnglePerPlayer * (float)uPlayerSlot;
-            
-            // calculate position using sin/cos
-            tTokenPos.x = tCenter.x + fRadius * cosf(fAngle);
-            tTokenPos.y = tCenter.y + fRadius * sinf(fAngle);
+            ptLayer->atTokenPositions[i] = pBounds->tCenter;
+            continue;
         }
-        
-        // draw circle for player token
-        uint32_t uColor = atPlayerColors[i];
-        plDrawSolidOptions tOptions = {.uColor = uColor};
-        gptDraw->add_circle_filled(ptLayer, tTokenPos, 10.0f, 16, tOptions);
-    }
+
+        // calculate radius based on property size (corners not same as props)
+        float fWidth = pBounds->tMax.x - pBounds->tMin.x;
+        float fHeight = pBounds->tMax.y - pBounds->tMin.y;
+        float fSmallestDim = (fWidth < fHeight) ? fWidth : fHeight; // smallest to fit weather side prop or top/ bottom prop
+        float fRadius = (fSmallestDim / 2.0f) * 0.6f; // 60% for some padding
+
+        // calculate angle for this player (where to draw on the circle inside square)
+        float fAngle = (2.0f * PL_PI) / (float)uPlayersOnSpace * (float)uPlayerSlot;
+        ptLayer->atTokenPositions[i].x = pBounds->tCenter.x + fRadius * cosf(fAngle);
+        ptLayer->atTokenPositions[i].y = pBounds->tCenter.y + fRadius * sinf(fAngle);
+    }
+}
+
+// board, mortgage markers, buildings and the last roll, in draw order
+void
+draw_board(plAppData* ptAppData)
+{
+    mSpriteBatch* ptBatch = &ptAppData->tSpriteBatch;
+    const mSpriteAtlas* ptAtlas = &ptAppData->tSpriteAtlas;
+    mGameData* pGame = ptAppData->pGameData;
+    const mScreenLayout* ptLayout = &ptAppData->tLayout;
+    const plVec4 tWhite = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    plVec2 tBoardMax = {ptLayout->tBoardMin.x + ptLayout->fBoardSize, ptLayout->tBoardMin.y + ptLayout->fBoardSize};
+    sprite_batch_add(ptBatch, ptAtlas, SPRITE_BOARD, ptLayout->tBoardMin, tBoardMax, tWhite);
+
+    const float fStrip = 18.0f * ptLayout->fBoardScale; // color strip along the inner edge of a street
+    const float fHouse = 12.0f * ptLayout->fBoardScale;
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        const mProperty* pProp = &pGame->amProperties[i];
+        const mPropertyBounds* pBounds = &ptAppData->atPropertyBounds[pProp->uPosition];
+
+        if(pProp->bIsMortgaged)
+            sprite_batch_add(ptBatch, ptAtlas, SPRITE_SOLID, pBounds->tMin, pBounds->tMax, (plVec4){0.0f, 0.0f, 0.0f, 0.45f});
+
+        if(pProp->uHouses == 0 && !pProp->bHasHotel)
+            continue;
+
+        // strip center line, buildings are spread along it
+        uint8_t uSide = pProp->uPosition / 10; // 0 bottom, 1 left, 2 top, 3 right
+        bool bAlongX = uSide == 0 || uSide == 2;
+        plVec2 tStart = pBounds->tMin;
+        plVec2 tEnd = pBounds->tMax;
+        if(uSide == 0)      tStart.y = tEnd.y = pBounds->tMin.y + fStrip * 0.5f;
+        else if(uSide == 1) tStart.x = tEnd.x = pBounds->tMax.x - fStrip * 0.5f;
+        else if(uSide == 2) tStart.y = tEnd.y = pBounds->tMax.y - fStrip * 0.5f;
+        else                tStart.x = tEnd.x = pBounds->tMin.x + fStrip * 0.5f;
+
+        if(pProp->bHasHotel)
+        {
+            plVec2 tCenter = {(tStart.x + tEnd.x) * 0.5f, (tStart.y + tEnd.y) * 0.5f};
+            sprite_batch_add(ptBatch, ptAtlas, SPRITE_HOTEL, (plVec2){tCenter.x - fHouse, tCenter.y - fHouse * 0.5f}, 
+                (plVec2){tCenter.x + fHouse, tCenter.y + fHouse * 0.5f}, (plVec4){0.85f, 0.1f, 0.1f, 1.0f});
+            continue;
+        }
+
+        for(uint8_t j = 0; j < pProp->uHouses; j++)
+        {
+            float fT = ((float)j + 0.5f) / 4.0f;
+            plVec2 tCenter = {
+                bAlongX ? tStart.x + (tEnd.x - tStart.x) * fT : tStart.x,
+                bAlongX ? tStart.y : tStart.y + (tEnd.y - tStart.y) * fT
+            };
+            sprite_batch_add(ptBatch, ptAtlas, SPRITE_HOUSE, (plVec2){tCenter.x - fHouse * 0.5f, tCenter.y - fHouse * 0.5f}, 
+                (plVec2){tCenter.x + fHouse * 0.5f, tCenter.y + fHouse * 0.5f}, (plVec4){0.1f, 0.6f, 0.1f, 1.0f});
+        }
+    }
+
+    // last roll in the middle of the board, tumbling for a moment after a roll
+    const mDice tDice = ptAppData->tAnimator.tShownDice;
+    if(tDice.uDie1 >= 1 && tDice.uDie1 <= 6 && tDice.uDie2 >= 1 && tDice.uDie2 <= 6)
+    {
+        const float fDie = 40.0f * ptLayout->fBoardScale;
+        const float fGap = 4.0f * ptLayout->fBoardScale;
+        plVec2 tCenter = {(ptLayout->tBoardMin.x + tBoardMax.x) * 0.5f, (ptLayout->tBoardMin.y + tBoardMax.y) * 0.5f};
+        sprite_batch_add(ptBatch, ptAtlas, (eSprite)(SPRITE_DIE_1 + tDice.uDie1 - 1), 
+            (plVec2){tCenter.x - fDie - fGap, tCenter.y - fDie * 0.5f}, (plVec2){tCenter.x - fGap, tCenter.y + fDie * 0.5f}, tWhite);
+        sprite_batch_add(ptBatch, ptAtlas, (eSprite)(SPRITE_DIE_1 + tDice.uDie2 - 1), 
+            (plVec2){tCenter.x + fGap, tCenter.y - fDie * 0.5f}, (plVec2){tCenter.x + fDie + fGap, tCenter.y + fDie * 0.5f}, tWhite);
+    }
+}
+
+// tokens at the slots from layout_player_tokens
+void
+draw_player_tokens(plAppData* ptAppData)
+{
+    const plVec4 atPlayerColors[6] = {
+        {1.0f, 0.0f, 0.0f, 1.0f}, // red
+        {0.0f, 0.0f, 1.0f, 1.0f}, // blue
+        {0.0f, 1.0f, 0.0f, 1.0f}, // green
+        {1.0f, 1.0f, 0.0f, 1.0f}, // yellow
+        {1.0f, 0.0f, 1.0f, 1.0f}, // magenta
+        {1.0f, 0.5f, 0.0f, 1.0f}  // orange
+    };
     
-    gptDraw->submit_2d_layer(ptLayer);
-    gptDraw->submit_2d_drawlist(ptDrawlist, ptRender, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT, 1);
+    const float fRadius = 11.0f * ptAppData->tLayout.fBoardScale;
+    for(uint8_t i = 0; i < ptAppData->pGameData->uPlayerCount; i++)
+    {
+        if(ptAppData->pGameData->amPlayers[i].bIsBankrupt)
+            continue;
+
+        plVec2 tTokenPos = ptAppData->tBoardLayer.atTokenPositions[i];
+
+        // tinted disc for player token
+        sprite_batch_add(&ptAppData->tSpriteBatch, &ptAppData->tSpriteAtlas, SPRITE_TOKEN, 
+            (plVec2){tTokenPos.x - fRadius, tTokenPos.y - fRadius}, (plVec2){tTokenPos.x + fRadius, tTokenPos.y + fRadius}, atPlayerColors[i]);
+    }
 }
 
 void
@@ -1033,7 +1381,7 @@ draw_preroll_menu(plAppData* ptAppData)
         return;
     
     // position menu in top right
-    gptUi->set_next_window_pos((plVec2){800.0f, 15.0f}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fPanelX, 15.0f}, PL_UI_COND_ALWAYS);
     gptUi->set_next_window_size((plVec2){400.0f, 230.0f}, PL_UI_COND_ALWAYS);
     
     char acWindowTitle[64];
@@ -1096,7 +1444,7 @@ draw_postroll_menu(plAppData* ptAppData)
     // show property purchase menu if on unowned property
     if(bOnUnownedProperty && m_is_waiting_input(&ptAppData->tGameFlow))
     {
-        gptUi->set_next_window_pos((plVec2){800.0f, 15.0f}, PL_UI_COND_ALWAYS);
+        gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fPanelX, 15.0f}, PL_UI_COND_ALWAYS);
         gptUi->set_next_window_size((plVec2){400.0f, 350.0f}, PL_UI_COND_ALWAYS);
         
         if(!gptUi->begin_window("Property Available", NULL, PL_UI_WINDOW_FLAGS_NO_RESIZE | PL_UI_WINDOW_FLAGS_NO_COLLAPSE | PL_UI_WINDOW_FLAGS_NO_MOVE | PL_UI_WINDOW_FLAGS_NO_SCROLLBAR))
@@ -1150,7 +1498,7 @@ draw_postroll_menu(plAppData* ptAppData)
     // show end-of-turn menu after forced actions
     else if(m_is_waiting_input(&ptAppData->tGameFlow))
     {
-        gptUi->set_next_window_pos((plVec2){800.0f, 15.0f}, PL_UI_COND_ALWAYS);
+        gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fPanelX, 15.0f}, PL_UI_COND_ALWAYS);
         gptUi->set_next_window_size((plVec2){400.0f, 240.0f}, PL_UI_COND_ALWAYS);
         
         if(!gptUi->begin_window("Turn Options", NULL, PL_UI_WINDOW_FLAGS_NO_RESIZE | PL_UI_WINDOW_FLAGS_NO_COLLAPSE | PL_UI_WINDOW_FLAGS_NO_MOVE | PL_UI_WINDOW_FLAGS_NO_SCROLLBAR))
@@ -1197,7 +1545,7 @@ draw_jail_menu(plAppData* ptAppData)
         return;
     
     // position menu in top right
-    gptUi->set_next_window_pos((plVec2){800.0f, 15.0f}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fPanelX, 15.0f}, PL_UI_COND_ALWAYS);
     gptUi->set_next_window_size((plVec2){400.0f, 250.0f}, PL_UI_COND_ALWAYS);
     
     char acWindowTitle[64];
@@ -1249,19 +1597,12 @@ draw_notification(plAppData* ptAppData)
 {
     mGameData* pGame = ptAppData->pGameData;
     
+    // times out in m_run_current_phase
     if(!pGame->bShowNotification)
         return;
     
-    // tick down timer (assuming ~60fps, so ~0.016s per frame)
-    pGame->fNotificationTimer -= 0.016f;
-    if(pGame->fNotificationTimer <= 0.0f)
-    {
-        m_clear_notification(pGame);
-        return;
-    }
-    
     // banner at top center
-    gptUi->set_next_window_pos((plVec2){300.0f, 15.0f}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fCenterX - 340.0f, 15.0f}, PL_UI_COND_ALWAYS);
     gptUi->set_next_window_size((plVec2){680.0f, 80.0f}, PL_UI_COND_ALWAYS);
     
     if(!gptUi->begin_window("##notification", NULL, PL_UI_WINDOW_FLAGS_NO_RESIZE | PL_UI_WINDOW_FLAGS_NO_COLLAPSE | PL_UI_WINDOW_FLAGS_NO_MOVE | PL_UI_WINDOW_FLAGS_NO_SCROLLBAR | PL_UI_WINDOW_FLAGS_NO_TITLE_BAR))
@@ -1274,10 +1615,12 @@ draw_notification(plAppData* ptAppData)
 }
 
 void 
-show_player_status(mGameData* pGameData)
+show_player_status(plAppData* ptAppData)
 {
+    mGameData* pGameData = ptAppData->pGameData;
+
     // render player status ui
-    gptUi->set_next_window_pos((plVec2){800.0f, 460.0f}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fPanelX, 460.0f}, PL_UI_COND_ALWAYS);
     gptUi->set_next_window_size((plVec2){400.0f, 250.0f}, PL_UI_COND_ALWAYS);
 
     // for code readability  
@@ -1346,7 +1689,7 @@ draw_dice_result(plAppData* ptAppData)
         return;
 
     // position right above player status window
-    gptUi->set_next_window_pos((plVec2){800.0f, 390.0f}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fPanelX, 390.0f}, PL_UI_COND_ALWAYS);
     gptUi->set_next_window_size((plVec2){400.0f, 60.0f}, PL_UI_COND_ALWAYS);
 
     if(!gptUi->begin_window("Dice Result", NULL, PL_UI_WINDOW_FLAGS_NO_RESIZE | PL_UI_WINDOW_FLAGS_NO_COLLAPSE | PL_UI_WINDOW_FLAGS_NO_MOVE | PL_UI_WINDOW_FLAGS_NO_TITLE_BAR))
@@ -1370,7 +1713,7 @@ draw_property_management_menu(plAppData* ptAppData)
     if(!pGame->bShowPropertyMenu)
         return;
     
-    gptUi->set_next_window_pos((plVec2){800.0f, 15.0f}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fPanelX, 15.0f}, PL_UI_COND_ALWAYS);
     gptUi->set_next_window_size((plVec2){400.0f, 400.0f}, PL_UI_COND_ALWAYS);
     
     if(!gptUi->begin_window("Property Management", NULL, PL_UI_WINDOW_FLAGS_NO_RESIZE | PL_UI_WINDOW_FLAGS_NO_COLLAPSE | PL_UI_WINDOW_FLAGS_NO_MOVE))
@@ -1546,7 +1889,7 @@ draw_auction_menu(plAppData* ptAppData)
     mPlayer* pCurrentBidder = &pGame->amPlayers[pAuction->uCurrentBidder];
     
     // position menu in center
-    gptUi->set_next_window_pos((plVec2){300.0f, 50.0f}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fCenterX - 340.0f, 50.0f}, PL_UI_COND_ALWAYS);
     gptUi->set_next_window_size((plVec2){680.0f, 500.0f}, PL_UI_COND_ALWAYS);
     
     if(!gptUi->begin_window("Auction", NULL, PL_UI_WINDOW_FLAGS_NO_RESIZE | PL_UI_WINDOW_FLAGS_NO_COLLAPSE | PL_UI_WINDOW_FLAGS_NO_MOVE))
@@ -1666,7 +2009,7 @@ draw_trade_menu(plAppData* ptAppData)
     mPlayer* pCurrentPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
     
     // centered window
-    gptUi->set_next_window_pos((plVec2){300.0f, 150.0f}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_pos((plVec2){ptAppData->tLayout.fCenterX - 340.0f, 150.0f}, PL_UI_COND_ALWAYS);
     gptUi->set_next_window_size((plVec2){680.0f, 500.0f}, PL_UI_COND_ALWAYS);
     
     if(!gptUi->begin_window("Trade", NULL, PL_UI_WINDOW_FLAGS_NO_RESIZE | PL_UI_WINDOW_FLAGS_NO_COLLAPSE | PL_UI_WINDOW_FLAGS_NO_MOVE))
@@ -1906,6 +2249,27 @@ draw_trade_menu(plAppData* ptAppData)
                 gptUi->text("  (Nothing)");
             }
             
+            // what accepting would do to both players
+            int32_t iFromAfter = 0;
+            int32_t iToAfter = 0;
+            if(preview_trade(ptAppData, pTrade, &iFromAfter, &iToAfter))
+            {
+                gptUi->vertical_spacing();
+                gptUi->text("Net worth after trade: Player %d $%d -> $%d, Player %d $%d -> $%d",
+                    pGame->uCurrentPlayerIndex + 1, m_calculate_net_worth(pGame, pGame->uCurrentPlayerIndex), iFromAfter,
+                    pTrade->uTargetPlayer + 1, m_calculate_net_worth(pGame, pTrade->uTargetPlayer), iToAfter);
+            }
+
+            // how the computer players would judge it (expected rent, sets, cash)
+            mTradeScore tScore;
+            if(m_ai_evaluate_trade(&ptAppData->tAiModel, pGame, pGame->uCurrentPlayerIndex, pTrade, &tScore))
+            {
+                gptUi->text("Trade value: Player %d %+.0f, Player %d %+.0f (%s)",
+                    pGame->uCurrentPlayerIndex + 1, tScore.fFromGain,
+                    pTrade->uTargetPlayer + 1, tScore.fToGain,
+                    tScore.fToGain >= ptAppData->tAiModel.fAcceptMargin ? "fair for both" : "bad for the receiver");
+            }
+            
             gptUi->vertical_spacing();
             gptUi->separator();
             gptUi->vertical_spacing();
@@ -1927,4 +2291,1276 @@ draw_trade_menu(plAppData* ptAppData)
     }
     
     gptUi->end_window();
-}
\ No newline at end of file
+}
+
+// applies the trade to the live game, reads the result and rolls it back again. the result
+// is cached until the trade is edited or the game changes
+bool
+preview_trade(plAppData* ptAppData, const mTradeData* pTrade, int32_t* piFromNetWorthOut, int32_t* piToNetWorthOut)
+{
+    mGameData* pGame = ptAppData->pGameData;
+    mTradePreview* ptPreview = &ptAppData->tTradePreview;
+    if(ptPreview->bValid && ptPreview->uStateVersion == pGame->uStateVersion &&
+       ptPreview->uFromPlayer == pGame->uCurrentPlayerIndex && trade_matches(&ptPreview->tTrade, pTrade))
+    {
+        *piFromNetWorthOut = ptPreview->iFromNetWorth;
+        *piToNetWorthOut   = ptPreview->iToNetWorth;
+        return ptPreview->bAvailable;
+    }
+
+    if(!ptAppData->pPreviewJournal || pGame->pJournal)
+        return false;
+
+    ptPreview->bValid        = true;
+    ptPreview->bAvailable    = false;
+    ptPreview->uStateVersion = pGame->uStateVersion;
+    ptPreview->uFromPlayer   = pGame->uCurrentPlayerIndex;
+    ptPreview->tTrade        = *pTrade;
+
+    // money the players don't have would wrap when applied
+    if(!m_ai_is_trade_valid(pGame, pGame->uCurrentPlayerIndex, pTrade))
+        return false;
+
+    // the game ends up exactly where it was, so observers shouldn't see a change
+    uint64_t uStateVersion    = pGame->uStateVersion;
+    uint32_t uDirtyFields     = pGame->uDirtyFields;
+    uint32_t uDirtyProperties = pGame->uDirtyProperties;
+    uint8_t  uDirtyPlayers    = pGame->uDirtyPlayers;
+
+    m_clear_change_journal(ptAppData->pPreviewJournal);
+    pGame->pJournal = ptAppData->pPreviewJournal;
+
+    uint32_t uCheckpoint = m_checkpoint(pGame);
+    m_apply_trade(pGame, pGame->uCurrentPlayerIndex, pTrade);
+    *piFromNetWorthOut = m_calculate_net_worth(pGame, pGame->uCurrentPlayerIndex);
+    *piToNetWorthOut   = m_calculate_net_worth(pGame, pTrade->uTargetPlayer);
+    bool bRestored = m_rollback(pGame, uCheckpoint);
+
+    pGame->pJournal         = NULL;
+    pGame->uStateVersion    = uStateVersion;
+    pGame->uDirtyFields     = uDirtyFields;
+    pGame->uDirtyProperties = uDirtyProperties;
+    pGame->uDirtyPlayers    = uDirtyPlayers;
+
+    ptPreview->bAvailable    = bRestored;
+    ptPreview->iFromNetWorth = *piFromNetWorthOut;
+    ptPreview->iToNetWorth   = *piToNetWorthOut;
+    return bRestored;
+}
+
+// compares what the trade moves, ignoring menu state
+bool
+trade_matches(const mTradeData* pA, const mTradeData* pB)
+{
+    if(pA->uTargetPlayer != pB->uTargetPlayer || pA->uOfferedMoney != pB->uOfferedMoney || 
+       pA->uRequestedMoney != pB->uRequestedMoney || pA->uOfferedPropertyCount != pB->uOfferedPropertyCount ||
+       pA->uRequestedPropertyCount != pB->uRequestedPropertyCount)
+        return false;
+    return memcmp(pA->auOfferedProperties, pB->auOfferedProperties, pA->uOfferedPropertyCount) == 0 &&
+           memcmp(pA->auRequestedProperties, pB->auRequestedProperties, pA->uRequestedPropertyCount) == 0;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] staging ring
+//-----------------------------------------------------------------------------
+
+void
+staging_ring_init(plAppData* ptAppData)
+{
+    mStagingRing* ptRing = &ptAppData->tStagingRing;
+    plDevice* ptDevice = ptAppData->ptDevice;
+
+    plBufferDesc tStagingDesc = {
+        .tUsage      = PL_BUFFER_USAGE_STAGING,
+        .szByteSize  = STAGING_RING_SIZE,
+        .pcDebugName = "staging ring"
+    };
+    plBuffer* ptStaging = NULL;
+    ptRing->tBuffer = gptGfx->create_buffer(ptDevice, &tStagingDesc, &ptStaging);
+    ptRing->tMemory = gptGfx->allocate_memory(ptDevice, ptStaging->tMemoryRequirements.ulSize, 
+        PL_MEMORY_FLAGS_HOST_VISIBLE | PL_MEMORY_FLAGS_HOST_COHERENT, ptStaging->tMemoryRequirements.uMemoryTypeBits, "staging ring memory");
+    gptGfx->bind_buffer_to_memory(ptDevice, ptRing->tBuffer, &ptRing->tMemory);
+
+    ptRing->ptSemaphore = gptGfx->create_semaphore(ptDevice, false);
+}
+
+// mapped space for an upload (or per frame data) read by the next staging_ring_submit.
+// NULL until enough earlier submissions retire, callers try again next frame
+void*
+staging_ring_alloc(mStagingRing* ptRing, size_t szSize, size_t* pszOffset)
+{
+    szSize = (szSize + STAGING_RING_ALIGNMENT - 1) & ~(size_t)(STAGING_RING_ALIGNMENT - 1);
+    if(szSize == 0 || szSize > STAGING_RING_SIZE)
+        return NULL;
+
+    // allocations since the last submit share a batch
+    uint64_t uValue = ptRing->uSubmittedValue + 1;
+    mStagingBatch* ptBatch = NULL;
+    if(ptRing->uBatchCount > 0)
+    {
+        ptBatch = &ptRing->atBatches[(ptRing->uFirstBatch + ptRing->uBatchCount - 1) % STAGING_RING_MAX_BATCHES];
+        if(ptBatch->uValue != uValue)
+            ptBatch = NULL;
+    }
+    if(!ptBatch && ptRing->uBatchCount == STAGING_RING_MAX_BATCHES)
+        return NULL;
+
+    size_t szHead = ptRing->szHead;
+    size_t szTail = ptRing->szTail;
+    bool bWrapped = szHead < szTail || (szHead == szTail && ptRing->uBatchCount > 0);
+
+    size_t szOffset = 0;
+    if(!bWrapped && STAGING_RING_SIZE - szHead >= szSize)
+        szOffset = szHead;
+    else if(!bWrapped && szTail >= szSize)
+        szOffset = 0; // wrap around, the end of the buffer is skipped
+    else if(bWrapped && szTail - szHead >= szSize)
+        szOffset = szHead;
+    else
+        return NULL;
+
+    if(!ptBatch)
+    {
+        ptBatch = &ptRing->atBatches[(ptRing->uFirstBatch + ptRing->uBatchCount) % STAGING_RING_MAX_BATCHES];
+        ptBatch->uValue = uValue;
+        ptRing->uBatchCount++;
+    }
+    ptRing->szHead = szOffset + szSize;
+    ptBatch->szEnd = ptRing->szHead;
+    *pszOffset = szOffset;
+    return &ptRing->tMemory.pHostMapped[szOffset];
+}
+
+// submits a recorded command buffer reading everything allocated since the last submit, the
+// caller still returns it
+void
+staging_ring_submit(mStagingRing* ptRing, plCommandBuffer* ptCmd)
+{
+    const plSubmitInfo tSubmitInfo = {
+        .uSignalSemaphoreCount   = 1,
+        .atSignalSempahores      = {ptRing->ptSemaphore},
+        .auSignalSemaphoreValues = {++ptRing->uSubmittedValue}
+    };
+    gptGfx->submit_command_buffer(ptCmd, &tSubmitInfo);
+}
+
+// once per frame, releases the space of every finished submission. never waits on the gpu
+void
+staging_ring_retire(plAppData* ptAppData)
+{
+    mStagingRing* ptRing = &ptAppData->tStagingRing;
+    if(ptRing->uCompletedValue == ptRing->uSubmittedValue)
+        return;
+
+    // retire in submission order, the semaphore only moves forward
+    ptRing->uCompletedValue = gptGfx->get_semaphore_value(ptAppData->ptDevice, ptRing->ptSemaphore);
+    while(ptRing->uBatchCount > 0)
+    {
+        const mStagingBatch* ptBatch = &ptRing->atBatches[ptRing->uFirstBatch];
+        if(ptBatch->uValue > ptRing->uCompletedValue)
+            break;
+        ptRing->szTail = ptBatch->szEnd;
+        ptRing->uFirstBatch = (ptRing->uFirstBatch + 1) % STAGING_RING_MAX_BATCHES;
+        ptRing->uBatchCount--;
+    }
+    if(ptRing->uBatchCount == 0)
+    {
+        ptRing->szHead = 0;
+        ptRing->szTail = 0;
+    }
+}
+
+// call after the device is flushed
+void
+staging_ring_cleanup(plAppData* ptAppData)
+{
+    mStagingRing* ptRing = &ptAppData->tStagingRing;
+    gptGfx->destroy_buffer(ptAppData->ptDevice, ptRing->tBuffer);
+    gptGfx->cleanup_semaphore(ptRing->ptSemaphore);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] texture streaming
+//-----------------------------------------------------------------------------
+
+// queues an image, it's decoded on a worker thread and uploaded by texture_stream_update.
+// *ptConfig->pbOutLoaded turns true once the texture and bind group can be used
+void
+load_texture(plAppData* ptAppData, const plTextureLoadConfig* ptConfig)
+{
+    mTextureStreamer* ptStreamer = &ptAppData->tTextureStreamer;
+    if(ptConfig->pbOutLoaded)
+        *ptConfig->pbOutLoaded = false;
+
+    m_mutex_lock(&ptStreamer->tMutex);
+    if(ptStreamer->uRequestCount == TEXTURE_STREAM_MAX_REQUESTS)
+    {
+        m_mutex_unlock(&ptStreamer->tMutex);
+        printf("ERROR: Too many textures, can't load %s\n", ptConfig->pcFilePath);
+        return;
+    }
+    mTextureRequest* ptRequest = &ptStreamer->atRequests[ptStreamer->uRequestCount++];
+    memset(ptRequest, 0, sizeof(mTextureRequest));
+    ptRequest->tConfig = *ptConfig;
+    m_condition_wake_one(&ptStreamer->tWake);
+    m_mutex_unlock(&ptStreamer->tMutex);
+}
+
+// loads a .mtex as is, false (and nothing allocated) if it's missing or unusable
+bool
+texture_stream_read_cooked(mTextureRequest* ptRequest)
+{
+    if(!ptRequest->tConfig.pcCookedPath)
+        return false;
+    FILE* ptFile = fopen(ptRequest->tConfig.pcCookedPath, "rb");
+    if(!ptFile)
+        return false;
+
+    fseek(ptFile, 0, SEEK_END);
+    long lSize = ftell(ptFile);
+    fseek(ptFile, 0, SEEK_SET);
+    unsigned char* pFile = lSize > 0 ? malloc((size_t)lSize) : NULL;
+    bool bOk = pFile && fread(pFile, 1, (size_t)lSize, ptFile) == (size_t)lSize;
+    fclose(ptFile);
+
+    mTextureFileHeader tHeader = {0};
+    if(bOk && (size_t)lSize >= sizeof(tHeader))
+        memcpy(&tHeader, pFile, sizeof(tHeader));
+    bOk = bOk && tHeader.uMagic == M_TEXTURE_FILE_MAGIC && tHeader.uVersion == M_TEXTURE_FILE_VERSION
+        && tHeader.uFormat == TEXTURE_FILE_FORMAT_RGBA8_UNORM
+        && tHeader.uMipCount > 0 && tHeader.uMipCount <= M_TEXTURE_MAX_MIPS
+        && tHeader.uDataOffset % M_TEXTURE_FILE_ALIGNMENT == 0
+        && tHeader.uDataOffset >= sizeof(tHeader) + sizeof(mTextureFileMip) * tHeader.uMipCount
+        && tHeader.uDataOffset + tHeader.uDataSize <= (uint64_t)lSize;
+    if(bOk)
+    {
+        memcpy(ptRequest->atMips, pFile + sizeof(tHeader), sizeof(mTextureFileMip) * tHeader.uMipCount);
+        for(uint32_t i = 0; i < tHeader.uMipCount; i++)
+        {
+            const mTextureFileMip* ptMip = &ptRequest->atMips[i];
+            bOk &= ptMip->uOffset % M_TEXTURE_FILE_ALIGNMENT == 0 && ptMip->uOffset + ptMip->uSize <= tHeader.uDataSize
+                && ptMip->uSize == (uint64_t)ptMip->uWidth * ptMip->uHeight * 4;
+        }
+    }
+    if(!bOk)
+    {
+        printf("ERROR: %s isn't a usable cooked texture, loading %s instead\n", ptRequest->tConfig.pcCookedPath, ptRequest->tConfig.pcFilePath);
+        free(pFile);
+        return false;
+    }
+
+    ptRequest->pPixels      = pFile;
+    ptRequest->iWidth       = (int)tHeader.uWidth;
+    ptRequest->iHeight      = (int)tHeader.uHeight;
+    ptRequest->bCooked      = true;
+    ptRequest->szDataOffset = (size_t)tHeader.uDataOffset;
+    ptRequest->szDataSize   = (size_t)tHeader.uDataSize;
+    ptRequest->uMipCount    = tHeader.uMipCount;
+    return true;
+}
+
+// cooked file when there is one, the source image otherwise
+bool
+texture_stream_decode(mTextureRequest* ptRequest)
+{
+    if(texture_stream_read_cooked(ptRequest))
+        return true;
+
+    int iChannels = 0;
+    ptRequest->pPixels = stbi_load(ptRequest->tConfig.pcFilePath, &ptRequest->iWidth, &ptRequest->iHeight, &iChannels, 4);
+    if(!ptRequest->pPixels)
+    {
+        printf("ERROR: Failed to load %s\n", ptRequest->tConfig.pcFilePath);
+        return false;
+    }
+    ptRequest->szDataSize = (size_t)ptRequest->iWidth * (size_t)ptRequest->iHeight * 4;
+    ptRequest->uMipCount  = 1;
+    ptRequest->atMips[0]  = (mTextureFileMip){
+        .uSize   = ptRequest->szDataSize,
+        .uWidth  = (uint32_t)ptRequest->iWidth,
+        .uHeight = (uint32_t)ptRequest->iHeight
+    };
+    return true;
+}
+
+void
+texture_stream_worker(void* pData)
+{
+    mTextureStreamer* ptStreamer = (mTextureStreamer*)pData;
+
+    m_mutex_lock(&ptStreamer->tMutex);
+    while(true)
+    {
+        while(ptStreamer->uNextDecode == ptStreamer->uRequestCount && !ptStreamer->bStop)
+            m_condition_wait(&ptStreamer->tWake, &ptStreamer->tMutex, 100);
+        if(ptStreamer->bStop)
+            break;
+
+        mTextureRequest* ptRequest = &ptStreamer->atRequests[ptStreamer->uNextDecode++];
+        m_atomic_store64(&ptRequest->iState, TEXTURE_REQUEST_DECODING);
+        m_mutex_unlock(&ptStreamer->tMutex);
+
+        M_PROFILE_BEGIN("texture decode");
+        bool bDecoded = ptRequest->tConfig.ptAtlas ? sprite_atlas_build(ptRequest) : texture_stream_decode(ptRequest);
+        M_PROFILE_END();
+
+        // the store publishes the pixels to the main thread
+        m_atomic_store64(&ptRequest->iState, bDecoded ? TEXTURE_REQUEST_DECODED : TEXTURE_REQUEST_FAILED);
+        m_mutex_lock(&ptStreamer->tMutex);
+    }
+    m_mutex_unlock(&ptStreamer->tMutex);
+}
+
+void
+texture_stream_start(plAppData* ptAppData)
+{
+    mTextureStreamer* ptStreamer = &ptAppData->tTextureStreamer;
+    m_mutex_init(&ptStreamer->tMutex);
+    m_condition_init(&ptStreamer->tWake);
+
+    // leave a core for the main thread
+    uint32_t uWorkers = m_get_hardware_thread_count();
+    uWorkers = uWorkers > 1 ? uWorkers - 1 : 1;
+    if(uWorkers > TEXTURE_STREAM_MAX_WORKERS)
+        uWorkers = TEXTURE_STREAM_MAX_WORKERS;
+    for(uint32_t i = 0; i < uWorkers; i++)
+    {
+        ptStreamer->aptWorkers[ptStreamer->uWorkerCount] = m_thread_create(texture_stream_worker, ptStreamer);
+        if(ptStreamer->aptWorkers[ptStreamer->uWorkerCount])
+            ptStreamer->uWorkerCount++;
+    }
+}
+
+void
+texture_stream_free_pixels(mTextureRequest* ptRequest)
+{
+    if(ptRequest->bCooked || ptRequest->tConfig.ptAtlas)
+        free(ptRequest->pPixels);
+    else
+        stbi_image_free(ptRequest->pPixels);
+    ptRequest->pPixels = NULL;
+}
+
+void
+texture_stream_create_texture(plAppData* ptAppData, mTextureRequest* ptRequest)
+{
+    plDevice* ptDevice = ptAppData->ptDevice;
+    const plTextureLoadConfig* ptConfig = &ptRequest->tConfig;
+
+    plTextureDesc tTexDesc = {
+        .tDimensions = {(float)ptRequest->iWidth, (float)ptRequest->iHeight, 1.0f},
+        .tFormat = PL_FORMAT_R8G8B8A8_UNORM,
+        .uLayers = 1,
+        .uMips = ptRequest->uMipCount,
+        .tType = PL_TEXTURE_TYPE_2D,
+        .tUsage = PL_TEXTURE_USAGE_SAMPLED,
+        .pcDebugName = ptConfig->pcFilePath
+    };
+
+    plTexture* ptTexture = NULL;
+    *ptConfig->ptOutTexture = gptGfx->create_texture(ptDevice, &tTexDesc, &ptTexture);
+    *ptConfig->ptOutMemory = gptGfx->allocate_memory(ptDevice, ptTexture->tMemoryRequirements.ulSize, PL_MEMORY_FLAGS_DEVICE_LOCAL, 
+        ptTexture->tMemoryRequirements.uMemoryTypeBits, "texture memory");
+    gptGfx->bind_texture_to_memory(ptDevice, *ptConfig->ptOutTexture, ptConfig->ptOutMemory);
+
+    plBindGroupDesc tBGDesc = {
+        .tLayout = ptAppData->tTextureBindGroupLayout,
+        .ptPool = ptAppData->tBindGroupPoolTexAndSamp,
+        .pcDebugName = "texture bind group"
+    };
+    *ptConfig->ptOutBindGroup = gptGfx->create_bind_group(ptDevice, &tBGDesc);
+
+    plBindGroupUpdateTextureData tTexUpdate = {
+        .tTexture = *ptConfig->ptOutTexture,
+        .uSlot = 0,
+        .tType = PL_TEXTURE_BINDING_TYPE_SAMPLED,
+        .tCurrentUsage = PL_TEXTURE_USAGE_SAMPLED
+    };
+    plBindGroupUpdateSamplerData tSamplerUpdate = {
+        .tSampler = ptConfig->tSampler,
+        .uSlot = 1
+    };
+    plBindGroupUpdateData tUpdateData = {
+        .uTextureCount = 1,
+        .atTextureBindings = &tTexUpdate,
+        .uSamplerCount = 1,
+        .atSamplerBindings = &tSamplerUpdate
+    };
+    gptGfx->update_bind_group(ptDevice, *ptConfig->ptOutBindGroup, &tUpdateData);
+}
+
+// once per frame (after staging_ring_retire): marks finished uploads ready, then copies every
+// decoded image that fits in the staging ring with a single submission. never waits on the gpu
+void
+texture_stream_update(plAppData* ptAppData)
+{
+    mTextureStreamer* ptStreamer = &ptAppData->tTextureStreamer;
+    mStagingRing* ptRing = &ptAppData->tStagingRing;
+    if(ptStreamer->uRequestCount == 0)
+        return;
+    M_PROFILE_BEGIN("texture stream update");
+
+    for(uint32_t i = 0; i < ptStreamer->uRequestCount; i++)
+    {
+        mTextureRequest* ptRequest = &ptStreamer->atRequests[i];
+        if(m_atomic_load64(&ptRequest->iState) != TEXTURE_REQUEST_UPLOADING || ptRequest->uUploadValue > ptRing->uCompletedValue)
+            continue;
+        m_atomic_store64(&ptRequest->iState, TEXTURE_REQUEST_READY);
+        if(ptRequest->tConfig.pbOutLoaded)
+            *ptRequest->tConfig.pbOutLoaded = true;
+    }
+
+    plCommandBuffer* ptCmd = NULL;
+    plBlitEncoder* ptBlit = NULL;
+    for(uint32_t i = 0; i < ptStreamer->uRequestCount; i++)
+    {
+        mTextureRequest* ptRequest = &ptStreamer->atRequests[i];
+        if(m_atomic_load64(&ptRequest->iState) != TEXTURE_REQUEST_DECODED)
+            continue;
+
+        if(ptRequest->szDataSize > STAGING_RING_SIZE)
+        {
+            printf("ERROR: %s doesn't fit in the staging ring\n", ptRequest->tConfig.pcFilePath);
+            texture_stream_free_pixels(ptRequest);
+            m_atomic_store64(&ptRequest->iState, TEXTURE_REQUEST_FAILED);
+            continue;
+        }
+
+        size_t szOffset = 0;
+        void* pStaging = staging_ring_alloc(ptRing, ptRequest->szDataSize, &szOffset);
+        if(!pStaging)
+            break; // ring is full, keep upload order and try again next frame
+
+        memcpy(pStaging, &ptRequest->pPixels[ptRequest->szDataOffset], ptRequest->szDataSize);
+        texture_stream_free_pixels(ptRequest);
+
+        texture_stream_create_texture(ptAppData, ptRequest);
+
+        if(!ptCmd)
+        {
+            ptCmd = gptGfx->request_command_buffer(ptAppData->ptCommandPool, "stream textures");
+            gptGfx->begin_command_recording(ptCmd, NULL);
+            ptBlit = gptGfx->begin_blit_pass(ptCmd);
+            gptGfx->pipeline_barrier_blit(ptBlit, 
+                PL_PIPELINE_STAGE_VERTEX_SHADER | PL_PIPELINE_STAGE_TRANSFER, 
+                PL_ACCESS_SHADER_READ | PL_ACCESS_TRANSFER_READ, 
+                PL_PIPELINE_STAGE_TRANSFER, 
+                PL_ACCESS_TRANSFER_WRITE);
+        }
+
+        gptGfx->set_texture_usage(ptBlit, *ptRequest->tConfig.ptOutTexture, PL_TEXTURE_USAGE_SAMPLED, 0);
+
+        plBufferImageCopy atCopies[M_TEXTURE_MAX_MIPS];
+        for(uint32_t uMip = 0; uMip < ptRequest->uMipCount; uMip++)
+        {
+            atCopies[uMip] = (plBufferImageCopy){
+                .szBufferOffset = szOffset + (size_t)ptRequest->atMips[uMip].uOffset,
+                .uImageWidth = ptRequest->atMips[uMip].uWidth,
+                .uImageHeight = ptRequest->atMips[uMip].uHeight,
+                .uImageDepth = 1,
+                .uMipLevel = uMip,
+                .uBaseArrayLayer = 0,
+                .uLayerCount = 1,
+                .tCurrentImageUsage = PL_TEXTURE_USAGE_SAMPLED
+            };
+        }
+        gptGfx->copy_buffer_to_texture(ptBlit, ptRing->tBuffer, *ptRequest->tConfig.ptOutTexture, ptRequest->uMipCount, atCopies);
+
+        ptRequest->uUploadValue = ptRing->uSubmittedValue + 1;
+        m_atomic_store64(&ptRequest->iState, TEXTURE_REQUEST_UPLOADING);
+    }
+
+    if(ptCmd)
+    {
+        gptGfx->pipeline_barrier_blit(ptBlit, 
+            PL_PIPELINE_STAGE_TRANSFER, 
+            PL_ACCESS_TRANSFER_WRITE, 
+            PL_PIPELINE_STAGE_VERTEX_SHADER | PL_PIPELINE_STAGE_TRANSFER, 
+            PL_ACCESS_SHADER_READ | PL_ACCESS_TRANSFER_READ);
+        gptGfx->end_blit_pass(ptBlit);
+        gptGfx->end_command_recording(ptCmd);
+        staging_ring_submit(ptRing, ptCmd);
+        gptGfx->return_command_buffer(ptCmd);
+    }
+    M_PROFILE_END();
+}
+
+// true while any request is still decoding or uploading
+bool
+texture_stream_busy(const mTextureStreamer* ptStreamer)
+{
+    for(uint32_t i = 0; i < ptStreamer->uRequestCount; i++)
+    {
+        int64_t iState = m_atomic_load64((volatile int64_t*)&ptStreamer->atRequests[i].iState);
+        if(iState != TEXTURE_REQUEST_READY && iState != TEXTURE_REQUEST_FAILED)
+            return true;
+    }
+    return false;
+}
+
+// call after the device is flushed
+void
+texture_stream_cleanup(plAppData* ptAppData)
+{
+    mTextureStreamer* ptStreamer = &ptAppData->tTextureStreamer;
+
+    // a worker in the middle of a decode finishes it first
+    m_mutex_lock(&ptStreamer->tMutex);
+    ptStreamer->bStop = true;
+    m_condition_wake_all(&ptStreamer->tWake);
+    m_mutex_unlock(&ptStreamer->tMutex);
+    for(uint32_t i = 0; i < ptStreamer->uWorkerCount; i++)
+        m_thread_join(ptStreamer->aptWorkers[i]);
+    ptStreamer->uWorkerCount = 0;
+
+    for(uint32_t i = 0; i < ptStreamer->uRequestCount; i++)
+    {
+        mTextureRequest* ptRequest = &ptStreamer->atRequests[i];
+        texture_stream_free_pixels(ptRequest);
+
+        // the gpu is idle, so submitted uploads are done and their textures need destroying
+        if(m_atomic_load64(&ptRequest->iState) == TEXTURE_REQUEST_UPLOADING && ptRequest->tConfig.pbOutLoaded)
+            *ptRequest->tConfig.pbOutLoaded = true;
+    }
+
+    m_condition_cleanup(&ptStreamer->tWake);
+    m_mutex_cleanup(&ptStreamer->tMutex);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] sprite atlas
+//-----------------------------------------------------------------------------
+
+// white shapes the batch tints, fX and fY in 0..1 across the sprite
+bool
+sprite_shape_covers(eSprite eSpriteId, float fX, float fY)
+{
+    switch(eSpriteId)
+    {
+        case SPRITE_TOKEN:
+            return (fX - 0.5f) * (fX - 0.5f) + (fY - 0.5f) * (fY - 0.5f) <= 0.48f * 0.48f;
+        case SPRITE_HOUSE: // body and roof
+            return (fX >= 0.15f && fX <= 0.85f && fY >= 0.45f && fY <= 0.95f) 
+                || (fY <= 0.5f && fY >= 0.05f + fabsf(fX - 0.5f));
+        case SPRITE_HOTEL:
+            return (fX >= 0.05f && fX <= 0.95f && fY >= 0.25f && fY <= 0.95f) 
+                || (fX >= 0.2f && fX <= 0.8f && fY >= 0.05f && fY <= 0.25f);
+        default:
+            return true;
+    }
+}
+
+// 4x4 samples per texel, with a darker outline so tinted pieces stand out from the board
+void
+sprite_shape_draw(eSprite eSpriteId, uint8_t* puTexels, uint32_t uWidth, uint32_t uHeight, uint32_t uStride)
+{
+    bool bOutline = eSpriteId != SPRITE_SOLID;
+    for(uint32_t uY = 0; uY < uHeight; uY++)
+    {
+        for(uint32_t uX = 0; uX < uWidth; uX++)
+        {
+            float fCovered = 0.0f;
+            float fShade = 0.0f;
+            for(uint32_t uSample = 0; uSample < 16; uSample++)
+            {
+                float fX = ((float)uX + ((float)(uSample % 4) + 0.5f) / 4.0f) / (float)uWidth;
+                float fY = ((float)uY + ((float)(uSample / 4) + 0.5f) / 4.0f) / (float)uHeight;
+                if(!sprite_shape_covers(eSpriteId, fX, fY))
+                    continue;
+                bool bInner = !bOutline || sprite_shape_covers(eSpriteId, 0.5f + (fX - 0.5f) * 1.15f, 0.5f + (fY - 0.5f) * 1.15f);
+                fCovered += 1.0f;
+                fShade += bInner ? 1.0f : 0.25f;
+            }
+
+            uint8_t* puTexel = &puTexels[((size_t)uY * uStride + uX) * 4];
+            uint8_t uShade = fCovered > 0.0f ? (uint8_t)(fShade / fCovered * 255.0f + 0.5f) : 0;
+            puTexel[0] = uShade;
+            puTexel[1] = uShade;
+            puTexel[2] = uShade;
+            puTexel[3] = (uint8_t)(fCovered / 16.0f * 255.0f + 0.5f);
+        }
+    }
+}
+
+// runs on a texture streaming worker: decodes the sprite images, shelf packs them with the
+// generated shapes and builds a short mip chain, laid out like a cooked texture
+bool
+sprite_atlas_build(mTextureRequest* ptRequest)
+{
+    mSpriteAtlas* ptAtlas = ptRequest->tConfig.ptAtlas;
+    const mSpriteImage atImages[] = {
+        {"../../monopoly/assets/monopoly-board.png", "../../monopoly/assets/cooked/monopoly-board.mtex", SPRITE_BOARD, 1, 1, 1},
+        {"../../monopoly/assets/dice-spritesheet.png", "../../monopoly/assets/cooked/dice-spritesheet.mtex", SPRITE_DIE_1, 6, 2, 6} // white row only
+    };
+    const uint32_t uImageCount = sizeof(atImages) / sizeof(atImages[0]);
+    mTextureRequest atSources[sizeof(atImages) / sizeof(atImages[0])];
+
+    // sprite sizes and where their texels come from, generated shapes have no source
+    uint32_t auWidth[SPRITE_COUNT];
+    uint32_t auHeight[SPRITE_COUNT];
+    const uint8_t* apuSource[SPRITE_COUNT] = {0};
+    uint32_t auSourceStride[SPRITE_COUNT] = {0};
+    for(uint32_t i = 0; i < SPRITE_COUNT; i++)
+    {
+        auWidth[i]  = 32;
+        auHeight[i] = 32;
+    }
+    auWidth[SPRITE_TOKEN]  = 64;
+    auHeight[SPRITE_TOKEN] = 64;
+    auWidth[SPRITE_HOTEL]  = 64;
+
+    for(uint32_t i = 0; i < uImageCount; i++)
+    {
+        mTextureRequest* ptSource = &atSources[i];
+        memset(ptSource, 0, sizeof(mTextureRequest));
+        ptSource->tConfig.pcFilePath   = atImages[i].pcFilePath;
+        ptSource->tConfig.pcCookedPath = atImages[i].pcCookedPath;
+        if(!texture_stream_decode(ptSource))
+            continue; // its sprites stay blank
+
+        const mTextureFileMip* ptMip = &ptSource->atMips[0];
+        const uint8_t* puTexels = &ptSource->pPixels[ptSource->szDataOffset + (size_t)ptMip->uOffset];
+        uint32_t uCellWidth = ptMip->uWidth / atImages[i].uColumns;
+        uint32_t uCellHeight = ptMip->uHeight / atImages[i].uRows;
+        for(uint32_t uCell = 0; uCell < atImages[i].uCellCount; uCell++)
+        {
+            eSprite eSpriteId = (eSprite)(atImages[i].eFirst + uCell);
+            uint32_t uCellX = (uCell % atImages[i].uColumns) * uCellWidth;
+            uint32_t uCellY = (uCell / atImages[i].uColumns) * uCellHeight;
+            auWidth[eSpriteId]        = uCellWidth;
+            auHeight[eSpriteId]       = uCellHeight;
+            apuSource[eSpriteId]      = &puTexels[((size_t)uCellY * ptMip->uWidth + uCellX) * 4];
+            auSourceStride[eSpriteId] = ptMip->uWidth;
+        }
+    }
+
+    // shelf pack tallest first, positions stay aligned so the gutter survives every mip
+    uint32_t auOrder[SPRITE_COUNT];
+    for(uint32_t i = 0; i < SPRITE_COUNT; i++)
+    {
+        uint32_t j = i;
+        while(j > 0 && auHeight[auOrder[j - 1]] < auHeight[i])
+        {
+            auOrder[j] = auOrder[j - 1];
+            j--;
+        }
+        auOrder[j] = i;
+    }
+
+    const uint32_t uAlign = SPRITE_ATLAS_PADDING;
+    uint32_t auX[SPRITE_COUNT];
+    uint32_t auY[SPRITE_COUNT];
+    uint32_t uX = SPRITE_ATLAS_PADDING;
+    uint32_t uY = SPRITE_ATLAS_PADDING;
+    uint32_t uShelfHeight = 0;
+    bool bFits = true;
+    for(uint32_t i = 0; i < SPRITE_COUNT; i++)
+    {
+        uint32_t uSprite = auOrder[i];
+        if(uX + auWidth[uSprite] + SPRITE_ATLAS_PADDING > SPRITE_ATLAS_WIDTH && uX > SPRITE_ATLAS_PADDING)
+        {
+            uX = SPRITE_ATLAS_PADDING;
+            uY += (uShelfHeight + SPRITE_ATLAS_PADDING + uAlign - 1) / uAlign * uAlign;
+            uShelfHeight = 0;
+        }
+        bFits &= uX + auWidth[uSprite] + SPRITE_ATLAS_PADDING <= SPRITE_ATLAS_WIDTH;
+        auX[uSprite] = uX;
+        auY[uSprite] = uY;
+        uX += (auWidth[uSprite] + SPRITE_ATLAS_PADDING + uAlign - 1) / uAlign * uAlign;
+        if(auHeight[uSprite] > uShelfHeight)
+            uShelfHeight = auHeight[uSprite];
+    }
+    uint32_t uAtlasHeight = (uY + uShelfHeight + SPRITE_ATLAS_PADDING + uAlign - 1) / uAlign * uAlign;
+    bFits &= uAtlasHeight <= SPRITE_ATLAS_MAX_HEIGHT;
+
+    // mip chain with the cooked layout, so texture_stream_update uploads it like any other
+    size_t szOffset = 0;
+    for(uint32_t uMip = 0; uMip < SPRITE_ATLAS_MIPS; uMip++)
+    {
+        mTextureFileMip* ptMip = &ptRequest->atMips[uMip];
+        ptMip->uOffset = szOffset;
+        ptMip->uWidth  = SPRITE_ATLAS_WIDTH >> uMip;
+        ptMip->uHeight = uAtlasHeight >> uMip;
+        ptMip->uSize   = (uint64_t)ptMip->uWidth * ptMip->uHeight * 4;
+        szOffset = (szOffset + (size_t)ptMip->uSize + M_TEXTURE_FILE_ALIGNMENT - 1) & ~(size_t)(M_TEXTURE_FILE_ALIGNMENT - 1);
+    }
+    uint8_t* puAtlas = bFits ? calloc(1, szOffset) : NULL;
+    if(!puAtlas)
+    {
+        printf("ERROR: Couldn't build the sprite atlas\n");
+        for(uint32_t i = 0; i < uImageCount; i++)
+            texture_stream_free_pixels(&atSources[i]);
+        return false;
+    }
+
+    for(uint32_t i = 0; i < SPRITE_COUNT; i++)
+    {
+        uint8_t* puDst = &puAtlas[((size_t)auY[i] * SPRITE_ATLAS_WIDTH + auX[i]) * 4];
+        if(apuSource[i])
+        {
+            for(uint32_t uRow = 0; uRow < auHeight[i]; uRow++)
+                memcpy(&puDst[(size_t)uRow * SPRITE_ATLAS_WIDTH * 4], &apuSource[i][(size_t)uRow * auSourceStride[i] * 4], (size_t)auWidth[i] * 4);
+        }
+        else if(i >= SPRITE_TOKEN)
+            sprite_shape_draw((eSprite)i, puDst, auWidth[i], auHeight[i], SPRITE_ATLAS_WIDTH);
+
+        ptAtlas->atUvs[i] = (plVec4){
+            (float)auX[i] / (float)SPRITE_ATLAS_WIDTH,
+            (float)auY[i] / (float)uAtlasHeight,
+            (float)(auX[i] + auWidth[i]) / (float)SPRITE_ATLAS_WIDTH,
+            (float)(auY[i] + auHeight[i]) / (float)uAtlasHeight
+        };
+    }
+    for(uint32_t i = 0; i < uImageCount; i++)
+        texture_stream_free_pixels(&atSources[i]);
+
+    // the solid fill is stretched over whole tiles, only sample its middle
+    plVec4* ptSolid = &ptAtlas->atUvs[SPRITE_SOLID];
+    plVec4 tSolid = *ptSolid;
+    ptSolid->x = tSolid.x + (tSolid.z - tSolid.x) * 0.25f;
+    ptSolid->y = tSolid.y + (tSolid.w - tSolid.y) * 0.25f;
+    ptSolid->z = tSolid.z - (tSolid.z - tSolid.x) * 0.25f;
+    ptSolid->w = tSolid.w - (tSolid.w - tSolid.y) * 0.25f;
+
+    // alpha weighted 2x2 box filter, transparent gutters don't darken sprite edges
+    for(uint32_t uMip = 1; uMip < SPRITE_ATLAS_MIPS; uMip++)
+    {
+        const mTextureFileMip* ptSrcMip = &ptRequest->atMips[uMip - 1];
+        const mTextureFileMip* ptDstMip = &ptRequest->atMips[uMip];
+        const uint8_t* puSrc = &puAtlas[ptSrcMip->uOffset];
+        uint8_t* puDst = &puAtlas[ptDstMip->uOffset];
+        for(uint32_t uDstY = 0; uDstY < ptDstMip->uHeight; uDstY++)
+        {
+            for(uint32_t uDstX = 0; uDstX < ptDstMip->uWidth; uDstX++)
+            {
+                uint32_t auColor[3] = {0};
+                uint32_t uAlpha = 0;
+                for(uint32_t uSample = 0; uSample < 4; uSample++)
+                {
+                    const uint8_t* puTexel = &puSrc[(((size_t)uDstY * 2 + uSample / 2) * ptSrcMip->uWidth + uDstX * 2 + uSample % 2) * 4];
+                    for(uint32_t c = 0; c < 3; c++)
+                        auColor[c] += (uint32_t)puTexel[c] * puTexel[3];
+                    uAlpha += puTexel[3];
+                }
+                uint8_t* puTexel = &puDst[((size_t)uDstY * ptDstMip->uWidth + uDstX) * 4];
+                for(uint32_t c = 0; c < 3; c++)
+                    puTexel[c] = uAlpha > 0 ? (uint8_t)((auColor[c] + uAlpha / 2) / uAlpha) : 0;
+                puTexel[3] = (uint8_t)((uAlpha + 2) / 4);
+            }
+        }
+    }
+
+    ptRequest->pPixels      = puAtlas;
+    ptRequest->iWidth       = SPRITE_ATLAS_WIDTH;
+    ptRequest->iHeight      = (int)uAtlasHeight;
+    ptRequest->szDataOffset = 0;
+    ptRequest->szDataSize   = szOffset;
+    ptRequest->uMipCount    = SPRITE_ATLAS_MIPS;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] sprite batch
+//-----------------------------------------------------------------------------
+
+void
+sprite_batch_init(plAppData* ptAppData)
+{
+    mSpriteBatch* ptBatch = &ptAppData->tSpriteBatch;
+    plDevice* ptDevice = ptAppData->ptDevice;
+
+    // unit quad, corners double as uv weights
+    const float atCorners[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+        0.0f, 1.0f
+    };
+    const uint32_t auIndices[] = { 0, 1, 2, 0, 2, 3 };
+
+    const plBufferDesc tVertexDesc = {
+        .tUsage      = PL_BUFFER_USAGE_VERTEX | PL_BUFFER_USAGE_TRANSFER_DESTINATION,
+        .szByteSize  = sizeof(atCorners),
+        .pcDebugName = "sprite quad vertices"
+    };
+    plBuffer* ptVertexBuffer = NULL;
+    ptBatch->tQuadVertexBuffer = gptGfx->create_buffer(ptDevice, &tVertexDesc, &ptVertexBuffer);
+    ptBatch->tQuadVertexMemory = gptGfx->allocate_memory(ptDevice, ptVertexBuffer->tMemoryRequirements.ulSize, 
+        PL_MEMORY_FLAGS_DEVICE_LOCAL, ptVertexBuffer->tMemoryRequirements.uMemoryTypeBits, "sprite quad vertex memory");
+    gptGfx->bind_buffer_to_memory(ptDevice, ptBatch->tQuadVertexBuffer, &ptBatch->tQuadVertexMemory);
+
+    const plBufferDesc tIndexDesc = {
+        .tUsage      = PL_BUFFER_USAGE_INDEX | PL_BUFFER_USAGE_TRANSFER_DESTINATION,
+        .szByteSize  = sizeof(auIndices),
+        .pcDebugName = "sprite quad indices"
+    };
+    plBuffer* ptIndexBuffer = NULL;
+    ptBatch->tQuadIndexBuffer = gptGfx->create_buffer(ptDevice, &tIndexDesc, &ptIndexBuffer);
+    ptBatch->tQuadIndexMemory = gptGfx->allocate_memory(ptDevice, ptIndexBuffer->tMemoryRequirements.ulSize, 
+        PL_MEMORY_FLAGS_DEVICE_LOCAL, ptIndexBuffer->tMemoryRequirements.uMemoryTypeBits, "sprite quad index memory");
+    gptGfx->bind_buffer_to_memory(ptDevice, ptBatch->tQuadIndexBuffer, &ptBatch->tQuadIndexMemory);
+
+    // the ring is still empty so this can't fail. the first frame waits for the copy on the gpu
+    // instead of blocking here
+    mStagingRing* ptStagingRing = &ptAppData->tStagingRing;
+    size_t szVertexOffset = 0;
+    size_t szIndexOffset = 0;
+    memcpy(staging_ring_alloc(ptStagingRing, sizeof(atCorners), &szVertexOffset), atCorners, sizeof(atCorners));
+    memcpy(staging_ring_alloc(ptStagingRing, sizeof(auIndices), &szIndexOffset), auIndices, sizeof(auIndices));
+
+    plCommandBuffer* ptCmd = gptGfx->request_command_buffer(ptAppData->ptCommandPool, "upload sprite quad");
+    gptGfx->begin_command_recording(ptCmd, NULL);
+
+    plBlitEncoder* ptBlit = gptGfx->begin_blit_pass(ptCmd);
+    gptGfx->copy_buffer(ptBlit, ptStagingRing->tBuffer, ptBatch->tQuadVertexBuffer, (uint32_t)szVertexOffset, 0, sizeof(atCorners));
+    gptGfx->copy_buffer(ptBlit, ptStagingRing->tBuffer, ptBatch->tQuadIndexBuffer, (uint32_t)szIndexOffset, 0, sizeof(auIndices));
+    gptGfx->end_blit_pass(ptBlit);
+
+    gptGfx->end_command_recording(ptCmd);
+    staging_ring_submit(ptStagingRing, ptCmd);
+    gptGfx->return_command_buffer(ptCmd);
+
+    // instances are read in the vertex shader
+    const plBindGroupLayoutDesc tInstanceLayoutDesc = {
+        .atBufferBindings = {
+            { .uSlot = 0, .tType = PL_BUFFER_BINDING_TYPE_STORAGE, .tStages = PL_SHADER_STAGE_VERTEX }
+        },
+        .pcDebugName = "sprite instance layout"
+    };
+    ptBatch->tInstanceLayoutDesc = tInstanceLayoutDesc;
+    ptBatch->tInstanceLayout = gptGfx->create_bind_group_layout(ptDevice, &tInstanceLayoutDesc);
+
+    // one per frame in flight, the cpu writes one while the gpu reads the others
+    for(uint32_t i = 0; i < gptGfx->get_frames_in_flight(); i++)
+    {
+        const plBufferDesc tInstanceDesc = {
+            .tUsage      = PL_BUFFER_USAGE_STORAGE,
+            .szByteSize  = sizeof(mSpriteInstance) * SPRITE_BATCH_MAX,
+            .pcDebugName = "sprite instances"
+        };
+        plBuffer* ptInstanceBuffer = NULL;
+        ptBatch->atInstanceBuffers[i] = gptGfx->create_buffer(ptDevice, &tInstanceDesc, &ptInstanceBuffer);
+        ptBatch->atInstanceMemory[i] = gptGfx->allocate_memory(ptDevice, ptInstanceBuffer->tMemoryRequirements.ulSize, 
+            PL_MEMORY_FLAGS_HOST_VISIBLE | PL_MEMORY_FLAGS_HOST_COHERENT, ptInstanceBuffer->tMemoryRequirements.uMemoryTypeBits, "sprite instance memory");
+        gptGfx->bind_buffer_to_memory(ptDevice, ptBatch->atInstanceBuffers[i], &ptBatch->atInstanceMemory[i]);
+
+        const plBindGroupDesc tBindGroupDesc = {
+            .tLayout     = ptBatch->tInstanceLayout,
+            .ptPool      = ptAppData->tBindGroupPoolTexAndSamp,
+            .pcDebugName = "sprite instance bind group"
+        };
+        ptBatch->atInstanceBindGroups[i] = gptGfx->create_bind_group(ptDevice, &tBindGroupDesc);
+
+        const plBindGroupUpdateBufferData tBufferUpdate = {
+            .tBuffer       = ptBatch->atInstanceBuffers[i],
+            .uSlot         = 0,
+            .szBufferRange = tInstanceDesc.szByteSize
+        };
+        const plBindGroupUpdateData tUpdateData = {
+            .uBufferCount     = 1,
+            .atBufferBindings  = &tBufferUpdate
+        };
+        gptGfx->update_bind_group(ptDevice, ptBatch->atInstanceBindGroups[i], &tUpdateData);
+    }
+}
+
+// starts rebuilding the sprites, the old ones stay drawn until then
+void
+sprite_batch_begin(mSpriteBatch* ptBatch)
+{
+    ptBatch->uCount = 0;
+    ptBatch->uVersion++;
+}
+
+void
+sprite_batch_add(mSpriteBatch* ptBatch, const mSpriteAtlas* ptAtlas, eSprite eSpriteId, plVec2 tMin, plVec2 tMax, plVec4 tColor)
+{
+    if(ptBatch->uCount == SPRITE_BATCH_MAX)
+        return;
+
+    ptBatch->atInstances[ptBatch->uCount++] = (mSpriteInstance){
+        .tPosition = tMin,
+        .tScale    = {tMax.x - tMin.x, tMax.y - tMin.y},
+        .tUv       = ptAtlas->atUvs[eSpriteId],
+        .tTint     = tColor
+    };
+}
+
+// one instanced draw for the sprites, after begin_frame
+void
+sprite_batch_submit(plAppData* ptAppData, plRenderEncoder* ptRender)
+{
+    mSpriteBatch* ptBatch = &ptAppData->tSpriteBatch;
+    if(ptBatch->uCount == 0)
+        return;
+
+    // the gpu is done with this frame's buffer, refresh it if the sprites changed since
+    uint32_t uFrame = gptGfx->get_current_frame_index();
+    if(ptBatch->auBufferVersion[uFrame] != ptBatch->uVersion)
+    {
+        memcpy(ptBatch->atInstanceMemory[uFrame].pHostMapped, ptBatch->atInstances, sizeof(mSpriteInstance) * ptBatch->uCount);
+        ptBatch->auBufferVersion[uFrame] = ptBatch->uVersion;
+    }
+
+    gptGfx->bind_shader(ptRender, ptAppData->tTexturedQuadShader);
+    gptGfx->bind_vertex_buffer(ptRender, ptBatch->tQuadVertexBuffer);
+
+    plDynamicDataBlock tBlock = gptGfx->allocate_dynamic_data_block(ptAppData->ptDevice);
+    plDynamicBinding tBinding = pl_allocate_dynamic_data(gptGfx, ptAppData->ptDevice, &tBlock);
+    plMat4* pMVP = (plMat4*)tBinding.pcData;
+    *pMVP = create_orthographic_projection(ptAppData->tLayout.tViewportSize.x, ptAppData->tLayout.tViewportSize.y);
+
+    const plBindGroupHandle atBindGroups[2] = {
+        ptAppData->tSpriteAtlas.tBindGroup,
+        ptBatch->atInstanceBindGroups[uFrame]
+    };
+    gptGfx->bind_graphics_bind_groups(ptRender, ptAppData->tTexturedQuadShader, 0, 2, atBindGroups, 1, &tBinding);
+
+    plDrawIndex tDraw = {
+        .uIndexCount = 6,
+        .tIndexBuffer = ptBatch->tQuadIndexBuffer,
+        .uInstanceCount = ptBatch->uCount
+    };
+    gptGfx->draw_indexed(ptRender, 1, &tDraw);
+}
+
+// call after the device is flushed
+void
+sprite_batch_cleanup(plAppData* ptAppData)
+{
+    mSpriteBatch* ptBatch = &ptAppData->tSpriteBatch;
+    for(uint32_t i = 0; i < gptGfx->get_frames_in_flight(); i++)
+    {
+        gptGfx->destroy_bind_group(ptAppData->ptDevice, ptBatch->atInstanceBindGroups[i]);
+        gptGfx->destroy_buffer(ptAppData->ptDevice, ptBatch->atInstanceBuffers[i]);
+    }
+    gptGfx->destroy_bind_group_layout(ptAppData->ptDevice, ptBatch->tInstanceLayout);
+    gptGfx->destroy_buffer(ptAppData->ptDevice, ptBatch->tQuadVertexBuffer);
+    gptGfx->destroy_buffer(ptAppData->ptDevice, ptBatch->tQuadIndexBuffer);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] animation
+//-----------------------------------------------------------------------------
+
+// once per frame after the phase has run. new rolls start a tumble and new positions start a
+// walk, then everything advances in fixed steps so speed doesn't depend on the frame rate
+void
+animator_update(plAppData* ptAppData, float fDeltaTime)
+{
+    mAnimator* ptAnim = &ptAppData->tAnimator;
+    const mGameData* pGame = ptAppData->pGameData;
+
+    // start from whatever the game shows
+    if(!ptAnim->bInitialized)
+    {
+        ptAnim->bInitialized = true;
+        ptAnim->uRng = (uint32_t)m_get_time_ns() | 1;
+        ptAnim->tTargetDice = pGame->tDice;
+        ptAnim->tShownDice = pGame->tDice;
+        for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+        {
+            ptAnim->atWalks[i].uFrom = pGame->amPlayers[i].uPosition;
+            ptAnim->atWalks[i].uTo = pGame->amPlayers[i].uPosition;
+        }
+    }
+
+    if(pGame->tDice.uDie1 != ptAnim->tTargetDice.uDie1 || pGame->tDice.uDie2 != ptAnim->tTargetDice.uDie2)
+    {
+        ptAnim->tTargetDice = pGame->tDice;
+        ptAnim->fDiceTime = ANIM_DICE_TIME;
+        ptAnim->fDiceFaceTime = 0.0f;
+    }
+
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        if(pGame->amPlayers[i].uPosition != ptAnim->atWalks[i].uTo)
+            animator_start_walk(&ptAnim->atWalks[i], pGame->amPlayers[i].uPosition);
+    }
+
+    // a long stall drops time instead of fast forwarding through it
+    ptAnim->fAccumulator += fDeltaTime;
+    if(ptAnim->fAccumulator > ANIM_STEP * ANIM_MAX_STEPS)
+        ptAnim->fAccumulator = ANIM_STEP * ANIM_MAX_STEPS;
+
+    bool bChanged = false;
+    while(ptAnim->fAccumulator >= ANIM_STEP)
+    {
+        bChanged |= animator_step(ptAnim);
+        ptAnim->fAccumulator -= ANIM_STEP;
+    }
+    ptAnim->fAlpha = ptAnim->fAccumulator / ANIM_STEP;
+
+    // still going (drawn positions blend between steps) or finished during this frame
+    bool bAnimating = ptAnim->fDiceTime > 0.0f;
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+        bAnimating |= ptAnim->atWalks[i].fTravel < (float)ptAnim->atWalks[i].uSquares;
+    ptAnim->bActive = bChanged || bAnimating;
+}
+
+// one fixed step, true if anything moved
+bool
+animator_step(mAnimator* ptAnim)
+{
+    // tokens wait for the dice to land
+    if(ptAnim->fDiceTime > 0.0f)
+    {
+        ptAnim->fDiceTime -= ANIM_STEP;
+        ptAnim->fDiceFaceTime -= ANIM_STEP;
+        if(ptAnim->fDiceTime <= 0.0f)
+        {
+            ptAnim->tShownDice = ptAnim->tTargetDice;
+        }
+        else if(ptAnim->fDiceFaceTime <= 0.0f)
+        {
+            ptAnim->tShownDice.uDie1 = animator_random_face(ptAnim);
+            ptAnim->tShownDice.uDie2 = animator_random_face(ptAnim);
+            ptAnim->fDiceFaceTime = ANIM_DICE_FACE_TIME;
+        }
+        return true;
+    }
+
+    bool bMoved = false;
+    for(uint8_t i = 0; i < MAX_PLAYERS; i++)
+    {
+        mTokenWalk* ptWalk = &ptAnim->atWalks[i];
+        ptWalk->fPrevTravel = ptWalk->fTravel;
+        if(ptWalk->fTravel >= (float)ptWalk->uSquares)
+            continue;
+
+        ptWalk->fTravel += ANIM_STEP / ANIM_HOP_TIME;
+        if(ptWalk->fTravel > (float)ptWalk->uSquares)
+            ptWalk->fTravel = (float)ptWalk->uSquares;
+        bMoved = true;
+    }
+    return bMoved;
+}
+
+// walks forward from the square the token is on now, long or backward moves jump
+void
+animator_start_walk(mTokenWalk* ptWalk, uint8_t uTo)
+{
+    uint8_t uFrom = (uint8_t)((ptWalk->uFrom + (uint8_t)ptWalk->fTravel) % TOTAL_BOARD_SQUARES);
+    uint8_t uSquares = (uint8_t)((uTo + TOTAL_BOARD_SQUARES - uFrom) % TOTAL_BOARD_SQUARES);
+    if(uSquares > ANIM_MAX_HOPS)
+    {
+        uFrom = uTo;
+        uSquares = 0;
+    }
+
+    ptWalk->uFrom       = uFrom;
+    ptWalk->uTo         = uTo;
+    ptWalk->uSquares    = uSquares;
+    ptWalk->fTravel     = 0.0f;
+    ptWalk->fPrevTravel = 0.0f;
+}
+
+// xorshift, cosmetic only
+uint8_t
+animator_random_face(mAnimator* ptAnim)
+{
+    uint32_t uX = ptAnim->uRng;
+    uX ^= uX << 13;
+    uX ^= uX >> 17;
+    uX ^= uX << 5;
+    ptAnim->uRng = uX;
+    return (uint8_t)(uX % 6 + 1);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] frame pacing
+//-----------------------------------------------------------------------------
+
+// any key, button, wheel or mouse movement since the last frame
+bool
+frame_input_received(mFrameScheduler* ptScheduler)
+{
+    bool bInput = false;
+
+    plVec2 tMousePos = gptIO->get_mouse_pos();
+    if(tMousePos.x != ptScheduler->tLastMousePos.x || tMousePos.y != ptScheduler->tLastMousePos.y)
+        bInput = true;
+    ptScheduler->tLastMousePos = tMousePos;
+
+    if(gptIO->get_mouse_wheel() != 0.0f)
+        bInput = true;
+
+    for(int i = 0; i < PL_MOUSE_BUTTON_COUNT && !bInput; i++)
+    {
+        if(gptIO->is_mouse_down((plMouseButton)i) || gptIO->is_mouse_released((plMouseButton)i))
+            bInput = true;
+    }
+
+    for(int i = PL_KEY_NONE + 1; i < PL_KEY_COUNT && !bInput; i++)
+    {
+        if(gptIO->is_key_down((plKey)i) || gptIO->is_key_released((plKey)i))
+            bInput = true;
+    }
+    return bInput;
+}
+
+// call after gptIO->new_frame. frames render at full rate while anything can change, once
+// everything has been quiet for FRAME_IDLE_DELAY_MS they're skipped (apart from a keep-alive
+// redraw) until input arrives
+bool
+frame_should_render(plAppData* ptAppData)
+{
+    mFrameScheduler* ptScheduler = &ptAppData->tFrameScheduler;
+    const mGameData* pGame = ptAppData->pGameData;
+    uint64_t uNow = m_get_time_ns();
+
+    // input is checked first so the mouse position is always tracked
+    bool bActive = frame_input_received(ptScheduler);
+    bActive |= !m_is_waiting_input(&ptAppData->tGameFlow); // phase is running on its own
+    bActive |= pGame->bShowNotification;                   // notification timer
+    bActive |= ptAppData->tPerf.bShowOverlay;              // histogram moves every frame
+    bActive |= ptAppData->tAnimator.bActive;
+    bActive |= texture_stream_busy(&ptAppData->tTextureStreamer);
+    bActive |= ptAppData->tStagingRing.uCompletedValue < ptAppData->tStagingRing.uSubmittedValue;
+
+    if(bActive)
+    {
+        ptScheduler->uLastActiveNs = uNow;
+        return true;
+    }
+
+    if(uNow - ptScheduler->uLastActiveNs < (uint64_t)FRAME_IDLE_DELAY_MS * 1000000)
+        return true;
+
+    if(FRAME_IDLE_REFRESH_MS > 0 && uNow - ptScheduler->uLastPresentNs >= (uint64_t)FRAME_IDLE_REFRESH_MS * 1000000)
+        return true;
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] performance overlay
+//-----------------------------------------------------------------------------
+
+float
+perf_ms_since(uint64_t uStartNs)
+{
+    return (float)(m_get_time_ns() - uStartNs) / 1000000.0f;
+}
+
+// pushes this frame's timings into the history ring
+void
+record_perf_frame(plAppData* ptAppData)
+{
+    mPerfStats* ptPerf = &ptAppData->tPerf;
+    uint32_t uSample = ptPerf->uNextSample;
+
+    ptPerf->afIntervalMs[uSample] = ptPerf->uLastFrameStartNs ? (float)(ptPerf->uFrameStartNs - ptPerf->uLastFrameStartNs) / 1000000.0f : 0.0f;
+    ptPerf->afCpuMs[uSample]      = perf_ms_since(ptPerf->uFrameStartNs);
+    ptPerf->afPhaseMs[uSample]    = ptPerf->fPhaseMs;
+    ptPerf->afUiMs[uSample]       = ptPerf->fUiMs;
+    ptPerf->afDrawMs[uSample]     = ptPerf->fDrawMs;
+
+    ptPerf->uLastFrameStartNs = ptPerf->uFrameStartNs;
+    ptPerf->uNextSample = (uSample + 1) % PERF_HISTORY_SIZE;
+    if(ptPerf->uSampleCount < PERF_HISTORY_SIZE)
+        ptPerf->uSampleCount++;
+}
+
+void
+draw_perf_overlay(plAppData* ptAppData)
+{
+    mPerfStats* ptPerf = &ptAppData->tPerf;
+
+    gptUi->set_next_window_pos((plVec2){PERF_WINDOW_X, PERF_WINDOW_Y}, PL_UI_COND_ALWAYS);
+    gptUi->set_next_window_size((plVec2){PERF_WINDOW_WIDTH, PERF_WINDOW_HEIGHT}, PL_UI_COND_ALWAYS);
+
+    if(!gptUi->begin_window("Performance (F3)", NULL, PL_UI_WINDOW_FLAGS_NO_RESIZE | PL_UI_WINDOW_FLAGS_NO_COLLAPSE | PL_UI_WINDOW_FLAGS_NO_MOVE | PL_UI_WINDOW_FLAGS_NO_SCROLLBAR))
+        return;
+
+    const char*  apcNames[5]   = { "frame", "cpu", "game phase", "ui build", "draw submit" };
+    const float* apfHistory[5] = { ptPerf->afIntervalMs, ptPerf->afCpuMs, ptPerf->afPhaseMs, ptPerf->afUiMs, ptPerf->afDrawMs };
+
+    gptUi->layout_static(0.0f, 75, 4);
+    gptUi->text("ms");
+    gptUi->text("last");
+    gptUi->text("avg");
+    gptUi->text("max");
+
+    uint32_t uLast = (ptPerf->uNextSample + PERF_HISTORY_SIZE - 1) % PERF_HISTORY_SIZE;
+    for(uint32_t i = 0; i < 5; i++)
+    {
+        float fSum = 0.0f;
+        float fMax = 0.0f;
+        for(uint32_t j = 0; j < ptPerf->uSampleCount; j++)
+        {
+            fSum += apfHistory[i][j];
+            if(apfHistory[i][j] > fMax)
+                fMax = apfHistory[i][j];
+        }
+        float fAvg = ptPerf->uSampleCount ? fSum / (float)ptPerf->uSampleCount : 0.0f;
+
+        gptUi->text("%s", apcNames[i]);
+        gptUi->text("%.2f", apfHistory[i][uLast]);
+        gptUi->text("%.2f", fAvg);
+        if(fMax > 16.7f)
+            gptUi->color_text((plVec4){1.0f, 0.3f, 0.3f, 1.0f}, "%.2f", fMax);
+        else
+            gptUi->text("%.2f", fMax);
+    }
+
+    // histogram legend
+    gptUi->vertical_spacing();
+    gptUi->layout_static(0.0f, 75, 4);
+    gptUi->color_text((plVec4){0.9f, 0.4f, 0.9f, 1.0f}, "phase");
+    gptUi->color_text((plVec4){0.4f, 0.6f, 1.0f, 1.0f}, "ui");
+    gptUi->color_text((plVec4){0.4f, 0.9f, 0.4f, 1.0f}, "draw");
+    gptUi->text("line 60hz");
+
+    gptUi->end_window();
+}
+
+// one stacked bar per frame, newest on the right
+void
+draw_perf_histogram(plAppData* ptAppData, plRenderEncoder* ptRender)
+{
+    mPerfStats* ptPerf = &ptAppData->tPerf;
+    plDrawLayer2D* ptLayer = ptPerf->ptLayer;
+
+    const float fLeft   = PERF_WINDOW_X + 10.0f;
+    const float fBottom = PERF_WINDOW_Y + PERF_WINDOW_HEIGHT - 10.0f;
+    const float fWidth  = PERF_WINDOW_WIDTH - 20.0f;
+    const float fBarWidth = fWidth / (float)PERF_HISTORY_SIZE;
+    const float fScale  = PERF_GRAPH_HEIGHT / PERF_GRAPH_MAX_MS;
+
+    gptDraw->add_rect_filled(ptLayer, (plVec2){fLeft, fBottom - PERF_GRAPH_HEIGHT}, (plVec2){fLeft + fWidth, fBottom},
+        (plDrawSolidOptions){.uColor = PL_COLOR_32(0.0f, 0.0f, 0.0f, 0.6f)});
+
+    const uint32_t auColors[3] = {
+        PL_COLOR_32(0.9f, 0.4f, 0.9f, 1.0f), // phase
+        PL_COLOR_32(0.4f, 0.6f, 1.0f, 1.0f), // ui
+        PL_COLOR_32(0.4f, 0.9f, 0.4f, 1.0f)  // draw
+    };
+
+    for(uint32_t i = 0; i < ptPerf->uSampleCount; i++)
+    {
+        uint32_t uSample = (ptPerf->uNextSample + PERF_HISTORY_SIZE - ptPerf->uSampleCount + i) % PERF_HISTORY_SIZE;
+        float fX = fLeft + fBarWidth * (float)(PERF_HISTORY_SIZE - ptPerf->uSampleCount + i);
+        float afMs[3] = { ptPerf->afPhaseMs[uSample], ptPerf->afUiMs[uSample], ptPerf->afDrawMs[uSample] };
+
+        float fY = fBottom;
+        for(uint32_t j = 0; j < 3; j++)
+        {
+            float fHeight = afMs[j] * fScale;
+            if(fY - fHeight < fBottom - PERF_GRAPH_HEIGHT)
+                fHeight = fY - (fBottom - PERF_GRAPH_HEIGHT);
+            if(fHeight <= 0.0f)
+                continue;
+            gptDraw->add_rect_filled(ptLayer, (plVec2){fX, fY - fHeight}, (plVec2){fX + fBarWidth, fY},
+                (plDrawSolidOptions){.uColor = auColors[j]});
+            fY -= fHeight;
+        }
+    }
+
+    // 60hz budget
+    float fBudgetY = fBottom - 16.7f * fScale;
+    gptDraw->add_rect_filled(ptLayer, (plVec2){fLeft, fBudgetY}, (plVec2){fLeft + fWidth, fBudgetY + 1.0f},
+        (plDrawSolidOptions){.uColor = PL_COLOR_32(1.0f, 1.0f, 1.0f, 0.8f)});
+
+    gptDraw->submit_2d_layer(ptLayer);
+    gptDraw->submit_2d_drawlist(ptPerf->ptDrawlist, ptRender, ptAppData->tLayout.tViewportSize.x, ptAppData->tLayout.tViewportSize.y, 1);
+}
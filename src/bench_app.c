@@ -0,0 +1,374 @@
+/*
+   bench_app.c - core rules micro benchmarks
+
+   times the hot rules functions on a fixed mid-game fixture with fixed seeds, so numbers
+   are comparable between builds. each benchmark is run with a growing iteration count
+   until one run takes at least the minimum time, then repeated and the median ns/op is
+   reported.
+
+   usage: monopoly_bench [-filter TEXT] [-min-time SECONDS] [-repetitions N]
+*/
+
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "monopoly.h"
+#include "monopoly_init.h"
+#include "monopoly_platform.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#define BENCH_SEED            12345u
+#define BENCH_MAX_REPETITIONS 32
+#define BENCH_TURN_INPUT_CAP  64 // inputs before a stuck turn is abandoned
+
+//-----------------------------------------------------------------------------
+// [SECTION] structs
+//-----------------------------------------------------------------------------
+
+typedef struct _mBenchContext
+{
+    mGameData* pFixture; // mid-game state every benchmark starts from
+    mGameData* pGame;    // working copy
+    mGameFlow  tFlow;
+    bool       bHasFlow;
+    uint64_t   uSink;    // results are folded in here so calls can't be optimized away
+} mBenchContext;
+
+typedef void (*fBenchFunc)(mBenchContext* ptContext, uint64_t uIterations);
+
+typedef struct _mBenchmark
+{
+    const char* pcName;
+    fBenchFunc  pfRun;
+} mBenchmark;
+
+typedef struct _mBenchResult
+{
+    uint64_t uIterations;
+    double   dNsPerOp;    // median over repetitions
+    double   dMinNsPerOp;
+    double   dMaxNsPerOp;
+} mBenchResult;
+
+//-----------------------------------------------------------------------------
+// [SECTION] fixture
+//-----------------------------------------------------------------------------
+
+// four players a few dozen rounds in: two built up sets, railroads, a utility pair,
+// some mortgages and scattered singles
+static mGameData*
+bench_create_fixture(void)
+{
+    mGameSettings tSettings = {
+        .uStartingMoney = 1500,
+        .uJailFine      = 50,
+        .uPlayerCount   = 4
+    };
+    mGameData* pGame = m_init_game(tSettings);
+    if(!pGame)
+        return NULL;
+    srand(BENCH_SEED);
+
+    static const struct { uint8_t uProperty; uint8_t uOwner; } atOwners[] = {
+        { ST_JAMES_PLACE_PROPERTY_ARRAY_INDEX,       0 },
+        { TENNESSEE_AVENUE_PROPERTY_ARRAY_INDEX,     0 },
+        { NEW_YORK_AVENUE_PROPERTY_ARRAY_INDEX,      0 },
+        { READING_RAILROAD_PROPERTY_ARRAY_INDEX,     0 },
+        { KENTUCKY_AVENUE_PROPERTY_ARRAY_INDEX,      1 },
+        { INDIANA_AVENUE_PROPERTY_ARRAY_INDEX,       1 },
+        { ILLINOIS_AVENUE_PROPERTY_ARRAY_INDEX,      1 },
+        { PENNSYLVANIA_RAILROAD_PROPERTY_ARRAY_INDEX, 1 },
+        { BO_RAILROAD_PROPERTY_ARRAY_INDEX,          1 },
+        { ORIENTAL_AVENUE_PROPERTY_ARRAY_INDEX,      2 },
+        { VERMONT_AVENUE_PROPERTY_ARRAY_INDEX,       2 },
+        { ELECTRIC_COMPANY_PROPERTY_ARRAY_INDEX,     2 },
+        { WATER_WORKS_PROPERTY_ARRAY_INDEX,          2 },
+        { PARK_PLACE_PROPERTY_ARRAY_INDEX,           3 },
+        { PACIFIC_AVENUE_PROPERTY_ARRAY_INDEX,       3 },
+        { MEDITERRANEAN_AVENUE_PROPERTY_ARRAY_INDEX, 3 },
+    };
+    for(uint32_t i = 0; i < sizeof(atOwners) / sizeof(atOwners[0]); i++)
+        m_set_property_owner(pGame, atOwners[i].uProperty, atOwners[i].uOwner);
+
+    // orange to 3 houses each, red to 2
+    for(uint8_t uRound = 0; uRound < 3; uRound++)
+    {
+        for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+        {
+            mProperty* pProp = &pGame->amProperties[i];
+            if(pProp->eColor == COLOR_ORANGE || (pProp->eColor == COLOR_RED && uRound < 2))
+                m_build_house(pGame, i, pProp->uOwnerIndex);
+        }
+    }
+    m_mortgage_property(pGame, PACIFIC_AVENUE_PROPERTY_ARRAY_INDEX, 3);
+    m_mortgage_property(pGame, MEDITERRANEAN_AVENUE_PROPERTY_ARRAY_INDEX, 3);
+
+    static const uint32_t auMoney[]    = { 640, 910, 1320, 380 };
+    static const uint8_t  auPosition[] = { 6, 19, 24, 37 };
+    for(uint8_t i = 0; i < 4; i++)
+    {
+        m_set_player_money(pGame, i, auMoney[i]);
+        m_set_player_position(pGame, i, auPosition[i]);
+    }
+    m_set_round_count(pGame, 30);
+    m_clear_dirty(pGame);
+    return pGame;
+}
+
+static void
+bench_reset(mBenchContext* ptContext)
+{
+    if(ptContext->bHasFlow)
+    {
+        m_cleanup_game_flow(&ptContext->tFlow);
+        ptContext->bHasFlow = false;
+    }
+    memcpy(ptContext->pGame, ptContext->pFixture, sizeof(mGameData));
+    srand(BENCH_SEED);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] benchmarks
+//-----------------------------------------------------------------------------
+
+static void
+bench_roll_dice(mBenchContext* ptContext, uint64_t uIterations)
+{
+    mDice tDice = {0};
+    for(uint64_t i = 0; i < uIterations; i++)
+    {
+        m_roll_dice(&tDice);
+        ptContext->uSink += tDice.uDie1 + tDice.uDie2;
+    }
+}
+
+static void
+bench_move_player(mBenchContext* ptContext, uint64_t uIterations)
+{
+    mGameData* pGame = ptContext->pGame;
+    for(uint64_t i = 0; i < uIterations; i++)
+    {
+        mDice tDice = { (uint8_t)(1 + i % 6), (uint8_t)(1 + (i / 6) % 6) };
+        m_move_player(&pGame->amPlayers[i & 3], &tDice, pGame);
+    }
+    ptContext->uSink += pGame->amPlayers[0].uPosition;
+}
+
+static void
+bench_calculate_rent(mBenchContext* ptContext, uint64_t uIterations)
+{
+    for(uint64_t i = 0; i < uIterations; i++)
+        ptContext->uSink += m_calculate_rent(ptContext->pGame, (uint8_t)(i % TOTAL_PROPERTIES));
+}
+
+static void
+bench_can_build_house(mBenchContext* ptContext, uint64_t uIterations)
+{
+    mGameData* pGame = ptContext->pGame;
+    for(uint64_t i = 0; i < uIterations; i++)
+    {
+        uint8_t uPropIdx = (uint8_t)(i % TOTAL_PROPERTIES);
+        uint8_t uOwner = pGame->amProperties[uPropIdx].uOwnerIndex;
+        ptContext->uSink += m_can_build_house(pGame, uPropIdx, uOwner == BANK_PLAYER_INDEX ? 0 : uOwner);
+    }
+}
+
+static void
+bench_calculate_net_worth(mBenchContext* ptContext, uint64_t uIterations)
+{
+    for(uint64_t i = 0; i < uIterations; i++)
+        ptContext->uSink += (uint64_t)m_calculate_net_worth(ptContext->pGame, (uint8_t)(i & 3));
+}
+
+static void
+bench_transfer_property(mBenchContext* ptContext, uint64_t uIterations)
+{
+    // railroad goes back and forth so both list removal and append are measured
+    mGameData* pGame = ptContext->pGame;
+    for(uint64_t i = 0; i < uIterations; i++)
+    {
+        uint8_t uFrom = (uint8_t)(i & 1);
+        m_transfer_property(pGame, READING_RAILROAD_PROPERTY_ARRAY_INDEX, uFrom, (uint8_t)(uFrom ^ 1));
+    }
+    ptContext->uSink += pGame->amPlayers[0].uPropertyCount;
+}
+
+static void
+bench_shuffle_deck(mBenchContext* ptContext, uint64_t uIterations)
+{
+    mGameData* pGame = ptContext->pGame;
+    for(uint64_t i = 0; i < uIterations; i++)
+        m_shuffle_deck(&pGame->tChanceDeck);
+    ptContext->uSink += pGame->tChanceDeck.auIndices[0];
+}
+
+// answers prompts like a player who buys whatever it can afford
+static int
+bench_choose_input(const mGameFlow* pFlow)
+{
+    mGameData* pGame = pFlow->pGame;
+    mPlayer* pPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
+
+    if(pFlow->pfCurrentPhase == m_phase_pre_roll)
+        return 3;
+    if(pFlow->pfCurrentPhase == m_phase_jail)
+        return m_can_afford(pPlayer, pGame->uJailFine) ? 1 : 3;
+    if(pFlow->pfCurrentPhase == m_phase_post_roll)
+    {
+        mPostRollData* pPostRoll = (mPostRollData*)pFlow->pCurrentPhaseData;
+        if(!pPostRoll->bHandledLanding && pPostRoll->eSquareType == SQUARE_PROPERTY &&
+           pPostRoll->uPropertyIndex != BANK_PLAYER_INDEX &&
+           pGame->amProperties[pPostRoll->uPropertyIndex].uOwnerIndex == BANK_PLAYER_INDEX)
+            return m_can_afford(pPlayer, pGame->amProperties[pPostRoll->uPropertyIndex].uPrice) ? 1 : 2;
+        return 3;
+    }
+    return 0;
+}
+
+// one input and the automatic phase steps it triggers (same settling as the server)
+static void
+bench_step_flow(mGameFlow* pFlow, int iInput)
+{
+    m_set_input_int(pFlow, iInput);
+    for(uint32_t i = 0; i < 4 && pFlow->bInputReceived; i++)
+        m_run_current_phase(pFlow, 0.0f);
+    if(pFlow->bInputReceived)
+        m_clear_input(pFlow);
+    for(uint32_t i = 0; i < 4; i++)
+        m_run_current_phase(pFlow, 0.0f);
+}
+
+static void
+bench_phase_turn(mBenchContext* ptContext, uint64_t uIterations)
+{
+    mGameData* pGame = ptContext->pGame;
+    for(uint64_t i = 0; i < uIterations; i++)
+    {
+        if(!ptContext->bHasFlow || !pGame->bIsRunning || pGame->uActivePlayers <= 1)
+        {
+            bench_reset(ptContext);
+            m_init_game_flow(&ptContext->tFlow, pGame, NULL);
+            ptContext->bHasFlow = true;
+            bench_step_flow(&ptContext->tFlow, 0); // show the first pre-roll menu
+        }
+
+        // pre-roll through post-roll until the next player is up
+        uint8_t uPlayer = pGame->uCurrentPlayerIndex;
+        for(uint32_t uInput = 0; uInput < BENCH_TURN_INPUT_CAP && pGame->uCurrentPlayerIndex == uPlayer && pGame->bIsRunning; uInput++)
+            bench_step_flow(&ptContext->tFlow, bench_choose_input(&ptContext->tFlow));
+    }
+    ptContext->uSink += pGame->uRoundCount;
+}
+
+static const mBenchmark gatBenchmarks[] = {
+    { "m_roll_dice",           bench_roll_dice },
+    { "m_move_player",         bench_move_player },
+    { "m_calculate_rent",      bench_calculate_rent },
+    { "m_can_build_house",     bench_can_build_house },
+    { "m_calculate_net_worth", bench_calculate_net_worth },
+    { "m_transfer_property",   bench_transfer_property },
+    { "m_shuffle_deck",        bench_shuffle_deck },
+    { "m_phase_* turn",        bench_phase_turn },
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] runner
+//-----------------------------------------------------------------------------
+
+static double
+bench_time_run(mBenchContext* ptContext, const mBenchmark* ptBenchmark, uint64_t uIterations)
+{
+    bench_reset(ptContext);
+    uint64_t uStart = m_get_time_ns();
+    ptBenchmark->pfRun(ptContext, uIterations);
+    return (double)(m_get_time_ns() - uStart);
+}
+
+static int
+bench_compare_double(const void* pA, const void* pB)
+{
+    double dA = *(const double*)pA;
+    double dB = *(const double*)pB;
+    return (dA > dB) - (dA < dB);
+}
+
+static void
+bench_run(mBenchContext* ptContext, const mBenchmark* ptBenchmark, double dMinTimeNs, uint32_t uRepetitions, mBenchResult* ptResultOut)
+{
+    // grow the iteration count until a run is long enough to time reliably
+    uint64_t uIterations = 1;
+    double dElapsed = bench_time_run(ptContext, ptBenchmark, uIterations);
+    while(dElapsed < dMinTimeNs && uIterations < (1ull << 40))
+    {
+        double dScale = dElapsed > 0.0 ? dMinTimeNs * 1.2 / dElapsed : 10.0;
+        if(dScale > 10.0) dScale = 10.0;
+        if(dScale < 2.0)  dScale = 2.0;
+        uIterations = (uint64_t)((double)uIterations * dScale);
+        dElapsed = bench_time_run(ptContext, ptBenchmark, uIterations);
+    }
+
+    double adNsPerOp[BENCH_MAX_REPETITIONS];
+    adNsPerOp[0] = dElapsed / (double)uIterations;
+    for(uint32_t i = 1; i < uRepetitions; i++)
+        adNsPerOp[i] = bench_time_run(ptContext, ptBenchmark, uIterations) / (double)uIterations;
+    qsort(adNsPerOp, uRepetitions, sizeof(double), bench_compare_double);
+
+    ptResultOut->uIterations = uIterations;
+    ptResultOut->dNsPerOp    = adNsPerOp[uRepetitions / 2];
+    ptResultOut->dMinNsPerOp = adNsPerOp[0];
+    ptResultOut->dMaxNsPerOp = adNsPerOp[uRepetitions - 1];
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] main
+//-----------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+    const char* pcFilter = NULL;
+    double dMinTime = 0.25;
+    uint32_t uRepetitions = 5;
+
+    for(int i = 1; i < argc - 1; i++)
+    {
+        if(strcmp(argv[i], "-filter") == 0)           pcFilter = argv[++i];
+        else if(strcmp(argv[i], "-min-time") == 0)    dMinTime = atof(argv[++i]);
+        else if(strcmp(argv[i], "-repetitions") == 0) uRepetitions = (uint32_t)atoi(argv[++i]);
+    }
+    if(uRepetitions < 1) uRepetitions = 1;
+    if(uRepetitions > BENCH_MAX_REPETITIONS) uRepetitions = BENCH_MAX_REPETITIONS;
+
+    mBenchContext tContext = {0};
+    tContext.pFixture = bench_create_fixture();
+    if(!tContext.pFixture)
+        return 1;
+    tContext.pGame = malloc(sizeof(mGameData));
+
+    printf("%-24s %14s %12s %12s %12s\n", "benchmark", "iterations", "ns/op", "min", "max");
+    for(uint32_t i = 0; i < sizeof(gatBenchmarks) / sizeof(gatBenchmarks[0]); i++)
+    {
+        const mBenchmark* ptBenchmark = &gatBenchmarks[i];
+        if(pcFilter && !strstr(ptBenchmark->pcName, pcFilter))
+            continue;
+
+        mBenchResult tResult;
+        bench_run(&tContext, ptBenchmark, dMinTime * 1e9, uRepetitions, &tResult);
+        printf("%-24s %14llu %12.2f %12.2f %12.2f\n", ptBenchmark->pcName, (unsigned long long)tResult.uIterations,
+            tResult.dNsPerOp, tResult.dMinNsPerOp, tResult.dMaxNsPerOp);
+    }
+
+    bench_reset(&tContext);
+    printf("(checksum %llu)\n", (unsigned long long)tContext.uSink);
+    free(tContext.pGame);
+    m_free_game(tContext.pFixture);
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*
+   cook_app.c - offline texture cooker
+
+   decodes images once at build time and writes them as .mtex containers (monopoly_texture.h)
+   holding a full mip chain, so the app streams them straight into a staging buffer instead
+   of decoding pngs at every launch. mips are box filtered in linear space with alpha
+   weighting, so transparent texels don't bleed into sprite edges.
+
+   usage: monopoly_cook [-o DIR] IMAGE...
+
+   each IMAGE is written to DIR/<name>.mtex (default: next to the image), e.g.
+       monopoly_cook -o ../assets/cooked ../assets/monopoly-board.png ../assets/dice-spritesheet.png
+*/
+
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "monopoly_texture.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#define COOK_MAX_PATH 512
+
+//-----------------------------------------------------------------------------
+// [SECTION] color conversion
+//-----------------------------------------------------------------------------
+
+static float gafSrgbToLinear[256];
+
+static void
+cook_init_tables(void)
+{
+    for(uint32_t i = 0; i < 256; i++)
+    {
+        float fValue = (float)i / 255.0f;
+        gafSrgbToLinear[i] = fValue <= 0.04045f ? fValue / 12.92f : powf((fValue + 0.055f) / 1.055f, 2.4f);
+    }
+}
+
+static uint8_t
+cook_linear_to_srgb(float fValue)
+{
+    if(fValue <= 0.0f) return 0;
+    if(fValue >= 1.0f) return 255;
+    float fSrgb = fValue <= 0.0031308f ? fValue * 12.92f : 1.055f * powf(fValue, 1.0f / 2.4f) - 0.055f;
+    return (uint8_t)(fSrgb * 255.0f + 0.5f);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] mip generation
+//-----------------------------------------------------------------------------
+
+// each destination texel averages the source texels it covers (2 or 3 per axis for odd sizes)
+static void
+cook_downsample(const uint8_t* puSrc, uint32_t uSrcWidth, uint32_t uSrcHeight, uint8_t* puDst, uint32_t uDstWidth, uint32_t uDstHeight)
+{
+    for(uint32_t uY = 0; uY < uDstHeight; uY++)
+    {
+        uint32_t uY0 = uY * uSrcHeight / uDstHeight;
+        uint32_t uY1 = (uY + 1) * uSrcHeight / uDstHeight;
+        if(uY1 <= uY0) uY1 = uY0 + 1;
+
+        for(uint32_t uX = 0; uX < uDstWidth; uX++)
+        {
+            uint32_t uX0 = uX * uSrcWidth / uDstWidth;
+            uint32_t uX1 = (uX + 1) * uSrcWidth / uDstWidth;
+            if(uX1 <= uX0) uX1 = uX0 + 1;
+
+            float afColor[3] = {0};
+            float fAlpha = 0.0f;
+            uint32_t uCount = 0;
+            for(uint32_t uSy = uY0; uSy < uY1; uSy++)
+            {
+                for(uint32_t uSx = uX0; uSx < uX1; uSx++)
+                {
+                    const uint8_t* puTexel = &puSrc[((size_t)uSy * uSrcWidth + uSx) * 4];
+                    float fTexelAlpha = (float)puTexel[3] / 255.0f;
+                    for(uint32_t c = 0; c < 3; c++)
+                        afColor[c] += gafSrgbToLinear[puTexel[c]] * fTexelAlpha;
+                    fAlpha += fTexelAlpha;
+                    uCount++;
+                }
+            }
+
+            uint8_t* puOut = &puDst[((size_t)uY * uDstWidth + uX) * 4];
+            for(uint32_t c = 0; c < 3; c++)
+                puOut[c] = fAlpha > 0.0f ? cook_linear_to_srgb(afColor[c] / fAlpha) : 0;
+            puOut[3] = (uint8_t)(fAlpha / (float)uCount * 255.0f + 0.5f);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] cooking
+//-----------------------------------------------------------------------------
+
+static bool
+cook_image(const char* pcInput, const char* pcOutput)
+{
+    int iWidth = 0, iHeight = 0, iChannels = 0;
+    uint8_t* puPixels = stbi_load(pcInput, &iWidth, &iHeight, &iChannels, 4);
+    if(!puPixels)
+    {
+        printf("couldn't load %s: %s\n", pcInput, stbi_failure_reason());
+        return false;
+    }
+
+    // layout every mip first
+    mTextureFileHeader tHeader = {
+        .uMagic    = M_TEXTURE_FILE_MAGIC,
+        .uVersion  = M_TEXTURE_FILE_VERSION,
+        .uFormat   = TEXTURE_FILE_FORMAT_RGBA8_UNORM,
+        .uWidth    = (uint32_t)iWidth,
+        .uHeight   = (uint32_t)iHeight
+    };
+    mTextureFileMip atMips[M_TEXTURE_MAX_MIPS] = {0};
+    uint32_t uWidth = tHeader.uWidth;
+    uint32_t uHeight = tHeader.uHeight;
+    uint64_t uOffset = 0;
+    while(tHeader.uMipCount < M_TEXTURE_MAX_MIPS)
+    {
+        mTextureFileMip* ptMip = &atMips[tHeader.uMipCount++];
+        ptMip->uOffset = uOffset;
+        ptMip->uSize   = (uint64_t)uWidth * uHeight * 4;
+        ptMip->uWidth  = uWidth;
+        ptMip->uHeight = uHeight;
+        uOffset = (uOffset + ptMip->uSize + M_TEXTURE_FILE_ALIGNMENT - 1) & ~(uint64_t)(M_TEXTURE_FILE_ALIGNMENT - 1);
+
+        if(uWidth == 1 && uHeight == 1)
+            break;
+        uWidth  = uWidth > 1 ? uWidth / 2 : 1;
+        uHeight = uHeight > 1 ? uHeight / 2 : 1;
+    }
+    uint64_t uTableEnd = sizeof(mTextureFileHeader) + sizeof(mTextureFileMip) * tHeader.uMipCount;
+    tHeader.uDataOffset = (uTableEnd + M_TEXTURE_FILE_ALIGNMENT - 1) & ~(uint64_t)(M_TEXTURE_FILE_ALIGNMENT - 1);
+    tHeader.uDataSize   = uOffset;
+
+    uint8_t* puData = calloc(1, (size_t)tHeader.uDataSize);
+    if(!puData)
+    {
+        stbi_image_free(puPixels);
+        return false;
+    }
+    memcpy(puData, puPixels, (size_t)atMips[0].uSize);
+    stbi_image_free(puPixels);
+
+    // each level from the one above
+    for(uint32_t i = 1; i < tHeader.uMipCount; i++)
+    {
+        cook_downsample(&puData[atMips[i - 1].uOffset], atMips[i - 1].uWidth, atMips[i - 1].uHeight,
+            &puData[atMips[i].uOffset], atMips[i].uWidth, atMips[i].uHeight);
+    }
+
+    FILE* ptFile = fopen(pcOutput, "wb");
+    if(!ptFile)
+    {
+        printf("couldn't create %s\n", pcOutput);
+        free(puData);
+        return false;
+    }
+
+    uint8_t auPadding[M_TEXTURE_FILE_ALIGNMENT] = {0};
+    fwrite(&tHeader, sizeof(tHeader), 1, ptFile);
+    fwrite(atMips, sizeof(mTextureFileMip), tHeader.uMipCount, ptFile);
+    fwrite(auPadding, 1, (size_t)(tHeader.uDataOffset - uTableEnd), ptFile);
+    fwrite(puData, 1, (size_t)tHeader.uDataSize, ptFile);
+    bool bOk = !ferror(ptFile);
+    fclose(ptFile);
+    free(puData);
+
+    printf("%s -> %s (%ux%u, %u mips, %.1f MB)\n", pcInput, pcOutput, tHeader.uWidth, tHeader.uHeight, tHeader.uMipCount,
+        (double)tHeader.uDataSize / (1024.0 * 1024.0));
+    return bOk;
+}
+
+// DIR/<name>.mtex, or next to the input when pcDirectory is NULL
+static void
+cook_output_path(const char* pcInput, const char* pcDirectory, char* pcOut)
+{
+    const char* pcName = pcInput;
+    for(const char* pc = pcInput; *pc; pc++)
+    {
+        if(*pc == '/' || *pc == '\\')
+            pcName = pc + 1;
+    }
+    size_t szStem = strlen(pcName);
+    const char* pcDot = strrchr(pcName, '.');
+    if(pcDot)
+        szStem = (size_t)(pcDot - pcName);
+
+    if(pcDirectory)
+        snprintf(pcOut, COOK_MAX_PATH, "%s/%.*s.mtex", pcDirectory, (int)szStem, pcName);
+    else
+        snprintf(pcOut, COOK_MAX_PATH, "%.*s%.*s.mtex", (int)(pcName - pcInput), pcInput, (int)szStem, pcName);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] main
+//-----------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+    const char* pcDirectory = NULL;
+    int iFirstInput = 1;
+    if(argc > 2 && strcmp(argv[1], "-o") == 0)
+    {
+        pcDirectory = argv[2];
+        iFirstInput = 3;
+    }
+    if(iFirstInput >= argc)
+    {
+        printf("usage: monopoly_cook [-o DIR] IMAGE...\n");
+        return 1;
+    }
+
+    cook_init_tables();
+
+    int iFailures = 0;
+    for(int i = iFirstInput; i < argc; i++)
+    {
+        char acOutput[COOK_MAX_PATH];
+        cook_output_path(argv[i], pcDirectory, acOutput);
+        if(!cook_image(argv[i], acOutput))
+            iFailures++;
+    }
+    return iFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,412 @@
+/*
+   games_bench_app.c - end to end games per second benchmark
+
+   plays complete games headlessly through the phase system with scripted controllers
+   (buy everything, never buy, random, and a mix of the three) for every player count,
+   and reports games/s, turns/s, heap allocations per game and peak rss. the core is
+   built with M_CUSTOM_ALLOCATOR so every allocation it makes is counted here.
+
+   usage: monopoly_games_bench [-games N] [-rounds N] [-seed N] [-trace FILE] [-stats PREFIX] [-history FILE]
+
+   -trace saves a chrome trace of the run (needs a build with M_ENABLE_PROFILING)
+   -stats aggregates game statistics over every game played and writes PREFIX.csv
+          and PREFIX.mstats (columnar, see monopoly_stats.h)
+   -history records every turn of every game played (columnar, see monopoly_history.h)
+*/
+
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "monopoly.h"
+#include "monopoly_init.h"
+#include "monopoly_platform.h"
+#include "monopoly_stats.h"
+#include "monopoly_history.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#define GAMES_BENCH_STEPS_PER_ROUND 200 // inputs per round before a game is called stuck
+#define GAMES_BENCH_SETTLE_TICKS    4
+
+//-----------------------------------------------------------------------------
+// [SECTION] enums
+//-----------------------------------------------------------------------------
+
+typedef enum _eBenchController
+{
+    BENCH_CONTROLLER_BUY_EVERYTHING,
+    BENCH_CONTROLLER_NEVER_BUY,
+    BENCH_CONTROLLER_RANDOM,
+    BENCH_CONTROLLER_MIXED, // seat i plays controller i % 3
+    BENCH_CONTROLLER_COUNT
+} eBenchController;
+
+//-----------------------------------------------------------------------------
+// [SECTION] structs
+//-----------------------------------------------------------------------------
+
+typedef struct _mBenchStats
+{
+    uint64_t uGames;
+    uint64_t uFinishedGames; // ended with a winner before the round cap
+    uint64_t uTurns;
+    uint64_t uSteps;
+    uint64_t uAllocations;
+    uint64_t uAllocatedBytes;
+    uint64_t uElapsedNs;
+} mBenchStats;
+
+typedef struct _mBenchHistory
+{
+    mHistoryBuffer tBuffer;
+    uint32_t       uGame; // id of the game being played
+} mBenchHistory;
+
+//-----------------------------------------------------------------------------
+// [SECTION] allocation tracking
+//-----------------------------------------------------------------------------
+
+// single threaded, so plain counters are enough
+static uint64_t guAllocations = 0;
+static uint64_t guAllocatedBytes = 0;
+
+void*
+m_custom_alloc(size_t szSize)
+{
+    guAllocations++;
+    guAllocatedBytes += szSize;
+    return malloc(szSize);
+}
+
+void
+m_custom_free(void* pMemory)
+{
+    free(pMemory);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] controllers
+//-----------------------------------------------------------------------------
+
+static const char* gapcControllerNames[BENCH_CONTROLLER_COUNT] = {
+    "buy-everything",
+    "never-buy",
+    "random",
+    "mixed"
+};
+
+// controller rng kept apart from rand() so the dice sequence doesn't depend on it
+static uint32_t
+bench_next_random(uint32_t* puState)
+{
+    uint32_t uX = *puState;
+    uX ^= uX << 13;
+    uX ^= uX >> 17;
+    uX ^= uX << 5;
+    *puState = uX;
+    return uX;
+}
+
+// player the current phase is waiting on
+static uint8_t
+bench_get_input_player(const mGameFlow* pFlow)
+{
+    if(pFlow->pfCurrentPhase == m_phase_auction)
+        return ((const mAuctionData*)pFlow->pCurrentPhaseData)->uCurrentBidder;
+    return pFlow->pGame->uCurrentPlayerIndex;
+}
+
+static int
+bench_choose_input(const mGameFlow* pFlow, eBenchController eGameController, uint32_t* puRandom)
+{
+    mGameData* pGame = pFlow->pGame;
+    uint8_t uPlayerIndex = bench_get_input_player(pFlow);
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+
+    eBenchController eController = eGameController;
+    if(eController == BENCH_CONTROLLER_MIXED)
+        eController = (eBenchController)(uPlayerIndex % BENCH_CONTROLLER_MIXED);
+    bool bRandom = eController == BENCH_CONTROLLER_RANDOM;
+
+    if(pFlow->pfCurrentPhase == m_phase_pre_roll)
+    {
+        return 3; // roll dice
+    }
+    else if(pFlow->pfCurrentPhase == m_phase_jail)
+    {
+        if(pPlayer->bHasJailFreeCard && (!bRandom || bench_next_random(puRandom) % 2))
+            return 2;
+        if(m_can_afford(pPlayer, pGame->uJailFine) && (!bRandom || bench_next_random(puRandom) % 2))
+            return 1;
+        return 3; // roll for doubles
+    }
+    else if(pFlow->pfCurrentPhase == m_phase_post_roll)
+    {
+        mPostRollData* pPostRoll = (mPostRollData*)pFlow->pCurrentPhaseData;
+        if(!pPostRoll->bHandledLanding && pPostRoll->eSquareType == SQUARE_PROPERTY &&
+           pPostRoll->uPropertyIndex != BANK_PLAYER_INDEX &&
+           pGame->amProperties[pPostRoll->uPropertyIndex].uOwnerIndex == BANK_PLAYER_INDEX)
+        {
+            bool bCanBuy = m_can_afford(pPlayer, pGame->amProperties[pPostRoll->uPropertyIndex].uPrice);
+            if(eController == BENCH_CONTROLLER_BUY_EVERYTHING)
+                return bCanBuy ? 1 : 2;
+            if(bRandom && bCanBuy && bench_next_random(puRandom) % 2)
+                return 1;
+            return 2; // pass to auction
+        }
+        return 3; // end turn
+    }
+    else if(pFlow->pfCurrentPhase == m_phase_auction)
+    {
+        mAuctionData* pAuction = (mAuctionData*)pFlow->pCurrentPhaseData;
+        mProperty* pProp = &pGame->amProperties[pAuction->ePropertyIndex];
+
+        uint32_t uBid = 0;
+        if(eController == BENCH_CONTROLLER_BUY_EVERYTHING && pAuction->uHighestBid + 10 <= pProp->uPrice)
+            uBid = pAuction->uHighestBid + 10;
+        else if(bRandom && bench_next_random(puRandom) % 2)
+            uBid = pAuction->uHighestBid + 1 + bench_next_random(puRandom) % 50;
+
+        // phases only accept bids the bidder can pay
+        if(uBid > pPlayer->uMoney)
+            uBid = 0;
+        return (int)uBid;
+    }
+
+    // trade and property management: back out
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] games
+//-----------------------------------------------------------------------------
+
+static void
+bench_record_turn(mGameFlow* pFlow, const mTurnRecord* pTurn, void* pUserData)
+{
+    (void)pFlow;
+    mBenchHistory* ptHistory = (mBenchHistory*)pUserData;
+    m_history_append(&ptHistory->tBuffer, ptHistory->uGame, pTurn);
+}
+
+// one input and the automatic phase steps it triggers (same settling as the server)
+static void
+bench_step_flow(mGameFlow* pFlow, int iInput)
+{
+    m_set_input_int(pFlow, iInput);
+    for(uint32_t i = 0; i < GAMES_BENCH_SETTLE_TICKS && pFlow->bInputReceived; i++)
+        m_run_current_phase(pFlow, 0.0f);
+    if(pFlow->bInputReceived)
+        m_clear_input(pFlow);
+    for(uint32_t i = 0; i < GAMES_BENCH_SETTLE_TICKS; i++)
+        m_run_current_phase(pFlow, 0.0f);
+}
+
+static void
+bench_play_game(const mGameData* pTemplate, eBenchController eController, uint32_t uMaxRounds, uint32_t uSeed, mBenchStats* ptStats, mStatsAggregate* ptAggregate, mBenchHistory* ptHistory)
+{
+    uint64_t uAllocationsStart = guAllocations;
+    uint64_t uBytesStart = guAllocatedBytes;
+    uint64_t uStart = m_get_time_ns();
+
+    srand(uSeed);
+    uint32_t uRandom = uSeed * 2654435761u + 1;
+
+    mGameData* pGame = M_ALLOC(sizeof(mGameData));
+    memcpy(pGame, pTemplate, sizeof(mGameData));
+    m_shuffle_deck(&pGame->tChanceDeck);
+    m_shuffle_deck(&pGame->tCommunityChestDeck);
+
+    mGameFlow tFlow;
+    m_init_game_flow(&tFlow, pGame, NULL);
+    if(ptHistory)
+    {
+        ptHistory->uGame++;
+        tFlow.pfTurnObserver    = bench_record_turn;
+        tFlow.pTurnObserverData = ptHistory;
+    }
+    bench_step_flow(&tFlow, 0); // show the first pre-roll menu
+
+    uint64_t uMaxSteps = (uint64_t)uMaxRounds * GAMES_BENCH_STEPS_PER_ROUND;
+    uint64_t uSteps = 0;
+    uint64_t uTurns = 0;
+    uint8_t uLastPlayer = pGame->uCurrentPlayerIndex;
+    while(pGame->bIsRunning && pGame->uActivePlayers > 1 && pGame->uRoundCount < uMaxRounds && uSteps < uMaxSteps)
+    {
+        bench_step_flow(&tFlow, bench_choose_input(&tFlow, eController, &uRandom));
+        uSteps++;
+        if(pGame->uCurrentPlayerIndex != uLastPlayer)
+        {
+            uLastPlayer = pGame->uCurrentPlayerIndex;
+            uTurns++;
+        }
+    }
+
+    bool bFinished = !pGame->bIsRunning || pGame->uActivePlayers <= 1;
+    m_cleanup_game_flow(&tFlow);
+    if(ptAggregate)
+        m_stats_add_game(ptAggregate, pGame);
+    M_FREE(pGame);
+
+    ptStats->uElapsedNs      += m_get_time_ns() - uStart;
+    ptStats->uGames++;
+    ptStats->uFinishedGames  += bFinished ? 1 : 0;
+    ptStats->uTurns          += uTurns;
+    ptStats->uSteps          += uSteps;
+    ptStats->uAllocations    += guAllocations - uAllocationsStart;
+    ptStats->uAllocatedBytes += guAllocatedBytes - uBytesStart;
+}
+
+static void
+bench_print_stats(const char* pcController, const char* pcPlayers, const mBenchStats* ptStats)
+{
+    double dSeconds = (double)ptStats->uElapsedNs / 1e9;
+    double dGames = ptStats->uGames ? (double)ptStats->uGames : 1.0;
+    printf("%-16s %7s %7llu %8llu %12.1f %12.0f %12.0f %10.1f %12.0f\n",
+        pcController, pcPlayers,
+        (unsigned long long)ptStats->uGames,
+        (unsigned long long)ptStats->uFinishedGames,
+        dSeconds > 0.0 ? (double)ptStats->uGames / dSeconds : 0.0,
+        dSeconds > 0.0 ? (double)ptStats->uTurns / dSeconds : 0.0,
+        (double)ptStats->uTurns / dGames,
+        (double)ptStats->uAllocations / dGames,
+        (double)ptStats->uAllocatedBytes / dGames);
+}
+
+static void
+bench_add_stats(mBenchStats* ptTotal, const mBenchStats* ptStats)
+{
+    ptTotal->uGames          += ptStats->uGames;
+    ptTotal->uFinishedGames  += ptStats->uFinishedGames;
+    ptTotal->uTurns          += ptStats->uTurns;
+    ptTotal->uSteps          += ptStats->uSteps;
+    ptTotal->uAllocations    += ptStats->uAllocations;
+    ptTotal->uAllocatedBytes += ptStats->uAllocatedBytes;
+    ptTotal->uElapsedNs      += ptStats->uElapsedNs;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] main
+//-----------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t uGamesPerRow = 200;
+    uint32_t uMaxRounds   = 1000;
+    uint32_t uSeed        = 1;
+    const char* pcTrace   = NULL;
+    const char* pcStats   = NULL;
+    const char* pcHistory = NULL;
+
+    for(int i = 1; i < argc - 1; i++)
+    {
+        if(strcmp(argv[i], "-games") == 0)       uGamesPerRow = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-rounds") == 0) uMaxRounds   = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-seed") == 0)   uSeed        = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-trace") == 0)  pcTrace      = argv[++i];
+        else if(strcmp(argv[i], "-stats") == 0)  pcStats      = argv[++i];
+        else if(strcmp(argv[i], "-history") == 0) pcHistory   = argv[++i];
+    }
+
+#ifndef M_ENABLE_PROFILING
+    if(pcTrace)
+        printf("-trace ignored, build with M_ENABLE_PROFILING to record one\n");
+#endif
+    if(pcTrace)
+        M_PROFILE_INIT(1 << 22); // ~128 MB, later events are dropped
+
+    // load game data once per player count and stamp it into every game
+    mGameData* apTemplates[MAX_PLAYERS + 1] = {0};
+    for(uint8_t uPlayers = 2; uPlayers <= MAX_PLAYERS; uPlayers++)
+    {
+        mGameSettings tSettings = {
+            .uStartingMoney = 1500,
+            .uJailFine      = 50,
+            .uPlayerCount   = uPlayers
+        };
+        apTemplates[uPlayers] = m_init_game(tSettings);
+        if(!apTemplates[uPlayers])
+            return 1;
+    }
+
+    printf("%-16s %7s %7s %8s %12s %12s %12s %10s %12s\n",
+        "controller", "players", "games", "finished", "games/s", "turns/s", "turns/game", "allocs/gm", "bytes/game");
+
+    mStatsAggregate tAggregate = {0};
+    mStatsAggregate* ptAggregate = pcStats ? &tAggregate : NULL;
+
+    mBenchHistory tHistory = {0};
+    mBenchHistory* ptHistory = NULL;
+    mHistoryWriter* ptHistoryWriter = NULL;
+    if(pcHistory)
+    {
+        ptHistoryWriter = m_history_open(pcHistory);
+        if(!ptHistoryWriter)
+        {
+            printf("couldn't create %s\n", pcHistory);
+            return 1;
+        }
+        m_history_buffer_init(ptHistoryWriter, &tHistory.tBuffer);
+        ptHistory = &tHistory;
+    }
+
+    mBenchStats tTotal = {0};
+    for(uint32_t uController = 0; uController < BENCH_CONTROLLER_COUNT; uController++)
+    {
+        mBenchStats tControllerTotal = {0};
+        for(uint8_t uPlayers = 2; uPlayers <= MAX_PLAYERS; uPlayers++)
+        {
+            mBenchStats tStats = {0};
+            for(uint32_t uGame = 0; uGame < uGamesPerRow; uGame++)
+                bench_play_game(apTemplates[uPlayers], (eBenchController)uController, uMaxRounds, uSeed + uGame, &tStats, ptAggregate, ptHistory);
+
+            char acPlayers[8];
+            snprintf(acPlayers, sizeof(acPlayers), "%u", uPlayers);
+            bench_print_stats(gapcControllerNames[uController], acPlayers, &tStats);
+            bench_add_stats(&tControllerTotal, &tStats);
+        }
+        bench_print_stats(gapcControllerNames[uController], "all", &tControllerTotal);
+        bench_add_stats(&tTotal, &tControllerTotal);
+    }
+    bench_print_stats("total", "all", &tTotal);
+
+    printf("round cap:         %u\n", uMaxRounds);
+    printf("peak rss:          %.1f MB\n", (double)m_get_peak_rss() / (1024.0 * 1024.0));
+
+    if(ptHistoryWriter)
+    {
+        m_history_buffer_flush(&tHistory.tBuffer);
+        if(!m_history_close(ptHistoryWriter))
+            printf("couldn't write %s\n", pcHistory);
+    }
+
+    if(ptAggregate)
+    {
+        // player counts share the same board and cards, any template has the names
+        char acPath[512];
+        snprintf(acPath, sizeof(acPath), "%s.csv", pcStats);
+        if(!m_stats_write_csv(ptAggregate, apTemplates[2], acPath))
+            printf("couldn't write %s\n", acPath);
+        snprintf(acPath, sizeof(acPath), "%s.mstats", pcStats);
+        if(!m_stats_write_columns(ptAggregate, apTemplates[2], acPath))
+            printf("couldn't write %s\n", acPath);
+    }
+
+    if(pcTrace)
+    {
+        M_PROFILE_WRITE_TRACE(pcTrace);
+        M_PROFILE_CLEANUP();
+    }
+
+    for(uint8_t uPlayers = 2; uPlayers <= MAX_PLAYERS; uPlayers++)
+        m_free_game(apTemplates[uPlayers]);
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "monopoly.h"
+#include "monopoly_platform.h" // M_THREAD_LOCAL
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -15,8 +16,9 @@ m_init_game_flow(mGameFlow* pFlow, mGameData* pGame, void* pInputContext)
     pFlow->pGame         = pGame;
     pFlow->pInputContext = pInputContext;
     pFlow->iStackDepth   = 0;
+    pFlow->fTimeScale    = 1.0f;
     
-    mPreRollData* pPreRoll = malloc(sizeof(mPreRollData));
+    mPreRollData* pPreRoll = M_ALLOC(sizeof(mPreRollData));
     memset(pPreRoll, 0, sizeof(mPreRollData));
     
     pFlow->pfCurrentPhase = m_phase_pre_roll;
@@ -25,6 +27,23 @@ m_init_game_flow(mGameFlow* pFlow, mGameData* pGame, void* pInputContext)
     pGame->bShowPrerollMenu = false;
 }
 
+void
+m_cleanup_game_flow(mGameFlow* pFlow)
+{
+    if(!pFlow) return;
+
+    for(int i = 0; i < pFlow->iStackDepth; i++)
+    {
+        M_FREE(pFlow->apPhaseDataStack[i]);
+        pFlow->apPhaseDataStack[i] = NULL;
+    }
+    pFlow->iStackDepth = 0;
+
+    M_FREE(pFlow->pCurrentPhaseData);
+    pFlow->pCurrentPhaseData = NULL;
+    pFlow->pfCurrentPhase    = NULL;
+}
+
 void 
 m_push_phase(mGameFlow* pFlow, fPhaseFunc pfNewPhase, void* pNewData)
 {
@@ -47,7 +66,7 @@ m_pop_phase(mGameFlow* pFlow)
     // free current phase data
     if(pFlow->pCurrentPhaseData)
     {
-        free(pFlow->pCurrentPhaseData);
+        M_FREE(pFlow->pCurrentPhaseData);
         pFlow->pCurrentPhaseData = NULL;
     }
 
@@ -61,12 +80,57 @@ void
 m_run_current_phase(mGameFlow* pFlow, float fDeltaTime)
 {
     if(!pFlow || !pFlow->pfCurrentPhase) return;
-    pFlow->fAccumulatedTime += fDeltaTime;
-    ePhaseResult tResult = pFlow->pfCurrentPhase(pFlow->pCurrentPhaseData, fDeltaTime, pFlow);
+    M_PROFILE_BEGIN("m_run_current_phase");
+    float fGameTime = fDeltaTime * pFlow->fTimeScale;
+    pFlow->fDeltaTime = fGameTime;
+    pFlow->fAccumulatedTime += fGameTime;
+
+    // notifications expire in game time too
+    mGameData* pGame = pFlow->pGame;
+    if(pGame->bShowNotification && fGameTime > 0.0f)
+    {
+        pGame->fNotificationTimer -= fGameTime;
+        if(pGame->fNotificationTimer <= 0.0f)
+            m_clear_notification(pGame);
+    }
+
+    M_PROFILE_BEGIN(m_get_phase_name(pFlow->pfCurrentPhase));
+    uint32_t uTurns = pFlow->pGame->tStats.uTurns;
+    ePhaseResult tResult = pFlow->pfCurrentPhase(pFlow->pCurrentPhaseData, fGameTime, pFlow);
+    M_PROFILE_END();
     if(tResult == PHASE_COMPLETE)
     {
         m_pop_phase(pFlow);
     }
+    if(pFlow->pfTurnObserver && pFlow->pGame->tStats.uTurns != uTurns)
+        pFlow->pfTurnObserver(pFlow, &pFlow->pGame->tStats.tLastTurn, pFlow->pTurnObserverData);
+    M_PROFILE_END();
+}
+
+size_t
+m_get_phase_data_size(fPhaseFunc pfPhase)
+{
+    if(pfPhase == m_phase_pre_roll)            return sizeof(mPreRollData);
+    if(pfPhase == m_phase_post_roll)           return sizeof(mPostRollData);
+    if(pfPhase == m_phase_jail)                return sizeof(mJailData);
+    if(pfPhase == m_phase_property_management) return sizeof(mPropertyManagementData);
+    if(pfPhase == m_phase_auction)             return sizeof(mAuctionData);
+    if(pfPhase == m_phase_bankruptcy)          return sizeof(mBankruptcyData);
+    if(pfPhase == m_phase_trade)               return sizeof(mTradeData);
+    return 0;
+}
+
+const char*
+m_get_phase_name(fPhaseFunc pfPhase)
+{
+    if(pfPhase == m_phase_pre_roll)            return "m_phase_pre_roll";
+    if(pfPhase == m_phase_post_roll)           return "m_phase_post_roll";
+    if(pfPhase == m_phase_jail)                return "m_phase_jail";
+    if(pfPhase == m_phase_property_management) return "m_phase_property_management";
+    if(pfPhase == m_phase_auction)             return "m_phase_auction";
+    if(pfPhase == m_phase_bankruptcy)          return "m_phase_bankruptcy";
+    if(pfPhase == m_phase_trade)               return "m_phase_trade";
+    return "unknown";
 }
 
 // ==================== INPUT SYSTEM ==================== //
@@ -103,6 +167,626 @@ m_is_waiting_input(mGameFlow* pFlow)
     return pFlow && !pFlow->bInputReceived;
 }
 
+// ==================== STATE MUTATORS ==================== //
+
+static void
+m__mark_dirty(mGameData* pGame, eChangeField eField, uint8_t uIndex)
+{
+    pGame->uStateVersion++;
+    pGame->uDirtyFields |= 1u << eField;
+
+    if(eField <= CHANGE_PLAYER_PROPERTY_REMOVED)
+        pGame->uDirtyPlayers |= (uint8_t)(1u << uIndex);
+    else if(eField <= CHANGE_PROPERTY_MORTGAGED)
+        pGame->uDirtyProperties |= 1u << uIndex;
+}
+
+static void
+m__record_change(mGameData* pGame, eChangeField eField, uint8_t uIndex, uint8_t uAux, uint32_t uOldValue, uint32_t uNewValue)
+{
+    m__mark_dirty(pGame, eField, uIndex);
+
+    mChangeJournal* pJournal = pGame->pJournal;
+    if(!pJournal)
+        return;
+
+    // a new change invalidates anything that was rolled back
+    pJournal->uRedoCount = 0;
+
+    if(pJournal->uCount >= pJournal->uCapacity)
+    {
+        pJournal->bOverflow = true;
+        return;
+    }
+
+    mChange* pChange = &pJournal->atChanges[pJournal->uCount++];
+    pChange->uField    = (uint8_t)eField;
+    pChange->uIndex    = uIndex;
+    pChange->uAux      = uAux;
+    pChange->uOldValue = uOldValue;
+    pChange->uNewValue = uNewValue;
+}
+
+// property list helpers, order is kept so the ui lists don't reshuffle
+static void
+m__insert_owned_property(mPlayer* pPlayer, uint8_t uSlot, uint8_t uPropertyIndex)
+{
+    for(uint8_t i = pPlayer->uPropertyCount; i > uSlot; i--)
+        pPlayer->auPropertiesOwned[i] = pPlayer->auPropertiesOwned[i - 1];
+    pPlayer->auPropertiesOwned[uSlot] = uPropertyIndex;
+    pPlayer->uPropertyCount++;
+}
+
+static void
+m__remove_owned_property(mPlayer* pPlayer, uint8_t uSlot)
+{
+    for(uint8_t i = uSlot; i + 1 < pPlayer->uPropertyCount; i++)
+        pPlayer->auPropertiesOwned[i] = pPlayer->auPropertiesOwned[i + 1];
+    pPlayer->uPropertyCount--;
+    pPlayer->auPropertiesOwned[pPlayer->uPropertyCount] = BANK_PLAYER_INDEX;
+}
+
+// adds or removes one property's share of its owner's running totals, called around
+// every write to an owned property so the totals never need a list walk
+static void
+m__account_property(mGameData* pGame, uint8_t uPropertyIndex, bool bAdd)
+{
+    mProperty* pProp = &pGame->amProperties[uPropertyIndex];
+    if(pProp->uOwnerIndex == BANK_PLAYER_INDEX) return;
+
+    uint32_t uPropertyValue     = 0;
+    uint32_t uMortgageDebt      = 0;
+    uint32_t uMortgageableValue = 0;
+    if(pProp->bIsMortgaged)
+    {
+        uMortgageDebt = pProp->uMortgageValue + (pProp->uMortgageValue / 10);
+    }
+    else
+    {
+        uPropertyValue     = pProp->uPrice;
+        uMortgageableValue = pProp->uMortgageValue;
+    }
+
+    // a hotel sells back as itself plus the four houses it replaced
+    uint32_t uBuildings = pProp->uHouses + (pProp->bHasHotel ? 5u : 0u);
+    uint32_t uBuildingResaleValue = uBuildings * (pProp->uHouseCost / 2);
+
+    mPlayer* pOwner = &pGame->amPlayers[pProp->uOwnerIndex];
+    if(bAdd)
+    {
+        pOwner->uPropertyValue       += uPropertyValue;
+        pOwner->uMortgageDebt        += uMortgageDebt;
+        pOwner->uMortgageableValue   += uMortgageableValue;
+        pOwner->uBuildingResaleValue += uBuildingResaleValue;
+    }
+    else
+    {
+        pOwner->uPropertyValue       -= uPropertyValue;
+        pOwner->uMortgageDebt        -= uMortgageDebt;
+        pOwner->uMortgageableValue   -= uMortgageableValue;
+        pOwner->uBuildingResaleValue -= uBuildingResaleValue;
+    }
+}
+
+void
+m_set_player_money(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uMoney)
+{
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    if(pPlayer->uMoney == uMoney) return;
+
+    m__record_change(pGame, CHANGE_PLAYER_MONEY, uPlayerIndex, 0, pPlayer->uMoney, uMoney);
+    pPlayer->uMoney = uMoney;
+}
+
+void
+m_add_player_money(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uAmount)
+{
+    m_set_player_money(pGame, uPlayerIndex, pGame->amPlayers[uPlayerIndex].uMoney + uAmount);
+}
+
+void
+m_remove_player_money(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uAmount)
+{
+    m_set_player_money(pGame, uPlayerIndex, pGame->amPlayers[uPlayerIndex].uMoney - uAmount);
+}
+
+void
+m_set_player_position(mGameData* pGame, uint8_t uPlayerIndex, uint8_t uPosition)
+{
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    if(pPlayer->uPosition == uPosition) return;
+
+    m__record_change(pGame, CHANGE_PLAYER_POSITION, uPlayerIndex, 0, pPlayer->uPosition, uPosition);
+    pPlayer->uPosition = uPosition;
+}
+
+void
+m_set_player_jail_turns(mGameData* pGame, uint8_t uPlayerIndex, uint8_t uJailTurns)
+{
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    if(pPlayer->uJailTurns == uJailTurns) return;
+
+    m__record_change(pGame, CHANGE_PLAYER_JAIL_TURNS, uPlayerIndex, 0, pPlayer->uJailTurns, uJailTurns);
+    pPlayer->uJailTurns = uJailTurns;
+}
+
+void
+m_set_player_jail_card(mGameData* pGame, uint8_t uPlayerIndex, bool bHasCard)
+{
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    if(pPlayer->bHasJailFreeCard == bHasCard) return;
+
+    m__record_change(pGame, CHANGE_PLAYER_JAIL_CARD, uPlayerIndex, 0, pPlayer->bHasJailFreeCard, bHasCard);
+    pPlayer->bHasJailFreeCard = bHasCard;
+}
+
+void
+m_set_player_bankrupt(mGameData* pGame, uint8_t uPlayerIndex, bool bIsBankrupt)
+{
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    if(pPlayer->bIsBankrupt == bIsBankrupt) return;
+
+    m__record_change(pGame, CHANGE_PLAYER_BANKRUPT, uPlayerIndex, 0, pPlayer->bIsBankrupt, bIsBankrupt);
+    pPlayer->bIsBankrupt = bIsBankrupt;
+}
+
+void
+m_set_property_owner(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uOwnerIndex)
+{
+    mProperty* pProp = &pGame->amProperties[uPropertyIndex];
+    uint8_t uOldOwner = pProp->uOwnerIndex;
+    if(uOldOwner == uOwnerIndex) return;
+
+    // remove from old owner's list
+    if(uOldOwner != BANK_PLAYER_INDEX)
+    {
+        mPlayer* pOldOwner = &pGame->amPlayers[uOldOwner];
+        for(uint8_t i = 0; i < pOldOwner->uPropertyCount; i++)
+        {
+            if(pOldOwner->auPropertiesOwned[i] == uPropertyIndex)
+            {
+                m__record_change(pGame, CHANGE_PLAYER_PROPERTY_REMOVED, uOldOwner, i, uPropertyIndex, BANK_PLAYER_INDEX);
+                m__remove_owned_property(pOldOwner, i);
+                break;
+            }
+        }
+    }
+
+    m__record_change(pGame, CHANGE_PROPERTY_OWNER, uPropertyIndex, 0, uOldOwner, uOwnerIndex);
+    m__account_property(pGame, uPropertyIndex, false);
+    pProp->uOwnerIndex = uOwnerIndex;
+    m__account_property(pGame, uPropertyIndex, true);
+
+    // append to new owner's list
+    if(uOwnerIndex != BANK_PLAYER_INDEX)
+    {
+        mPlayer* pNewOwner = &pGame->amPlayers[uOwnerIndex];
+        if(pNewOwner->uPropertyCount < PROPERTY_ARRAY_SIZE)
+        {
+            uint8_t uSlot = pNewOwner->uPropertyCount;
+            m__record_change(pGame, CHANGE_PLAYER_PROPERTY_ADDED, uOwnerIndex, uSlot, BANK_PLAYER_INDEX, uPropertyIndex);
+            m__insert_owned_property(pNewOwner, uSlot, uPropertyIndex);
+        }
+    }
+}
+
+void
+m_set_property_houses(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uHouses)
+{
+    mProperty* pProp = &pGame->amProperties[uPropertyIndex];
+    if(pProp->uHouses == uHouses) return;
+
+    m__record_change(pGame, CHANGE_PROPERTY_HOUSES, uPropertyIndex, 0, pProp->uHouses, uHouses);
+    m__account_property(pGame, uPropertyIndex, false);
+    pProp->uHouses = uHouses;
+    m__account_property(pGame, uPropertyIndex, true);
+}
+
+void
+m_set_property_hotel(mGameData* pGame, uint8_t uPropertyIndex, bool bHasHotel)
+{
+    mProperty* pProp = &pGame->amProperties[uPropertyIndex];
+    if(pProp->bHasHotel == bHasHotel) return;
+
+    m__record_change(pGame, CHANGE_PROPERTY_HOTEL, uPropertyIndex, 0, pProp->bHasHotel, bHasHotel);
+    m__account_property(pGame, uPropertyIndex, false);
+    pProp->bHasHotel = bHasHotel;
+    m__account_property(pGame, uPropertyIndex, true);
+}
+
+void
+m_set_property_mortgaged(mGameData* pGame, uint8_t uPropertyIndex, bool bIsMortgaged)
+{
+    mProperty* pProp = &pGame->amProperties[uPropertyIndex];
+    if(pProp->bIsMortgaged == bIsMortgaged) return;
+
+    m__record_change(pGame, CHANGE_PROPERTY_MORTGAGED, uPropertyIndex, 0, pProp->bIsMortgaged, bIsMortgaged);
+    m__account_property(pGame, uPropertyIndex, false);
+    pProp->bIsMortgaged = bIsMortgaged;
+    m__account_property(pGame, uPropertyIndex, true);
+}
+
+void
+m_set_house_supply(mGameData* pGame, uint32_t uSupply)
+{
+    if(pGame->uGlobalHouseSupply == uSupply) return;
+
+    m__record_change(pGame, CHANGE_HOUSE_SUPPLY, 0, 0, pGame->uGlobalHouseSupply, uSupply);
+    pGame->uGlobalHouseSupply = uSupply;
+}
+
+void
+m_set_hotel_supply(mGameData* pGame, uint32_t uSupply)
+{
+    if(pGame->uGlobalHotelSupply == uSupply) return;
+
+    m__record_change(pGame, CHANGE_HOTEL_SUPPLY, 0, 0, pGame->uGlobalHotelSupply, uSupply);
+    pGame->uGlobalHotelSupply = uSupply;
+}
+
+void
+m_set_current_player(mGameData* pGame, uint8_t uPlayerIndex)
+{
+    if(pGame->uCurrentPlayerIndex == uPlayerIndex) return;
+
+    m__record_change(pGame, CHANGE_CURRENT_PLAYER, 0, 0, pGame->uCurrentPlayerIndex, uPlayerIndex);
+    pGame->uCurrentPlayerIndex = uPlayerIndex;
+}
+
+void
+m_set_round_count(mGameData* pGame, uint64_t uRoundCount)
+{
+    if(pGame->uRoundCount == uRoundCount) return;
+
+    // journal keeps the low 32 bits, plenty for any real game
+    m__record_change(pGame, CHANGE_ROUND_COUNT, 0, 0, (uint32_t)pGame->uRoundCount, (uint32_t)uRoundCount);
+    pGame->uRoundCount = uRoundCount;
+}
+
+void
+m_set_active_players(mGameData* pGame, uint8_t uActivePlayers)
+{
+    if(pGame->uActivePlayers == uActivePlayers) return;
+
+    m__record_change(pGame, CHANGE_ACTIVE_PLAYERS, 0, 0, pGame->uActivePlayers, uActivePlayers);
+    pGame->uActivePlayers = uActivePlayers;
+}
+
+void
+m_set_game_running(mGameData* pGame, bool bIsRunning)
+{
+    if(pGame->bIsRunning == bIsRunning) return;
+
+    m__record_change(pGame, CHANGE_GAME_RUNNING, 0, 0, pGame->bIsRunning, bIsRunning);
+    pGame->bIsRunning = bIsRunning;
+}
+
+// only the draw position is journaled, a reshuffle's new order is not
+void
+m_set_deck_index(mGameData* pGame, mDeckState* pDeck, uint8_t uIndex)
+{
+    if(pDeck->uCurrentIndex == uIndex) return;
+
+    uint8_t uDeck = pDeck == &pGame->tChanceDeck ? 0 : 1;
+    m__record_change(pGame, CHANGE_DECK_INDEX, uDeck, 0, pDeck->uCurrentIndex, uIndex);
+    pDeck->uCurrentIndex = uIndex;
+}
+
+// ==================== CHANGE JOURNAL ==================== //
+
+mChangeJournal*
+m_create_change_journal(uint32_t uCapacity)
+{
+    mChangeJournal* pJournal = M_ALLOC(sizeof(mChangeJournal));
+    if(!pJournal) return NULL;
+
+    memset(pJournal, 0, sizeof(mChangeJournal));
+    pJournal->atChanges = M_ALLOC(sizeof(mChange) * uCapacity);
+    if(!pJournal->atChanges)
+    {
+        M_FREE(pJournal);
+        return NULL;
+    }
+    pJournal->uCapacity = uCapacity;
+    return pJournal;
+}
+
+void
+m_free_change_journal(mChangeJournal* pJournal)
+{
+    if(!pJournal) return;
+    M_FREE(pJournal->atChanges);
+    M_FREE(pJournal);
+}
+
+void
+m_clear_change_journal(mChangeJournal* pJournal)
+{
+    if(!pJournal) return;
+    pJournal->uCount     = 0;
+    pJournal->uRedoCount = 0;
+    pJournal->bOverflow  = false;
+}
+
+// writes one side of a journal entry straight into the game without recording it.
+// entries are undone newest first and redone oldest first, so the owned property
+// lists always see the same slot layout they were recorded against.
+static void
+m__apply_change(mGameData* pGame, const mChange* pChange, bool bUndo)
+{
+    uint32_t uValue = bUndo ? pChange->uOldValue : pChange->uNewValue;
+    eChangeField eField = (eChangeField)pChange->uField;
+
+    switch(eField)
+    {
+        case CHANGE_PLAYER_MONEY:      pGame->amPlayers[pChange->uIndex].uMoney           = uValue; break;
+        case CHANGE_PLAYER_POSITION:   pGame->amPlayers[pChange->uIndex].uPosition        = (uint8_t)uValue; break;
+        case CHANGE_PLAYER_JAIL_TURNS: pGame->amPlayers[pChange->uIndex].uJailTurns       = (uint8_t)uValue; break;
+        case CHANGE_PLAYER_JAIL_CARD:  pGame->amPlayers[pChange->uIndex].bHasJailFreeCard = uValue != 0; break;
+        case CHANGE_PLAYER_BANKRUPT:   pGame->amPlayers[pChange->uIndex].bIsBankrupt      = uValue != 0; break;
+
+        case CHANGE_PLAYER_PROPERTY_ADDED:
+            if(bUndo) m__remove_owned_property(&pGame->amPlayers[pChange->uIndex], pChange->uAux);
+            else      m__insert_owned_property(&pGame->amPlayers[pChange->uIndex], pChange->uAux, (uint8_t)uValue);
+            break;
+
+        case CHANGE_PLAYER_PROPERTY_REMOVED:
+            if(bUndo) m__insert_owned_property(&pGame->amPlayers[pChange->uIndex], pChange->uAux, (uint8_t)uValue);
+            else      m__remove_owned_property(&pGame->amPlayers[pChange->uIndex], pChange->uAux);
+            break;
+
+        case CHANGE_PROPERTY_OWNER:
+        case CHANGE_PROPERTY_HOUSES:
+        case CHANGE_PROPERTY_HOTEL:
+        case CHANGE_PROPERTY_MORTGAGED:
+        {
+            mProperty* pProp = &pGame->amProperties[pChange->uIndex];
+            m__account_property(pGame, pChange->uIndex, false);
+            if(eField == CHANGE_PROPERTY_OWNER)       pProp->uOwnerIndex  = (uint8_t)uValue;
+            else if(eField == CHANGE_PROPERTY_HOUSES) pProp->uHouses      = (uint8_t)uValue;
+            else if(eField == CHANGE_PROPERTY_HOTEL)  pProp->bHasHotel    = uValue != 0;
+            else                                      pProp->bIsMortgaged = uValue != 0;
+            m__account_property(pGame, pChange->uIndex, true);
+            break;
+        }
+
+        case CHANGE_HOUSE_SUPPLY:    pGame->uGlobalHouseSupply  = uValue; break;
+        case CHANGE_HOTEL_SUPPLY:    pGame->uGlobalHotelSupply  = uValue; break;
+        case CHANGE_CURRENT_PLAYER:  pGame->uCurrentPlayerIndex = (uint8_t)uValue; break;
+        case CHANGE_ROUND_COUNT:     pGame->uRoundCount         = uValue; break;
+        case CHANGE_ACTIVE_PLAYERS:  pGame->uActivePlayers      = (uint8_t)uValue; break;
+        case CHANGE_GAME_RUNNING:    pGame->bIsRunning          = uValue != 0; break;
+
+        case CHANGE_DECK_INDEX:
+        {
+            mDeckState* pDeck = pChange->uIndex == 0 ? &pGame->tChanceDeck : &pGame->tCommunityChestDeck;
+            pDeck->uCurrentIndex = (uint8_t)uValue;
+            break;
+        }
+
+        default:
+            return;
+    }
+
+    // the state is different from what observers last saw either way
+    m__mark_dirty(pGame, eField, pChange->uIndex);
+}
+
+uint32_t
+m_checkpoint(mGameData* pGame)
+{
+    return pGame->pJournal ? pGame->pJournal->uCount : 0;
+}
+
+bool
+m_rollback(mGameData* pGame, uint32_t uCheckpoint)
+{
+    mChangeJournal* pJournal = pGame->pJournal;
+    if(!pJournal || pJournal->bOverflow || uCheckpoint > pJournal->uCount)
+        return false;
+
+    // undone entries stay in the buffer past uCount so they can be redone
+    while(pJournal->uCount > uCheckpoint)
+    {
+        pJournal->uCount--;
+        pJournal->uRedoCount++;
+        m__apply_change(pGame, &pJournal->atChanges[pJournal->uCount], true);
+    }
+    return true;
+}
+
+bool
+m_redo(mGameData* pGame, uint32_t uCheckpoint)
+{
+    mChangeJournal* pJournal = pGame->pJournal;
+    if(!pJournal || pJournal->bOverflow || uCheckpoint < pJournal->uCount ||
+       uCheckpoint > pJournal->uCount + pJournal->uRedoCount)
+        return false;
+
+    while(pJournal->uCount < uCheckpoint)
+    {
+        m__apply_change(pGame, &pJournal->atChanges[pJournal->uCount], false);
+        pJournal->uCount++;
+        pJournal->uRedoCount--;
+    }
+    return true;
+}
+
+void
+m_clear_dirty(mGameData* pGame)
+{
+    pGame->uDirtyFields     = 0;
+    pGame->uDirtyProperties = 0;
+    pGame->uDirtyPlayers    = 0;
+}
+
+static void
+m__rebuild_player_aggregates(mGameData* pGame, uint8_t uPlayerIndex, mPlayer* pPlayer)
+{
+    pPlayer->uPropertyValue       = 0;
+    pPlayer->uMortgageDebt        = 0;
+    pPlayer->uMortgageableValue   = 0;
+    pPlayer->uBuildingResaleValue = 0;
+
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        mProperty* pProp = &pGame->amProperties[i];
+        if(pProp->uOwnerIndex != uPlayerIndex) continue;
+
+        if(pProp->bIsMortgaged)
+        {
+            pPlayer->uMortgageDebt += pProp->uMortgageValue + (pProp->uMortgageValue / 10);
+        }
+        else
+        {
+            pPlayer->uPropertyValue     += pProp->uPrice;
+            pPlayer->uMortgageableValue += pProp->uMortgageValue;
+        }
+        pPlayer->uBuildingResaleValue += (pProp->uHouses + (pProp->bHasHotel ? 5u : 0u)) * (pProp->uHouseCost / 2);
+    }
+}
+
+void
+m_refresh_player_aggregates(mGameData* pGame)
+{
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+        m__rebuild_player_aggregates(pGame, i, &pGame->amPlayers[i]);
+}
+
+static bool
+m__check_player_invariants(mGameData* pGame, uint8_t uPlayerIndex)
+{
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+
+    if(pPlayer->uPosition >= TOTAL_BOARD_SQUARES) return false;
+    if(pPlayer->uPropertyCount > PROPERTY_ARRAY_SIZE) return false;
+
+    // every listed property must point back at this player
+    for(uint8_t i = 0; i < pPlayer->uPropertyCount; i++)
+    {
+        uint8_t uPropIdx = pPlayer->auPropertiesOwned[i];
+        if(uPropIdx >= TOTAL_PROPERTIES) return false;
+        if(pGame->amProperties[uPropIdx].uOwnerIndex != uPlayerIndex) return false;
+    }
+
+    // running totals must match a fresh walk
+    mPlayer tFresh = *pPlayer;
+    m__rebuild_player_aggregates(pGame, uPlayerIndex, &tFresh);
+    return tFresh.uPropertyValue == pPlayer->uPropertyValue &&
+           tFresh.uMortgageDebt == pPlayer->uMortgageDebt &&
+           tFresh.uMortgageableValue == pPlayer->uMortgageableValue &&
+           tFresh.uBuildingResaleValue == pPlayer->uBuildingResaleValue;
+}
+
+static bool
+m__check_property_invariants(mGameData* pGame, uint8_t uPropertyIndex)
+{
+    mProperty* pProp = &pGame->amProperties[uPropertyIndex];
+
+    if(pProp->uHouses > 4) return false;
+    if(pProp->bHasHotel && pProp->uHouses != 0) return false;
+    if(pProp->eType != PROPERTY_TYPE_STREET && (pProp->uHouses > 0 || pProp->bHasHotel)) return false;
+
+    if(pProp->uOwnerIndex == BANK_PLAYER_INDEX)
+        return pProp->uHouses == 0 && !pProp->bHasHotel && !pProp->bIsMortgaged;
+
+    // owner must list it
+    if(pProp->uOwnerIndex >= pGame->uPlayerCount) return false;
+    mPlayer* pOwner = &pGame->amPlayers[pProp->uOwnerIndex];
+    for(uint8_t i = 0; i < pOwner->uPropertyCount; i++)
+    {
+        if(pOwner->auPropertiesOwned[i] == uPropertyIndex)
+            return true;
+    }
+    return false;
+}
+
+bool
+m_check_change_invariants(mGameData* pGame, const mChangeJournal* pJournal, uint32_t uFirstChange)
+{
+    uint8_t  uPlayersToCheck = 0;
+    uint32_t uPropertiesToCheck = 0;
+    bool     bCheckSupply = false;
+
+    if(pJournal->bOverflow)
+    {
+        // lost track of what changed, check everything
+        uPlayersToCheck    = (uint8_t)((1u << pGame->uPlayerCount) - 1);
+        uPropertiesToCheck = (1u << TOTAL_PROPERTIES) - 1;
+        bCheckSupply       = true;
+    }
+
+    for(uint32_t i = uFirstChange; i < pJournal->uCount; i++)
+    {
+        const mChange* pChange = &pJournal->atChanges[i];
+        switch((eChangeField)pChange->uField)
+        {
+            case CHANGE_PLAYER_MONEY:
+            case CHANGE_PLAYER_POSITION:
+            case CHANGE_PLAYER_JAIL_TURNS:
+            case CHANGE_PLAYER_JAIL_CARD:
+            case CHANGE_PLAYER_BANKRUPT:
+            case CHANGE_PLAYER_PROPERTY_ADDED:
+            case CHANGE_PLAYER_PROPERTY_REMOVED:
+                uPlayersToCheck |= (uint8_t)(1u << pChange->uIndex);
+                break;
+
+            case CHANGE_PROPERTY_OWNER:
+                uPropertiesToCheck |= 1u << pChange->uIndex;
+                if(pChange->uOldValue != BANK_PLAYER_INDEX) uPlayersToCheck |= (uint8_t)(1u << pChange->uOldValue);
+                if(pChange->uNewValue != BANK_PLAYER_INDEX) uPlayersToCheck |= (uint8_t)(1u << pChange->uNewValue);
+                break;
+
+            case CHANGE_PROPERTY_HOUSES:
+            case CHANGE_PROPERTY_HOTEL:
+            case CHANGE_PROPERTY_MORTGAGED:
+            {
+                // the owner's running totals moved too
+                uint8_t uOwner = pGame->amProperties[pChange->uIndex].uOwnerIndex;
+                uPropertiesToCheck |= 1u << pChange->uIndex;
+                if(uOwner < pGame->uPlayerCount) uPlayersToCheck |= (uint8_t)(1u << uOwner);
+                break;
+            }
+
+            case CHANGE_HOUSE_SUPPLY:
+            case CHANGE_HOTEL_SUPPLY:
+                bCheckSupply = true;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        if((uPlayersToCheck & (1u << i)) && !m__check_player_invariants(pGame, i))
+            return false;
+    }
+
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        if((uPropertiesToCheck & (1u << i)) && !m__check_property_invariants(pGame, i))
+            return false;
+    }
+
+    // buildings on the board plus the bank's supply must add up to the full set
+    if(bCheckSupply)
+    {
+        uint32_t uHouses = pGame->uGlobalHouseSupply;
+        uint32_t uHotels = pGame->uGlobalHotelSupply;
+        for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+        {
+            uHouses += pGame->amProperties[i].uHouses;
+            uHotels += pGame->amProperties[i].bHasHotel ? 1 : 0;
+        }
+        if(uHouses != 32 || uHotels != 12)
+            return false;
+    }
+
+    return true;
+}
+
 // ==================== DICE ==================== //
 
 void
@@ -118,25 +802,91 @@ m_roll_dice(mDice* pDice)
 void
 m_move_player(mPlayer* pPlayer, mDice* pDice, mGameData* pGame)
 {
+    uint8_t uPlayerIndex = (uint8_t)(pPlayer - pGame->amPlayers);
     uint8_t uSpacesToMove = pDice->uDie1 + pDice->uDie2;
     uint8_t uOldPosition = pPlayer->uPosition;
     
-    pPlayer->uPosition = (pPlayer->uPosition + uSpacesToMove) % TOTAL_BOARD_SQUARES;
+    m_set_player_position(pGame, uPlayerIndex, (uint8_t)((pPlayer->uPosition + uSpacesToMove) % TOTAL_BOARD_SQUARES));
     
     if(pPlayer->uPosition < uOldPosition || pPlayer->uPosition == 0)
     {
-        pPlayer->uMoney += GO_MONEY;
-        if(pGame)
-            m_set_notification(pGame, "Passed GO! Collected $%d", GO_MONEY);
+        m_add_player_money(pGame, uPlayerIndex, GO_MONEY);
+        m_set_notification(pGame, "Passed GO! Collected $%d", GO_MONEY);
     }
 }
 
 // for sending player to specific location
 void
-m_move_player_to(mPlayer* pPlayer, uint8_t uPosition)
+m_move_player_to(mGameData* pGame, uint8_t uPlayerIndex, uint8_t uPosition)
 {
     if(uPosition >= TOTAL_BOARD_SQUARES) return;
-    pPlayer->uPosition = uPosition;
+    m_set_player_position(pGame, uPlayerIndex, uPosition);
+}
+
+// ==================== STATISTICS ==================== //
+
+static void
+m__stats_record_rent(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPayerIndex, uint8_t uOwnerIndex, uint32_t uAmount)
+{
+    mGameStats* pStats = &pGame->tStats;
+    pStats->auPropertyRent[uPropertyIndex] += uAmount;
+    pStats->auPropertyRentCount[uPropertyIndex]++;
+    pStats->auRentPaid[uPayerIndex] += uAmount;
+    if(uOwnerIndex < MAX_PLAYERS)
+        pStats->auRentReceived[uOwnerIndex] += uAmount;
+    pStats->tTurn.uRentPaid += uAmount;
+    pStats->tTurn.uActions |= (uint8_t)TURN_ACTION_PAID_RENT;
+}
+
+// counts the finished turn and notes anyone who now owns a full street color group
+static void
+m__stats_end_turn(mGameData* pGame)
+{
+    mGameStats* pStats = &pGame->tStats;
+    pStats->uTurns++;
+
+    const mPlayer* pPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
+    pStats->tLastTurn           = pStats->tTurn;
+    pStats->tLastTurn.uTurn     = pStats->uTurns;
+    pStats->tLastTurn.uMoney    = pPlayer->uMoney;
+    pStats->tLastTurn.uPlayer   = pGame->uCurrentPlayerIndex;
+    pStats->tLastTurn.uDie1     = pGame->tDice.uDie1;
+    pStats->tLastTurn.uDie2     = pGame->tDice.uDie2;
+    pStats->tLastTurn.uPosition = pPlayer->uPosition;
+    memset(&pStats->tTurn, 0, sizeof(mTurnRecord));
+
+    bool bAnyMissing = false;
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+        bAnyMissing |= pStats->auFirstMonopolyTurn[i] == 0 && !pGame->amPlayers[i].bIsBankrupt;
+    if(!bAnyMissing)
+        return;
+
+    // one pass over the streets instead of m_owns_color_set per player and color
+    uint8_t auGroupSize[COLOR_RAILROAD] = {0};
+    uint8_t auOwned[MAX_PLAYERS][COLOR_RAILROAD] = {{0}};
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        const mProperty* pProp = &pGame->amProperties[i];
+        if(pProp->eColor >= COLOR_RAILROAD)
+            continue;
+        auGroupSize[pProp->eColor]++;
+        if(pProp->uOwnerIndex < MAX_PLAYERS)
+            auOwned[pProp->uOwnerIndex][pProp->eColor]++;
+    }
+
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        if(pStats->auFirstMonopolyTurn[i] != 0)
+            continue;
+        for(uint8_t uColor = 0; uColor < COLOR_RAILROAD; uColor++)
+        {
+            if(auOwned[i][uColor] == auGroupSize[uColor])
+            {
+                pStats->auFirstMonopolyTurn[i] = pStats->uTurns;
+                break;
+            }
+        }
+    }
 }
 
 // ==================== TURN MANAGEMENT ==================== //
@@ -146,10 +896,11 @@ m_next_player_turn(mGameData* pGame)
 {
     uint8_t uStartingPlayer = pGame->uCurrentPlayerIndex;
     uint8_t uAttempts = 0;
+    m__stats_end_turn(pGame);
     
     while(uAttempts < pGame->uPlayerCount)
     {
-        pGame->uCurrentPlayerIndex = (pGame->uCurrentPlayerIndex + 1) % pGame->uPlayerCount;
+        m_set_current_player(pGame, (pGame->uCurrentPlayerIndex + 1) % pGame->uPlayerCount);
         if(!pGame->amPlayers[pGame->uCurrentPlayerIndex].bIsBankrupt) // skip bankrupt players
         {
             // increment round if we've wrapped back to the first active player after a full cycle
@@ -157,7 +908,7 @@ m_next_player_turn(mGameData* pGame)
             // protects from player one bankrupting messing up round counter
             if(pGame->uCurrentPlayerIndex < uStartingPlayer)
             {
-                pGame->uRoundCount++;
+                m_set_round_count(pGame, pGame->uRoundCount + 1);
             }
             return;
         }
@@ -166,7 +917,7 @@ m_next_player_turn(mGameData* pGame)
     }
     
     // all players bankrupt
-    pGame->bIsRunning = false;
+    m_set_game_running(pGame, false);
 }
 
 // ==================== PROPERTY BUYING ==================== //
@@ -190,16 +941,9 @@ m_buy_property(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPlayerIndex)
     if(pProp->uOwnerIndex != BANK_PLAYER_INDEX) return false;
     if(!m_can_afford(pPlayer, pProp->uPrice)) return false;
     
-    // transfer ownership
-    pPlayer->uMoney -= pProp->uPrice;
-    pProp->uOwnerIndex = uPlayerIndex;
-    
-    // add to player's property list
-    if(pPlayer->uPropertyCount < PROPERTY_ARRAY_SIZE)
-    {
-        pPlayer->auPropertiesOwned[pPlayer->uPropertyCount] = uPropertyIndex;
-        pPlayer->uPropertyCount++;
-    }
+    // transfer ownership (also adds it to the player's property list)
+    m_remove_player_money(pGame, uPlayerIndex, pProp->uPrice);
+    m_set_property_owner(pGame, uPropertyIndex, uPlayerIndex);
     
     return true;
 }
@@ -263,12 +1007,11 @@ m_build_house(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPlayerIndex)
     if(!m_can_build_house(pGame, uPropertyIndex, uPlayerIndex)) return false;
     
     mProperty* pProp = &pGame->amProperties[uPropertyIndex];
-    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
     
     // charge player
-    pPlayer->uMoney -= pProp->uHouseCost;
-    pProp->uHouses++;
-    pGame->uGlobalHouseSupply--;
+    m_remove_player_money(pGame, uPlayerIndex, pProp->uHouseCost);
+    m_set_property_houses(pGame, uPropertyIndex, pProp->uHouses + 1);
+    m_set_house_supply(pGame, pGame->uGlobalHouseSupply - 1);
     
     return true;
 }
@@ -302,18 +1045,17 @@ m_build_hotel(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPlayerIndex)
     if(!m_can_build_hotel(pGame, uPropertyIndex, uPlayerIndex)) return false;
     
     mProperty* pProp = &pGame->amProperties[uPropertyIndex];
-    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
     
     // charge player (same as house cost)
-    pPlayer->uMoney -= pProp->uHouseCost;
+    m_remove_player_money(pGame, uPlayerIndex, pProp->uHouseCost);
     
     // remove 4 houses, add hotel
-    pProp->uHouses = 0;
-    pProp->bHasHotel = true;
+    m_set_property_houses(pGame, uPropertyIndex, 0);
+    m_set_property_hotel(pGame, uPropertyIndex, true);
     
     // update supply (return 4 houses, remove 1 hotel)
-    pGame->uGlobalHouseSupply += 4;
-    pGame->uGlobalHotelSupply--;
+    m_set_house_supply(pGame, pGame->uGlobalHouseSupply + 4);
+    m_set_hotel_supply(pGame, pGame->uGlobalHotelSupply - 1);
     
     return true;
 }
@@ -356,12 +1098,11 @@ m_sell_house(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPlayerIndex)
     if(!m_can_sell_house(pGame, uPropertyIndex, uPlayerIndex)) return false;
     
     mProperty* pProp = &pGame->amProperties[uPropertyIndex];
-    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
     
     // give player half the build cost
-    pPlayer->uMoney += (pProp->uHouseCost / 2);
-    pProp->uHouses--;
-    pGame->uGlobalHouseSupply++;
+    m_add_player_money(pGame, uPlayerIndex, pProp->uHouseCost / 2);
+    m_set_property_houses(pGame, uPropertyIndex, pProp->uHouses - 1);
+    m_set_house_supply(pGame, pGame->uGlobalHouseSupply + 1);
     
     return true;
 }
@@ -387,18 +1128,17 @@ m_sell_hotel(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPlayerIndex)
     if(!m_can_sell_hotel(pGame, uPropertyIndex, uPlayerIndex)) return false;
     
     mProperty* pProp = &pGame->amProperties[uPropertyIndex];
-    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
     
     // give player half the build cost
-    pPlayer->uMoney += (pProp->uHouseCost / 2);
+    m_add_player_money(pGame, uPlayerIndex, pProp->uHouseCost / 2);
     
     // convert hotel to 4 houses
-    pProp->bHasHotel = false;
-    pProp->uHouses = 4;
+    m_set_property_hotel(pGame, uPropertyIndex, false);
+    m_set_property_houses(pGame, uPropertyIndex, 4);
     
     // update supply (remove 4 houses, return 1 hotel)
-    pGame->uGlobalHouseSupply -= 4;
-    pGame->uGlobalHotelSupply++;
+    m_set_house_supply(pGame, pGame->uGlobalHouseSupply - 4);
+    m_set_hotel_supply(pGame, pGame->uGlobalHotelSupply + 1);
     
     return true;
 }
@@ -508,7 +1248,7 @@ m_pay_rent(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPayerIndex)
     // no owner (bank owns) or payer is owner
     if(pProp->uOwnerIndex == BANK_PLAYER_INDEX || pProp->uOwnerIndex == uPayerIndex) return false;
     
-    mPlayer* pOwner = &pGame->amPlayers[pProp->uOwnerIndex];
+    uint8_t uOwnerIndex = pProp->uOwnerIndex;
     uint32_t uRent = m_calculate_rent(pGame, uPropertyIndex);
     
     // special case for utilities: multiply by dice roll
@@ -520,19 +1260,15 @@ m_pay_rent(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPayerIndex)
     // transfer money
     if(pPayer->uMoney >= uRent)
     {
-        pPayer->uMoney -= uRent;
-        pOwner->uMoney += uRent;
+        m_remove_player_money(pGame, uPayerIndex, uRent);
+        m_add_player_money(pGame, uOwnerIndex, uRent);
+        m__stats_record_rent(pGame, uPropertyIndex, uPayerIndex, uOwnerIndex, uRent);
+        M_PROFILE_COUNT(PROFILE_COUNTER_RENTS_PAID, 1);
         return true;
     }
-    else
-    {
-        // player can't afford rent - goes bankrupt
-        pOwner->uMoney += pPayer->uMoney;
-        pPayer->uMoney = 0;
-        pPayer->bIsBankrupt = true;
-        pGame->uActivePlayers--;
-        return false;
-    }
+    
+    // player can't afford rent, the bankruptcy phase liquidates or settles the debt
+    return false;
 }
 
 // ==================== PROPERTY LOOKUP ==================== //
@@ -607,12 +1343,12 @@ m_get_square_name(mGameData* pGame, uint8_t uPosition)
 // ==================== JAIL ==================== //
 
 bool
-m_use_jail_free_card(mPlayer* pPlayer)
+m_use_jail_free_card(mGameData* pGame, uint8_t uPlayerIndex)
 {
-    if(!pPlayer->bHasJailFreeCard) return false;
+    if(!pGame->amPlayers[uPlayerIndex].bHasJailFreeCard) return false;
     
-    pPlayer->bHasJailFreeCard = false;
-    pPlayer->uJailTurns = 0;
+    m_set_player_jail_card(pGame, uPlayerIndex, false);
+    m_set_player_jail_turns(pGame, uPlayerIndex, 0);
     
     return true;
 }
@@ -626,15 +1362,14 @@ m_mortgage_property(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPlayerInd
     if(uPlayerIndex >= pGame->uPlayerCount) return false;
     
     mProperty* pProp = &pGame->amProperties[uPropertyIndex];
-    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
     
     // check ownership and mortgage status
     if(pProp->uOwnerIndex != uPlayerIndex) return false;
     if(pProp->bIsMortgaged) return false;
     
     // mortgage property
-    pProp->bIsMortgaged = true;
-    pPlayer->uMoney += pProp->uMortgageValue;
+    m_set_property_mortgaged(pGame, uPropertyIndex, true);
+    m_add_player_money(pGame, uPlayerIndex, pProp->uMortgageValue);
     
     return true;
 }
@@ -657,8 +1392,8 @@ m_unmortgage_property(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPlayerI
     if(!m_can_afford(pPlayer, uCost)) return false;
     
     // unmortgage property
-    pProp->bIsMortgaged = false;
-    pPlayer->uMoney -= uCost;
+    m_set_property_mortgaged(pGame, uPropertyIndex, false);
+    m_remove_player_money(pGame, uPlayerIndex, uCost);
     
     return true;
 }
@@ -690,11 +1425,12 @@ m_clear_notification(mGameData* pGame)
 void
 m_trigger_card_bankruptcy(mGameData* pGame, mGameFlow* pFlow, uint32_t uAmountOwed)
 {
-    mBankruptcyData* pBankruptcyData = malloc(sizeof(mBankruptcyData));
+    mBankruptcyData* pBankruptcyData = M_ALLOC(sizeof(mBankruptcyData));
     memset(pBankruptcyData, 0, sizeof(mBankruptcyData));
     pBankruptcyData->eBankruptPlayer = pGame->uCurrentPlayerIndex;
     pBankruptcyData->uCreditor = BANK_PLAYER_INDEX;
     pBankruptcyData->uAmountOwed = uAmountOwed;
+    pBankruptcyData->eCause = BANKRUPTCY_CAUSE_CARD;
     m_push_phase(pFlow, m_phase_bankruptcy, pBankruptcyData);
 }
 
@@ -702,13 +1438,14 @@ void
 m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
 {
     mPlayer* pPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
+    uint8_t uPlayerIndex = pGame->uCurrentPlayerIndex;
     
     switch(uCardIdx)
     {
         case 0: // advance to go
         {
-            pPlayer->uPosition = 0;
-            pPlayer->uMoney += GO_MONEY;
+            m_set_player_position(pGame, uPlayerIndex, 0);
+            m_add_player_money(pGame, uPlayerIndex, GO_MONEY);
             break;
         }
         
@@ -716,16 +1453,16 @@ m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
         {
             uint8_t uIllinoisPos = pGame->amProperties[ILLINOIS_AVENUE_PROPERTY_ARRAY_INDEX].uPosition;
             if(pPlayer->uPosition > uIllinoisPos)
-                pPlayer->uMoney += GO_MONEY;
-            pPlayer->uPosition = uIllinoisPos;
+                m_add_player_money(pGame, uPlayerIndex, GO_MONEY);
+            m_set_player_position(pGame, uPlayerIndex, uIllinoisPos);
             break;
         }
         
         case 2: // advance to st. charles place (position 11)
         {
             if(pPlayer->uPosition > 11)
-                pPlayer->uMoney += GO_MONEY;
-            pPlayer->uPosition = 11;
+                m_add_player_money(pGame, uPlayerIndex, GO_MONEY);
+            m_set_player_position(pGame, uPlayerIndex, 11);
             break;
         }
         
@@ -736,13 +1473,13 @@ m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
             
             if(pPlayer->uPosition > uElectricPos && pPlayer->uPosition < uWaterPos)
             {
-                pPlayer->uPosition = uWaterPos;
+                m_set_player_position(pGame, uPlayerIndex, uWaterPos);
             }
             else
             {
                 if(pPlayer->uPosition > uWaterPos)
-                    pPlayer->uMoney += GO_MONEY;
-                pPlayer->uPosition = uElectricPos;
+                    m_add_player_money(pGame, uPlayerIndex, GO_MONEY);
+                m_set_player_position(pGame, uPlayerIndex, uElectricPos);
             }
             break;
         }
@@ -753,43 +1490,45 @@ m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
             if(uCurrent < 5 || uCurrent >= 35)
             {
                 if(uCurrent >= 35)
-                    pPlayer->uMoney += GO_MONEY;
-                pPlayer->uPosition = 5;
+                    m_add_player_money(pGame, uPlayerIndex, GO_MONEY);
+                m_set_player_position(pGame, uPlayerIndex, 5);
             }
             else if(uCurrent < 15)
-                pPlayer->uPosition = 15;
+                m_set_player_position(pGame, uPlayerIndex, 15);
             else if(uCurrent < 25)
-                pPlayer->uPosition = 25;
+                m_set_player_position(pGame, uPlayerIndex, 25);
             else
-                pPlayer->uPosition = 35;
+                m_set_player_position(pGame, uPlayerIndex, 35);
             break;
         }
         
         case 5: // bank pays dividend $50
         {
-            pPlayer->uMoney += 50;
+            m_add_player_money(pGame, uPlayerIndex, 50);
             break;
         }
         
         case 6: // get out of jail free
         {
-            pPlayer->bHasJailFreeCard = true;
+            m_set_player_jail_card(pGame, uPlayerIndex, true);
             break;
         }
         
         case 7: // go back 3 spaces
         {
             if(pPlayer->uPosition < 3)
-                pPlayer->uPosition = 40 + pPlayer->uPosition - 3;
+                m_set_player_position(pGame, uPlayerIndex, (uint8_t)(40 + pPlayer->uPosition - 3));
             else
-                pPlayer->uPosition -= 3;
+                m_set_player_position(pGame, uPlayerIndex, pPlayer->uPosition - 3);
             break;
         }
         
         case 8: // go to jail
         {
-            pPlayer->uPosition = 10;
-            pPlayer->uJailTurns = 1;
+            m_set_player_position(pGame, uPlayerIndex, 10);
+            m_set_player_jail_turns(pGame, uPlayerIndex, 1);
+            pGame->tStats.auJailVisits[uPlayerIndex]++;
+            pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_JAILED;
             break;
         }
         
@@ -816,7 +1555,7 @@ m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
 
             if(pPlayer->uMoney >= uTotalCost)
             {
-                pPlayer->uMoney -= uTotalCost;
+                m_remove_player_money(pGame, uPlayerIndex, uTotalCost);
             }
             else
             {
@@ -829,7 +1568,7 @@ m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
         {
             if(pPlayer->uMoney >= 15)
             {
-                pPlayer->uMoney -= 15;
+                m_remove_player_money(pGame, uPlayerIndex, 15);
             }
             else
             {
@@ -842,14 +1581,14 @@ m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
         {
             uint8_t uReadingPos = pGame->amProperties[READING_RAILROAD_PROPERTY_ARRAY_INDEX].uPosition;
             if(pPlayer->uPosition > uReadingPos)
-                pPlayer->uMoney += GO_MONEY;
-            pPlayer->uPosition = uReadingPos;
+                m_add_player_money(pGame, uPlayerIndex, GO_MONEY);
+            m_set_player_position(pGame, uPlayerIndex, uReadingPos);
             break;
         }
         
         case 12: // boardwalk (position 39)
         {
-            pPlayer->uPosition = 39;
+            m_set_player_position(pGame, uPlayerIndex, 39);
             break;
         }
         
@@ -878,8 +1617,8 @@ m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
                     if(pGame->amPlayers[i].bIsBankrupt)
                         continue;
                     
-                    pPlayer->uMoney -= 50;
-                    pGame->amPlayers[i].uMoney += 50;
+                    m_remove_player_money(pGame, uPlayerIndex, 50);
+                    m_add_player_money(pGame, i, 50);
                 }
             }
             else
@@ -891,13 +1630,13 @@ m_execute_chance_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
         
         case 14: // building loan matures $150
         {
-            pPlayer->uMoney += 150;
+            m_add_player_money(pGame, uPlayerIndex, 150);
             break;
         }
         
         case 15: // crossword competition $100
         {
-            pPlayer->uMoney += 100;
+            m_add_player_money(pGame, uPlayerIndex, 100);
             break;
         }
     }
@@ -907,19 +1646,20 @@ void
 m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pFlow)
 {
     mPlayer* pPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
+    uint8_t uPlayerIndex = pGame->uCurrentPlayerIndex;
     
     switch(uCardIdx)
     {
         case 0: // advance to go
         {
-            pPlayer->uPosition = 0;
-            pPlayer->uMoney += GO_MONEY;
+            m_set_player_position(pGame, uPlayerIndex, 0);
+            m_add_player_money(pGame, uPlayerIndex, GO_MONEY);
             break;
         }
         
         case 1: // bank error $200
         {
-            pPlayer->uMoney += 200;
+            m_add_player_money(pGame, uPlayerIndex, 200);
             break;
         }
         
@@ -927,7 +1667,7 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
         {
             if(pPlayer->uMoney >= 50)
             {
-                pPlayer->uMoney -= 50;
+                m_remove_player_money(pGame, uPlayerIndex, 50);
             }
             else
             {
@@ -938,20 +1678,22 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
         
         case 3: // stock sale $50
         {
-            pPlayer->uMoney += 50;
+            m_add_player_money(pGame, uPlayerIndex, 50);
             break;
         }
         
         case 4: // get out of jail free
         {
-            pPlayer->bHasJailFreeCard = true;
+            m_set_player_jail_card(pGame, uPlayerIndex, true);
             break;
         }
         
         case 5: // go to jail
         {
-            pPlayer->uPosition = 10;
-            pPlayer->uJailTurns = 1;
+            m_set_player_position(pGame, uPlayerIndex, 10);
+            m_set_player_jail_turns(pGame, uPlayerIndex, 1);
+            pGame->tStats.auJailVisits[uPlayerIndex]++;
+            pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_JAILED;
             break;
         }
         
@@ -966,20 +1708,21 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
                 
                 if(pGame->amPlayers[i].uMoney >= 50)
                 {
-                    pGame->amPlayers[i].uMoney -= 50;
-                    pPlayer->uMoney += 50;
+                    m_remove_player_money(pGame, i, 50);
+                    m_add_player_money(pGame, uPlayerIndex, 50);
                 }
                 else
                 {
                     // other player goes bankrupt, current player is creditor
-                    pPlayer->uMoney += pGame->amPlayers[i].uMoney;
-                    pGame->amPlayers[i].uMoney = 0;
+                    m_add_player_money(pGame, uPlayerIndex, pGame->amPlayers[i].uMoney);
+                    m_set_player_money(pGame, i, 0);
                     
-                    mBankruptcyData* pBankruptcyData = malloc(sizeof(mBankruptcyData));
+                    mBankruptcyData* pBankruptcyData = M_ALLOC(sizeof(mBankruptcyData));
                     memset(pBankruptcyData, 0, sizeof(mBankruptcyData));
                     pBankruptcyData->eBankruptPlayer = i;
                     pBankruptcyData->uCreditor = pGame->uCurrentPlayerIndex;
                     pBankruptcyData->uAmountOwed = 50;
+                    pBankruptcyData->eCause = BANKRUPTCY_CAUSE_CARD;
                     m_push_phase(pFlow, m_phase_bankruptcy, pBankruptcyData);
                 }
             }
@@ -988,13 +1731,13 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
         
         case 7: // holiday fund $100
         {
-            pPlayer->uMoney += 100;
+            m_add_player_money(pGame, uPlayerIndex, 100);
             break;
         }
         
         case 8: // income tax refund $20
         {
-            pPlayer->uMoney += 20;
+            m_add_player_money(pGame, uPlayerIndex, 20);
             break;
         }
         
@@ -1009,20 +1752,21 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
                 
                 if(pGame->amPlayers[i].uMoney >= 10)
                 {
-                    pGame->amPlayers[i].uMoney -= 10;
-                    pPlayer->uMoney += 10;
+                    m_remove_player_money(pGame, i, 10);
+                    m_add_player_money(pGame, uPlayerIndex, 10);
                 }
                 else
                 {
                     // other player goes bankrupt, current player is creditor
-                    pPlayer->uMoney += pGame->amPlayers[i].uMoney;
-                    pGame->amPlayers[i].uMoney = 0;
+                    m_add_player_money(pGame, uPlayerIndex, pGame->amPlayers[i].uMoney);
+                    m_set_player_money(pGame, i, 0);
                     
-                    mBankruptcyData* pBankruptcyData = malloc(sizeof(mBankruptcyData));
+                    mBankruptcyData* pBankruptcyData = M_ALLOC(sizeof(mBankruptcyData));
                     memset(pBankruptcyData, 0, sizeof(mBankruptcyData));
                     pBankruptcyData->eBankruptPlayer = i;
                     pBankruptcyData->uCreditor = pGame->uCurrentPlayerIndex;
                     pBankruptcyData->uAmountOwed = 10;
+                    pBankruptcyData->eCause = BANKRUPTCY_CAUSE_CARD;
                     m_push_phase(pFlow, m_phase_bankruptcy, pBankruptcyData);
                 }
             }
@@ -1031,7 +1775,7 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
         
         case 10: // life insurance $100
         {
-            pPlayer->uMoney += 100;
+            m_add_player_money(pGame, uPlayerIndex, 100);
             break;
         }
         
@@ -1039,7 +1783,7 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
         {
             if(pPlayer->uMoney >= 100)
             {
-                pPlayer->uMoney -= 100;
+                m_remove_player_money(pGame, uPlayerIndex, 100);
             }
             else
             {
@@ -1052,7 +1796,7 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
         {
             if(pPlayer->uMoney >= 150)
             {
-                pPlayer->uMoney -= 150;
+                m_remove_player_money(pGame, uPlayerIndex, 150);
             }
             else
             {
@@ -1063,7 +1807,7 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
         
         case 13: // consultancy fee $25
         {
-            pPlayer->uMoney += 25;
+            m_add_player_money(pGame, uPlayerIndex, 25);
             break;
         }
         
@@ -1084,191 +1828,607 @@ m_execute_community_chest_card(mGameData* pGame, uint8_t uCardIdx, mGameFlow* pF
                 }
                 else
                 {
-                    uTotalCost += pProp->uHouses * 40;
+                    uTotalCost += pProp->uHouses * 40;
+                }
+            }
+            
+            if(pPlayer->uMoney >= uTotalCost)
+            {
+                m_remove_player_money(pGame, uPlayerIndex, uTotalCost);
+            }
+            else
+            {
+                m_trigger_card_bankruptcy(pGame, pFlow, uTotalCost);
+            }
+            break;
+        }
+        
+        case 15: // beauty contest $10
+        {
+            m_add_player_money(pGame, uPlayerIndex, 10);
+            break;
+        }
+    }
+}
+
+uint8_t
+m_draw_chance_card(mGameData* pGame)
+{
+    mDeckState* pDeck = &pGame->tChanceDeck;
+    M_PROFILE_COUNT(PROFILE_COUNTER_CARDS_DRAWN, 1);
+    
+    // if deck exhausted, reshuffle (the index reset is journaled, the new order isn't)
+    if(pDeck->uCurrentIndex >= 16)
+    {
+        uint8_t uExhaustedIndex = pDeck->uCurrentIndex;
+        m_shuffle_deck(pDeck);
+        pDeck->uCurrentIndex = uExhaustedIndex;
+        m_set_deck_index(pGame, pDeck, 0);
+    }
+    
+    uint8_t uCardIdx = pDeck->auIndices[pDeck->uCurrentIndex];
+    m_set_deck_index(pGame, pDeck, pDeck->uCurrentIndex + 1);
+    
+    return uCardIdx;
+}
+
+uint8_t
+m_draw_community_chest_card(mGameData* pGame)
+{
+    mDeckState* pDeck = &pGame->tCommunityChestDeck;
+    M_PROFILE_COUNT(PROFILE_COUNTER_CARDS_DRAWN, 1);
+    
+    // if deck exhausted, reshuffle (the index reset is journaled, the new order isn't)
+    if(pDeck->uCurrentIndex >= 16)
+    {
+        uint8_t uExhaustedIndex = pDeck->uCurrentIndex;
+        m_shuffle_deck(pDeck);
+        pDeck->uCurrentIndex = uExhaustedIndex;
+        m_set_deck_index(pGame, pDeck, 0);
+    }
+    
+    uint8_t uCardIdx = pDeck->auIndices[pDeck->uCurrentIndex];
+    m_set_deck_index(pGame, pDeck, pDeck->uCurrentIndex + 1);
+    
+    return uCardIdx;
+}
+
+// property managment 
+int32_t
+m_calculate_net_worth(mGameData* pGame, uint8_t uPlayerIndex)
+{
+    if(uPlayerIndex >= pGame->uPlayerCount) return 0;
+    
+    // unmortgaged properties count at full price, mortgaged ones subtract their payoff
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    return (int32_t)pPlayer->uMoney + (int32_t)pPlayer->uPropertyValue - (int32_t)pPlayer->uMortgageDebt;
+}
+
+uint32_t
+m_get_liquidation_value(mGameData* pGame, uint8_t uPlayerIndex)
+{
+    if(uPlayerIndex >= pGame->uPlayerCount) return 0;
+
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    return pPlayer->uMoney + pPlayer->uBuildingResaleValue + pPlayer->uMortgageableValue;
+}
+
+void
+m_transfer_assets_to_player(mGameData* pGame, uint8_t uFromPlayer, uint8_t uToPlayer)
+{
+    mPlayer* pBankruptPlayer = &pGame->amPlayers[uFromPlayer];
+    
+    // transfer all remaining money
+    m_add_player_money(pGame, uToPlayer, pBankruptPlayer->uMoney);
+    m_set_player_money(pGame, uFromPlayer, 0);
+    
+    // transfer get out of jail free card if they have it
+    if(pBankruptPlayer->bHasJailFreeCard)
+    {
+        m_set_player_jail_card(pGame, uToPlayer, true);
+        m_set_player_jail_card(pGame, uFromPlayer, false);
+    }
+    
+    // transfer all properties in list order (each transfer removes the head of the bankrupt player's list)
+    while(pBankruptPlayer->uPropertyCount > 0)
+    {
+        m_set_property_owner(pGame, pBankruptPlayer->auPropertiesOwned[0], uToPlayer);
+    }
+}
+
+void
+m_transfer_assets_to_bank(mGameData* pGame, uint8_t uFromPlayer)
+{
+    mPlayer* pBankruptPlayer = &pGame->amPlayers[uFromPlayer];
+    
+    // money is lost (bank has inifinate money no need to return)
+    m_set_player_money(pGame, uFromPlayer, 0);
+    
+    // return get out of jail free card to deck if they have it
+    if(pBankruptPlayer->bHasJailFreeCard)
+    {
+        m_set_player_jail_card(pGame, uFromPlayer, false);
+        // card goes back into deck rotation naturally since we track by player ownership
+    }
+    
+    // return all properties to bank (each transfer removes the head of the list)
+    while(pBankruptPlayer->uPropertyCount > 0)
+    {
+        uint8_t uPropIdx = pBankruptPlayer->auPropertiesOwned[0];
+        mProperty* pProp = &pGame->amProperties[uPropIdx];
+        
+        // sell all houses/hotels back to bank
+        if(pProp->uHouses > 0)
+        {
+            m_set_house_supply(pGame, pGame->uGlobalHouseSupply + pProp->uHouses);
+            m_set_property_houses(pGame, uPropIdx, 0);
+        }
+        
+        if(pProp->bHasHotel)
+        {
+            m_set_property_hotel(pGame, uPropIdx, false);
+            m_set_hotel_supply(pGame, pGame->uGlobalHotelSupply + 1);
+        }
+        
+        // unmortgage property (bank takes it back fresh)
+        m_set_property_mortgaged(pGame, uPropIdx, false);
+        
+        // return to bank ownership
+        m_set_property_owner(pGame, uPropIdx, BANK_PLAYER_INDEX);
+    }
+}
+
+// ==================== LIQUIDATION ==================== //
+
+// everything one color group can raise: building sales from the top down (the only
+// order the even selling rule allows), then once the group is bare any set of its
+// unmortgaged properties
+typedef struct _mLiquidationGroup
+{
+    mLiquidationStep atBuildingSteps[15];
+    uint32_t         auBuildingRaised[16];     // totals after the first k steps
+    uint32_t         auBuildingLoss[16];
+    uint8_t          auBuildingPeakNeed[16];   // house supply the first k steps need up front
+    int8_t           aiBuildingSupplyDelta[16];
+    uint8_t          uBuildingStepCount;
+    uint8_t          auMortgageable[4];
+    uint8_t          uMortgageableCount;
+
+    // every option flattened for the dp (see m__liquidation_option)
+    uint8_t          uOptionCount;
+    uint32_t         auOptionUnits[31];   // money raised in solver units
+    uint32_t         auOptionLoss[31];
+    uint8_t          auOptionPeakNeed[31];
+    int8_t           aiOptionSupplyDelta[31];
+} mLiquidationGroup;
+
+static bool
+m__build_liquidation_group(mGameData* pGame, uint8_t uPlayerIndex, ePropertyColor eColor, mLiquidationGroup* pGroup)
+{
+    memset(pGroup, 0, sizeof(mLiquidationGroup));
+
+    uint8_t auProps[4];
+    uint8_t auLevels[4]; // houses, hotel = 5
+    uint8_t uPropCount = 0;
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES && uPropCount < 4; i++)
+    {
+        mProperty* pProp = &pGame->amProperties[i];
+        if(pProp->eColor != eColor || pProp->uOwnerIndex != uPlayerIndex) continue;
+
+        auProps[uPropCount]  = i;
+        auLevels[uPropCount] = pProp->bHasHotel ? 5 : pProp->uHouses;
+        uPropCount++;
+
+        if(!pProp->bIsMortgaged)
+            pGroup->auMortgageable[pGroup->uMortgageableCount++] = i;
+    }
+    if(uPropCount == 0)
+        return false;
+
+    // always sell from the most developed property
+    int32_t iSupplyDelta = 0;
+    uint8_t uPeakNeed = 0;
+    while(pGroup->uBuildingStepCount < 15)
+    {
+        uint8_t uTop = 0;
+        for(uint8_t i = 1; i < uPropCount; i++)
+        {
+            if(auLevels[i] > auLevels[uTop]) uTop = i;
+        }
+        if(auLevels[uTop] == 0) break;
+
+        mProperty* pProp = &pGame->amProperties[auProps[uTop]];
+        mLiquidationStep* pStep = &pGroup->atBuildingSteps[pGroup->uBuildingStepCount];
+        pStep->uPropertyIndex = auProps[uTop];
+
+        if(auLevels[uTop] == 5)
+        {
+            // the hotel comes back as 4 houses from the bank
+            int32_t iNeed = 4 - iSupplyDelta;
+            if(iNeed > uPeakNeed) uPeakNeed = (uint8_t)iNeed;
+            pStep->uAction = LIQUIDATE_SELL_HOTEL;
+            iSupplyDelta -= 4;
+        }
+        else
+        {
+            pStep->uAction = LIQUIDATE_SELL_HOUSE;
+            iSupplyDelta += 1;
+        }
+        auLevels[uTop]--;
+
+        uint8_t k = ++pGroup->uBuildingStepCount;
+        pGroup->auBuildingRaised[k]      = pGroup->auBuildingRaised[k - 1] + pProp->uHouseCost / 2;
+        pGroup->auBuildingLoss[k]        = pGroup->auBuildingLoss[k - 1] + (pProp->uHouseCost - pProp->uHouseCost / 2);
+        pGroup->auBuildingPeakNeed[k]    = uPeakNeed;
+        pGroup->aiBuildingSupplyDelta[k] = (int8_t)iSupplyDelta;
+    }
+    return true;
+}
+
+// options are 0..B = sell the first k buildings, B + mask = sell them all and mortgage the masked set
+static uint8_t
+m__liquidation_option_count(const mLiquidationGroup* pGroup)
+{
+    return (uint8_t)(pGroup->uBuildingStepCount + (1u << pGroup->uMortgageableCount));
+}
+
+static void
+m__liquidation_option(mGameData* pGame, const mLiquidationGroup* pGroup, uint8_t uOption, uint32_t* puRaised, uint32_t* puLoss, uint8_t* puPeakNeed, int32_t* piSupplyDelta)
+{
+    uint8_t uBuildings = uOption < pGroup->uBuildingStepCount ? uOption : pGroup->uBuildingStepCount;
+    *puRaised      = pGroup->auBuildingRaised[uBuildings];
+    *puLoss        = pGroup->auBuildingLoss[uBuildings];
+    *puPeakNeed    = pGroup->auBuildingPeakNeed[uBuildings];
+    *piSupplyDelta = pGroup->aiBuildingSupplyDelta[uBuildings];
+
+    uint32_t uMask = uOption > pGroup->uBuildingStepCount ? uOption - pGroup->uBuildingStepCount : 0;
+    for(uint8_t i = 0; i < pGroup->uMortgageableCount; i++)
+    {
+        if(!(uMask & (1u << i))) continue;
+        mProperty* pProp = &pGame->amProperties[pGroup->auMortgageable[i]];
+        *puRaised += pProp->uMortgageValue;
+        *puLoss   += pProp->uMortgageValue / 10; // what it costs to lift the mortgage later
+    }
+}
+
+static uint32_t
+m__gcd(uint32_t uA, uint32_t uB)
+{
+    while(uB)
+    {
+        uint32_t uT = uA % uB;
+        uA = uB;
+        uB = uT;
+    }
+    return uA;
+}
+
+// dp states the solver has room for, ~38 KB of scratch (one per thread, see m_plan_liquidation)
+#define LIQUIDATION_MAX_STATES 1024
+
+// scratch for one liquidation dp, state index = raised units * supply rows + house supply.
+// supply is capped at the most all hotel groups could ever need together, anything
+// above that can't change which options are possible
+typedef struct _mLiquidationSolver
+{
+    mGameData*        pGame;
+    mLiquidationGroup atGroups[COLOR_NONE];
+    uint8_t           uGroupCount;
+    uint32_t          uUnit;        // gcd of every amount (or coarser, see m_plan_liquidation), the dp counts in these
+    uint32_t          uNeedUnits;   // shortfall, raised money is capped here
+    uint32_t          uSupplyRows;  // house supply tracked as 0..rows-1, 1 = not tracked
+    uint32_t          uStateCount;  // (need units + 1) * supply rows, at most LIQUIDATION_MAX_STATES
+    uint32_t          auLoss[LIQUIDATION_MAX_STATES * 2];               // two layers
+    uint8_t           auChoice[LIQUIDATION_MAX_STATES * COLOR_NONE];    // option per group per state
+    uint16_t          auPrevious[LIQUIDATION_MAX_STATES * COLOR_NONE];  // previous state per group per state
+} mLiquidationSolver;
+
+// multiple choice knapsack over the groups in the given order, one option each.
+// returns the least loss that covers the shortfall (UINT32_MAX if none) and the options.
+static uint32_t
+m__solve_liquidation(mLiquidationSolver* ptSolver, const uint8_t* auOrder, uint8_t* auOptionsOut)
+{
+    uint32_t uStateCount  = ptSolver->uStateCount;
+    uint32_t uSupplyRows  = ptSolver->uSupplyRows;
+    bool     bTrackSupply = uSupplyRows > 1;
+    uint32_t uSupplyCap   = uSupplyRows - 1;
+    uint32_t uStartSupply = ptSolver->pGame->uGlobalHouseSupply;
+
+    uint32_t* auCurrent = ptSolver->auLoss;
+    uint32_t* auNext    = ptSolver->auLoss + uStateCount;
+    for(uint32_t i = 0; i < uStateCount; i++)
+        auCurrent[i] = UINT32_MAX;
+    auCurrent[uStartSupply < uSupplyCap ? uStartSupply : uSupplyCap] = 0;
+
+    for(uint8_t g = 0; g < ptSolver->uGroupCount; g++)
+    {
+        const mLiquidationGroup* pGroup = &ptSolver->atGroups[auOrder[g]];
+        uint8_t*  auGroupChoice   = &ptSolver->auChoice[g * uStateCount];
+        uint16_t* auGroupPrevious = &ptSolver->auPrevious[g * uStateCount];
+
+        for(uint32_t i = 0; i < uStateCount; i++)
+            auNext[i] = UINT32_MAX;
+
+        for(uint32_t uState = 0; uState < uStateCount; uState++)
+        {
+            if(auCurrent[uState] == UINT32_MAX) continue;
+            uint32_t uRaisedUnits = uState / uSupplyRows;
+            uint32_t uSupply      = uState % uSupplyRows;
+
+            for(uint8_t o = 0; o < pGroup->uOptionCount; o++)
+            {
+                if(bTrackSupply && uSupply < pGroup->auOptionPeakNeed[o]) continue;
+
+                uint32_t uNewRaised = uRaisedUnits + pGroup->auOptionUnits[o];
+                if(uNewRaised > ptSolver->uNeedUnits) uNewRaised = ptSolver->uNeedUnits;
+                uint32_t uNewSupply = bTrackSupply ? (uint32_t)((int32_t)uSupply + pGroup->aiOptionSupplyDelta[o]) : 0;
+                if(uNewSupply > uSupplyCap) uNewSupply = uSupplyCap;
+                uint32_t uNewState  = uNewRaised * uSupplyRows + uNewSupply;
+
+                uint32_t uNewLoss = auCurrent[uState] + pGroup->auOptionLoss[o];
+                if(uNewLoss < auNext[uNewState])
+                {
+                    auNext[uNewState]          = uNewLoss;
+                    auGroupChoice[uNewState]   = o;
+                    auGroupPrevious[uNewState] = (uint16_t)uState;
                 }
             }
-            
-            if(pPlayer->uMoney >= uTotalCost)
-            {
-                pPlayer->uMoney -= uTotalCost;
-            }
-            else
-            {
-                m_trigger_card_bankruptcy(pGame, pFlow, uTotalCost);
-            }
-            break;
-        }
-        
-        case 15: // beauty contest $10
-        {
-            pPlayer->uMoney += 10;
-            break;
         }
+
+        uint32_t* pSwap = auCurrent;
+        auCurrent = auNext;
+        auNext = pSwap;
     }
-}
 
-uint8_t
-m_draw_chance_card(mGameData* pGame)
-{
-    mDeckState* pDeck = &pGame->tChanceDeck;
-    
-    // if deck exhausted, reshuffle
-    if(pDeck->uCurrentIndex >= 16)
+    // cheapest state that covers the shortfall
+    uint32_t uBestState = UINT32_MAX;
+    for(uint32_t uSupply = 0; uSupply < uSupplyRows; uSupply++)
     {
-        m_shuffle_deck(pDeck);
+        uint32_t uState = ptSolver->uNeedUnits * uSupplyRows + uSupply;
+        if(auCurrent[uState] == UINT32_MAX) continue;
+        if(uBestState == UINT32_MAX || auCurrent[uState] < auCurrent[uBestState])
+            uBestState = uState;
     }
-    
-    uint8_t uCardIdx = pDeck->auIndices[pDeck->uCurrentIndex];
-    pDeck->uCurrentIndex++;
-    
-    return uCardIdx;
+    if(uBestState == UINT32_MAX)
+        return UINT32_MAX;
+
+    // walk back to find each group's option
+    uint32_t uBestLoss = auCurrent[uBestState];
+    uint32_t uState = uBestState;
+    for(uint8_t g = ptSolver->uGroupCount; g-- > 0;)
+    {
+        auOptionsOut[g] = ptSolver->auChoice[g * uStateCount + uState];
+        uState = ptSolver->auPrevious[g * uStateCount + uState];
+    }
+    return uBestLoss;
 }
 
-uint8_t
-m_draw_community_chest_card(mGameData* pGame)
+static bool
+m__next_permutation(uint8_t* auValues, uint8_t uCount)
 {
-    mDeckState* pDeck = &pGame->tCommunityChestDeck;
-    
-    // if deck exhausted, reshuffle
-    if(pDeck->uCurrentIndex >= 16)
+    if(uCount < 2) return false;
+
+    uint8_t i = uCount - 1;
+    while(i > 0 && auValues[i - 1] >= auValues[i]) i--;
+    if(i == 0) return false;
+
+    uint8_t j = uCount - 1;
+    while(auValues[j] <= auValues[i - 1]) j--;
+    uint8_t uTemp = auValues[i - 1]; auValues[i - 1] = auValues[j]; auValues[j] = uTemp;
+
+    for(uint8_t k = uCount - 1; i < k; i++, k--)
     {
-        m_shuffle_deck(pDeck);
+        uTemp = auValues[i]; auValues[i] = auValues[k]; auValues[k] = uTemp;
     }
-    
-    uint8_t uCardIdx = pDeck->auIndices[pDeck->uCurrentIndex];
-    pDeck->uCurrentIndex++;
-    
-    return uCardIdx;
+    return true;
 }
 
-// property managment 
-int32_t
-m_calculate_net_worth(mGameData* pGame, uint8_t uPlayerIndex)
+bool
+m_plan_liquidation(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uAmountOwed, mLiquidationPlan* pPlanOut)
 {
-    if(uPlayerIndex >= pGame->uPlayerCount) return 0;
-    
+    memset(pPlanOut, 0, sizeof(mLiquidationPlan));
+    if(uPlayerIndex >= pGame->uPlayerCount) return false;
+
     mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
-    int32_t iNetWorth = (int32_t)pPlayer->uMoney;
-    
-    for(uint8_t i = 0; i < pPlayer->uPropertyCount; i++)
+    if(pPlayer->uMoney >= uAmountOwed) return true;
+    if(m_get_liquidation_value(pGame, uPlayerIndex) < uAmountOwed) return false;
+    uint32_t uShortfall = uAmountOwed - pPlayer->uMoney;
+
+    // ~41 KB, too big for worker thread stacks (ai rollouts and game workers plan too)
+    static M_THREAD_LOCAL mLiquidationSolver tSolver;
+    memset(&tSolver, 0, sizeof(mLiquidationSolver));
+    tSolver.pGame = pGame;
+
+    uint8_t  auOrder[COLOR_NONE];
+    uint8_t  uHotelGroupCount = 0;
+    uint32_t uTotalPeakNeed = 0;
+    for(uint8_t i = 0; i < COLOR_NONE; i++)
     {
-        uint8_t uPropIdx = pPlayer->auPropertiesOwned[i];
-        if(uPropIdx == BANK_PLAYER_INDEX)
-            break;
-        
-        mProperty* pProp = &pGame->amProperties[uPropIdx];
-        
-        if(pProp->bIsMortgaged)
+        mLiquidationGroup* pGroup = &tSolver.atGroups[tSolver.uGroupCount];
+        if(!m__build_liquidation_group(pGame, uPlayerIndex, (ePropertyColor)i, pGroup))
+            continue;
+        if(pGroup->uBuildingStepCount == 0 && pGroup->uMortgageableCount == 0)
+            continue;
+
+        // every amount is a multiple of the gcd, so the dp can count in those units
+        for(uint8_t j = 0; j < pGroup->uBuildingStepCount; j++)
+            tSolver.uUnit = m__gcd(tSolver.uUnit, pGroup->auBuildingRaised[j + 1] - pGroup->auBuildingRaised[j]);
+        for(uint8_t j = 0; j < pGroup->uMortgageableCount; j++)
+            tSolver.uUnit = m__gcd(tSolver.uUnit, pGame->amProperties[pGroup->auMortgageable[j]].uMortgageValue);
+
+        uint8_t uPeakNeed = pGroup->auBuildingPeakNeed[pGroup->uBuildingStepCount];
+        if(uPeakNeed > 0)
         {
-            // subtract mortgage debt (mortgage value + 10%)
-            uint32_t uDebt = pProp->uMortgageValue + (pProp->uMortgageValue / 10);
-            iNetWorth -= (int32_t)uDebt;
+            uHotelGroupCount++;
+            uTotalPeakNeed += uPeakNeed;
         }
-        else
+        tSolver.uGroupCount++;
+    }
+    if(tSolver.uGroupCount == 0 || tSolver.uUnit == 0) return false;
+
+    // supply only needs tracking if the bank could run short
+    bool bSupplyShort = pGame->uGlobalHouseSupply < uTotalPeakNeed;
+    tSolver.uSupplyRows = bSupplyShort ? (uTotalPeakNeed < 32 ? uTotalPeakNeed : 32) + 1 : 1;
+
+    // a shortfall too big for the scratch is counted in coarser units. options round
+    // down to whole units, so a plan found this way still covers the debt, but a debt
+    // that only just can be covered may get no plan (m_phase_bankruptcy falls back)
+    uint32_t uMaxNeedUnits = LIQUIDATION_MAX_STATES / tSolver.uSupplyRows - 1;
+    if((uShortfall + tSolver.uUnit - 1) / tSolver.uUnit > uMaxNeedUnits)
+        tSolver.uUnit = (uShortfall + uMaxNeedUnits - 1) / uMaxNeedUnits;
+    tSolver.uNeedUnits  = (uShortfall + tSolver.uUnit - 1) / tSolver.uUnit;
+    tSolver.uStateCount = (tSolver.uNeedUnits + 1) * tSolver.uSupplyRows;
+
+    // groups are sold in dp order: ones that only hand houses back go first, then the
+    // ones whose hotels need houses from the bank, least needy first
+    for(uint8_t i = 0; i < tSolver.uGroupCount; i++)
+        auOrder[i] = i;
+    for(uint8_t i = 1; i < tSolver.uGroupCount; i++)
+    {
+        uint8_t uGroup = auOrder[i];
+        uint8_t uNeed = tSolver.atGroups[uGroup].auBuildingPeakNeed[tSolver.atGroups[uGroup].uBuildingStepCount];
+        uint8_t j = i;
+        while(j > 0 && tSolver.atGroups[auOrder[j - 1]].auBuildingPeakNeed[tSolver.atGroups[auOrder[j - 1]].uBuildingStepCount] > uNeed)
         {
-            // add full property value
-            iNetWorth += (int32_t)pProp->uPrice;
+            auOrder[j] = auOrder[j - 1];
+            j--;
         }
+        auOrder[j] = uGroup;
     }
-    
-    return iNetWorth;
-}
 
-void
-m_transfer_assets_to_player(mGameData* pGame, uint8_t uFromPlayer, uint8_t uToPlayer)
-{
-    mPlayer* pBankruptPlayer = &pGame->amPlayers[uFromPlayer];
-    mPlayer* pCreditor = &pGame->amPlayers[uToPlayer];
-    
-    // transfer all remaining money
-    pCreditor->uMoney += pBankruptPlayer->uMoney;
-    pBankruptPlayer->uMoney = 0;
-    
-    // transfer get out of jail free card if they have it
-    if(pBankruptPlayer->bHasJailFreeCard)
+    // flatten the options now the unit is known
+    for(uint8_t g = 0; g < tSolver.uGroupCount; g++)
     {
-        pCreditor->bHasJailFreeCard = true;
-        pBankruptPlayer->bHasJailFreeCard = false;
+        mLiquidationGroup* pGroup = &tSolver.atGroups[g];
+        pGroup->uOptionCount = m__liquidation_option_count(pGroup);
+        for(uint8_t o = 0; o < pGroup->uOptionCount; o++)
+        {
+            uint32_t uRaised;
+            int32_t  iSupplyDelta;
+            m__liquidation_option(pGame, pGroup, o, &uRaised, &pGroup->auOptionLoss[o], &pGroup->auOptionPeakNeed[o], &iSupplyDelta);
+            pGroup->auOptionUnits[o]       = uRaised / tSolver.uUnit;
+            pGroup->aiOptionSupplyDelta[o] = (int8_t)iSupplyDelta;
+        }
     }
-    
-    // transfer all properties
-    for(uint8_t i = 0; i < pBankruptPlayer->uPropertyCount; i++)
+
+    uint8_t  auBestOrder[COLOR_NONE];
+    uint8_t  auBestOptions[COLOR_NONE];
+    uint32_t uBestLoss = m__solve_liquidation(&tSolver, auOrder, auBestOptions);
+    memcpy(auBestOrder, auOrder, sizeof(auOrder));
+
+    // when the bank is short of houses the order the hotel groups are broken up in
+    // matters, try every order of a few of them (the rest always goes first)
+    if(bSupplyShort && uHotelGroupCount > 1 && uHotelGroupCount <= 4)
     {
-        uint8_t uPropIdx = pBankruptPlayer->auPropertiesOwned[i];
-        if(uPropIdx == BANK_PLAYER_INDEX)
-            break;
-        
-        mProperty* pProp = &pGame->amProperties[uPropIdx];
-        
-        // change ownership
-        pProp->uOwnerIndex = uToPlayer;
-        
-        // add to creditor's property list
-        if(pCreditor->uPropertyCount < PROPERTY_ARRAY_SIZE)
+        uint8_t* auHotelOrder = &auOrder[tSolver.uGroupCount - uHotelGroupCount];
+        uint8_t  auOptions[COLOR_NONE];
+
+        // start from the lowest permutation so every order is visited
+        for(uint8_t i = 1; i < uHotelGroupCount; i++)
         {
-            pCreditor->auPropertiesOwned[pCreditor->uPropertyCount] = uPropIdx;
-            pCreditor->uPropertyCount++;
+            for(uint8_t j = i; j > 0 && auHotelOrder[j - 1] > auHotelOrder[j]; j--)
+            {
+                uint8_t uTemp = auHotelOrder[j]; auHotelOrder[j] = auHotelOrder[j - 1]; auHotelOrder[j - 1] = uTemp;
+            }
         }
+
+        do
+        {
+            uint32_t uLoss = m__solve_liquidation(&tSolver, auOrder, auOptions);
+            if(uLoss < uBestLoss)
+            {
+                uBestLoss = uLoss;
+                memcpy(auBestOrder, auOrder, sizeof(auOrder));
+                memcpy(auBestOptions, auOptions, sizeof(auOptions));
+            }
+        } while(m__next_permutation(auHotelOrder, uHotelGroupCount));
     }
-    
-    // clear bankrupt player's property list
-    pBankruptPlayer->uPropertyCount = 0;
-    for(uint8_t i = 0; i < PROPERTY_ARRAY_SIZE; i++)
+
+    if(uBestLoss == UINT32_MAX)
+        return false;
+
+    // emit steps group by group
+    for(uint8_t g = 0; g < tSolver.uGroupCount; g++)
     {
-        pBankruptPlayer->auPropertiesOwned[i] = BANK_PLAYER_INDEX;
+        const mLiquidationGroup* pGroup = &tSolver.atGroups[auBestOrder[g]];
+        uint8_t uOption = auBestOptions[g];
+        uint32_t uRaised, uLoss;
+        uint8_t  uPeakNeed;
+        int32_t  iSupplyDelta;
+        m__liquidation_option(pGame, pGroup, uOption, &uRaised, &uLoss, &uPeakNeed, &iSupplyDelta);
+        pPlanOut->uRaised += uRaised;
+        pPlanOut->uLoss   += uLoss;
+
+        uint8_t uBuildings = uOption < pGroup->uBuildingStepCount ? uOption : pGroup->uBuildingStepCount;
+        for(uint8_t i = 0; i < uBuildings; i++)
+            pPlanOut->atSteps[pPlanOut->uStepCount++] = pGroup->atBuildingSteps[i];
+
+        uint32_t uMask = uOption > pGroup->uBuildingStepCount ? uOption - pGroup->uBuildingStepCount : 0;
+        for(uint8_t i = 0; i < pGroup->uMortgageableCount; i++)
+        {
+            if(!(uMask & (1u << i))) continue;
+            mLiquidationStep* pStep = &pPlanOut->atSteps[pPlanOut->uStepCount++];
+            pStep->uPropertyIndex = pGroup->auMortgageable[i];
+            pStep->uAction        = LIQUIDATE_MORTGAGE;
+        }
     }
+    return true;
 }
 
-void
-m_transfer_assets_to_bank(mGameData* pGame, uint8_t uFromPlayer)
+bool
+m_execute_liquidation_plan(mGameData* pGame, uint8_t uPlayerIndex, const mLiquidationPlan* pPlan)
 {
-    mPlayer* pBankruptPlayer = &pGame->amPlayers[uFromPlayer];
-    
-    // money is lost (bank has inifinate money no need to return)
-    pBankruptPlayer->uMoney = 0;
-    
-    // return get out of jail free card to deck if they have it
-    if(pBankruptPlayer->bHasJailFreeCard)
-    {
-        pBankruptPlayer->bHasJailFreeCard = false;
-        // card goes back into deck rotation naturally since we track by player ownership
-    }
-    
-    // return all properties to bank
-    for(uint8_t i = 0; i < pBankruptPlayer->uPropertyCount; i++)
+    for(uint8_t i = 0; i < pPlan->uStepCount; i++)
     {
-        uint8_t uPropIdx = pBankruptPlayer->auPropertiesOwned[i];
-        if(uPropIdx == BANK_PLAYER_INDEX)
-            break;
-        
-        mProperty* pProp = &pGame->amProperties[uPropIdx];
-        
-        // sell all houses/hotels back to bank
-        while(pProp->uHouses > 0)
-        {
-            pProp->uHouses--;
-            pGame->uGlobalHouseSupply++;
-        }
-        
-        if(pProp->bHasHotel)
+        const mLiquidationStep* pStep = &pPlan->atSteps[i];
+        bool bDone = false;
+        switch((eLiquidationAction)pStep->uAction)
         {
-            pProp->bHasHotel = false;
-            pGame->uGlobalHotelSupply++;
+            case LIQUIDATE_SELL_HOTEL: bDone = m_sell_hotel(pGame, pStep->uPropertyIndex, uPlayerIndex); break;
+            case LIQUIDATE_SELL_HOUSE: bDone = m_sell_house(pGame, pStep->uPropertyIndex, uPlayerIndex); break;
+            case LIQUIDATE_MORTGAGE:   bDone = m_mortgage_property(pGame, pStep->uPropertyIndex, uPlayerIndex); break;
         }
-        
-        // unmortgage property (bank takes it back fresh)
-        pProp->bIsMortgaged = false;
-        
-        // return to bank ownership
-        pProp->uOwnerIndex = BANK_PLAYER_INDEX;
+        if(!bDone) return false; // stale plan
     }
-    
-    // clear bankrupt player's property list
-    pBankruptPlayer->uPropertyCount = 0;
-    for(uint8_t i = 0; i < PROPERTY_ARRAY_SIZE; i++)
+    return true;
+}
+
+// true when none of the player's properties of this color have buildings (mortgaging allowed)
+static bool
+m__color_group_bare(mGameData* pGame, uint8_t uPlayerIndex, ePropertyColor eColor)
+{
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        mProperty* pProp = &pGame->amProperties[i];
+        if(pProp->eColor == eColor && pProp->uOwnerIndex == uPlayerIndex && (pProp->uHouses > 0 || pProp->bHasHotel))
+            return false;
+    }
+    return true;
+}
+
+// raises money a step at a time until the debt is covered or nothing is left to sell: mortgages
+// first (they lose the least), then houses, then hotels as the bank has houses to break them into
+static bool
+m__liquidate_in_order(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uAmountOwed)
+{
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    while(pPlayer->uMoney < uAmountOwed)
     {
-        pBankruptPlayer->auPropertiesOwned[i] = BANK_PLAYER_INDEX;
+        bool bRaised = false;
+        for(uint8_t i = 0; i < TOTAL_PROPERTIES && !bRaised; i++)
+        {
+            mProperty* pProp = &pGame->amProperties[i];
+            if(pProp->uOwnerIndex == uPlayerIndex && !pProp->bIsMortgaged && m__color_group_bare(pGame, uPlayerIndex, pProp->eColor))
+                bRaised = m_mortgage_property(pGame, i, uPlayerIndex);
+        }
+        for(uint8_t i = 0; i < TOTAL_PROPERTIES && !bRaised; i++)
+            bRaised = m_sell_house(pGame, i, uPlayerIndex);
+        for(uint8_t i = 0; i < TOTAL_PROPERTIES && !bRaised; i++)
+            bRaised = m_sell_hotel(pGame, i, uPlayerIndex);
+        if(!bRaised)
+            return false;
     }
+    return true;
 }
 
 // ==================== PHASES ==================== //
@@ -1282,10 +2442,13 @@ m_phase_pre_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
     
     if(pPlayer->uJailTurns > 0)
     {
-        mJailData* pJail = malloc(sizeof(mJailData));
+        pGame->tStats.auJailTurns[pGame->uCurrentPlayerIndex]++;
+        pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_IN_JAIL;
+
+        mJailData* pJail = M_ALLOC(sizeof(mJailData));
         memset(pJail, 0, sizeof(mJailData));
         
-        free(pPreRoll);
+        M_FREE(pPreRoll);
         pFlow->pCurrentPhaseData = pJail;
         pFlow->pfCurrentPhase = m_phase_jail;
         
@@ -1312,7 +2475,7 @@ m_phase_pre_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
     {
         case 1:
         {
-            mPropertyManagementData* pPropMgmt = malloc(sizeof(mPropertyManagementData));
+            mPropertyManagementData* pPropMgmt = M_ALLOC(sizeof(mPropertyManagementData));
             memset(pPropMgmt, 0, sizeof(mPropertyManagementData));
 
             m_push_phase(pFlow, m_phase_property_management, pPropMgmt);
@@ -1324,7 +2487,7 @@ m_phase_pre_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
         
         case 2:
         {
-            mTradeData* pTradeData = malloc(sizeof(mTradeData));
+            mTradeData* pTradeData = M_ALLOC(sizeof(mTradeData));
             memset(pTradeData, 0, sizeof(mTradeData));
             pTradeData->eStep = TRADE_STEP_SELECT_PLAYER;
             m_push_phase(pFlow, m_phase_trade, pTradeData);
@@ -1338,10 +2501,10 @@ m_phase_pre_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
             
             m_roll_dice(&pGame->tDice);
             
-            mPostRollData* pPostRoll = malloc(sizeof(mPostRollData));
+            mPostRollData* pPostRoll = M_ALLOC(sizeof(mPostRollData));
             memset(pPostRoll, 0, sizeof(mPostRollData));
             
-            free(pPreRoll);
+            M_FREE(pPreRoll);
             pFlow->pCurrentPhaseData = pPostRoll;
             pFlow->pfCurrentPhase = m_phase_post_roll;
             
@@ -1362,6 +2525,7 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
     mPostRollData* pPostRoll = (mPostRollData*)pPhaseData;
     mGameData* pGame = pFlow->pGame;
     mPlayer* pPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
+    uint8_t uPlayerIndex = pGame->uCurrentPlayerIndex;
     
     // move player if not already done
     if(!pPostRoll->bMovedPlayer)
@@ -1414,6 +2578,7 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                     {
                         if(m_buy_property(pGame, pPostRoll->uPropertyIndex, pGame->uCurrentPlayerIndex))
                         {
+                            pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_BOUGHT;
                             m_set_notification(pGame, "Bought %s for $%d", pProp->cName, pProp->uPrice);
                         }
                         else
@@ -1425,25 +2590,26 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                     }
                     else if(iChoice == 2) // pass - start auction
                     {
-                        mAuctionData* pAuction = malloc(sizeof(mAuctionData));
+                        mAuctionData* pAuction = M_ALLOC(sizeof(mAuctionData));
                         memset(pAuction, 0, sizeof(mAuctionData));
 
                         pAuction->ePropertyIndex = pPostRoll->uPropertyIndex;
 
                         m_push_phase(pFlow, m_phase_auction, pAuction);
+                        pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_AUCTIONED;
                         pPostRoll->bHandledLanding = true;  
                         return PHASE_RUNNING;
                     }
                     else if(iChoice == 3) // manage properties
                     {
-                        mPropertyManagementData* pPropMgmt = malloc(sizeof(mPropertyManagementData));
+                        mPropertyManagementData* pPropMgmt = M_ALLOC(sizeof(mPropertyManagementData));
                         memset(pPropMgmt, 0, sizeof(mPropertyManagementData));
                         m_push_phase(pFlow, m_phase_property_management, pPropMgmt);
                         // don't set bHandledLanding - return to property decision after managing
                     }
                     else if(iChoice == 4) // propose trade (from property menu)
                     {
-                        mTradeData* pTradeData = malloc(sizeof(mTradeData));
+                        mTradeData* pTradeData = M_ALLOC(sizeof(mTradeData));
                         memset(pTradeData, 0, sizeof(mTradeData));
                         pTradeData->eStep = TRADE_STEP_SELECT_PLAYER;
                         m_push_phase(pFlow, m_phase_trade, pTradeData);
@@ -1475,11 +2641,13 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                     else
                     {
                         // trigger bankruptcy phase
-                        mBankruptcyData* pBankruptcyData = malloc(sizeof(mBankruptcyData));
+                        mBankruptcyData* pBankruptcyData = M_ALLOC(sizeof(mBankruptcyData));
                         memset(pBankruptcyData, 0, sizeof(mBankruptcyData));
                         pBankruptcyData->eBankruptPlayer = pGame->uCurrentPlayerIndex;
                         pBankruptcyData->uCreditor = pProp->uOwnerIndex;
                         pBankruptcyData->uAmountOwed = uRent;
+                        pBankruptcyData->eCause = BANKRUPTCY_CAUSE_RENT;
+                        pBankruptcyData->uPropertyIndex = pPostRoll->uPropertyIndex;
                         m_push_phase(pFlow, m_phase_bankruptcy, pBankruptcyData);
                     }
                     
@@ -1492,17 +2660,19 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
             {
                 if(pPlayer->uMoney >= INCOME_TAX)
                 {
-                    pPlayer->uMoney -= INCOME_TAX;
+                    m_remove_player_money(pGame, uPlayerIndex, INCOME_TAX);
+                    pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_PAID_TAX;
                     m_set_notification(pGame, "Paid $%d Income Tax", INCOME_TAX);
                 }
                 else
                 {
                     // trigger bankruptcy phase
-                    mBankruptcyData* pBankruptcyData = malloc(sizeof(mBankruptcyData));
+                    mBankruptcyData* pBankruptcyData = M_ALLOC(sizeof(mBankruptcyData));
                     memset(pBankruptcyData, 0, sizeof(mBankruptcyData));
                     pBankruptcyData->eBankruptPlayer = pGame->uCurrentPlayerIndex;
                     pBankruptcyData->uCreditor = BANK_PLAYER_INDEX;
                     pBankruptcyData->uAmountOwed = INCOME_TAX;
+                    pBankruptcyData->eCause = BANKRUPTCY_CAUSE_TAX;
                     m_push_phase(pFlow, m_phase_bankruptcy, pBankruptcyData);
                 }
                 pPostRoll->bHandledLanding = true;
@@ -1513,17 +2683,19 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
             {
                 if(pPlayer->uMoney >= LUXURY_TAX)
                 {
-                    pPlayer->uMoney -= LUXURY_TAX;
+                    m_remove_player_money(pGame, uPlayerIndex, LUXURY_TAX);
+                    pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_PAID_TAX;
                     m_set_notification(pGame, "Paid $%d Luxury Tax", LUXURY_TAX);
                 }
                 else
                 {
                     // trigger bankruptcy phase
-                    mBankruptcyData* pBankruptcyData = malloc(sizeof(mBankruptcyData));
+                    mBankruptcyData* pBankruptcyData = M_ALLOC(sizeof(mBankruptcyData));
                     memset(pBankruptcyData, 0, sizeof(mBankruptcyData));
                     pBankruptcyData->eBankruptPlayer = pGame->uCurrentPlayerIndex;
                     pBankruptcyData->uCreditor = BANK_PLAYER_INDEX;
                     pBankruptcyData->uAmountOwed = LUXURY_TAX;
+                    pBankruptcyData->eCause = BANKRUPTCY_CAUSE_TAX;
                     m_push_phase(pFlow, m_phase_bankruptcy, pBankruptcyData);
                 }
                 pPostRoll->bHandledLanding = true;
@@ -1535,6 +2707,8 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                 // draw card
                 uint8_t uCardIdx = m_draw_chance_card(pGame);
                 mChanceCard* pCard = &pGame->amChanceCards[uCardIdx];
+                pGame->tStats.auChanceDrawn[uCardIdx]++;
+                pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_DREW_CARD;
 
                 // show card to player
                 m_set_notification(pGame, "Chance: %s", pCard->cDescription);
@@ -1551,6 +2725,8 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                 // draw card
                 uint8_t uCardIdx = m_draw_community_chest_card(pGame); 
                 mCommunityChestCard* pCard = &pGame->amCommunityChestCards[uCardIdx]; 
+                pGame->tStats.auCommunityChestDrawn[uCardIdx]++;
+                pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_DREW_CARD;
 
                 // show card to player
                 m_set_notification(pGame, "Community Chest: %s", pCard->cDescription);
@@ -1577,8 +2753,10 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
             
             case SQUARE_GO_TO_JAIL:
             {
-                pPlayer->uPosition = 10;  // jail position
-                pPlayer->uJailTurns = 1;
+                m_set_player_position(pGame, uPlayerIndex, 10);  // jail position
+                m_set_player_jail_turns(pGame, uPlayerIndex, 1);
+                pGame->tStats.auJailVisits[uPlayerIndex]++;
+                pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_JAILED;
                 m_set_notification(pGame, "Go to Jail!");
                 pPostRoll->bHandledLanding = true;
                 break;
@@ -1603,14 +2781,14 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
 
     if(iChoice == 1) // manage properties
     {
-        mPropertyManagementData* pPropMgmt = malloc(sizeof(mPropertyManagementData));
+        mPropertyManagementData* pPropMgmt = M_ALLOC(sizeof(mPropertyManagementData));
         memset(pPropMgmt, 0, sizeof(mPropertyManagementData));
         m_push_phase(pFlow, m_phase_property_management, pPropMgmt);
         return PHASE_RUNNING;
     }
     else if(iChoice == 2) // propose trade (end-of-turn menu)
     {
-        mTradeData* pTradeData = malloc(sizeof(mTradeData));
+        mTradeData* pTradeData = M_ALLOC(sizeof(mTradeData));
         memset(pTradeData, 0, sizeof(mTradeData));
         pTradeData->eStep = TRADE_STEP_SELECT_PLAYER;
         m_push_phase(pFlow, m_phase_trade, pTradeData);
@@ -1623,10 +2801,10 @@ m_phase_post_roll(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
     
     m_next_player_turn(pGame);
     
-    mPreRollData* pNextPreRoll = malloc(sizeof(mPreRollData));
+    mPreRollData* pNextPreRoll = M_ALLOC(sizeof(mPreRollData));
     memset(pNextPreRoll, 0, sizeof(mPreRollData));
     
-    free(pPostRoll);
+    M_FREE(pPostRoll);
     pFlow->pCurrentPhaseData = pNextPreRoll;
     pFlow->pfCurrentPhase = m_phase_pre_roll;
     pGame->bShowPrerollMenu = true;
@@ -1641,6 +2819,7 @@ m_phase_jail(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
     mJailData* pJail = (mJailData*)pPhaseData;
     mGameData* pGame = pFlow->pGame;
     mPlayer* pPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
+    uint8_t uPlayerIndex = pGame->uCurrentPlayerIndex;
     
     // show menu first time
     if(!pJail->bShowedMenu)
@@ -1666,18 +2845,18 @@ m_phase_jail(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
         {
             if(pPlayer->uMoney >= pGame->uJailFine)
             {
-                pPlayer->uMoney -= pGame->uJailFine;
-                pPlayer->uJailTurns = 0;
+                m_remove_player_money(pGame, uPlayerIndex, pGame->uJailFine);
+                m_set_player_jail_turns(pGame, uPlayerIndex, 0);
                 m_set_notification(pGame, "Paid $50 fine - released from jail!");
                 
                 // end turn after paying fine
                 m_next_player_turn(pGame);
                 pGame->bShowJailMenu = false;
                 
-                mPreRollData* pNextPreRoll = malloc(sizeof(mPreRollData));
+                mPreRollData* pNextPreRoll = M_ALLOC(sizeof(mPreRollData));
                 memset(pNextPreRoll, 0, sizeof(mPreRollData));
                 
-                free(pJail);
+                M_FREE(pJail);
                 pFlow->pCurrentPhaseData = pNextPreRoll;
                 pFlow->pfCurrentPhase = m_phase_pre_roll;
                 
@@ -1695,18 +2874,18 @@ m_phase_jail(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
         {
             if(pPlayer->bHasJailFreeCard)
             {
-                pPlayer->bHasJailFreeCard = false;
-                pPlayer->uJailTurns = 0;
+                m_set_player_jail_card(pGame, uPlayerIndex, false);
+                m_set_player_jail_turns(pGame, uPlayerIndex, 0);
                 m_set_notification(pGame, "Used Get Out of Jail Free card!");
                 
                 // end turn after using card
                 m_next_player_turn(pGame);
                 pGame->bShowJailMenu = false;
                 
-                mPreRollData* pNextPreRoll = malloc(sizeof(mPreRollData));
+                mPreRollData* pNextPreRoll = M_ALLOC(sizeof(mPreRollData));
                 memset(pNextPreRoll, 0, sizeof(mPreRollData));
                 
-                free(pJail);
+                M_FREE(pJail);
                 pFlow->pCurrentPhaseData = pNextPreRoll;
                 pFlow->pfCurrentPhase = m_phase_pre_roll;
                 
@@ -1729,15 +2908,15 @@ m_phase_jail(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                 
                 if(pGame->tDice.uDie1 == pGame->tDice.uDie2)
                 {
-                    pPlayer->uJailTurns = 0;
+                    m_set_player_jail_turns(pGame, uPlayerIndex, 0);
                     m_set_notification(pGame, "Rolled doubles (%d+%d)! Released and moving...", pGame->tDice.uDie1, pGame->tDice.uDie2);
                     
                     // transition to post-roll to move with the doubles roll
                     pGame->bShowJailMenu = false;
-                    mPostRollData* pPostRoll = malloc(sizeof(mPostRollData));
+                    mPostRollData* pPostRoll = M_ALLOC(sizeof(mPostRollData));
                     memset(pPostRoll, 0, sizeof(mPostRollData));
                     
-                    free(pJail);
+                    M_FREE(pJail);
                     pFlow->pCurrentPhaseData = pPostRoll;
                     pFlow->pfCurrentPhase = m_phase_post_roll;
                     
@@ -1746,25 +2925,25 @@ m_phase_jail(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                 else
                 {
                     // didn't roll doubles
-                    pPlayer->uJailTurns++;
+                    m_set_player_jail_turns(pGame, uPlayerIndex, pPlayer->uJailTurns + 1);
                     
                     // check if this was third attempt - must pay fine on third failed attempt
                     if(pPlayer->uJailTurns > 3)
                     {
                         if(m_can_afford(pPlayer, pGame->uJailFine))
                         {
-                            pPlayer->uMoney -= pGame->uJailFine;
-                            pPlayer->uJailTurns = 0;
+                            m_remove_player_money(pGame, uPlayerIndex, pGame->uJailFine);
+                            m_set_player_jail_turns(pGame, uPlayerIndex, 0);
                             m_set_notification(pGame, "Failed 3 attempts - paid $50 fine");
 
                             // end turn after forced payment
                             m_next_player_turn(pGame);
                             pGame->bShowJailMenu = false;
 
-                            mPreRollData* pNextPreRoll = malloc(sizeof(mPreRollData));
+                            mPreRollData* pNextPreRoll = M_ALLOC(sizeof(mPreRollData));
                             memset(pNextPreRoll, 0, sizeof(mPreRollData));
 
-                            free(pJail);
+                            M_FREE(pJail);
                             pFlow->pCurrentPhaseData = pNextPreRoll;
                             pFlow->pfCurrentPhase = m_phase_pre_roll;
 
@@ -1774,17 +2953,17 @@ m_phase_jail(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                         {
                             // can't afford fine after 3 attempts - bankruptcy
                             m_set_notification(pGame, "Cannot afford jail fine - BANKRUPT!");
-                            pPlayer->bIsBankrupt = true;
-                            pGame->uActivePlayers--;
+                            m_set_player_bankrupt(pGame, uPlayerIndex, true);
+                            m_set_active_players(pGame, pGame->uActivePlayers - 1);
                             
                             // end turn
                             m_next_player_turn(pGame);
                             pGame->bShowPrerollMenu = false;
                             
-                            mPreRollData* pNextPreRoll = malloc(sizeof(mPreRollData));
+                            mPreRollData* pNextPreRoll = M_ALLOC(sizeof(mPreRollData));
                             memset(pNextPreRoll, 0, sizeof(mPreRollData));
                             
-                            free(pJail);
+                            M_FREE(pJail);
                             pFlow->pCurrentPhaseData = pNextPreRoll;
                             pFlow->pfCurrentPhase = m_phase_pre_roll;
                             
@@ -1799,10 +2978,10 @@ m_phase_jail(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
                         m_next_player_turn(pGame);
                         pGame->bShowPrerollMenu = false;
                         
-                        mPreRollData* pNextPreRoll = malloc(sizeof(mPreRollData));
+                        mPreRollData* pNextPreRoll = M_ALLOC(sizeof(mPreRollData));
                         memset(pNextPreRoll, 0, sizeof(mPreRollData));
                         
-                        free(pJail);
+                        M_FREE(pJail);
                         pFlow->pCurrentPhaseData = pNextPreRoll;
                         pFlow->pfCurrentPhase = m_phase_pre_roll;
                         
@@ -1995,6 +3174,36 @@ m_phase_property_management(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow
     return PHASE_RUNNING;
 }
 
+// awards the property to the highest bidder (if any) and returns to post-roll
+static void
+m__finish_auction(mGameFlow* pFlow, mAuctionData* pAuction)
+{
+    mGameData* pGame = pFlow->pGame;
+    pGame->bShowAuctionMenu = false;
+    
+    // award property to highest bidder
+    if(pAuction->uHighestBidder != BANK_PLAYER_INDEX)
+    {
+        mProperty* pProp = &pGame->amProperties[pAuction->ePropertyIndex];
+        
+        // ownership change also adds it to the winner's property list
+        m_remove_player_money(pGame, pAuction->uHighestBidder, pAuction->uHighestBid);
+        m_set_property_owner(pGame, (uint8_t)pAuction->ePropertyIndex, pAuction->uHighestBidder);
+        
+        m_set_notification(pGame, "Player %d won %s for $%d!", 
+            pAuction->uHighestBidder + 1, pProp->cName, pAuction->uHighestBid);
+    }
+    else
+    {
+        m_set_notification(pGame, "No bids - property remains unowned");
+    }
+    
+    mPostRollData* pPostRoll = (mPostRollData*)pFlow->apPhaseDataStack[pFlow->iStackDepth - 1];
+    pPostRoll->bHandledLanding = true;
+    
+    m_pop_phase(pFlow);
+}
+
 ePhaseResult
 m_phase_auction(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
 {
@@ -2021,6 +3230,10 @@ m_phase_auction(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
         pAuction->uHighestBid = 0;
         pAuction->uConsecutivePasses = 0;
         
+        // let the resolver settle it in one go if it can
+        if(pFlow->pfAuctionResolver && pFlow->pfAuctionResolver(pFlow, pAuction, pFlow->pAuctionResolverData))
+            m__finish_auction(pFlow, pAuction);
+        
         return PHASE_RUNNING;
     }
     
@@ -2059,36 +3272,7 @@ m_phase_auction(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
         
         if(bAuctionOver)
         {
-            pGame->bShowAuctionMenu = false;
-            
-            // award property to highest bidder
-            if(pAuction->uHighestBidder != BANK_PLAYER_INDEX)
-            {
-                mProperty* pProp = &pGame->amProperties[pAuction->ePropertyIndex];
-                mPlayer* pWinner = &pGame->amPlayers[pAuction->uHighestBidder];
-                
-                pWinner->uMoney -= pAuction->uHighestBid;
-                pProp->uOwnerIndex = pAuction->uHighestBidder;
-                
-                // add to winner's property list
-                if(pWinner->uPropertyCount < PROPERTY_ARRAY_SIZE)
-                {
-                    pWinner->auPropertiesOwned[pWinner->uPropertyCount] = pAuction->ePropertyIndex;
-                    pWinner->uPropertyCount++;
-                }
-                
-                m_set_notification(pGame, "Player %d won %s for $%d!", 
-                    pAuction->uHighestBidder + 1, pProp->cName, pAuction->uHighestBid);
-            }
-            else
-            {
-                m_set_notification(pGame, "No bids - property remains unowned");
-            }
-            
-            mPostRollData* pPostRoll = (mPostRollData*)pFlow->apPhaseDataStack[pFlow->iStackDepth - 1];
-            pPostRoll->bHandledLanding = true;
-            
-            m_pop_phase(pFlow);
+            m__finish_auction(pFlow, pAuction);
             return PHASE_RUNNING;
         }
         
@@ -2137,109 +3321,39 @@ m_phase_bankruptcy(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
     mBankruptcyData* pBankruptcy = (mBankruptcyData*)pPhaseData;
     mGameData* pGame = pFlow->pGame;
     mPlayer* pBankruptPlayer = &pGame->amPlayers[pBankruptcy->eBankruptPlayer];
+    uint8_t uBankruptIndex = (uint8_t)pBankruptcy->eBankruptPlayer;
     
-    uint32_t uDebtOwed = pBankruptcy->uAmountOwed;
-    uint32_t uMoneyRaised = pBankruptPlayer->uMoney;
-    
-    // sell all hotels back to 4 houses
-    for(uint8_t i = 0; i < pBankruptPlayer->uPropertyCount; i++)
-    {
-        uint8_t uPropIdx = pBankruptPlayer->auPropertiesOwned[i];
-        if(uPropIdx == BANK_PLAYER_INDEX) break;
-        
-        mProperty* pProp = &pGame->amProperties[uPropIdx];
-        
-        if(pProp->bHasHotel && pGame->uGlobalHouseSupply >= 4)
-        {
-            m_sell_hotel(pGame, uPropIdx, pBankruptcy->eBankruptPlayer);
-            uMoneyRaised += pProp->uHouseCost / 2;
-            
-            if(uMoneyRaised >= uDebtOwed)
-            {
-                // paid off debt through hotel sales
-                pBankruptPlayer->uMoney = uMoneyRaised - uDebtOwed;
-                
-                // pay the creditor
-                if(pBankruptcy->uCreditor != BANK_PLAYER_INDEX)
-                {
-                    pGame->amPlayers[pBankruptcy->uCreditor].uMoney += uDebtOwed;
-                }
-                
-                m_pop_phase(pFlow);
-                return PHASE_RUNNING;
-            }
-        }
-    }
-    
-    // sell all houses
-    bool bSoldHouse = true;
-    while(bSoldHouse && uMoneyRaised < uDebtOwed)
+    // raise the money the cheapest way if it can be raised at all
+    mLiquidationPlan tPlan;
+    bool bCovered = m_plan_liquidation(pGame, uBankruptIndex, pBankruptcy->uAmountOwed, &tPlan) &&
+                    m_execute_liquidation_plan(pGame, uBankruptIndex, &tPlan) &&
+                    pBankruptPlayer->uMoney >= pBankruptcy->uAmountOwed;
+
+    // the planner counts big debts in coarse units and can miss a cover that is only just
+    // there, so no plan doesn't mean no money. sell in order before giving up
+    if(!bCovered && m_get_liquidation_value(pGame, uBankruptIndex) >= pBankruptcy->uAmountOwed)
+        bCovered = m__liquidate_in_order(pGame, uBankruptIndex, pBankruptcy->uAmountOwed);
+
+    if(bCovered)
     {
-        bSoldHouse = false;
-        
-        for(uint8_t i = 0; i < pBankruptPlayer->uPropertyCount; i++)
+        m_remove_player_money(pGame, uBankruptIndex, pBankruptcy->uAmountOwed);
+        if(pBankruptcy->uCreditor != BANK_PLAYER_INDEX)
         {
-            uint8_t uPropIdx = pBankruptPlayer->auPropertiesOwned[i];
-            if(uPropIdx == BANK_PLAYER_INDEX) break;
-            
-            if(m_can_sell_house(pGame, uPropIdx, pBankruptcy->eBankruptPlayer))
-            {
-                mProperty* pProp = &pGame->amProperties[uPropIdx];
-                m_sell_house(pGame, uPropIdx, pBankruptcy->eBankruptPlayer);
-                uMoneyRaised += pProp->uHouseCost / 2;
-                bSoldHouse = true;
-                
-                if(uMoneyRaised >= uDebtOwed)
-                {
-                    // paid off debt through house sales
-                    pBankruptPlayer->uMoney = uMoneyRaised - uDebtOwed;
-                    
-                    // pay the creditor
-                    if(pBankruptcy->uCreditor != BANK_PLAYER_INDEX)
-                    {
-                        pGame->amPlayers[pBankruptcy->uCreditor].uMoney += uDebtOwed;
-                    }
-                    
-                    m_pop_phase(pFlow);
-                    return PHASE_RUNNING;
-                }
-            }
+            m_add_player_money(pGame, pBankruptcy->uCreditor, pBankruptcy->uAmountOwed);
         }
-    }
-    
-    // mortgage all unmortgaged properties
-    for(uint8_t i = 0; i < pBankruptPlayer->uPropertyCount; i++)
-    {
-        uint8_t uPropIdx = pBankruptPlayer->auPropertiesOwned[i];
-        if(uPropIdx == BANK_PLAYER_INDEX) break;
-        
-        mProperty* pProp = &pGame->amProperties[uPropIdx];
+        if(pBankruptcy->eCause == BANKRUPTCY_CAUSE_RENT)
+            m__stats_record_rent(pGame, pBankruptcy->uPropertyIndex, uBankruptIndex, pBankruptcy->uCreditor, pBankruptcy->uAmountOwed);
         
-        if(!pProp->bIsMortgaged)
-        {
-            m_mortgage_property(pGame, uPropIdx, pBankruptcy->eBankruptPlayer);
-            uMoneyRaised += pProp->uMortgageValue;
-            
-            if(uMoneyRaised >= uDebtOwed)
-            {
-                // paid off debt through mortgages
-                pBankruptPlayer->uMoney = uMoneyRaised - uDebtOwed;
-                
-                // pay the creditor
-                if(pBankruptcy->uCreditor != BANK_PLAYER_INDEX)
-                {
-                    pGame->amPlayers[pBankruptcy->uCreditor].uMoney += uDebtOwed;
-                }
-                
-                m_pop_phase(pFlow);
-                return PHASE_RUNNING;
-            }
-        }
+        m_pop_phase(pFlow);
+        return PHASE_RUNNING;
     }
     
-    // still can't pay - declare bankruptcy
-    pBankruptPlayer->bIsBankrupt = true;
-    pGame->uActivePlayers--;
+    // nothing left to sell covers the debt - declare bankruptcy and hand over the assets as they are
+    m_set_player_bankrupt(pGame, (uint8_t)pBankruptcy->eBankruptPlayer, true);
+    pGame->tStats.auBankruptcyCause[uBankruptIndex] = (uint8_t)pBankruptcy->eCause;
+    pGame->tStats.auBankruptcyTurn[uBankruptIndex]  = pGame->tStats.uTurns + 1;
+    pGame->tStats.tTurn.uActions |= (uint8_t)TURN_ACTION_BANKRUPT;
+    m_set_active_players(pGame, pGame->uActivePlayers - 1);
 
     // transfer assets based on creditor type
     if(pBankruptcy->uCreditor == BANK_PLAYER_INDEX)
@@ -2260,7 +3374,7 @@ m_phase_bankruptcy(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
     // check if game is over (only 1 player left)
     if(pGame->uActivePlayers == 1)
     {
-        pGame->bIsRunning = false;
+        m_set_game_running(pGame, false);
         
         // find the winner
         for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
@@ -2504,30 +3618,7 @@ m_phase_trade(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
         {
             if(iChoice == 1) // accept
             {
-                // execute trade
-                mPlayer* pTargetPlayer = &pGame->amPlayers[pTrade->uTargetPlayer];
-                
-                // transfer offered properties
-                for(uint8_t i = 0; i < pTrade->uOfferedPropertyCount; i++)
-                {
-                    uint8_t uPropIdx = pTrade->auOfferedProperties[i];
-                    m_transfer_property(pGame, uPropIdx, pGame->uCurrentPlayerIndex, pTrade->uTargetPlayer);
-                }
-                
-                // transfer requested properties
-                for(uint8_t i = 0; i < pTrade->uRequestedPropertyCount; i++)
-                {
-                    uint8_t uPropIdx = pTrade->auRequestedProperties[i];
-                    m_transfer_property(pGame, uPropIdx, pTrade->uTargetPlayer, pGame->uCurrentPlayerIndex);
-                }
-                
-                // transfer money
-                pCurrentPlayer->uMoney -= pTrade->uOfferedMoney;
-                pTargetPlayer->uMoney += pTrade->uOfferedMoney;
-                
-                pCurrentPlayer->uMoney += pTrade->uRequestedMoney;
-                pTargetPlayer->uMoney -= pTrade->uRequestedMoney;
-                
+                m_apply_trade(pGame, pGame->uCurrentPlayerIndex, pTrade);
                 m_set_notification(pGame, "Trade completed!");
                 
                 pGame->bShowTradeMenu = false;
@@ -2552,32 +3643,29 @@ m_phase_trade(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
 void
 m_transfer_property(mGameData* pGame, uint8_t uPropIdx, uint8_t uFromPlayer, uint8_t uToPlayer)
 {
-    mProperty* pProp = &pGame->amProperties[uPropIdx];
-    mPlayer* pFrom = &pGame->amPlayers[uFromPlayer];
-    mPlayer* pTo = &pGame->amPlayers[uToPlayer];
-    
-    // remove from old owner
-    for(uint8_t i = 0; i < pFrom->uPropertyCount; i++)
-    {
-        if(pFrom->auPropertiesOwned[i] == uPropIdx)
-        {
-            // shift remaining properties down
-            for(uint8_t j = i; j < pFrom->uPropertyCount - 1; j++)
-            {
-                pFrom->auPropertiesOwned[j] = pFrom->auPropertiesOwned[j + 1];
-            }
-            pFrom->auPropertiesOwned[pFrom->uPropertyCount - 1] = BANK_PLAYER_INDEX;
-            pFrom->uPropertyCount--;
-            break;
-        }
-    }
-    
-    // add to new owner
-    pTo->auPropertiesOwned[pTo->uPropertyCount] = uPropIdx;
-    pTo->uPropertyCount++;
+    if(pGame->amProperties[uPropIdx].uOwnerIndex != uFromPlayer) return;
     
-    // update property ownership
-    pProp->uOwnerIndex = uToPlayer;
+    // removes from the old owner's list and appends to the new owner's
+    m_set_property_owner(pGame, uPropIdx, uToPlayer);
+}
+
+void
+m_apply_trade(mGameData* pGame, uint8_t uFromPlayer, const mTradeData* pTrade)
+{
+    // transfer offered properties
+    for(uint8_t i = 0; i < pTrade->uOfferedPropertyCount; i++)
+        m_transfer_property(pGame, pTrade->auOfferedProperties[i], uFromPlayer, pTrade->uTargetPlayer);
+
+    // transfer requested properties
+    for(uint8_t i = 0; i < pTrade->uRequestedPropertyCount; i++)
+        m_transfer_property(pGame, pTrade->auRequestedProperties[i], pTrade->uTargetPlayer, uFromPlayer);
+
+    // transfer money
+    m_remove_player_money(pGame, uFromPlayer, pTrade->uOfferedMoney);
+    m_add_player_money(pGame, pTrade->uTargetPlayer, pTrade->uOfferedMoney);
+
+    m_add_player_money(pGame, uFromPlayer, pTrade->uRequestedMoney);
+    m_remove_player_money(pGame, pTrade->uTargetPlayer, pTrade->uRequestedMoney);
 }
 
 bool
@@ -2586,7 +3674,7 @@ m_check_game_over(mGameData* pGame)
     // check if only one player remains
     if(pGame->uActivePlayers <= 1)
     {
-        pGame->bIsRunning = false;
+        m_set_game_running(pGame, false);
         
         // find and announce the winner
         for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
@@ -3,6 +3,8 @@
 
 #include <stdint.h> // uint
 #include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include "monopoly_profile.h"
 
 // ==================== CONSTANTS ==================== //
 
@@ -18,6 +20,23 @@
 // property ownership array sizes (with buffer for trading/selling)
 #define PROPERTY_ARRAY_SIZE 35
 
+// 22 streets * 5 buildings + 28 mortgages
+#define MAX_LIQUIDATION_STEPS 138
+
+// ==================== ALLOCATION ==================== //
+
+// every heap allocation the core makes goes through these. tools that count or redirect
+// them build the core with M_CUSTOM_ALLOCATOR and provide m_custom_alloc/m_custom_free
+#ifdef M_CUSTOM_ALLOCATOR
+    void* m_custom_alloc(size_t szSize);
+    void  m_custom_free(void* pMemory);
+    #define M_ALLOC(szSize) (M_PROFILE_COUNT(PROFILE_COUNTER_ALLOCATIONS, 1), m_custom_alloc(szSize))
+    #define M_FREE(pMemory) m_custom_free(pMemory)
+#else
+    #define M_ALLOC(szSize) (M_PROFILE_COUNT(PROFILE_COUNTER_ALLOCATIONS, 1), malloc(szSize))
+    #define M_FREE(pMemory) free(pMemory)
+#endif
+
 // ==================== ENUMS ==================== //
 
 // board square types
@@ -146,6 +165,69 @@ typedef enum _ePlayerArrayIndex
     PLAYER_SIX_ARRAY_INDEX
 } ePlayerArrayIndex;
 
+// ways to raise money from the bank
+typedef enum _eLiquidationAction
+{
+    LIQUIDATE_SELL_HOTEL,
+    LIQUIDATE_SELL_HOUSE,
+    LIQUIDATE_MORTGAGE
+} eLiquidationAction;
+
+// what a bankrupt player couldn't pay
+typedef enum _eBankruptcyCause
+{
+    BANKRUPTCY_CAUSE_NONE,
+    BANKRUPTCY_CAUSE_RENT,
+    BANKRUPTCY_CAUSE_TAX,
+    BANKRUPTCY_CAUSE_CARD,
+
+    BANKRUPTCY_CAUSE_COUNT
+} eBankruptcyCause;
+
+// what happened during a turn (bit flags, mTurnRecord::uActions)
+typedef enum _eTurnAction
+{
+    TURN_ACTION_NONE      = 0,
+    TURN_ACTION_IN_JAIL   = 1 << 0, // started the turn in jail
+    TURN_ACTION_BOUGHT    = 1 << 1,
+    TURN_ACTION_AUCTIONED = 1 << 2,
+    TURN_ACTION_PAID_RENT = 1 << 3,
+    TURN_ACTION_PAID_TAX  = 1 << 4,
+    TURN_ACTION_DREW_CARD = 1 << 5,
+    TURN_ACTION_JAILED    = 1 << 6,
+    TURN_ACTION_BANKRUPT  = 1 << 7
+} eTurnAction;
+
+// fields a change journal entry can refer to
+typedef enum _eChangeField
+{
+    // player fields (uIndex = player)
+    CHANGE_PLAYER_MONEY,
+    CHANGE_PLAYER_POSITION,
+    CHANGE_PLAYER_JAIL_TURNS,
+    CHANGE_PLAYER_JAIL_CARD,
+    CHANGE_PLAYER_BANKRUPT,
+    CHANGE_PLAYER_PROPERTY_ADDED,   // uAux = slot in auPropertiesOwned, uNewValue = property
+    CHANGE_PLAYER_PROPERTY_REMOVED, // uAux = slot in auPropertiesOwned, uOldValue = property
+
+    // property fields (uIndex = property)
+    CHANGE_PROPERTY_OWNER,
+    CHANGE_PROPERTY_HOUSES,
+    CHANGE_PROPERTY_HOTEL,
+    CHANGE_PROPERTY_MORTGAGED,
+
+    // game fields
+    CHANGE_HOUSE_SUPPLY,
+    CHANGE_HOTEL_SUPPLY,
+    CHANGE_CURRENT_PLAYER,
+    CHANGE_ROUND_COUNT,
+    CHANGE_ACTIVE_PLAYERS,
+    CHANGE_GAME_RUNNING,
+    CHANGE_DECK_INDEX,              // uIndex = 0 chance, 1 community chest
+
+    CHANGE_FIELD_COUNT
+} eChangeField;
+
 // special player indices
 #define BANK_PLAYER_INDEX 255
 
@@ -189,6 +271,12 @@ typedef struct _mPlayer
     ePlayerPiece ePiece;
     bool         bHasJailFreeCard;
     bool         bIsBankrupt;
+
+    // running totals over owned properties, kept up to date by the state mutators
+    uint32_t     uPropertyValue;         // list price of unmortgaged properties
+    uint32_t     uMortgageDebt;          // payoff (value + 10%) of mortgaged properties
+    uint32_t     uMortgageableValue;     // mortgage value of unmortgaged properties
+    uint32_t     uBuildingResaleValue;   // what selling every house and hotel back would raise (ignores house supply)
 } mPlayer;
 
 // chance card
@@ -212,13 +300,57 @@ typedef struct _mDeckState
     uint8_t uCurrentIndex; // next card to draw
 } mDeckState;
 
+// one recorded state change
+typedef struct _mChange
+{
+    uint8_t  uField; // eChangeField
+    uint8_t  uIndex; // player or property index
+    uint8_t  uAux;
+    uint32_t uOldValue;
+    uint32_t uNewValue;
+} mChange;
+
+// append-only log of changes, filled by the state mutators while attached to a game
+typedef struct _mChangeJournal
+{
+    mChange* atChanges;
+    uint32_t uCapacity;
+    uint32_t uCount;
+    uint32_t uRedoCount; // rolled back entries kept after uCount, dropped by the next new change
+    bool     bOverflow;  // entries were dropped, consumers must fall back to a full rescan
+} mChangeJournal;
+
+// sells and mortgages in the order they have to be made
+typedef struct _mLiquidationStep
+{
+    uint8_t uPropertyIndex;
+    uint8_t uAction; // eLiquidationAction
+} mLiquidationStep;
+
+typedef struct _mLiquidationPlan
+{
+    mLiquidationStep atSteps[MAX_LIQUIDATION_STEPS];
+    uint8_t          uStepCount;
+    uint32_t         uRaised; // money the steps bring in
+    uint32_t         uLoss;   // value given up: half of each building's cost plus the 10% to lift each mortgage
+} mLiquidationPlan;
+
 // forward declaration for phase function pointer
 typedef struct _mGameData mGameData;
 typedef struct _mGameFlow mGameFlow;
 
+typedef struct _mAuctionData mAuctionData;
+typedef struct _mTurnRecord mTurnRecord;
+
 // phase function pointer type
 typedef ePhaseResult (*fPhaseFunc)(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow);
 
+// settles a whole auction at once (sets uHighestBidder/uHighestBid), false = run it bid by bid
+typedef bool (*fAuctionResolver)(mGameFlow* pFlow, mAuctionData* pAuction, void* pUserData);
+
+// called after a phase step that finished a turn (e.g. to record game history)
+typedef void (*fTurnObserver)(mGameFlow* pFlow, const mTurnRecord* pTurn, void* pUserData);
+
 // game flow state (phase system)
 typedef struct _mGameFlow
 {
@@ -239,8 +371,18 @@ typedef struct _mGameFlow
     int   iInputValue;
     char  szInputString[256];
     
-    // timing
+    // timing, in game seconds (real seconds * fTimeScale)
     float fAccumulatedTime;
+    float fDeltaTime; // of the latest m_run_current_phase
+    float fTimeScale; // 1 after m_init_game_flow, raise it to run phase timers faster (e.g. ai spectating)
+
+    // optional automatic auctions (e.g. computer players), set after m_init_game_flow
+    fAuctionResolver pfAuctionResolver;
+    void*            pAuctionResolverData;
+
+    // optional, set after m_init_game_flow
+    fTurnObserver pfTurnObserver;
+    void*         pTurnObserverData;
 } mGameFlow;
 
 // pre-roll phase data
@@ -310,8 +452,44 @@ typedef struct _mBankruptcyData
     ePlayerArrayIndex eBankruptPlayer;
     uint8_t           uCreditor;
     uint32_t          uAmountOwed;
+    eBankruptcyCause  eCause;
+    uint8_t           uPropertyIndex; // rent debts only
 } mBankruptcyData;
 
+// one finished turn, state as the turn ended
+typedef struct _mTurnRecord
+{
+    uint32_t uTurn;
+    uint32_t uMoney;
+    uint32_t uRentPaid;
+    uint8_t  uPlayer;
+    uint8_t  uDie1;
+    uint8_t  uDie2;
+    uint8_t  uPosition;
+    uint8_t  uActions; // eTurnAction bits
+} mTurnRecord;
+
+// per game statistics, counted by the phases as the game is played (never by the mutators,
+// so speculative changes and rollbacks don't show up here). fixed size, no allocation.
+// turn numbers count every player's turn from 1, 0 = never
+typedef struct _mGameStats
+{
+    uint32_t uTurns;
+    uint32_t auPropertyRent[TOTAL_PROPERTIES];       // rent collected on each property
+    uint16_t auPropertyRentCount[TOTAL_PROPERTIES];  // times rent was paid on it
+    uint32_t auRentPaid[MAX_PLAYERS];
+    uint32_t auRentReceived[MAX_PLAYERS];
+    uint16_t auChanceDrawn[TOTAL_CHANCE_CARDS];      // by card index
+    uint16_t auCommunityChestDrawn[TOTAL_COMMUNITY_CHEST_CARDS];
+    uint16_t auJailVisits[MAX_PLAYERS];              // times sent to jail
+    uint16_t auJailTurns[MAX_PLAYERS];               // turns started in jail
+    uint32_t auFirstMonopolyTurn[MAX_PLAYERS];       // first full street color group
+    uint32_t auBankruptcyTurn[MAX_PLAYERS];
+    uint8_t  auBankruptcyCause[MAX_PLAYERS];         // eBankruptcyCause
+    mTurnRecord tTurn;                               // turn in progress (rent and actions so far)
+    mTurnRecord tLastTurn;                           // filled in when a turn ends
+} mGameStats;
+
 // main game state
 typedef struct _mGameData
 {
@@ -333,6 +511,16 @@ typedef struct _mGameData
     eGameState          eState;
     bool                bIsRunning;
     
+    // change tracking (written by the state mutators only)
+    uint64_t            uStateVersion;    // bumped on every change
+    uint32_t            uDirtyFields;     // bit per eChangeField since the last m_clear_dirty
+    uint32_t            uDirtyProperties; // bit per property
+    uint8_t             uDirtyPlayers;    // bit per player
+    mChangeJournal*     pJournal;         // optional, NULL = don't record
+    
+    // statistics (see monopoly_stats.h for aggregating them over many games)
+    mGameStats          tStats;
+    
     // ui state flags
     bool bShowPrerollMenu;
     bool bShowPropertyMenu;
@@ -352,15 +540,19 @@ typedef struct _mGameSettings
     uint32_t uStartingMoney;
     uint32_t uJailFine;
     uint8_t  uPlayerCount;
+    const char* pcDataDirectory; // folder holding the game data json, NULL for "../../monopoly/game_data"
 } mGameSettings;
 
 // ==================== PHASE SYSTEM FUNCTIONS ==================== //
 
 // phase management
 void m_init_game_flow(mGameFlow* pFlow, mGameData* pGame, void* pInputContext);
+void m_cleanup_game_flow(mGameFlow* pFlow); // frees current and stacked phase data
 void m_push_phase(mGameFlow* pFlow, fPhaseFunc pfNewPhase, void* pNewData);
 void m_pop_phase(mGameFlow* pFlow);
-void m_run_current_phase(mGameFlow* pFlow, float fDeltaTime);
+void m_run_current_phase(mGameFlow* pFlow, float fDeltaTime); // real seconds since the last call, 0 when headless
+size_t m_get_phase_data_size(fPhaseFunc pfPhase); // bytes allocated for a phase's data (0 if unknown)
+const char* m_get_phase_name(fPhaseFunc pfPhase); // function name, "unknown" for phases outside the core
 
 // input handling
 void m_set_input_int(mGameFlow* pFlow, int iValue);
@@ -368,6 +560,45 @@ void m_set_input_string(mGameFlow* pFlow, const char* szValue);
 void m_clear_input(mGameFlow* pFlow);
 bool m_is_waiting_input(mGameFlow* pFlow);
 
+// ==================== STATE MUTATORS ==================== //
+
+// all writes to player, property and turn state go through these so they can be
+// journaled and dirty tracked (direct field writes are only ok during init)
+void m_set_player_money(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uMoney);
+void m_add_player_money(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uAmount);
+void m_remove_player_money(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uAmount);
+void m_set_player_position(mGameData* pGame, uint8_t uPlayerIndex, uint8_t uPosition);
+void m_set_player_jail_turns(mGameData* pGame, uint8_t uPlayerIndex, uint8_t uJailTurns);
+void m_set_player_jail_card(mGameData* pGame, uint8_t uPlayerIndex, bool bHasCard);
+void m_set_player_bankrupt(mGameData* pGame, uint8_t uPlayerIndex, bool bIsBankrupt);
+void m_set_property_owner(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uOwnerIndex); // keeps owner property lists in sync
+void m_set_property_houses(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uHouses);
+void m_set_property_hotel(mGameData* pGame, uint8_t uPropertyIndex, bool bHasHotel);
+void m_set_property_mortgaged(mGameData* pGame, uint8_t uPropertyIndex, bool bIsMortgaged);
+void m_set_house_supply(mGameData* pGame, uint32_t uSupply);
+void m_set_hotel_supply(mGameData* pGame, uint32_t uSupply);
+void m_set_current_player(mGameData* pGame, uint8_t uPlayerIndex);
+void m_set_round_count(mGameData* pGame, uint64_t uRoundCount);
+void m_set_active_players(mGameData* pGame, uint8_t uActivePlayers);
+void m_set_game_running(mGameData* pGame, bool bIsRunning);
+void m_set_deck_index(mGameData* pGame, mDeckState* pDeck, uint8_t uIndex);
+
+// change journal
+mChangeJournal* m_create_change_journal(uint32_t uCapacity);
+void            m_free_change_journal(mChangeJournal* pJournal);
+void            m_clear_change_journal(mChangeJournal* pJournal);
+void            m_clear_dirty(mGameData* pGame);
+bool            m_check_change_invariants(mGameData* pGame, const mChangeJournal* pJournal, uint32_t uFirstChange); // only checks what changed
+void            m_refresh_player_aggregates(mGameData* pGame); // rebuild the running totals after direct writes
+
+// speculative execution: checkpoint, apply any rule functions, then roll back to undo
+// them field by field (or redo them again). needs an attached journal that doesn't
+// overflow in between. only covers what the mutators write: phase/flow data, dice,
+// notifications, the shuffled deck order and rand() state are not restored.
+uint32_t m_checkpoint(mGameData* pGame);                        // current journal position
+bool     m_rollback(mGameData* pGame, uint32_t uCheckpoint);    // undo back to a checkpoint
+bool     m_redo(mGameData* pGame, uint32_t uCheckpoint);        // reapply rolled back changes up to a checkpoint
+
 // ==================== GAME LOGIC FUNCTIONS ==================== //
 
 // dice
@@ -375,7 +606,7 @@ void m_roll_dice(mDice* pDice);
 
 // movement
 void m_move_player(mPlayer* pPlayer, mDice* pDice, mGameData* pGame);
-void m_move_player_to(mPlayer* pPlayer, uint8_t uPosition);
+void m_move_player_to(mGameData* pGame, uint8_t uPlayerIndex, uint8_t uPosition);
 
 // turn management
 void m_next_player_turn(mGameData* pGame);
@@ -407,7 +638,7 @@ eSquareType m_get_square_type(uint8_t uPosition);
 const char* m_get_square_name(mGameData* pGame, uint8_t uPosition);
 
 // jail
-bool m_use_jail_free_card(mPlayer* pPlayer);
+bool m_use_jail_free_card(mGameData* pGame, uint8_t uPlayerIndex);
 
 // mortgaging
 bool m_mortgage_property(mGameData* pGame, uint8_t uPropertyIndex, uint8_t uPlayerIndex);
@@ -425,9 +656,12 @@ uint8_t m_draw_chance_card(mGameData* pGame);
 uint8_t m_draw_community_chest_card(mGameData* pGame);
 
 //property management
-int32_t m_calculate_net_worth(mGameData* pGame, uint8_t uPlayerIndex); // int because can be nagative
+int32_t  m_calculate_net_worth(mGameData* pGame, uint8_t uPlayerIndex); // int because can be nagative
+uint32_t m_get_liquidation_value(mGameData* pGame, uint8_t uPlayerIndex); // cash plus everything sold and mortgaged
 
 // bankruptcy 
+bool m_plan_liquidation(mGameData* pGame, uint8_t uPlayerIndex, uint32_t uAmountOwed, mLiquidationPlan* pPlanOut); // cheapest way to cover a debt, false if none was found (big debts are planned in coarse units and can miss a tight cover)
+bool m_execute_liquidation_plan(mGameData* pGame, uint8_t uPlayerIndex, const mLiquidationPlan* pPlan);
 void m_transfer_assets_to_player(mGameData* pGame, uint8_t uFromPlayer, uint8_t uToPlayer);
 void m_transfer_assets_to_bank(mGameData* pGame, uint8_t uFromPlayer);
 
@@ -444,6 +678,7 @@ ePhaseResult m_phase_trade(void* pPhaseData, float fDeltaTime, mGameFlow* pFlow)
 
 // helpers
 void m_transfer_property(mGameData* pGame, uint8_t uPropIdx, uint8_t uFromPlayer, uint8_t uToPlayer);
+void m_apply_trade(mGameData* pGame, uint8_t uFromPlayer, const mTradeData* pTrade); // moves everything in the offer, no validation
 void m_trigger_card_bankruptcy(mGameData* pGame, mGameFlow* pFlow, uint32_t uAmountOwed);
 
 bool
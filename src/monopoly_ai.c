@@ -0,0 +1,642 @@
+#include "monopoly_ai.h"
+#include <string.h>
+
+// ==================== LANDING PROBABILITIES ==================== //
+
+#define M__AI_MODEL_ITERATIONS 128
+#define M__AI_AVERAGE_DICE     7.0f // utility rent is a multiple of the roll
+#define M__AI_MONEY_STEP       10   // granularity of cash balancing in generated trades
+
+static uint8_t
+m__ai_next_square_of_type(uint8_t uSquare, bool bRailroad)
+{
+    for(uint8_t i = 1; i <= TOTAL_BOARD_SQUARES; i++)
+    {
+        uint8_t uPos = (uint8_t)((uSquare + i) % TOTAL_BOARD_SQUARES);
+        if(bRailroad && uPos % 10 == 5)
+            return uPos;
+        if(!bRailroad && (uPos == 12 || uPos == 28))
+            return uPos;
+    }
+    return uSquare;
+}
+
+// where a turn that stops on uSquare actually ends, following the movement cards
+// (same destinations as m_execute_chance_card / m_execute_community_chest_card)
+static void
+m__ai_add_landing(float* afNext, uint8_t uSquare, float fProbability)
+{
+    eSquareType eType = m_get_square_type(uSquare);
+
+    if(eType == SQUARE_GO_TO_JAIL)
+    {
+        afNext[10] += fProbability;
+    }
+    else if(eType == SQUARE_CHANCE)
+    {
+        // 9 of the 16 chance cards move the player
+        float fCard = fProbability / (float)TOTAL_CHANCE_CARDS;
+        afNext[0]  += fCard;                                      // go
+        afNext[24] += fCard;                                      // illinois avenue
+        afNext[11] += fCard;                                      // st. charles place
+        afNext[m__ai_next_square_of_type(uSquare, false)] += fCard; // nearest utility
+        afNext[m__ai_next_square_of_type(uSquare, true)]  += fCard; // nearest railroad
+        afNext[10] += fCard;                                      // go to jail
+        afNext[5]  += fCard;                                      // reading railroad
+        afNext[39] += fCard;                                      // boardwalk
+        m__ai_add_landing(afNext, (uint8_t)((uSquare + TOTAL_BOARD_SQUARES - 3) % TOTAL_BOARD_SQUARES), fCard); // back 3
+        afNext[uSquare] += fCard * (float)(TOTAL_CHANCE_CARDS - 9);
+    }
+    else if(eType == SQUARE_COMMUNITY_CHEST)
+    {
+        // advance to go and go to jail
+        float fCard = fProbability / (float)TOTAL_COMMUNITY_CHEST_CARDS;
+        afNext[0]  += fCard;
+        afNext[10] += fCard;
+        afNext[uSquare] += fCard * (float)(TOTAL_COMMUNITY_CHEST_CARDS - 2);
+    }
+    else
+    {
+        afNext[uSquare] += fProbability;
+    }
+}
+
+// stationary distribution of the square a turn ends on (one roll per turn, jail is
+// left on the next roll)
+static void
+m__ai_compute_square_probabilities(float* afProbabilities)
+{
+    float afNext[TOTAL_BOARD_SQUARES];
+
+    for(uint8_t i = 0; i < TOTAL_BOARD_SQUARES; i++)
+        afProbabilities[i] = 1.0f / (float)TOTAL_BOARD_SQUARES;
+
+    for(uint32_t uIteration = 0; uIteration < M__AI_MODEL_ITERATIONS; uIteration++)
+    {
+        memset(afNext, 0, sizeof(afNext));
+        for(uint8_t uFrom = 0; uFrom < TOTAL_BOARD_SQUARES; uFrom++)
+        {
+            for(uint8_t uRoll = 2; uRoll <= 12; uRoll++)
+            {
+                int iWays = 6 - (uRoll > 7 ? uRoll - 7 : 7 - uRoll);
+                float fRoll = afProbabilities[uFrom] * (float)iWays / 36.0f;
+                m__ai_add_landing(afNext, (uint8_t)((uFrom + uRoll) % TOTAL_BOARD_SQUARES), fRoll);
+            }
+        }
+        memcpy(afProbabilities, afNext, sizeof(afNext));
+    }
+}
+
+void
+m_ai_init_model(mAiModel* ptModel)
+{
+    memset(ptModel, 0, sizeof(mAiModel));
+    m__ai_compute_square_probabilities(ptModel->afSquareProbability);
+    ptModel->fHorizonTurns         = 20.0f;
+    ptModel->fCashReserve          = 200.0f;
+    ptModel->fCashShortfallPenalty = 0.5f;
+    ptModel->fDevelopmentWeight    = 0.5f;
+    ptModel->fRivalryWeight        = 0.5f;
+    ptModel->fAcceptMargin         = 25.0f;
+}
+
+float
+m_ai_get_property_probability(const mAiModel* ptModel, mGameData* pGame, uint8_t uPropertyIndex)
+{
+    return ptModel->afSquareProbability[pGame->amProperties[uPropertyIndex].uPosition];
+}
+
+// ==================== VALUATION ==================== //
+
+// rent an opponent pays on average when landing here
+static float
+m__ai_expected_rent(mGameData* pGame, uint8_t uPropertyIndex)
+{
+    mProperty* pProp = &pGame->amProperties[uPropertyIndex];
+
+    // roughly what it earns once paid off again
+    if(pProp->bIsMortgaged)
+        return (float)pProp->uRentBase;
+
+    float fRent = (float)m_calculate_rent(pGame, uPropertyIndex);
+    if(pProp->eType == PROPERTY_TYPE_UTILITY)
+        fRent *= M__AI_AVERAGE_DICE;
+    return fRent;
+}
+
+static float
+m__ai_cash_value(const mAiModel* ptModel, uint32_t uMoney)
+{
+    float fMoney = (float)uMoney;
+    if(fMoney >= ptModel->fCashReserve)
+        return fMoney;
+    return fMoney - (ptModel->fCashReserve - fMoney) * ptModel->fCashShortfallPenalty;
+}
+
+float
+m_ai_evaluate_position(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex)
+{
+    mPlayer* pPlayer = &pGame->amPlayers[uPlayerIndex];
+    if(pPlayer->bIsBankrupt)
+        return 0.0f;
+
+    // rent only comes from the other players
+    uint8_t uOpponents = pGame->uActivePlayers > 1 ? (uint8_t)(pGame->uActivePlayers - 1) : 0;
+    float fIncomeScale = ptModel->fHorizonTurns * (float)uOpponents;
+
+    float fValue = m__ai_cash_value(ptModel, pPlayer->uMoney);
+
+    for(uint8_t i = 0; i < pPlayer->uPropertyCount; i++)
+    {
+        uint8_t uPropIdx = pPlayer->auPropertiesOwned[i];
+        mProperty* pProp = &pGame->amProperties[uPropIdx];
+        float fProbability = m_ai_get_property_probability(ptModel, pGame, uPropIdx);
+        float fIncome = fIncomeScale * fProbability * m__ai_expected_rent(pGame, uPropIdx);
+
+        if(pProp->bIsMortgaged)
+        {
+            // worth what it earns after paying the mortgage off
+            float fPayoff = (float)pProp->uMortgageValue * 1.1f;
+            fValue += fIncome > fPayoff ? fIncome - fPayoff : 0.0f;
+            continue;
+        }
+
+        // what could be raised from it plus what it earns
+        fValue += (float)pProp->uMortgageValue + fIncome;
+        if(pProp->bHasHotel)
+            fValue += (float)(pProp->uHouseCost / 2) * 5.0f;
+        else
+            fValue += (float)(pProp->uHouseCost / 2) * (float)pProp->uHouses;
+
+        // a completed set can be built up to 3 houses, where rent returns are best
+        if(pProp->eType == PROPERTY_TYPE_STREET && !pProp->bHasHotel && pProp->uHouses < 3 &&
+           m_owns_color_set(pGame, uPlayerIndex, pProp->eColor))
+        {
+            float fBuiltIncome = fIncomeScale * fProbability * (float)pProp->auRentWithHouses[3];
+            float fBuildCost = (float)((3 - pProp->uHouses) * pProp->uHouseCost);
+            float fGain = fBuiltIncome - fBuildCost - fIncome;
+            if(fGain > 0.0f)
+                fValue += fGain * ptModel->fDevelopmentWeight;
+        }
+    }
+
+    return fValue;
+}
+
+float
+m_ai_evaluate_standing(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex)
+{
+    float fOpponents = 0.0f;
+    uint8_t uOpponentCount = 0;
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        if(i == uPlayerIndex || pGame->amPlayers[i].bIsBankrupt)
+            continue;
+        fOpponents += m_ai_evaluate_position(ptModel, pGame, i);
+        uOpponentCount++;
+    }
+
+    float fValue = m_ai_evaluate_position(ptModel, pGame, uPlayerIndex);
+    if(uOpponentCount > 0)
+        fValue -= ptModel->fRivalryWeight * fOpponents / (float)uOpponentCount;
+    return fValue;
+}
+
+// ==================== SPECULATION ==================== //
+
+// changes made between begin and end are rolled back on a private journal, and the
+// game ends up exactly where it was so observers shouldn't see a change
+typedef struct _mAiSpeculation
+{
+    mChange         atChanges[M_AI_TRADE_JOURNAL_SIZE];
+    mChangeJournal  tJournal;
+    mChangeJournal* pSavedJournal;
+    uint64_t        uStateVersion;
+    uint32_t        uDirtyFields;
+    uint32_t        uDirtyProperties;
+    uint8_t         uDirtyPlayers;
+} mAiSpeculation;
+
+static void
+m__ai_begin_speculation(mGameData* pGame, mAiSpeculation* ptSpeculation)
+{
+    memset(&ptSpeculation->tJournal, 0, sizeof(mChangeJournal));
+    ptSpeculation->tJournal.atChanges = ptSpeculation->atChanges;
+    ptSpeculation->tJournal.uCapacity = M_AI_TRADE_JOURNAL_SIZE;
+    ptSpeculation->pSavedJournal    = pGame->pJournal;
+    ptSpeculation->uStateVersion    = pGame->uStateVersion;
+    ptSpeculation->uDirtyFields     = pGame->uDirtyFields;
+    ptSpeculation->uDirtyProperties = pGame->uDirtyProperties;
+    ptSpeculation->uDirtyPlayers    = pGame->uDirtyPlayers;
+    pGame->pJournal = &ptSpeculation->tJournal;
+}
+
+static bool
+m__ai_end_speculation(mGameData* pGame, mAiSpeculation* ptSpeculation)
+{
+    bool bRestored = m_rollback(pGame, 0);
+    pGame->pJournal         = ptSpeculation->pSavedJournal;
+    pGame->uStateVersion    = ptSpeculation->uStateVersion;
+    pGame->uDirtyFields     = ptSpeculation->uDirtyFields;
+    pGame->uDirtyProperties = ptSpeculation->uDirtyProperties;
+    pGame->uDirtyPlayers    = ptSpeculation->uDirtyPlayers;
+    return bRestored;
+}
+
+// weight of one opponent's gain against ours
+static float
+m__ai_rivalry_share(const mAiModel* ptModel, mGameData* pGame)
+{
+    if(pGame->uActivePlayers > 1)
+        return ptModel->fRivalryWeight / (float)(pGame->uActivePlayers - 1);
+    return ptModel->fRivalryWeight;
+}
+
+// ==================== TRADES ==================== //
+
+bool
+m_ai_is_trade_valid(mGameData* pGame, uint8_t uFromPlayer, const mTradeData* pTrade)
+{
+    uint8_t uToPlayer = pTrade->uTargetPlayer;
+    if(uFromPlayer >= pGame->uPlayerCount || uToPlayer >= pGame->uPlayerCount || uFromPlayer == uToPlayer)
+        return false;
+
+    mPlayer* pFrom = &pGame->amPlayers[uFromPlayer];
+    mPlayer* pTo = &pGame->amPlayers[uToPlayer];
+    if(pFrom->bIsBankrupt || pTo->bIsBankrupt)
+        return false;
+    if(pTrade->uOfferedMoney > pFrom->uMoney || pTrade->uRequestedMoney > pTo->uMoney)
+        return false;
+
+    for(uint8_t i = 0; i < pTrade->uOfferedPropertyCount; i++)
+    {
+        uint8_t uPropIdx = pTrade->auOfferedProperties[i];
+        if(uPropIdx >= TOTAL_PROPERTIES || pGame->amProperties[uPropIdx].uOwnerIndex != uFromPlayer)
+            return false;
+    }
+    for(uint8_t i = 0; i < pTrade->uRequestedPropertyCount; i++)
+    {
+        uint8_t uPropIdx = pTrade->auRequestedProperties[i];
+        if(uPropIdx >= TOTAL_PROPERTIES || pGame->amProperties[uPropIdx].uOwnerIndex != uToPlayer)
+            return false;
+    }
+    return true;
+}
+
+bool
+m_ai_evaluate_trade(const mAiModel* ptModel, mGameData* pGame, uint8_t uFromPlayer, const mTradeData* pTrade, mTradeScore* ptScoreOut)
+{
+    if(!m_ai_is_trade_valid(pGame, uFromPlayer, pTrade))
+        return false;
+
+    uint8_t uToPlayer = pTrade->uTargetPlayer;
+    float fFromBefore = m_ai_evaluate_position(ptModel, pGame, uFromPlayer);
+    float fToBefore   = m_ai_evaluate_position(ptModel, pGame, uToPlayer);
+
+    mAiSpeculation tSpeculation;
+    m__ai_begin_speculation(pGame, &tSpeculation);
+    m_apply_trade(pGame, uFromPlayer, pTrade);
+    float fFromAfter = m_ai_evaluate_position(ptModel, pGame, uFromPlayer);
+    float fToAfter   = m_ai_evaluate_position(ptModel, pGame, uToPlayer);
+    if(!m__ai_end_speculation(pGame, &tSpeculation))
+        return false;
+
+    // nobody else's position moves, so each side's standing changes by its own gain
+    // less its share of the other side's
+    float fRivalry = m__ai_rivalry_share(ptModel, pGame);
+    float fFromDelta = fFromAfter - fFromBefore;
+    float fToDelta   = fToAfter - fToBefore;
+    ptScoreOut->fFromGain = fFromDelta - fToDelta * fRivalry;
+    ptScoreOut->fToGain   = fToDelta - fFromDelta * fRivalry;
+    return true;
+}
+
+bool
+m_ai_should_accept_trade(const mAiModel* ptModel, mGameData* pGame, uint8_t uFromPlayer, const mTradeData* pTrade)
+{
+    mTradeScore tScore;
+    if(!m_ai_evaluate_trade(ptModel, pGame, uFromPlayer, pTrade, &tScore))
+        return false;
+    return tScore.fToGain >= ptModel->fAcceptMargin;
+}
+
+// ==================== TRADE GENERATION ==================== //
+
+// a group of properties one player could hand over in one piece
+typedef struct _mAiTradeGroup
+{
+    uint8_t auProperties[4];
+    uint8_t uCount;
+} mAiTradeGroup;
+
+// properties of a color held by a player, or false if they can't be traded (buildings
+// in the group have to be sold first)
+static bool
+m__ai_collect_group(mGameData* pGame, uint8_t uPlayerIndex, ePropertyColor eColor, mAiTradeGroup* ptGroupOut)
+{
+    ptGroupOut->uCount = 0;
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        mProperty* pProp = &pGame->amProperties[i];
+        if(pProp->eColor != eColor)
+            continue;
+        if(pProp->uHouses > 0 || pProp->bHasHotel)
+            return false;
+        if(pProp->uOwnerIndex == uPlayerIndex && ptGroupOut->uCount < 4)
+            ptGroupOut->auProperties[ptGroupOut->uCount++] = i;
+    }
+    return ptGroupOut->uCount > 0;
+}
+
+// groups uGiver holds that would complete (or for railroads and utilities, grow) a
+// set uTaker has started. everything else is pruned: it can't change rent levels.
+static uint32_t
+m__ai_find_useful_groups(mGameData* pGame, uint8_t uGiver, uint8_t uTaker, mAiTradeGroup* atGroupsOut)
+{
+    uint32_t uCount = 0;
+    for(uint32_t uColor = COLOR_BROWN; uColor <= COLOR_UTILITY; uColor++)
+    {
+        ePropertyColor eColor = (ePropertyColor)uColor;
+        uint8_t uTakerCount = m_count_properties_of_color(pGame, uTaker, eColor);
+        if(uTakerCount == 0)
+            continue;
+
+        mAiTradeGroup tGroup;
+        if(!m__ai_collect_group(pGame, uGiver, eColor, &tGroup))
+            continue;
+
+        bool bCompletes = uTakerCount + tGroup.uCount == m_get_color_set_size(eColor);
+        if(bCompletes || eColor == COLOR_RAILROAD || eColor == COLOR_UTILITY)
+            atGroupsOut[uCount++] = tGroup;
+    }
+    return uCount;
+}
+
+static float
+m__ai_score_with_money(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex, mTradeData* pTrade,
+    uint32_t uOffered, uint32_t uRequested, mTradeScore* ptScoreOut)
+{
+    pTrade->uOfferedMoney = uOffered;
+    pTrade->uRequestedMoney = uRequested;
+    if(!m_ai_evaluate_trade(ptModel, pGame, uPlayerIndex, pTrade, ptScoreOut))
+        return -1e30f;
+    return ptScoreOut->fToGain;
+}
+
+// settles the cash side of a property swap: the least money the other side accepts,
+// or the most it would pay on top. the other side's gain only rises with money offered
+// and only falls with money requested, so both are binary searches.
+static bool
+m__ai_balance_trade(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex, mTradeData* pTrade, mTradeScore* ptScoreOut)
+{
+    float fMargin = ptModel->fAcceptMargin;
+    uint32_t uFromSteps = pGame->amPlayers[uPlayerIndex].uMoney / M__AI_MONEY_STEP;
+    uint32_t uToSteps = pGame->amPlayers[pTrade->uTargetPlayer].uMoney / M__AI_MONEY_STEP;
+    mTradeScore tScore;
+
+    if(m__ai_score_with_money(ptModel, pGame, uPlayerIndex, pTrade, 0, 0, &tScore) >= fMargin)
+    {
+        // largest request they still accept
+        uint32_t uLow = 0;
+        uint32_t uHigh = uToSteps;
+        while(uLow < uHigh)
+        {
+            uint32_t uMid = (uLow + uHigh + 1) / 2;
+            if(m__ai_score_with_money(ptModel, pGame, uPlayerIndex, pTrade, 0, uMid * M__AI_MONEY_STEP, &tScore) >= fMargin)
+                uLow = uMid;
+            else
+                uHigh = uMid - 1;
+        }
+        m__ai_score_with_money(ptModel, pGame, uPlayerIndex, pTrade, 0, uLow * M__AI_MONEY_STEP, &tScore);
+    }
+    else
+    {
+        // smallest offer they accept
+        if(m__ai_score_with_money(ptModel, pGame, uPlayerIndex, pTrade, uFromSteps * M__AI_MONEY_STEP, 0, &tScore) < fMargin)
+            return false;
+
+        uint32_t uLow = 0;
+        uint32_t uHigh = uFromSteps;
+        while(uLow < uHigh)
+        {
+            uint32_t uMid = (uLow + uHigh) / 2;
+            if(m__ai_score_with_money(ptModel, pGame, uPlayerIndex, pTrade, uMid * M__AI_MONEY_STEP, 0, &tScore) >= fMargin)
+                uHigh = uMid;
+            else
+                uLow = uMid + 1;
+        }
+        m__ai_score_with_money(ptModel, pGame, uPlayerIndex, pTrade, uLow * M__AI_MONEY_STEP, 0, &tScore);
+    }
+
+    *ptScoreOut = tScore;
+    return tScore.fFromGain >= fMargin && tScore.fToGain >= fMargin;
+}
+
+// keeps the list sorted by the proposer's gain, dropping the worst when full
+static uint32_t
+m__ai_insert_candidate(mTradeCandidate* atCandidates, uint32_t uCount, uint32_t uMaxCandidates, const mTradeData* pTrade, const mTradeScore* ptScore)
+{
+    uint32_t uPos = uCount;
+    while(uPos > 0 && atCandidates[uPos - 1].tScore.fFromGain < ptScore->fFromGain)
+        uPos--;
+    if(uPos >= uMaxCandidates)
+        return uCount;
+
+    uint32_t uNewCount = uCount < uMaxCandidates ? uCount + 1 : uMaxCandidates;
+    for(uint32_t i = uNewCount - 1; i > uPos; i--)
+        atCandidates[i] = atCandidates[i - 1];
+    atCandidates[uPos].tTrade = *pTrade;
+    atCandidates[uPos].tScore = *ptScore;
+    return uNewCount;
+}
+
+static void
+m__ai_add_group(uint8_t* auProperties, uint8_t* puCount, const mAiTradeGroup* ptGroup)
+{
+    for(uint8_t i = 0; i < ptGroup->uCount; i++)
+        auProperties[(*puCount)++] = ptGroup->auProperties[i];
+}
+
+uint32_t
+m_ai_generate_trades(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex, mTradeCandidate* atCandidatesOut, uint32_t uMaxCandidates)
+{
+    if(uPlayerIndex >= pGame->uPlayerCount || pGame->amPlayers[uPlayerIndex].bIsBankrupt || uMaxCandidates == 0)
+        return 0;
+
+    uint32_t uCount = 0;
+    mAiTradeGroup atWanted[COLOR_NONE];
+    mAiTradeGroup atGiven[COLOR_NONE];
+
+    for(uint8_t uTarget = 0; uTarget < pGame->uPlayerCount; uTarget++)
+    {
+        if(uTarget == uPlayerIndex || pGame->amPlayers[uTarget].bIsBankrupt)
+            continue;
+
+        // only ask for what moves one of our sets forward, and only give what moves one
+        // of theirs (or nothing, for a cash purchase)
+        uint32_t uWantedCount = m__ai_find_useful_groups(pGame, uTarget, uPlayerIndex, atWanted);
+        if(uWantedCount == 0)
+            continue;
+        uint32_t uGivenCount = m__ai_find_useful_groups(pGame, uPlayerIndex, uTarget, atGiven);
+
+        for(uint32_t uWanted = 0; uWanted < uWantedCount; uWanted++)
+        {
+            for(uint32_t uGiven = 0; uGiven <= uGivenCount; uGiven++)
+            {
+                mTradeData tTrade;
+                memset(&tTrade, 0, sizeof(mTradeData));
+                tTrade.eStep = TRADE_STEP_AWAITING_RESPONSE;
+                tTrade.uTargetPlayer = uTarget;
+                m__ai_add_group(tTrade.auRequestedProperties, &tTrade.uRequestedPropertyCount, &atWanted[uWanted]);
+                if(uGiven < uGivenCount)
+                    m__ai_add_group(tTrade.auOfferedProperties, &tTrade.uOfferedPropertyCount, &atGiven[uGiven]);
+
+                mTradeScore tScore;
+                if(m__ai_balance_trade(ptModel, pGame, uPlayerIndex, &tTrade, &tScore))
+                    uCount = m__ai_insert_candidate(atCandidatesOut, uCount, uMaxCandidates, &tTrade, &tScore);
+            }
+        }
+    }
+
+    return uCount;
+}
+
+// ==================== AUCTIONS ==================== //
+
+// what each player's position gains from owning an unowned property for free
+static void
+m__ai_property_gains(const mAiModel* ptModel, mGameData* pGame, uint8_t uPropertyIndex, float* afGainsOut)
+{
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        afGainsOut[i] = 0.0f;
+        if(pGame->amPlayers[i].bIsBankrupt)
+            continue;
+
+        float fBefore = m_ai_evaluate_position(ptModel, pGame, i);
+        mAiSpeculation tSpeculation;
+        m__ai_begin_speculation(pGame, &tSpeculation);
+        m_set_property_owner(pGame, uPropertyIndex, i);
+        float fAfter = m_ai_evaluate_position(ptModel, pGame, i);
+        if(m__ai_end_speculation(pGame, &tSpeculation))
+            afGainsOut[i] = fAfter - fBefore;
+    }
+}
+
+// most a player pays before the cash given up is worth more than fGain. cash value is
+// linear above the reserve and steeper below it, so this inverts it piecewise.
+static uint32_t
+m__ai_price_for_gain(const mAiModel* ptModel, uint32_t uMoney, float fGain)
+{
+    if(fGain <= 0.0f)
+        return 0;
+
+    float fMoney = (float)uMoney;
+    float fPrice = fGain;
+    if(fMoney - fGain < ptModel->fCashReserve)
+    {
+        float fSlope = 1.0f + ptModel->fCashShortfallPenalty;
+        fPrice = fMoney + (fGain - m__ai_cash_value(ptModel, uMoney) - ptModel->fCashShortfallPenalty * ptModel->fCashReserve) / fSlope;
+    }
+
+    if(fPrice <= 0.0f)
+        return 0;
+    if(fPrice >= fMoney)
+        return uMoney;
+    return (uint32_t)fPrice;
+}
+
+static uint32_t
+m__ai_reservation_from_gains(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex, const float* afGains)
+{
+    // keeping it away from whoever wants it most is worth our share of their gain
+    float fBlocking = 0.0f;
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        if(i != uPlayerIndex && afGains[i] > fBlocking)
+            fBlocking = afGains[i];
+    }
+
+    float fGain = afGains[uPlayerIndex] + fBlocking * m__ai_rivalry_share(ptModel, pGame);
+    return m__ai_price_for_gain(ptModel, pGame->amPlayers[uPlayerIndex].uMoney, fGain);
+}
+
+uint32_t
+m_ai_get_reservation_price(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex, uint8_t uPropertyIndex)
+{
+    if(uPlayerIndex >= pGame->uPlayerCount || pGame->amPlayers[uPlayerIndex].bIsBankrupt ||
+       pGame->amProperties[uPropertyIndex].uOwnerIndex != BANK_PLAYER_INDEX)
+        return 0;
+
+    float afGains[MAX_PLAYERS];
+    m__ai_property_gains(ptModel, pGame, uPropertyIndex, afGains);
+    return m__ai_reservation_from_gains(ptModel, pGame, uPlayerIndex, afGains);
+}
+
+bool
+m_ai_resolve_auction(const mAiModel* ptModel, mGameData* pGame, uint8_t uPropertyIndex, uint8_t uBidderMask,
+    uint8_t uFirstBidder, uint8_t* puWinnerOut, uint32_t* puPriceOut)
+{
+    *puWinnerOut = BANK_PLAYER_INDEX;
+    *puPriceOut = 0;
+    if(pGame->amProperties[uPropertyIndex].uOwnerIndex != BANK_PLAYER_INDEX || pGame->uPlayerCount == 0)
+        return false;
+
+    float afGains[MAX_PLAYERS];
+    m__ai_property_gains(ptModel, pGame, uPropertyIndex, afGains);
+
+    // with $1 raises in bidding order everyone stays in until their reservation price,
+    // so the highest reservation wins (earliest bidder on ties) at one over the runner up
+    uint32_t uBest = 0;
+    uint32_t uSecond = 0;
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        uint8_t uBidder = (uint8_t)((uFirstBidder + i) % pGame->uPlayerCount);
+        if(!(uBidderMask & (1u << uBidder)) || pGame->amPlayers[uBidder].bIsBankrupt)
+            continue;
+
+        uint32_t uReservation = m__ai_reservation_from_gains(ptModel, pGame, uBidder, afGains);
+        if(uReservation > uBest)
+        {
+            uSecond = uBest;
+            uBest = uReservation;
+            *puWinnerOut = uBidder;
+        }
+        else if(uReservation > uSecond)
+        {
+            uSecond = uReservation;
+        }
+    }
+
+    if(*puWinnerOut == BANK_PLAYER_INDEX)
+        return false;
+
+    *puPriceOut = uSecond + 1 < uBest ? uSecond + 1 : uBest;
+    return true;
+}
+
+bool
+m_ai_auction_resolver(mGameFlow* pFlow, mAuctionData* pAuction, void* pUserData)
+{
+    const mAiPlayers* ptPlayers = (const mAiPlayers*)pUserData;
+    mGameData* pGame = pFlow->pGame;
+
+    // a person at the table bids through the ui
+    uint8_t uBidders = 0;
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        if(pGame->amPlayers[i].bIsBankrupt)
+            continue;
+        if(!(ptPlayers->uComputerPlayers & (1u << i)))
+            return false;
+        uBidders |= (uint8_t)(1u << i);
+    }
+
+    uint8_t uWinner = BANK_PLAYER_INDEX;
+    uint32_t uPrice = 0;
+    m_ai_resolve_auction(ptPlayers->ptModel, pGame, (uint8_t)pAuction->ePropertyIndex, uBidders,
+        pAuction->uCurrentBidder, &uWinner, &uPrice);
+    pAuction->uHighestBidder = uWinner;
+    pAuction->uHighestBid = uPrice;
+    return true;
+}
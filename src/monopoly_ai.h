@@ -0,0 +1,74 @@
+#ifndef MONOPOLY_AI_H
+#define MONOPOLY_AI_H
+
+#include "monopoly.h"
+
+// computer player decisions. positions are valued as cash plus what the holdings are
+// expected to earn in rent over the next few turns (using the long run chance of a turn
+// ending on each square), and a trade is scored by how much it moves each party's value
+// against the rest of the table. trades are evaluated by applying them to the live game
+// and rolling them back, so everything the rules functions know (m_owns_color_set,
+// railroad counts, ...) is taken into account without a separate model of the rules.
+
+// ==================== CONSTANTS ==================== //
+
+#define M_AI_MAX_TRADE_CANDIDATES 32 // most candidates m_ai_generate_trades keeps
+#define M_AI_TRADE_JOURNAL_SIZE   320 // changes one trade can make (every property moving + money)
+
+// ==================== STRUCTS ==================== //
+
+// read only after m_ai_init_model, so one model can be shared by every table and thread
+typedef struct _mAiModel
+{
+    float afSquareProbability[TOTAL_BOARD_SQUARES]; // chance a turn ends on each square
+    float fHorizonTurns;                            // turns of rent income a property is worth
+    float fCashReserve;                             // cash below this is worth less (bankruptcy risk)
+    float fCashShortfallPenalty;                    // value lost per dollar under the reserve
+    float fDevelopmentWeight;                       // share of the value of building up a new color set
+    float fRivalryWeight;                           // how much an opponent's gain counts against ours
+    float fAcceptMargin;                            // gain a player needs before agreeing to a trade
+} mAiModel;
+
+typedef struct _mTradeScore
+{
+    float fFromGain; // change in standing for the player making the offer
+    float fToGain;   // change in standing for the player receiving it
+} mTradeScore;
+
+typedef struct _mTradeCandidate
+{
+    mTradeData  tTrade;
+    mTradeScore tScore;
+} mTradeCandidate;
+
+// which seats are computer controlled, passed as the auction resolver's user data
+typedef struct _mAiPlayers
+{
+    const mAiModel* ptModel;
+    uint8_t         uComputerPlayers; // bit per player
+} mAiPlayers;
+
+// ==================== AI FUNCTIONS ==================== //
+
+// model
+void  m_ai_init_model(mAiModel* ptModel); // default weights + landing probabilities
+float m_ai_get_property_probability(const mAiModel* ptModel, mGameData* pGame, uint8_t uPropertyIndex);
+
+// valuation
+float m_ai_evaluate_position(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex);
+float m_ai_evaluate_standing(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex); // position minus the average opponent
+
+// trades (the game is changed and restored while scoring, the state version and dirty bits are kept)
+bool     m_ai_is_trade_valid(mGameData* pGame, uint8_t uFromPlayer, const mTradeData* pTrade);
+bool     m_ai_evaluate_trade(const mAiModel* ptModel, mGameData* pGame, uint8_t uFromPlayer, const mTradeData* pTrade, mTradeScore* ptScoreOut); // false if invalid
+bool     m_ai_should_accept_trade(const mAiModel* ptModel, mGameData* pGame, uint8_t uFromPlayer, const mTradeData* pTrade);
+uint32_t m_ai_generate_trades(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex, mTradeCandidate* atCandidatesOut, uint32_t uMaxCandidates); // best first, only ones the other side accepts
+
+// auctions: a player bids up to the most their position gains from the property (plus
+// a share of what it's worth to the keenest opponent), converted to cash at the rate
+// m_ai_evaluate_position values money
+uint32_t m_ai_get_reservation_price(const mAiModel* ptModel, mGameData* pGame, uint8_t uPlayerIndex, uint8_t uPropertyIndex);
+bool     m_ai_resolve_auction(const mAiModel* ptModel, mGameData* pGame, uint8_t uPropertyIndex, uint8_t uBidderMask, uint8_t uFirstBidder, uint8_t* puWinnerOut, uint32_t* puPriceOut); // false if nobody bids
+bool     m_ai_auction_resolver(mGameFlow* pFlow, mAuctionData* pAuction, void* pUserData); // fAuctionResolver, pUserData = mAiPlayers*, settles only auctions with no people in them
+
+#endif // MONOPOLY_AI_H
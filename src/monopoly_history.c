@@ -0,0 +1,286 @@
+#include "monopoly_history.h"
+#include <stddef.h> // offsetof
+#include <stdlib.h> // malloc, free (M_ALLOC)
+#include <string.h> // memcpy, memset
+#include "monopoly_platform.h"
+
+// ==================== CONSTANTS ==================== //
+
+#define M_HISTORY_INITIAL_SIZE (16u << 20) // file space is doubled whenever it runs out
+#define M_HISTORY_MAX_PENDING  64          // full chunks queued before appending threads wait
+#define M_HISTORY_COLUMN_COUNT 9
+#define M_HISTORY_NAME_SIZE    16
+
+// ==================== STRUCTS ==================== //
+
+typedef struct _mHistoryWriter
+{
+    mMappedFile    tFile;   // only the writer thread touches it while running
+    size_t         szUsed;
+    bool           bFailed;
+
+    mMutex         tMutex;  // guards everything below
+    mCondition     tWake;   // chunks queued or stopping
+    mCondition     tDrained;
+    mHistoryChunk* ptPendingHead;
+    mHistoryChunk* ptPendingTail;
+    mHistoryChunk* ptFree;
+    uint32_t       uPending;
+    bool           bStop;
+    mThread*       ptThread;
+} mHistoryWriter;
+
+typedef struct _mHistoryColumn
+{
+    const char* pcName;
+    uint32_t    uWidth;
+    size_t      szOffset; // of the array in mHistoryChunk
+} mHistoryColumn;
+
+static const mHistoryColumn gatHistoryColumns[M_HISTORY_COLUMN_COUNT] = {
+    {"game",      4, offsetof(mHistoryChunk, auGame)},
+    {"turn",      4, offsetof(mHistoryChunk, auTurn)},
+    {"money",     4, offsetof(mHistoryChunk, auMoney)},
+    {"rent_paid", 4, offsetof(mHistoryChunk, auRentPaid)},
+    {"player",    1, offsetof(mHistoryChunk, auPlayer)},
+    {"die1",      1, offsetof(mHistoryChunk, auDie1)},
+    {"die2",      1, offsetof(mHistoryChunk, auDie2)},
+    {"position",  1, offsetof(mHistoryChunk, auPosition)},
+    {"actions",   1, offsetof(mHistoryChunk, auActions)},
+};
+
+// ==================== WRITER THREAD ==================== //
+
+// reserves space in the mapping, growing the file when needed
+static uint8_t*
+m__history_reserve(mHistoryWriter* ptWriter, size_t szBytes)
+{
+    if(ptWriter->bFailed)
+        return NULL;
+
+    if(ptWriter->szUsed + szBytes > ptWriter->tFile.szSize)
+    {
+        size_t szSize = ptWriter->tFile.szSize;
+        while(ptWriter->szUsed + szBytes > szSize)
+            szSize *= 2;
+        if(!m_map_file_resize(&ptWriter->tFile, szSize))
+        {
+            ptWriter->bFailed = true;
+            return NULL;
+        }
+    }
+
+    uint8_t* puData = (uint8_t*)ptWriter->tFile.pData + ptWriter->szUsed;
+    ptWriter->szUsed += szBytes;
+    return puData;
+}
+
+static void
+m__history_write_chunk(mHistoryWriter* ptWriter, const mHistoryChunk* ptChunk)
+{
+    size_t szBytes = 8;
+    for(uint32_t i = 0; i < M_HISTORY_COLUMN_COUNT; i++)
+        szBytes += (size_t)gatHistoryColumns[i].uWidth * ptChunk->uRows;
+    size_t szPadded = (szBytes + 7) & ~(size_t)7;
+
+    uint8_t* puOut = m__history_reserve(ptWriter, szPadded);
+    if(!puOut)
+        return;
+
+    uint32_t auHeader[2] = { ptChunk->uRows, 0 };
+    memcpy(puOut, auHeader, sizeof(auHeader));
+    puOut += sizeof(auHeader);
+    for(uint32_t i = 0; i < M_HISTORY_COLUMN_COUNT; i++)
+    {
+        size_t szColumn = (size_t)gatHistoryColumns[i].uWidth * ptChunk->uRows;
+        memcpy(puOut, (const uint8_t*)ptChunk + gatHistoryColumns[i].szOffset, szColumn);
+        puOut += szColumn;
+    }
+    memset(puOut, 0, szPadded - szBytes);
+}
+
+static void
+m__history_thread(void* pData)
+{
+    mHistoryWriter* ptWriter = (mHistoryWriter*)pData;
+
+    m_mutex_lock(&ptWriter->tMutex);
+    while(true)
+    {
+        while(!ptWriter->ptPendingHead && !ptWriter->bStop)
+            m_condition_wait(&ptWriter->tWake, &ptWriter->tMutex, 100);
+        if(!ptWriter->ptPendingHead)
+            break; // stopping and drained
+
+        mHistoryChunk* ptChunk = ptWriter->ptPendingHead;
+        ptWriter->ptPendingHead = ptChunk->ptNext;
+        if(!ptWriter->ptPendingHead)
+            ptWriter->ptPendingTail = NULL;
+
+        // copy without holding the lock so appending threads can keep submitting
+        m_mutex_unlock(&ptWriter->tMutex);
+        m__history_write_chunk(ptWriter, ptChunk);
+        m_mutex_lock(&ptWriter->tMutex);
+
+        ptChunk->ptNext  = ptWriter->ptFree;
+        ptWriter->ptFree = ptChunk;
+        ptWriter->uPending--;
+        m_condition_wake_all(&ptWriter->tDrained);
+    }
+    m_mutex_unlock(&ptWriter->tMutex);
+}
+
+// ==================== HISTORY FUNCTIONS ==================== //
+
+mHistoryWriter*
+m_history_open(const char* pcPath)
+{
+    mHistoryWriter* ptWriter = M_ALLOC(sizeof(mHistoryWriter));
+    if(!ptWriter)
+        return NULL;
+    memset(ptWriter, 0, sizeof(mHistoryWriter));
+
+    if(!m_map_file_create(&ptWriter->tFile, pcPath, M_HISTORY_INITIAL_SIZE))
+    {
+        M_FREE(ptWriter);
+        return NULL;
+    }
+
+    // file header, the writer thread isn't running yet
+    uint32_t auHeader[2] = { M_HISTORY_FILE_VERSION, M_HISTORY_COLUMN_COUNT };
+    uint8_t* puOut = m__history_reserve(ptWriter, 4 + sizeof(auHeader) + M_HISTORY_COLUMN_COUNT * (M_HISTORY_NAME_SIZE + 4));
+    memcpy(puOut, "MHIS", 4);
+    memcpy(puOut + 4, auHeader, sizeof(auHeader));
+    puOut += 4 + sizeof(auHeader);
+    for(uint32_t i = 0; i < M_HISTORY_COLUMN_COUNT; i++)
+    {
+        memset(puOut, 0, M_HISTORY_NAME_SIZE);
+        memcpy(puOut, gatHistoryColumns[i].pcName, strlen(gatHistoryColumns[i].pcName));
+        memcpy(puOut + M_HISTORY_NAME_SIZE, &gatHistoryColumns[i].uWidth, 4);
+        puOut += M_HISTORY_NAME_SIZE + 4;
+    }
+
+    m_mutex_init(&ptWriter->tMutex);
+    m_condition_init(&ptWriter->tWake);
+    m_condition_init(&ptWriter->tDrained);
+    ptWriter->ptThread = m_thread_create(m__history_thread, ptWriter);
+    if(!ptWriter->ptThread)
+    {
+        // no writer thread to stop, so not m_history_close
+        m_map_file_close(&ptWriter->tFile, ptWriter->szUsed);
+        m_condition_cleanup(&ptWriter->tDrained);
+        m_condition_cleanup(&ptWriter->tWake);
+        m_mutex_cleanup(&ptWriter->tMutex);
+        M_FREE(ptWriter);
+        return NULL;
+    }
+    return ptWriter;
+}
+
+bool
+m_history_close(mHistoryWriter* ptWriter)
+{
+    if(!ptWriter)
+        return false;
+
+    m_mutex_lock(&ptWriter->tMutex);
+    ptWriter->bStop = true;
+    m_condition_wake_all(&ptWriter->tWake);
+    m_mutex_unlock(&ptWriter->tMutex);
+    m_thread_join(ptWriter->ptThread);
+
+    bool bOk = !ptWriter->bFailed;
+    bOk &= m_map_file_close(&ptWriter->tFile, ptWriter->szUsed);
+
+    while(ptWriter->ptFree)
+    {
+        mHistoryChunk* ptNext = ptWriter->ptFree->ptNext;
+        M_FREE(ptWriter->ptFree);
+        ptWriter->ptFree = ptNext;
+    }
+    m_condition_cleanup(&ptWriter->tDrained);
+    m_condition_cleanup(&ptWriter->tWake);
+    m_mutex_cleanup(&ptWriter->tMutex);
+    M_FREE(ptWriter);
+    return bOk;
+}
+
+// queues the buffer's chunk (if any rows) and returns a free one, NULL when bTake is false
+static mHistoryChunk*
+m__history_submit(mHistoryWriter* ptWriter, mHistoryChunk* ptChunk, bool bTake)
+{
+    m_mutex_lock(&ptWriter->tMutex);
+
+    if(ptChunk && ptChunk->uRows > 0)
+    {
+        while(ptWriter->uPending >= M_HISTORY_MAX_PENDING)
+            m_condition_wait(&ptWriter->tDrained, &ptWriter->tMutex, 100);
+
+        ptChunk->ptNext = NULL;
+        if(ptWriter->ptPendingTail)
+            ptWriter->ptPendingTail->ptNext = ptChunk;
+        else
+            ptWriter->ptPendingHead = ptChunk;
+        ptWriter->ptPendingTail = ptChunk;
+        ptWriter->uPending++;
+        m_condition_wake_one(&ptWriter->tWake);
+    }
+    else if(ptChunk)
+    {
+        ptChunk->ptNext  = ptWriter->ptFree;
+        ptWriter->ptFree = ptChunk;
+    }
+
+    mHistoryChunk* ptNew = NULL;
+    if(bTake && ptWriter->ptFree)
+    {
+        ptNew = ptWriter->ptFree;
+        ptWriter->ptFree = ptNew->ptNext;
+    }
+    m_mutex_unlock(&ptWriter->tMutex);
+
+    if(bTake && !ptNew)
+        ptNew = M_ALLOC(sizeof(mHistoryChunk));
+    if(ptNew)
+        ptNew->uRows = 0;
+    return ptNew;
+}
+
+void
+m_history_buffer_init(mHistoryWriter* ptWriter, mHistoryBuffer* ptBuffer)
+{
+    ptBuffer->ptWriter = ptWriter;
+    ptBuffer->ptChunk  = NULL;
+}
+
+void
+m_history_buffer_flush(mHistoryBuffer* ptBuffer)
+{
+    if(ptBuffer->ptChunk)
+        m__history_submit(ptBuffer->ptWriter, ptBuffer->ptChunk, false);
+    ptBuffer->ptChunk = NULL;
+}
+
+void
+m_history_append(mHistoryBuffer* ptBuffer, uint32_t uGame, const mTurnRecord* pTurn)
+{
+    mHistoryChunk* ptChunk = ptBuffer->ptChunk;
+    if(!ptChunk || ptChunk->uRows == M_HISTORY_CHUNK_ROWS)
+    {
+        ptChunk = m__history_submit(ptBuffer->ptWriter, ptChunk, true);
+        ptBuffer->ptChunk = ptChunk;
+        if(!ptChunk)
+            return; // out of memory, the row is lost
+    }
+
+    uint32_t uRow = ptChunk->uRows++;
+    ptChunk->auGame[uRow]     = uGame;
+    ptChunk->auTurn[uRow]     = pTurn->uTurn;
+    ptChunk->auMoney[uRow]    = pTurn->uMoney;
+    ptChunk->auRentPaid[uRow] = pTurn->uRentPaid;
+    ptChunk->auPlayer[uRow]   = pTurn->uPlayer;
+    ptChunk->auDie1[uRow]     = pTurn->uDie1;
+    ptChunk->auDie2[uRow]     = pTurn->uDie2;
+    ptChunk->auPosition[uRow] = pTurn->uPosition;
+    ptChunk->auActions[uRow]  = pTurn->uActions;
+}
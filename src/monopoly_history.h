@@ -0,0 +1,58 @@
+#ifndef MONOPOLY_HISTORY_H
+#define MONOPOLY_HISTORY_H
+
+#include "monopoly.h"
+
+// turn by turn game history for offline analysis. simulator threads append finished turns
+// (mTurnRecord) to their own mHistoryBuffer without locking, full buffers are handed to a
+// background thread that copies them into a memory mapped, append only file. the file is
+// columnar, every chunk stores each column's rows back to back:
+//
+//   header  "MHIS", uint32 version, uint32 column count
+//           per column: char name[16], uint32 bytes per value
+//   chunk   uint32 rows, uint32 reserved, then each column (rows * bytes), padded to 8 bytes
+//
+// values are in native byte order. columns in order: game, turn, money, rent_paid (uint32),
+// player, die1, die2, position, actions (uint8, eTurnAction bits)
+
+// ==================== CONSTANTS ==================== //
+
+#define M_HISTORY_FILE_VERSION 1
+#define M_HISTORY_CHUNK_ROWS   4096
+
+// ==================== STRUCTS ==================== //
+
+typedef struct _mHistoryWriter mHistoryWriter;
+
+typedef struct _mHistoryChunk
+{
+    struct _mHistoryChunk* ptNext;
+    uint32_t uRows;
+    uint32_t auGame[M_HISTORY_CHUNK_ROWS];
+    uint32_t auTurn[M_HISTORY_CHUNK_ROWS];
+    uint32_t auMoney[M_HISTORY_CHUNK_ROWS];
+    uint32_t auRentPaid[M_HISTORY_CHUNK_ROWS];
+    uint8_t  auPlayer[M_HISTORY_CHUNK_ROWS];
+    uint8_t  auDie1[M_HISTORY_CHUNK_ROWS];
+    uint8_t  auDie2[M_HISTORY_CHUNK_ROWS];
+    uint8_t  auPosition[M_HISTORY_CHUNK_ROWS];
+    uint8_t  auActions[M_HISTORY_CHUNK_ROWS];
+} mHistoryChunk;
+
+// one per thread, never shared
+typedef struct _mHistoryBuffer
+{
+    mHistoryWriter* ptWriter;
+    mHistoryChunk*  ptChunk; // rows not yet handed to the writer
+} mHistoryBuffer;
+
+// ==================== HISTORY FUNCTIONS ==================== //
+
+mHistoryWriter* m_history_open(const char* pcPath); // NULL if the file can't be created
+bool            m_history_close(mHistoryWriter* ptWriter); // flush buffers first, false if anything failed to write
+
+void m_history_buffer_init(mHistoryWriter* ptWriter, mHistoryBuffer* ptBuffer);
+void m_history_buffer_flush(mHistoryBuffer* ptBuffer); // hands over a partial chunk and releases the buffer
+void m_history_append(mHistoryBuffer* ptBuffer, uint32_t uGame, const mTurnRecord* pTurn);
+
+#endif // MONOPOLY_HISTORY_H
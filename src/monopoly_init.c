@@ -1,14 +1,144 @@
-
+#include <stdlib.h> // malloc, free
 #include <string.h> // memset etc...
 #include <time.h> // srand
 #include <stdio.h> // printf
 #include <stdarg.h>  // va_copy, va_start, va_end 
 
-#define PL_JSON_IMPLEMENTATION
-#include "pl_json.h"
-
 #include "monopoly_init.h"
 
+#ifdef M_USE_BUILTIN_JSON
+    #include "monopoly_json.h"
+#else
+    #define PL_JSON_IMPLEMENTATION
+    #include "pl_json.h"
+#endif
+
+#define M_DEFAULT_DATA_DIRECTORY "../../monopoly/game_data"
+#define M_DATA_MAX_TOKENS        2048 // properties.json is ~650 tokens
+
+// ==================== DATA FILES ==================== //
+
+// a game data file is a root object holding one array of entries. the loader only ever reads
+// members of those entries, so this is all the json it needs from either backend.
+typedef struct _mDataFile
+{
+    char*    pcText;
+    uint32_t uCount; // entries in the array
+#ifdef M_USE_BUILTIN_JSON
+    mJsonToken*   atTokens;
+    mJsonDocument tDoc;
+    int32_t       iArray;
+#else
+    plJsonObject* ptRoot;
+    plJsonObject* ptArray;
+#endif
+} mDataFile;
+
+static bool
+m__open_data_file(mDataFile* ptFile, const char* pcDirectory, const char* pcFileName, const char* pcArrayName)
+{
+    memset(ptFile, 0, sizeof(mDataFile));
+
+    char cPath[512] = {0};
+    snprintf(cPath, sizeof(cPath), "%s/%s", pcDirectory, pcFileName);
+    FILE* ptStream = fopen(cPath, "rb");
+    if(!ptStream)
+    {
+        printf("Failed to open %s\n", pcFileName);
+        return false;
+    }
+
+    // read the whole file, no fixed size buffer to outgrow
+    fseek(ptStream, 0, SEEK_END);
+    long lSize = ftell(ptStream);
+    fseek(ptStream, 0, SEEK_SET);
+    if(lSize < 0)
+    {
+        fclose(ptStream);
+        return false;
+    }
+    ptFile->pcText = M_ALLOC((size_t)lSize + 1);
+    if(!ptFile->pcText)
+    {
+        fclose(ptStream);
+        return false;
+    }
+    size_t szRead = fread(ptFile->pcText, 1, (size_t)lSize, ptStream);
+    ptFile->pcText[szRead] = '\0';
+    fclose(ptStream);
+
+#ifdef M_USE_BUILTIN_JSON
+    ptFile->atTokens = M_ALLOC(sizeof(mJsonToken) * M_DATA_MAX_TOKENS);
+    if(!ptFile->atTokens || !m_json_parse(&ptFile->tDoc, ptFile->pcText, ptFile->atTokens, M_DATA_MAX_TOKENS))
+    {
+        printf("Failed to parse %s\n", pcFileName);
+        if(ptFile->atTokens)
+            M_FREE(ptFile->atTokens);
+        M_FREE(ptFile->pcText);
+        return false;
+    }
+    ptFile->iArray = m_json_member(&ptFile->tDoc, 0, pcArrayName);
+    ptFile->uCount = m_json_count(&ptFile->tDoc, ptFile->iArray);
+#else
+    pl_load_json(ptFile->pcText, &ptFile->ptRoot);
+    ptFile->ptArray = pl_json_array_member(ptFile->ptRoot, pcArrayName, &ptFile->uCount);
+#endif
+    return true;
+}
+
+static void
+m__close_data_file(mDataFile* ptFile)
+{
+#ifdef M_USE_BUILTIN_JSON
+    M_FREE(ptFile->atTokens);
+#else
+    pl_unload_json(&ptFile->ptRoot);
+#endif
+    M_FREE(ptFile->pcText);
+    memset(ptFile, 0, sizeof(mDataFile));
+}
+
+static uint32_t
+m__data_uint(mDataFile* ptFile, uint32_t uEntry, const char* pcKey)
+{
+#ifdef M_USE_BUILTIN_JSON
+    int32_t iEntry = m_json_element(&ptFile->tDoc, ptFile->iArray, uEntry);
+    return m_json_uint(&ptFile->tDoc, m_json_member(&ptFile->tDoc, iEntry, pcKey), 0);
+#else
+    return pl_json_uint_member(pl_json_member_by_index(ptFile->ptArray, uEntry), pcKey, 0);
+#endif
+}
+
+static void
+m__data_string(mDataFile* ptFile, uint32_t uEntry, const char* pcKey, char* pcOut, uint32_t uOutSize)
+{
+#ifdef M_USE_BUILTIN_JSON
+    int32_t iEntry = m_json_element(&ptFile->tDoc, ptFile->iArray, uEntry);
+    m_json_string(&ptFile->tDoc, m_json_member(&ptFile->tDoc, iEntry, pcKey), pcOut, uOutSize);
+#else
+    pl_json_string_member(pl_json_member_by_index(ptFile->ptArray, uEntry), pcKey, pcOut, uOutSize);
+#endif
+}
+
+static void
+m__data_uint_array(mDataFile* ptFile, uint32_t uEntry, const char* pcKey, uint32_t* auOut, uint32_t uCount)
+{
+    memset(auOut, 0, sizeof(uint32_t) * uCount);
+#ifdef M_USE_BUILTIN_JSON
+    int32_t iEntry = m_json_element(&ptFile->tDoc, ptFile->iArray, uEntry);
+    int32_t iArray = m_json_member(&ptFile->tDoc, iEntry, pcKey);
+    uint32_t uFound = m_json_count(&ptFile->tDoc, iArray);
+    for(uint32_t i = 0; i < uFound && i < uCount; i++)
+        auOut[i] = m_json_uint(&ptFile->tDoc, m_json_element(&ptFile->tDoc, iArray, i), 0);
+#else
+    int32_t aiValues[16] = {0}; // function requires int type
+    uint32_t uFound = uCount < 16 ? uCount : 16;
+    pl_json_int_array_member(pl_json_member_by_index(ptFile->ptArray, uEntry), pcKey, aiValues, &uFound);
+    for(uint32_t i = 0; i < uFound && i < uCount; i++)
+        auOut[i] = (uint32_t)aiValues[i];
+#endif
+}
+
 
 static ePropertyColor
 m_string_to_color_enum(const char* cColor)
@@ -86,65 +216,52 @@ m_init_players(mPlayer* pPlayers, uint8_t uPlayerCount, uint32_t uStartingMoney)
 mGameData*
 m_init_game(mGameSettings tSettings)
 {
+    M_PROFILE_BEGIN("m_init_game");
+
     // seed random number generator (for dice)
     srand((unsigned int)time(NULL));
 
     // allocate and zero-initialize game data
-    mGameData* pGame = calloc(1, sizeof(mGameData));
+    mGameData* pGame = M_ALLOC(sizeof(mGameData));
     if(!pGame)
     {
         printf("Failed to allocate game data\n");
+        M_PROFILE_END();
         return NULL;
     }
+    memset(pGame, 0, sizeof(mGameData));
+
+    const char* pcDirectory = tSettings.pcDataDirectory ? tSettings.pcDataDirectory : M_DEFAULT_DATA_DIRECTORY;
+    mDataFile tFile = {0};
 
     // ==================== LOAD PROPERTIES ==================== //
-    FILE* jsonFileProperties = fopen("../../monopoly/game_data/properties.json", "r");
-    if(!jsonFileProperties)
+    if(!m__open_data_file(&tFile, pcDirectory, "properties.json", "properties"))
     {
-        printf("Failed to open properties.json\n");
-        free(pGame);
+        M_FREE(pGame);
+        M_PROFILE_END();
         return NULL;
     }
 
-    char jsonBufferProperties[8000] = {0};
-    fread(jsonBufferProperties, 1, 8000, jsonFileProperties);
-    fclose(jsonFileProperties);
-
-    plJsonObject* tRootProperties = NULL;
-    pl_load_json(jsonBufferProperties, &tRootProperties);
-
-    uint32_t uPropertyCount = 0;
-    plJsonObject* tPropertyArray = pl_json_array_member(tRootProperties, "properties", &uPropertyCount);
-
-    for(uint32_t i = 0; i < uPropertyCount && i < TOTAL_PROPERTIES; i++)
+    for(uint32_t i = 0; i < tFile.uCount && i < TOTAL_PROPERTIES; i++)
     {
-        plJsonObject* tProp = pl_json_member_by_index(tPropertyArray, i);
-        
         char cName[50] = {0};
         char cType[20] = {0};
         char cColor[20] = {0};
         
-        pl_json_string_member(tProp, "name", cName, 50);
-        pl_json_string_member(tProp, "type", cType, 20);
-        pl_json_string_member(tProp, "color", cColor, 20);
+        m__data_string(&tFile, i, "name", cName, 50);
+        m__data_string(&tFile, i, "type", cType, 20);
+        m__data_string(&tFile, i, "color", cColor, 20);
         
         strncpy(pGame->amProperties[i].cName, cName, 49);
         pGame->amProperties[i].eType = m_string_to_type_enum(cType);
         pGame->amProperties[i].eColor = m_string_to_color_enum(cColor);
-        pGame->amProperties[i].uPrice = pl_json_uint_member(tProp, "price", 0);
-        pGame->amProperties[i].uPosition = (uint8_t)pl_json_uint_member(tProp, "position", 0);
-        pGame->amProperties[i].uMortgageValue = pl_json_uint_member(tProp, "mortgage", 0);
-        pGame->amProperties[i].uHouseCost = pl_json_uint_member(tProp, "house_cost", 0);
+        pGame->amProperties[i].uPrice = m__data_uint(&tFile, i, "price");
+        pGame->amProperties[i].uPosition = (uint8_t)m__data_uint(&tFile, i, "position");
+        pGame->amProperties[i].uMortgageValue = m__data_uint(&tFile, i, "mortgage");
+        pGame->amProperties[i].uHouseCost = m__data_uint(&tFile, i, "house_cost");
         
         // read rent array
-        uint32_t uRentCount = 6;
-        int32_t aiRent[6] = {0}; // function requires int type 
-        pl_json_int_array_member(tProp, "rent", aiRent, &uRentCount);
-        
-        for(uint8_t j = 0; j < 6; j++)
-        {
-            pGame->amProperties[i].auRentWithHouses[j] = (uint32_t)aiRent[j];
-        }
+        m__data_uint_array(&tFile, i, "rent", pGame->amProperties[i].auRentWithHouses, 6);
         
         // set base rent and monopoly rent from rent array
         pGame->amProperties[i].uRentBase = pGame->amProperties[i].auRentWithHouses[0];
@@ -157,65 +274,39 @@ m_init_game(mGameSettings tSettings)
         pGame->amProperties[i].bHasHotel = false;
     }
 
-    pl_unload_json(&tRootProperties);
+    m__close_data_file(&tFile);
 
     // ==================== LOAD CHANCE CARDS ==================== //
-    FILE* jsonFileChance = fopen("../../monopoly/game_data/chance_cards.json", "r");
-    if(!jsonFileChance)
+    if(!m__open_data_file(&tFile, pcDirectory, "chance_cards.json", "chance_cards"))
     {
-        printf("Failed to open chance_cards.json\n");
-        free(pGame);
+        M_FREE(pGame);
+        M_PROFILE_END();
         return NULL;
     }
 
-    char jsonBufferChance[4000] = {0};
-    fread(jsonBufferChance, 1, 4000, jsonFileChance);
-    fclose(jsonFileChance);
-
-    plJsonObject* tRootChance = NULL;
-    pl_load_json(jsonBufferChance, &tRootChance);
-
-    uint32_t uChanceCount = 0;
-    plJsonObject* tChanceArray = pl_json_array_member(tRootChance, "chance_cards", &uChanceCount);
-
-    for(uint32_t i = 0; i < uChanceCount && i < 16; i++)
+    for(uint32_t i = 0; i < tFile.uCount && i < 16; i++)
     {
-        plJsonObject* tCard = pl_json_member_by_index(tChanceArray, i);
-        
-        pGame->amChanceCards[i].uCardID = pl_json_uint_member(tCard, "id", 0);
-        pl_json_string_member(tCard, "description", pGame->amChanceCards[i].cDescription, 199);
+        pGame->amChanceCards[i].uCardID = m__data_uint(&tFile, i, "id");
+        m__data_string(&tFile, i, "description", pGame->amChanceCards[i].cDescription, 199);
     }
 
-    pl_unload_json(&tRootChance);
+    m__close_data_file(&tFile);
 
     // ==================== LOAD COMMUNITY CHEST CARDS ==================== //
-    FILE* jsonFileCommChest = fopen("../../monopoly/game_data/community_chest_cards.json", "r");
-    if(!jsonFileCommChest)
+    if(!m__open_data_file(&tFile, pcDirectory, "community_chest_cards.json", "community_chest_cards"))
     {
-        printf("Failed to open community_chest_cards.json\n");
-        free(pGame);
+        M_FREE(pGame);
+        M_PROFILE_END();
         return NULL;
     }
 
-    char jsonBufferCommChest[4000] = {0};
-    fread(jsonBufferCommChest, 1, 4000, jsonFileCommChest);
-    fclose(jsonFileCommChest);
-
-    plJsonObject* tRootCommChest = NULL;
-    pl_load_json(jsonBufferCommChest, &tRootCommChest);
-
-    uint32_t uCommChestCount = 0;
-    plJsonObject* tCommChestArray = pl_json_array_member(tRootCommChest, "community_chest_cards", &uCommChestCount);
-
-    for(uint32_t i = 0; i < uCommChestCount && i < 16; i++)
+    for(uint32_t i = 0; i < tFile.uCount && i < 16; i++)
     {
-        plJsonObject* tCard = pl_json_member_by_index(tCommChestArray, i);
-        
-        pGame->amCommunityChestCards[i].uCardID = pl_json_uint_member(tCard, "id", 0);
-        pl_json_string_member(tCard, "description", pGame->amCommunityChestCards[i].cDescription, 199);
+        pGame->amCommunityChestCards[i].uCardID = m__data_uint(&tFile, i, "id");
+        m__data_string(&tFile, i, "description", pGame->amCommunityChestCards[i].cDescription, 199);
     }
 
-    pl_unload_json(&tRootCommChest);
+    m__close_data_file(&tFile);
 
     // ==================== INITIALIZE OTHER COMPONENTS ==================== //
     
@@ -235,6 +326,7 @@ m_init_game(mGameSettings tSettings)
     pGame->uGlobalHotelSupply = 12;
     pGame->uGlobalHouseSupply = 32;
 
+    M_PROFILE_END();
     return pGame;
 }
 
@@ -245,6 +337,6 @@ m_free_game(mGameData* pGame)
 {
     if(pGame)
     {
-        free(pGame);
+        M_FREE(pGame);
     }
 }
\ No newline at end of file
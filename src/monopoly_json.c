@@ -0,0 +1,322 @@
+#include "monopoly_json.h"
+#include <stdlib.h> // strtod
+#include <string.h> // memcmp
+
+// ==================== PARSING ==================== //
+
+static void
+m__json_skip_whitespace(const char* pcText, uint32_t* puPos)
+{
+    while(pcText[*puPos] == ' ' || pcText[*puPos] == '\t' || pcText[*puPos] == '\n' || pcText[*puPos] == '\r')
+        (*puPos)++;
+}
+
+static int32_t
+m__json_push(mJsonDocument* ptDoc, eJsonType eType, uint32_t uStart)
+{
+    if(ptDoc->uTokenCount >= ptDoc->uCapacity)
+        return -1;
+
+    int32_t iToken = (int32_t)ptDoc->uTokenCount++;
+    mJsonToken* ptToken = &ptDoc->atTokens[iToken];
+    ptToken->uType       = (uint32_t)eType;
+    ptToken->uStart      = uStart;
+    ptToken->uLength     = 0;
+    ptToken->uChildCount = 0;
+    ptToken->uNext       = ptDoc->uTokenCount;
+    return iToken;
+}
+
+static bool
+m__json_parse_string(mJsonDocument* ptDoc, uint32_t* puPos)
+{
+    const char* pcText = ptDoc->pcText;
+    (*puPos)++; // opening quote
+
+    int32_t iToken = m__json_push(ptDoc, JSON_TYPE_STRING, *puPos);
+    if(iToken < 0)
+        return false;
+
+    while(pcText[*puPos] != '"')
+    {
+        char c = pcText[*puPos];
+        if(c == '\0' || c == '\n')
+            return false;
+        if(c == '\\')
+        {
+            (*puPos)++;
+            if(pcText[*puPos] == '\0')
+                return false;
+        }
+        (*puPos)++;
+    }
+
+    ptDoc->atTokens[iToken].uLength = *puPos - ptDoc->atTokens[iToken].uStart;
+    (*puPos)++; // closing quote
+    return true;
+}
+
+static bool
+m__json_parse_primitive(mJsonDocument* ptDoc, uint32_t* puPos)
+{
+    const char* pcText = ptDoc->pcText;
+    uint32_t uStart = *puPos;
+
+    static const char* apcLiterals[] = { "true", "false", "null" };
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        size_t szLength = strlen(apcLiterals[i]);
+        if(strncmp(&pcText[uStart], apcLiterals[i], szLength) == 0)
+        {
+            int32_t iToken = m__json_push(ptDoc, JSON_TYPE_LITERAL, uStart);
+            if(iToken < 0)
+                return false;
+            ptDoc->atTokens[iToken].uLength = (uint32_t)szLength;
+            *puPos += (uint32_t)szLength;
+            return true;
+        }
+    }
+
+    // number: sign, digits, fraction and exponent are all just accepted here and left to strtod
+    bool bHasDigit = false;
+    while(true)
+    {
+        char c = pcText[*puPos];
+        if(c >= '0' && c <= '9')
+            bHasDigit = true;
+        else if(c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E')
+            break;
+        (*puPos)++;
+    }
+    if(!bHasDigit)
+        return false;
+
+    int32_t iToken = m__json_push(ptDoc, JSON_TYPE_NUMBER, uStart);
+    if(iToken < 0)
+        return false;
+    ptDoc->atTokens[iToken].uLength = *puPos - uStart;
+    return true;
+}
+
+static bool
+m__json_parse_value(mJsonDocument* ptDoc, uint32_t* puPos, uint32_t uDepth)
+{
+    const char* pcText = ptDoc->pcText;
+    m__json_skip_whitespace(pcText, puPos);
+
+    char c = pcText[*puPos];
+    if(c == '"')
+        return m__json_parse_string(ptDoc, puPos);
+    if(c != '{' && c != '[')
+        return m__json_parse_primitive(ptDoc, puPos);
+
+    if(uDepth >= M_JSON_MAX_DEPTH)
+        return false;
+
+    bool bObject = c == '{';
+    char cClose = bObject ? '}' : ']';
+    int32_t iToken = m__json_push(ptDoc, bObject ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY, *puPos);
+    if(iToken < 0)
+        return false;
+    uint32_t uStart = *puPos;
+    (*puPos)++;
+
+    m__json_skip_whitespace(pcText, puPos);
+    if(pcText[*puPos] == cClose)
+    {
+        (*puPos)++;
+    }
+    else
+    {
+        while(true)
+        {
+            if(bObject)
+            {
+                // key then colon
+                m__json_skip_whitespace(pcText, puPos);
+                if(pcText[*puPos] != '"' || !m__json_parse_string(ptDoc, puPos))
+                    return false;
+                m__json_skip_whitespace(pcText, puPos);
+                if(pcText[*puPos] != ':')
+                    return false;
+                (*puPos)++;
+            }
+
+            if(!m__json_parse_value(ptDoc, puPos, uDepth + 1))
+                return false;
+            ptDoc->atTokens[iToken].uChildCount++;
+
+            m__json_skip_whitespace(pcText, puPos);
+            if(pcText[*puPos] == ',')
+            {
+                (*puPos)++;
+                continue;
+            }
+            if(pcText[*puPos] != cClose)
+                return false;
+            (*puPos)++;
+            break;
+        }
+    }
+
+    // children were pushed after this token, so the subtree ends at the current count
+    ptDoc->atTokens[iToken].uLength = *puPos - uStart;
+    ptDoc->atTokens[iToken].uNext   = ptDoc->uTokenCount;
+    return true;
+}
+
+bool
+m_json_parse(mJsonDocument* ptDoc, const char* pcText, mJsonToken* atTokens, uint32_t uCapacity)
+{
+    ptDoc->pcText      = pcText;
+    ptDoc->atTokens    = atTokens;
+    ptDoc->uTokenCount = 0;
+    ptDoc->uCapacity   = uCapacity;
+
+    uint32_t uPos = 0;
+    if(!m__json_parse_value(ptDoc, &uPos, 0))
+    {
+        ptDoc->uTokenCount = 0;
+        return false;
+    }
+
+    // nothing but whitespace after the root value
+    m__json_skip_whitespace(pcText, &uPos);
+    if(pcText[uPos] != '\0')
+    {
+        ptDoc->uTokenCount = 0;
+        return false;
+    }
+    return true;
+}
+
+// ==================== LOOKUP ==================== //
+
+static const mJsonToken*
+m__json_token(const mJsonDocument* ptDoc, int32_t iValue)
+{
+    if(iValue < 0 || (uint32_t)iValue >= ptDoc->uTokenCount)
+        return NULL;
+    return &ptDoc->atTokens[iValue];
+}
+
+int32_t
+m_json_member(const mJsonDocument* ptDoc, int32_t iObject, const char* pcKey)
+{
+    const mJsonToken* ptObject = m__json_token(ptDoc, iObject);
+    if(!ptObject || ptObject->uType != JSON_TYPE_OBJECT)
+        return -1;
+
+    size_t szKeyLength = strlen(pcKey);
+    uint32_t uKey = (uint32_t)iObject + 1;
+    for(uint32_t i = 0; i < ptObject->uChildCount; i++)
+    {
+        const mJsonToken* ptKey = &ptDoc->atTokens[uKey];
+        if(ptKey->uLength == szKeyLength && memcmp(&ptDoc->pcText[ptKey->uStart], pcKey, szKeyLength) == 0)
+            return (int32_t)(uKey + 1);
+        uKey = ptDoc->atTokens[uKey + 1].uNext; // skip the value
+    }
+    return -1;
+}
+
+int32_t
+m_json_element(const mJsonDocument* ptDoc, int32_t iArray, uint32_t uIndex)
+{
+    const mJsonToken* ptArray = m__json_token(ptDoc, iArray);
+    if(!ptArray || ptArray->uType != JSON_TYPE_ARRAY || uIndex >= ptArray->uChildCount)
+        return -1;
+
+    uint32_t uElement = (uint32_t)iArray + 1;
+    for(uint32_t i = 0; i < uIndex; i++)
+        uElement = ptDoc->atTokens[uElement].uNext;
+    return (int32_t)uElement;
+}
+
+uint32_t
+m_json_count(const mJsonDocument* ptDoc, int32_t iValue)
+{
+    const mJsonToken* ptToken = m__json_token(ptDoc, iValue);
+    if(!ptToken || (ptToken->uType != JSON_TYPE_OBJECT && ptToken->uType != JSON_TYPE_ARRAY))
+        return 0;
+    return ptToken->uChildCount;
+}
+
+uint32_t
+m_json_uint(const mJsonDocument* ptDoc, int32_t iValue, uint32_t uDefault)
+{
+    const mJsonToken* ptToken = m__json_token(ptDoc, iValue);
+    if(!ptToken || ptToken->uType != JSON_TYPE_NUMBER)
+        return uDefault;
+
+    // strtod stops at the first character that isn't part of the number
+    double dValue = strtod(&ptDoc->pcText[ptToken->uStart], NULL);
+    if(dValue < 0.0 || dValue > 4294967295.0)
+        return uDefault;
+    return (uint32_t)dValue;
+}
+
+int32_t
+m_json_int(const mJsonDocument* ptDoc, int32_t iValue, int32_t iDefault)
+{
+    const mJsonToken* ptToken = m__json_token(ptDoc, iValue);
+    if(!ptToken || ptToken->uType != JSON_TYPE_NUMBER)
+        return iDefault;
+
+    double dValue = strtod(&ptDoc->pcText[ptToken->uStart], NULL);
+    if(dValue < -2147483648.0 || dValue > 2147483647.0)
+        return iDefault;
+    return (int32_t)dValue;
+}
+
+static uint32_t
+m__json_hex_digit(char c)
+{
+    if(c >= '0' && c <= '9') return (uint32_t)(c - '0');
+    if(c >= 'a' && c <= 'f') return (uint32_t)(c - 'a' + 10);
+    if(c >= 'A' && c <= 'F') return (uint32_t)(c - 'A' + 10);
+    return 0;
+}
+
+bool
+m_json_string(const mJsonDocument* ptDoc, int32_t iValue, char* pcOut, uint32_t uOutSize)
+{
+    if(uOutSize == 0)
+        return false;
+    pcOut[0] = '\0';
+
+    const mJsonToken* ptToken = m__json_token(ptDoc, iValue);
+    if(!ptToken || ptToken->uType != JSON_TYPE_STRING)
+        return false;
+
+    const char* pcText = &ptDoc->pcText[ptToken->uStart];
+    uint32_t uOut = 0;
+    for(uint32_t i = 0; i < ptToken->uLength && uOut + 1 < uOutSize; i++)
+    {
+        char c = pcText[i];
+        if(c == '\\' && i + 1 < ptToken->uLength)
+        {
+            c = pcText[++i];
+            switch(c)
+            {
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u':
+                {
+                    // game data is ascii, anything else becomes '?'
+                    uint32_t uCodepoint = 0;
+                    for(uint32_t j = 0; j < 4 && i + 1 < ptToken->uLength; j++)
+                        uCodepoint = (uCodepoint << 4) | m__json_hex_digit(pcText[++i]);
+                    c = uCodepoint < 128 ? (char)uCodepoint : '?';
+                    break;
+                }
+                default: break; // \" \\ \/ are the character itself
+            }
+        }
+        pcOut[uOut++] = c;
+    }
+    pcOut[uOut] = '\0';
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef MONOPOLY_JSON_H
+#define MONOPOLY_JSON_H
+
+#include <stdint.h> // uint
+#include <stdbool.h> // bool
+
+// small json reader for the game data files, used instead of pilot light's pl_json when
+// the core is built with M_USE_BUILTIN_JSON (headless tools, ci). the text is parsed
+// into a caller owned flat token array and never copied, so values are looked up by
+// walking the tokens and read straight out of the text.
+
+// ==================== CONSTANTS ==================== //
+
+#define M_JSON_MAX_DEPTH 32
+
+// ==================== ENUMS ==================== //
+
+typedef enum _eJsonType
+{
+    JSON_TYPE_NONE,
+    JSON_TYPE_OBJECT,
+    JSON_TYPE_ARRAY,
+    JSON_TYPE_STRING,
+    JSON_TYPE_NUMBER,
+    JSON_TYPE_LITERAL // true, false, null
+} eJsonType;
+
+// ==================== STRUCTS ==================== //
+
+// objects are followed by key, value, key, value ... and arrays by their values
+typedef struct _mJsonToken
+{
+    uint32_t uType;       // eJsonType
+    uint32_t uStart;      // offset into the text (strings without the quotes)
+    uint32_t uLength;
+    uint32_t uChildCount; // members or elements
+    uint32_t uNext;       // first token after this value and everything in it
+} mJsonToken;
+
+typedef struct _mJsonDocument
+{
+    const char* pcText;
+    mJsonToken* atTokens;
+    uint32_t    uTokenCount;
+    uint32_t    uCapacity;
+} mJsonDocument;
+
+// ==================== JSON FUNCTIONS ==================== //
+
+bool     m_json_parse(mJsonDocument* ptDoc, const char* pcText, mJsonToken* atTokens, uint32_t uCapacity); // false on syntax error or too many tokens, root is token 0
+int32_t  m_json_member(const mJsonDocument* ptDoc, int32_t iObject, const char* pcKey);     // token of a member's value, -1 if missing
+int32_t  m_json_element(const mJsonDocument* ptDoc, int32_t iArray, uint32_t uIndex);       // -1 if out of range
+uint32_t m_json_count(const mJsonDocument* ptDoc, int32_t iValue);                          // members or elements, 0 for anything else
+uint32_t m_json_uint(const mJsonDocument* ptDoc, int32_t iValue, uint32_t uDefault);
+int32_t  m_json_int(const mJsonDocument* ptDoc, int32_t iValue, int32_t iDefault);
+bool     m_json_string(const mJsonDocument* ptDoc, int32_t iValue, char* pcOut, uint32_t uOutSize); // unescapes, always terminates
+
+#endif // MONOPOLY_JSON_H
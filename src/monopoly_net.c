@@ -0,0 +1,653 @@
+#include "monopoly_net.h"
+#include <string.h>
+
+// ==================== INTERNAL HELPERS ==================== //
+
+#define M_NET_HISTORY_MASK (M_NET_HISTORY_SIZE - 1)
+#define M_NET_QUEUE_MASK   (M_NET_QUEUE_SIZE - 1)
+#define M_NET_OWNER_BANK   7 // 3 bit owner field value for BANK_PLAYER_INDEX
+
+// true if sequence a is newer than b (handles 16 bit wrap)
+static bool
+m__net_sequence_newer(uint16_t uA, uint16_t uB)
+{
+    return (int16_t)(uint16_t)(uA - uB) > 0;
+}
+
+// baseline for full snapshots: nothing owned, everything zero
+static void
+m__net_empty_snapshot(mNetSnapshot* ptSnapshot)
+{
+    memset(ptSnapshot, 0, sizeof(mNetSnapshot));
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+        ptSnapshot->atProperties[i].uOwnerIndex = BANK_PLAYER_INDEX;
+}
+
+static uint8_t
+m__net_get_phase_id(fPhaseFunc pfPhase)
+{
+    if(pfPhase == m_phase_pre_roll)            return NET_PHASE_PRE_ROLL;
+    if(pfPhase == m_phase_post_roll)           return NET_PHASE_POST_ROLL;
+    if(pfPhase == m_phase_jail)                return NET_PHASE_JAIL;
+    if(pfPhase == m_phase_property_management) return NET_PHASE_PROPERTY_MANAGEMENT;
+    if(pfPhase == m_phase_auction)             return NET_PHASE_AUCTION;
+    if(pfPhase == m_phase_bankruptcy)          return NET_PHASE_BANKRUPTCY;
+    if(pfPhase == m_phase_trade)               return NET_PHASE_TRADE;
+    return NET_PHASE_NONE;
+}
+
+static bool
+m__net_players_equal(const mNetPlayerState* ptA, const mNetPlayerState* ptB)
+{
+    return ptA->uMoney == ptB->uMoney && ptA->uPosition == ptB->uPosition && ptA->uJailTurns == ptB->uJailTurns &&
+           ptA->bHasJailFreeCard == ptB->bHasJailFreeCard && ptA->bIsBankrupt == ptB->bIsBankrupt;
+}
+
+static bool
+m__net_properties_equal(const mNetPropertyState* ptA, const mNetPropertyState* ptB)
+{
+    return ptA->uOwnerIndex == ptB->uOwnerIndex && ptA->uHouses == ptB->uHouses &&
+           ptA->bHasHotel == ptB->bHasHotel && ptA->bIsMortgaged == ptB->bIsMortgaged;
+}
+
+static void
+m__net_write_header(mNetBitWriter* ptWriter, eNetPacketType eType, uint16_t uSequence)
+{
+    m_net_write_bits(ptWriter, (uint32_t)eType, 2);
+    m_net_write_bits(ptWriter, uSequence, 16);
+}
+
+static uint16_t
+m__net_packet_bytes(const mNetBitWriter* ptWriter)
+{
+    return (uint16_t)((ptWriter->uBitPos + 7) / 8);
+}
+
+// ==================== BIT PACKING ==================== //
+
+// bits are packed lsb first; the buffer must start zeroed
+void
+m_net_write_bits(mNetBitWriter* ptWriter, uint32_t uValue, uint32_t uBitCount)
+{
+    if(ptWriter->uBitPos + uBitCount > ptWriter->uCapacityBits)
+    {
+        ptWriter->bOverflow = true;
+        return;
+    }
+
+    while(uBitCount > 0)
+    {
+        uint32_t uBitOffset = ptWriter->uBitPos & 7;
+        uint32_t uChunk = 8 - uBitOffset;
+        if(uChunk > uBitCount)
+            uChunk = uBitCount;
+
+        uint32_t uMask = (1u << uChunk) - 1;
+        ptWriter->puData[ptWriter->uBitPos >> 3] |= (uint8_t)((uValue & uMask) << uBitOffset);
+
+        uValue >>= uChunk;
+        uBitCount -= uChunk;
+        ptWriter->uBitPos += uChunk;
+    }
+}
+
+uint32_t
+m_net_read_bits(mNetBitReader* ptReader, uint32_t uBitCount)
+{
+    if(ptReader->uBitPos + uBitCount > ptReader->uSizeBits)
+    {
+        ptReader->bOverflow = true;
+        return 0;
+    }
+
+    uint32_t uValue = 0;
+    uint32_t uShift = 0;
+    while(uBitCount > 0)
+    {
+        uint32_t uBitOffset = ptReader->uBitPos & 7;
+        uint32_t uChunk = 8 - uBitOffset;
+        if(uChunk > uBitCount)
+            uChunk = uBitCount;
+
+        uint32_t uMask = (1u << uChunk) - 1;
+        uValue |= (((uint32_t)ptReader->puData[ptReader->uBitPos >> 3] >> uBitOffset) & uMask) << uShift;
+
+        uShift += uChunk;
+        uBitCount -= uChunk;
+        ptReader->uBitPos += uChunk;
+    }
+    return uValue;
+}
+
+// small deltas (rent, tax, one round) fit the 4 and 8 bit classes
+static const uint32_t gauSignedClassBits[4] = {4, 8, 16, 32};
+
+void
+m_net_write_signed(mNetBitWriter* ptWriter, int32_t iValue)
+{
+    uint32_t uZigZag = ((uint32_t)iValue << 1) ^ (uint32_t)(iValue >> 31);
+
+    uint32_t uClass = 3;
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        if(uZigZag < (1u << gauSignedClassBits[i]))
+        {
+            uClass = i;
+            break;
+        }
+    }
+
+    m_net_write_bits(ptWriter, uClass, 2);
+    m_net_write_bits(ptWriter, uZigZag, gauSignedClassBits[uClass]);
+}
+
+int32_t
+m_net_read_signed(mNetBitReader* ptReader)
+{
+    uint32_t uClass = m_net_read_bits(ptReader, 2);
+    uint32_t uZigZag = m_net_read_bits(ptReader, gauSignedClassBits[uClass]);
+    return (int32_t)(uZigZag >> 1) ^ -(int32_t)(uZigZag & 1);
+}
+
+// ==================== SNAPSHOTS ==================== //
+
+uint8_t
+m_net_get_input_player(const mGameFlow* pFlow)
+{
+    const mGameData* pGame = pFlow->pGame;
+
+    if(pFlow->pfCurrentPhase == m_phase_auction)
+    {
+        const mAuctionData* pAuction = (const mAuctionData*)pFlow->pCurrentPhaseData;
+        if(pAuction->bShowedMenu)
+            return pAuction->uCurrentBidder;
+    }
+    else if(pFlow->pfCurrentPhase == m_phase_trade)
+    {
+        const mTradeData* pTrade = (const mTradeData*)pFlow->pCurrentPhaseData;
+        if(pTrade->eStep == TRADE_STEP_AWAITING_RESPONSE)
+            return pTrade->uTargetPlayer;
+    }
+    return pGame->uCurrentPlayerIndex;
+}
+
+void
+m_net_capture_snapshot(const mGameFlow* pFlow, mNetSnapshot* ptSnapshotOut)
+{
+    const mGameData* pGame = pFlow->pGame;
+
+    memset(ptSnapshotOut, 0, sizeof(mNetSnapshot));
+
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        const mPlayer* pPlayer = &pGame->amPlayers[i];
+        mNetPlayerState* ptPlayer = &ptSnapshotOut->atPlayers[i];
+        ptPlayer->uMoney           = pPlayer->uMoney;
+        ptPlayer->uPosition        = pPlayer->uPosition;
+        ptPlayer->uJailTurns       = pPlayer->uJailTurns;
+        ptPlayer->bHasJailFreeCard = pPlayer->bHasJailFreeCard;
+        ptPlayer->bIsBankrupt      = pPlayer->bIsBankrupt;
+    }
+
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        const mProperty* pProp = &pGame->amProperties[i];
+        mNetPropertyState* ptProp = &ptSnapshotOut->atProperties[i];
+        ptProp->uOwnerIndex  = pProp->uOwnerIndex;
+        ptProp->uHouses      = pProp->uHouses;
+        ptProp->bHasHotel    = pProp->bHasHotel;
+        ptProp->bIsMortgaged = pProp->bIsMortgaged;
+    }
+
+    ptSnapshotOut->uRoundCount         = (uint32_t)pGame->uRoundCount;
+    ptSnapshotOut->uPlayerCount        = pGame->uPlayerCount;
+    ptSnapshotOut->uCurrentPlayerIndex = pGame->uCurrentPlayerIndex;
+    ptSnapshotOut->uInputPlayer        = m_net_get_input_player(pFlow);
+    ptSnapshotOut->uPhase              = m__net_get_phase_id(pFlow->pfCurrentPhase);
+    ptSnapshotOut->uDie1               = pGame->tDice.uDie1;
+    ptSnapshotOut->uDie2               = pGame->tDice.uDie2;
+}
+
+bool
+m_net_snapshots_equal(const mNetSnapshot* ptA, const mNetSnapshot* ptB)
+{
+    if(ptA->uRoundCount != ptB->uRoundCount || ptA->uPlayerCount != ptB->uPlayerCount ||
+       ptA->uCurrentPlayerIndex != ptB->uCurrentPlayerIndex || ptA->uInputPlayer != ptB->uInputPlayer ||
+       ptA->uPhase != ptB->uPhase || ptA->uDie1 != ptB->uDie1 || ptA->uDie2 != ptB->uDie2)
+        return false;
+
+    for(uint8_t i = 0; i < MAX_PLAYERS; i++)
+    {
+        if(!m__net_players_equal(&ptA->atPlayers[i], &ptB->atPlayers[i]))
+            return false;
+    }
+
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        if(!m__net_properties_equal(&ptA->atProperties[i], &ptB->atProperties[i]))
+            return false;
+    }
+    return true;
+}
+
+// layout: a change bit per global field (value follows if set), a change bit per player
+// (5 bit field mask + values follow), then one bit for "any property changed" followed
+// by a change bit per property (owner/houses/hotel/mortgaged packed in 8 bits)
+uint32_t
+m_net_encode_delta(const mNetSnapshot* ptBase, const mNetSnapshot* ptCurrent, mNetBitWriter* ptWriter)
+{
+    mNetSnapshot tEmpty;
+    if(!ptBase)
+    {
+        m__net_empty_snapshot(&tEmpty);
+        ptBase = &tEmpty;
+    }
+
+    uint32_t uStartBit = ptWriter->uBitPos;
+
+    // globals
+    bool bChanged = ptCurrent->uPlayerCount != ptBase->uPlayerCount;
+    m_net_write_bits(ptWriter, bChanged, 1);
+    if(bChanged) m_net_write_bits(ptWriter, ptCurrent->uPlayerCount, 3);
+
+    bChanged = ptCurrent->uCurrentPlayerIndex != ptBase->uCurrentPlayerIndex;
+    m_net_write_bits(ptWriter, bChanged, 1);
+    if(bChanged) m_net_write_bits(ptWriter, ptCurrent->uCurrentPlayerIndex, 3);
+
+    bChanged = ptCurrent->uInputPlayer != ptBase->uInputPlayer;
+    m_net_write_bits(ptWriter, bChanged, 1);
+    if(bChanged) m_net_write_bits(ptWriter, ptCurrent->uInputPlayer, 3);
+
+    bChanged = ptCurrent->uPhase != ptBase->uPhase;
+    m_net_write_bits(ptWriter, bChanged, 1);
+    if(bChanged) m_net_write_bits(ptWriter, ptCurrent->uPhase, 3);
+
+    bChanged = ptCurrent->uDie1 != ptBase->uDie1 || ptCurrent->uDie2 != ptBase->uDie2;
+    m_net_write_bits(ptWriter, bChanged, 1);
+    if(bChanged)
+    {
+        m_net_write_bits(ptWriter, ptCurrent->uDie1, 3);
+        m_net_write_bits(ptWriter, ptCurrent->uDie2, 3);
+    }
+
+    bChanged = ptCurrent->uRoundCount != ptBase->uRoundCount;
+    m_net_write_bits(ptWriter, bChanged, 1);
+    if(bChanged) m_net_write_signed(ptWriter, (int32_t)(ptCurrent->uRoundCount - ptBase->uRoundCount));
+
+    // players
+    for(uint8_t i = 0; i < ptCurrent->uPlayerCount; i++)
+    {
+        const mNetPlayerState* ptOld = &ptBase->atPlayers[i];
+        const mNetPlayerState* ptNew = &ptCurrent->atPlayers[i];
+
+        uint32_t uMask = 0;
+        if(ptNew->uMoney != ptOld->uMoney)                     uMask |= 1 << 0;
+        if(ptNew->uPosition != ptOld->uPosition)               uMask |= 1 << 1;
+        if(ptNew->uJailTurns != ptOld->uJailTurns)             uMask |= 1 << 2;
+        if(ptNew->bHasJailFreeCard != ptOld->bHasJailFreeCard) uMask |= 1 << 3;
+        if(ptNew->bIsBankrupt != ptOld->bIsBankrupt)           uMask |= 1 << 4;
+
+        m_net_write_bits(ptWriter, uMask != 0, 1);
+        if(uMask == 0)
+            continue;
+
+        m_net_write_bits(ptWriter, uMask, 5);
+        if(uMask & (1 << 0)) m_net_write_signed(ptWriter, (int32_t)(ptNew->uMoney - ptOld->uMoney));
+        if(uMask & (1 << 1)) m_net_write_bits(ptWriter, ptNew->uPosition, 6);
+        if(uMask & (1 << 2)) m_net_write_bits(ptWriter, ptNew->uJailTurns, 3);
+        if(uMask & (1 << 3)) m_net_write_bits(ptWriter, ptNew->bHasJailFreeCard, 1);
+        if(uMask & (1 << 4)) m_net_write_bits(ptWriter, ptNew->bIsBankrupt, 1);
+    }
+
+    // properties
+    bool bAnyPropertyChanged = false;
+    for(uint8_t i = 0; i < TOTAL_PROPERTIES && !bAnyPropertyChanged; i++)
+        bAnyPropertyChanged = !m__net_properties_equal(&ptBase->atProperties[i], &ptCurrent->atProperties[i]);
+
+    m_net_write_bits(ptWriter, bAnyPropertyChanged, 1);
+    if(bAnyPropertyChanged)
+    {
+        for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+        {
+            const mNetPropertyState* ptNew = &ptCurrent->atProperties[i];
+            bChanged = !m__net_properties_equal(&ptBase->atProperties[i], ptNew);
+            m_net_write_bits(ptWriter, bChanged, 1);
+            if(!bChanged)
+                continue;
+
+            m_net_write_bits(ptWriter, ptNew->uOwnerIndex == BANK_PLAYER_INDEX ? M_NET_OWNER_BANK : ptNew->uOwnerIndex, 3);
+            m_net_write_bits(ptWriter, ptNew->uHouses, 3);
+            m_net_write_bits(ptWriter, ptNew->bHasHotel, 1);
+            m_net_write_bits(ptWriter, ptNew->bIsMortgaged, 1);
+        }
+    }
+
+    return ptWriter->uBitPos - uStartBit;
+}
+
+bool
+m_net_decode_delta(const mNetSnapshot* ptBase, mNetBitReader* ptReader, mNetSnapshot* ptSnapshotOut)
+{
+    if(ptBase)
+        memcpy(ptSnapshotOut, ptBase, sizeof(mNetSnapshot));
+    else
+        m__net_empty_snapshot(ptSnapshotOut);
+
+    // globals
+    if(m_net_read_bits(ptReader, 1)) ptSnapshotOut->uPlayerCount        = (uint8_t)m_net_read_bits(ptReader, 3);
+    if(m_net_read_bits(ptReader, 1)) ptSnapshotOut->uCurrentPlayerIndex = (uint8_t)m_net_read_bits(ptReader, 3);
+    if(m_net_read_bits(ptReader, 1)) ptSnapshotOut->uInputPlayer        = (uint8_t)m_net_read_bits(ptReader, 3);
+    if(m_net_read_bits(ptReader, 1)) ptSnapshotOut->uPhase              = (uint8_t)m_net_read_bits(ptReader, 3);
+    if(m_net_read_bits(ptReader, 1))
+    {
+        ptSnapshotOut->uDie1 = (uint8_t)m_net_read_bits(ptReader, 3);
+        ptSnapshotOut->uDie2 = (uint8_t)m_net_read_bits(ptReader, 3);
+    }
+    if(m_net_read_bits(ptReader, 1))
+        ptSnapshotOut->uRoundCount += (uint32_t)m_net_read_signed(ptReader);
+
+    if(ptSnapshotOut->uPlayerCount > MAX_PLAYERS)
+        return false;
+
+    // players
+    for(uint8_t i = 0; i < ptSnapshotOut->uPlayerCount; i++)
+    {
+        if(!m_net_read_bits(ptReader, 1))
+            continue;
+
+        mNetPlayerState* ptPlayer = &ptSnapshotOut->atPlayers[i];
+        uint32_t uMask = m_net_read_bits(ptReader, 5);
+        if(uMask & (1 << 0)) ptPlayer->uMoney          += (uint32_t)m_net_read_signed(ptReader);
+        if(uMask & (1 << 1)) ptPlayer->uPosition        = (uint8_t)m_net_read_bits(ptReader, 6);
+        if(uMask & (1 << 2)) ptPlayer->uJailTurns       = (uint8_t)m_net_read_bits(ptReader, 3);
+        if(uMask & (1 << 3)) ptPlayer->bHasJailFreeCard = m_net_read_bits(ptReader, 1) != 0;
+        if(uMask & (1 << 4)) ptPlayer->bIsBankrupt      = m_net_read_bits(ptReader, 1) != 0;
+    }
+
+    // properties
+    if(m_net_read_bits(ptReader, 1))
+    {
+        for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+        {
+            if(!m_net_read_bits(ptReader, 1))
+                continue;
+
+            mNetPropertyState* ptProp = &ptSnapshotOut->atProperties[i];
+            uint8_t uOwner = (uint8_t)m_net_read_bits(ptReader, 3);
+            ptProp->uOwnerIndex  = uOwner == M_NET_OWNER_BANK ? BANK_PLAYER_INDEX : uOwner;
+            ptProp->uHouses      = (uint8_t)m_net_read_bits(ptReader, 3);
+            ptProp->bHasHotel    = m_net_read_bits(ptReader, 1) != 0;
+            ptProp->bIsMortgaged = m_net_read_bits(ptReader, 1) != 0;
+        }
+    }
+
+    return !ptReader->bOverflow;
+}
+
+// ==================== LOOPBACK TRANSPORT ==================== //
+
+void
+m_net_loopback_init(mNetLoopback* ptLink)
+{
+    memset(ptLink, 0, sizeof(mNetLoopback));
+}
+
+bool
+m_net_queue_push(mNetQueue* ptQueue, const uint8_t* puData, uint16_t uSize)
+{
+    if(ptQueue->uTail - ptQueue->uHead >= M_NET_QUEUE_SIZE || uSize > M_NET_MAX_PACKET_SIZE)
+        return false; // dropped, like a full socket buffer
+
+    mNetPacket* ptPacket = &ptQueue->atPackets[ptQueue->uTail & M_NET_QUEUE_MASK];
+    ptPacket->uSize = uSize;
+    memcpy(ptPacket->auData, puData, uSize);
+    ptQueue->uTail++;
+    return true;
+}
+
+bool
+m_net_queue_pop(mNetQueue* ptQueue, mNetPacket* ptPacketOut)
+{
+    if(ptQueue->uHead == ptQueue->uTail)
+        return false;
+
+    *ptPacketOut = ptQueue->atPackets[ptQueue->uHead & M_NET_QUEUE_MASK];
+    ptQueue->uHead++;
+    return true;
+}
+
+// ==================== SERVER ==================== //
+
+void
+m_net_server_init(mNetServer* ptServer, const mGameFlow* pFlow)
+{
+    memset(ptServer, 0, sizeof(mNetServer));
+    ptServer->pFlow = pFlow;
+}
+
+int
+m_net_server_add_client(mNetServer* ptServer, mNetLoopback* ptLink, uint8_t uPlayerIndex)
+{
+    if(ptServer->uClientCount >= M_NET_MAX_CLIENTS)
+        return -1;
+
+    mNetServerClient* ptClient = &ptServer->atClients[ptServer->uClientCount];
+    memset(ptClient, 0, sizeof(mNetServerClient));
+    ptClient->ptLink = ptLink;
+    ptClient->uPlayerIndex = uPlayerIndex;
+    return (int)ptServer->uClientCount++;
+}
+
+bool
+m_net_server_poll_input(mNetServer* ptServer, int* piValueOut)
+{
+    mNetPacket tPacket;
+
+    for(uint32_t i = 0; i < ptServer->uClientCount; i++)
+    {
+        mNetServerClient* ptClient = &ptServer->atClients[i];
+
+        while(m_net_queue_pop(&ptClient->ptLink->tToServer, &tPacket))
+        {
+            mNetBitReader tReader = {
+                .puData    = tPacket.auData,
+                .uSizeBits = (uint32_t)tPacket.uSize * 8
+            };
+            eNetPacketType eType = (eNetPacketType)m_net_read_bits(&tReader, 2);
+            uint16_t uSequence = (uint16_t)m_net_read_bits(&tReader, 16);
+
+            if(eType == NET_PACKET_ACK)
+            {
+                if(!ptClient->bHasAck || m__net_sequence_newer(uSequence, ptClient->uAckedSequence))
+                {
+                    ptClient->uAckedSequence = uSequence;
+                    ptClient->bHasAck = true;
+                }
+            }
+            else if(eType == NET_PACKET_INPUT)
+            {
+                int32_t iValue = m_net_read_signed(&tReader);
+                if(tReader.bOverflow)
+                    continue;
+
+                // authoritative: only the player the game is waiting on may answer
+                if(ptClient->uPlayerIndex != m_net_get_input_player(ptServer->pFlow))
+                {
+                    ptServer->uRejectedInputs++;
+                    continue;
+                }
+
+                *piValueOut = (int)iValue;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void
+m_net_server_broadcast(mNetServer* ptServer)
+{
+    mNetSnapshot tCurrent;
+    m_net_capture_snapshot(ptServer->pFlow, &tCurrent);
+
+    if(!ptServer->bHasSnapshot ||
+       !m_net_snapshots_equal(&tCurrent, &ptServer->atHistory[ptServer->uSequence & M_NET_HISTORY_MASK]))
+    {
+        if(ptServer->bHasSnapshot)
+            ptServer->uSequence++;
+        ptServer->atHistory[ptServer->uSequence & M_NET_HISTORY_MASK] = tCurrent;
+        ptServer->bHasSnapshot = true;
+    }
+
+    const mNetSnapshot* ptNewest = &ptServer->atHistory[ptServer->uSequence & M_NET_HISTORY_MASK];
+
+    for(uint32_t i = 0; i < ptServer->uClientCount; i++)
+    {
+        mNetServerClient* ptClient = &ptServer->atClients[i];
+
+        // up to date, or the newest state is already on its way
+        if(ptClient->bHasAck && ptClient->uAckedSequence == ptServer->uSequence)
+            continue;
+        // the newest state is on its way, unless it went unacked for long enough to count as lost
+        if(ptClient->bHasSent && ptClient->uSentSequence == ptServer->uSequence &&
+           ++ptClient->uBroadcastsSinceSend < M_NET_RESEND_BROADCASTS)
+            continue;
+
+        // delta against the last acked state if it's still in the history, otherwise full
+        bool bFull = !ptClient->bHasAck ||
+                     (uint16_t)(ptServer->uSequence - ptClient->uAckedSequence) >= M_NET_HISTORY_SIZE;
+
+        uint8_t auBuffer[M_NET_MAX_PACKET_SIZE] = {0};
+        mNetBitWriter tWriter = {
+            .puData        = auBuffer,
+            .uCapacityBits = M_NET_MAX_PACKET_SIZE * 8
+        };
+        m__net_write_header(&tWriter, NET_PACKET_STATE, ptServer->uSequence);
+        m_net_write_bits(&tWriter, bFull, 1);
+        if(bFull)
+        {
+            m_net_encode_delta(NULL, ptNewest, &tWriter);
+        }
+        else
+        {
+            m_net_write_bits(&tWriter, ptClient->uAckedSequence, 16);
+            m_net_encode_delta(&ptServer->atHistory[ptClient->uAckedSequence & M_NET_HISTORY_MASK], ptNewest, &tWriter);
+        }
+
+        if(tWriter.bOverflow)
+            continue;
+
+        uint16_t uSize = m__net_packet_bytes(&tWriter);
+        if(m_net_queue_push(&ptClient->ptLink->tToClient, auBuffer, uSize))
+        {
+            ptClient->bHasSent = true;
+            ptClient->uSentSequence = ptServer->uSequence;
+            ptClient->uBroadcastsSinceSend = 0;
+            ptClient->uBytesSent += uSize;
+            ptClient->uPacketsSent++;
+        }
+    }
+}
+
+// ==================== CLIENT ==================== //
+
+// so the next delta is taken against this state
+static void
+m__net_client_ack(mNetClient* ptClient, uint16_t uSequence)
+{
+    uint8_t auAck[4] = {0};
+    mNetBitWriter tWriter = {
+        .puData        = auAck,
+        .uCapacityBits = sizeof(auAck) * 8
+    };
+    m__net_write_header(&tWriter, NET_PACKET_ACK, uSequence);
+    m_net_queue_push(&ptClient->ptLink->tToServer, auAck, m__net_packet_bytes(&tWriter));
+}
+
+void
+m_net_client_init(mNetClient* ptClient, mNetLoopback* ptLink)
+{
+    memset(ptClient, 0, sizeof(mNetClient));
+    ptClient->ptLink = ptLink;
+    m__net_empty_snapshot(&ptClient->tState);
+}
+
+bool
+m_net_client_send_input(mNetClient* ptClient, int iValue)
+{
+    uint8_t auBuffer[8] = {0};
+    mNetBitWriter tWriter = {
+        .puData        = auBuffer,
+        .uCapacityBits = sizeof(auBuffer) * 8
+    };
+    m__net_write_header(&tWriter, NET_PACKET_INPUT, ptClient->uInputSequence++);
+    m_net_write_signed(&tWriter, (int32_t)iValue);
+
+    return m_net_queue_push(&ptClient->ptLink->tToServer, auBuffer, m__net_packet_bytes(&tWriter));
+}
+
+bool
+m_net_client_receive(mNetClient* ptClient)
+{
+    bool bChanged = false;
+    mNetPacket tPacket;
+
+    while(m_net_queue_pop(&ptClient->ptLink->tToClient, &tPacket))
+    {
+        ptClient->uBytesReceived += tPacket.uSize;
+
+        mNetBitReader tReader = {
+            .puData    = tPacket.auData,
+            .uSizeBits = (uint32_t)tPacket.uSize * 8
+        };
+        eNetPacketType eType = (eNetPacketType)m_net_read_bits(&tReader, 2);
+        uint16_t uSequence = (uint16_t)m_net_read_bits(&tReader, 16);
+        if(eType != NET_PACKET_STATE)
+            continue;
+
+        // a resend of the current state means the ack was lost, ack it again
+        if(ptClient->bHasState && uSequence == ptClient->uSequence)
+        {
+            m__net_client_ack(ptClient, uSequence);
+            continue;
+        }
+
+        // stale (reordered) packet
+        if(ptClient->bHasState && !m__net_sequence_newer(uSequence, ptClient->uSequence))
+            continue;
+
+        const mNetSnapshot* ptBase = NULL;
+        if(!m_net_read_bits(&tReader, 1))
+        {
+            uint16_t uBaseSequence = (uint16_t)m_net_read_bits(&tReader, 16);
+            uint32_t uSlot = uBaseSequence & M_NET_HISTORY_MASK;
+            if(!ptClient->abHistoryValid[uSlot] || ptClient->auHistorySequence[uSlot] != uBaseSequence)
+            {
+                ptClient->uDroppedPackets++;
+                continue;
+            }
+            ptBase = &ptClient->atHistory[uSlot];
+        }
+
+        mNetSnapshot tDecoded;
+        if(!m_net_decode_delta(ptBase, &tReader, &tDecoded))
+        {
+            ptClient->uDroppedPackets++;
+            continue;
+        }
+
+        uint32_t uSlot = uSequence & M_NET_HISTORY_MASK;
+        ptClient->atHistory[uSlot] = tDecoded;
+        ptClient->auHistorySequence[uSlot] = uSequence;
+        ptClient->abHistoryValid[uSlot] = true;
+        ptClient->tState = tDecoded;
+        ptClient->uSequence = uSequence;
+        ptClient->bHasState = true;
+        bChanged = true;
+
+        m__net_client_ack(ptClient, uSequence);
+    }
+
+    return bChanged;
+}
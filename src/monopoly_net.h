@@ -0,0 +1,187 @@
+#ifndef MONOPOLY_NET_H
+#define MONOPOLY_NET_H
+
+#include "monopoly.h"
+
+// authoritative server protocol. clients only ever send inputs (the same ints the ui
+// passes to m_set_input_int) and acks; the server sends the synced part of the game as
+// a bit-packed delta against the last snapshot each client acked, so an idle table
+// sends nothing and a normal turn costs a handful of bytes per client.
+//
+// the transport is a pair of in-memory packet queues (mNetLoopback) so the whole thing
+// runs in one process for tests and the headless server. a socket transport only needs
+// to move the same packets.
+
+// ==================== CONSTANTS ==================== //
+
+#define M_NET_MAX_PACKET_SIZE  256 // a full snapshot of a 6 player game is ~90 bytes
+#define M_NET_QUEUE_SIZE       8   // packets in flight per direction (power of two)
+#define M_NET_HISTORY_SIZE     32  // snapshots kept to delta against (power of two)
+#define M_NET_MAX_CLIENTS      8   // players + spectators per table
+#define M_NET_SPECTATOR        254 // client player index for watch-only clients
+#define M_NET_RESEND_BROADCASTS 8  // unacked state is sent again after this many broadcasts
+
+// ==================== ENUMS ==================== //
+
+typedef enum _eNetPacketType
+{
+    NET_PACKET_INPUT, // client -> server
+    NET_PACKET_ACK,   // client -> server
+    NET_PACKET_STATE  // server -> client
+} eNetPacketType;
+
+// phase ids sent instead of phase function pointers
+typedef enum _eNetPhase
+{
+    NET_PHASE_NONE,
+    NET_PHASE_PRE_ROLL,
+    NET_PHASE_POST_ROLL,
+    NET_PHASE_JAIL,
+    NET_PHASE_PROPERTY_MANAGEMENT,
+    NET_PHASE_AUCTION,
+    NET_PHASE_BANKRUPTCY,
+    NET_PHASE_TRADE
+} eNetPhase;
+
+// ==================== STRUCTS ==================== //
+
+// synced subset of mGameData (everything a client needs to draw the board)
+typedef struct _mNetPlayerState
+{
+    uint32_t uMoney;
+    uint8_t  uPosition;
+    uint8_t  uJailTurns;
+    bool     bHasJailFreeCard;
+    bool     bIsBankrupt;
+} mNetPlayerState;
+
+typedef struct _mNetPropertyState
+{
+    uint8_t uOwnerIndex; // BANK_PLAYER_INDEX = unowned
+    uint8_t uHouses;
+    bool    bHasHotel;
+    bool    bIsMortgaged;
+} mNetPropertyState;
+
+typedef struct _mNetSnapshot
+{
+    mNetPlayerState   atPlayers[MAX_PLAYERS];
+    mNetPropertyState atProperties[TOTAL_PROPERTIES];
+    uint32_t          uRoundCount;
+    uint8_t           uPlayerCount;
+    uint8_t           uCurrentPlayerIndex;
+    uint8_t           uInputPlayer; // player the current phase is waiting on
+    uint8_t           uPhase;       // eNetPhase
+    uint8_t           uDie1;
+    uint8_t           uDie2;
+} mNetSnapshot;
+
+// bit packing
+typedef struct _mNetBitWriter
+{
+    uint8_t* puData;
+    uint32_t uCapacityBits;
+    uint32_t uBitPos;
+    bool     bOverflow;
+} mNetBitWriter;
+
+typedef struct _mNetBitReader
+{
+    const uint8_t* puData;
+    uint32_t       uSizeBits;
+    uint32_t       uBitPos;
+    bool           bOverflow;
+} mNetBitReader;
+
+// loopback transport
+typedef struct _mNetPacket
+{
+    uint16_t uSize;
+    uint8_t  auData[M_NET_MAX_PACKET_SIZE];
+} mNetPacket;
+
+typedef struct _mNetQueue
+{
+    mNetPacket atPackets[M_NET_QUEUE_SIZE];
+    uint32_t   uHead; // next packet to pop
+    uint32_t   uTail; // next slot to push
+} mNetQueue;
+
+typedef struct _mNetLoopback
+{
+    mNetQueue tToServer;
+    mNetQueue tToClient;
+} mNetLoopback;
+
+// server side
+typedef struct _mNetServerClient
+{
+    mNetLoopback* ptLink;
+    uint8_t       uPlayerIndex;  // M_NET_SPECTATOR for watch-only
+    bool          bHasAck;       // false until the first state is acked (full snapshot sent)
+    bool          bHasSent;
+    uint16_t      uAckedSequence;
+    uint16_t      uSentSequence; // newest state in flight
+    uint16_t      uBroadcastsSinceSend; // resent once this reaches M_NET_RESEND_BROADCASTS without an ack
+    uint64_t      uBytesSent;
+    uint64_t      uPacketsSent;
+} mNetServerClient;
+
+typedef struct _mNetServer
+{
+    const mGameFlow* pFlow;
+    mNetSnapshot     atHistory[M_NET_HISTORY_SIZE]; // indexed by sequence
+    uint16_t         uSequence;                     // sequence of the newest snapshot
+    bool             bHasSnapshot;
+    mNetServerClient atClients[M_NET_MAX_CLIENTS];
+    uint32_t         uClientCount;
+    uint64_t         uRejectedInputs;
+} mNetServer;
+
+// client side
+typedef struct _mNetClient
+{
+    mNetLoopback* ptLink;
+    mNetSnapshot  tState;                         // latest replicated state
+    mNetSnapshot  atHistory[M_NET_HISTORY_SIZE];  // received snapshots, deltas may reference any of them
+    uint16_t      auHistorySequence[M_NET_HISTORY_SIZE];
+    bool          abHistoryValid[M_NET_HISTORY_SIZE];
+    uint16_t      uSequence;
+    bool          bHasState;
+    uint16_t      uInputSequence;
+    uint64_t      uBytesReceived;
+    uint64_t      uDroppedPackets; // deltas against a snapshot we no longer have
+} mNetClient;
+
+// ==================== NET FUNCTIONS ==================== //
+
+// bit packing
+void     m_net_write_bits(mNetBitWriter* ptWriter, uint32_t uValue, uint32_t uBitCount);
+uint32_t m_net_read_bits(mNetBitReader* ptReader, uint32_t uBitCount);
+void     m_net_write_signed(mNetBitWriter* ptWriter, int32_t iValue); // zigzag + 2 bit size class
+int32_t  m_net_read_signed(mNetBitReader* ptReader);
+
+// snapshots
+void     m_net_capture_snapshot(const mGameFlow* pFlow, mNetSnapshot* ptSnapshotOut);
+bool     m_net_snapshots_equal(const mNetSnapshot* ptA, const mNetSnapshot* ptB);
+uint32_t m_net_encode_delta(const mNetSnapshot* ptBase, const mNetSnapshot* ptCurrent, mNetBitWriter* ptWriter); // base NULL = full, returns bits written
+bool     m_net_decode_delta(const mNetSnapshot* ptBase, mNetBitReader* ptReader, mNetSnapshot* ptSnapshotOut);
+
+// loopback transport
+void m_net_loopback_init(mNetLoopback* ptLink);
+bool m_net_queue_push(mNetQueue* ptQueue, const uint8_t* puData, uint16_t uSize);
+bool m_net_queue_pop(mNetQueue* ptQueue, mNetPacket* ptPacketOut);
+
+// server
+void     m_net_server_init(mNetServer* ptServer, const mGameFlow* pFlow);
+int      m_net_server_add_client(mNetServer* ptServer, mNetLoopback* ptLink, uint8_t uPlayerIndex); // returns client index or -1
+bool     m_net_server_poll_input(mNetServer* ptServer, int* piValueOut); // next accepted input, false when drained
+void     m_net_server_broadcast(mNetServer* ptServer); // snapshot the game and send deltas to clients that are behind
+uint8_t  m_net_get_input_player(const mGameFlow* pFlow);
+
+// client
+void m_net_client_init(mNetClient* ptClient, mNetLoopback* ptLink);
+bool m_net_client_send_input(mNetClient* ptClient, int iValue);
+bool m_net_client_receive(mNetClient* ptClient); // applies queued states and acks them, true if state changed
+
+#endif // MONOPOLY_NET_H
@@ -0,0 +1,406 @@
+#include "monopoly_platform.h"
+#include <stdlib.h> // malloc, free
+#include <string.h> // memset
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <psapi.h> // K32GetProcessMemoryInfo
+#else
+    #include <time.h> // clock_gettime, nanosleep
+    #include <unistd.h> // sysconf, ftruncate, close
+    #include <sys/resource.h> // getrusage
+    #include <fcntl.h> // open
+    #include <sys/mman.h> // mmap
+#endif
+
+// ==================== THREADS ==================== //
+
+typedef struct _mThread
+{
+    fThreadFunc pfFunc;
+    void*       pData;
+#ifdef _WIN32
+    HANDLE      tHandle;
+#else
+    pthread_t   tHandle;
+#endif
+} mThread;
+
+#ifdef _WIN32
+
+static DWORD WINAPI
+m__thread_entry(LPVOID pArg)
+{
+    mThread* ptThread = (mThread*)pArg;
+    ptThread->pfFunc(ptThread->pData);
+    return 0;
+}
+
+#else
+
+static void*
+m__thread_entry(void* pArg)
+{
+    mThread* ptThread = (mThread*)pArg;
+    ptThread->pfFunc(ptThread->pData);
+    return NULL;
+}
+
+#endif
+
+mThread*
+m_thread_create(fThreadFunc pfFunc, void* pData)
+{
+    mThread* ptThread = malloc(sizeof(mThread));
+    if(!ptThread) return NULL;
+
+    ptThread->pfFunc = pfFunc;
+    ptThread->pData  = pData;
+
+#ifdef _WIN32
+    ptThread->tHandle = CreateThread(NULL, 0, m__thread_entry, ptThread, 0, NULL);
+    if(!ptThread->tHandle)
+#else
+    if(pthread_create(&ptThread->tHandle, NULL, m__thread_entry, ptThread) != 0)
+#endif
+    {
+        free(ptThread);
+        return NULL;
+    }
+    return ptThread;
+}
+
+void
+m_thread_join(mThread* ptThread)
+{
+    if(!ptThread) return;
+
+#ifdef _WIN32
+    WaitForSingleObject(ptThread->tHandle, INFINITE);
+    CloseHandle(ptThread->tHandle);
+#else
+    pthread_join(ptThread->tHandle, NULL);
+#endif
+    free(ptThread);
+}
+
+uint32_t
+m_get_hardware_thread_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO tInfo;
+    GetSystemInfo(&tInfo);
+    return (uint32_t)tInfo.dwNumberOfProcessors;
+#else
+    long lCount = sysconf(_SC_NPROCESSORS_ONLN);
+    return lCount > 0 ? (uint32_t)lCount : 1;
+#endif
+}
+
+void
+m_sleep_ms(uint32_t uMilliseconds)
+{
+#ifdef _WIN32
+    Sleep(uMilliseconds);
+#else
+    struct timespec tDuration = {
+        .tv_sec  = uMilliseconds / 1000,
+        .tv_nsec = (long)(uMilliseconds % 1000) * 1000000L
+    };
+    nanosleep(&tDuration, NULL);
+#endif
+}
+
+// ==================== SYNCHRONIZATION ==================== //
+
+void
+m_mutex_init(mMutex* ptMutex)
+{
+#ifdef _WIN32
+    InitializeSRWLock((PSRWLOCK)&ptMutex->pHandle);
+#else
+    pthread_mutex_init(&ptMutex->tHandle, NULL);
+#endif
+}
+
+void
+m_mutex_cleanup(mMutex* ptMutex)
+{
+#ifdef _WIN32
+    ptMutex->pHandle = NULL; // srw locks have nothing to release
+#else
+    pthread_mutex_destroy(&ptMutex->tHandle);
+#endif
+}
+
+void
+m_mutex_lock(mMutex* ptMutex)
+{
+#ifdef _WIN32
+    AcquireSRWLockExclusive((PSRWLOCK)&ptMutex->pHandle);
+#else
+    pthread_mutex_lock(&ptMutex->tHandle);
+#endif
+}
+
+void
+m_mutex_unlock(mMutex* ptMutex)
+{
+#ifdef _WIN32
+    ReleaseSRWLockExclusive((PSRWLOCK)&ptMutex->pHandle);
+#else
+    pthread_mutex_unlock(&ptMutex->tHandle);
+#endif
+}
+
+void
+m_condition_init(mCondition* ptCondition)
+{
+#ifdef _WIN32
+    InitializeConditionVariable((PCONDITION_VARIABLE)&ptCondition->pHandle);
+#else
+    pthread_cond_init(&ptCondition->tHandle, NULL);
+#endif
+}
+
+void
+m_condition_cleanup(mCondition* ptCondition)
+{
+#ifdef _WIN32
+    ptCondition->pHandle = NULL;
+#else
+    pthread_cond_destroy(&ptCondition->tHandle);
+#endif
+}
+
+void
+m_condition_wait(mCondition* ptCondition, mMutex* ptMutex, uint32_t uTimeoutMs)
+{
+#ifdef _WIN32
+    SleepConditionVariableSRW((PCONDITION_VARIABLE)&ptCondition->pHandle, (PSRWLOCK)&ptMutex->pHandle, uTimeoutMs, 0);
+#else
+    struct timespec tDeadline;
+    clock_gettime(CLOCK_REALTIME, &tDeadline);
+    tDeadline.tv_sec  += uTimeoutMs / 1000;
+    tDeadline.tv_nsec += (long)(uTimeoutMs % 1000) * 1000000L;
+    if(tDeadline.tv_nsec >= 1000000000L)
+    {
+        tDeadline.tv_sec++;
+        tDeadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&ptCondition->tHandle, &ptMutex->tHandle, &tDeadline);
+#endif
+}
+
+void
+m_condition_wake_one(mCondition* ptCondition)
+{
+#ifdef _WIN32
+    WakeConditionVariable((PCONDITION_VARIABLE)&ptCondition->pHandle);
+#else
+    pthread_cond_signal(&ptCondition->tHandle);
+#endif
+}
+
+void
+m_condition_wake_all(mCondition* ptCondition)
+{
+#ifdef _WIN32
+    WakeAllConditionVariable((PCONDITION_VARIABLE)&ptCondition->pHandle);
+#else
+    pthread_cond_broadcast(&ptCondition->tHandle);
+#endif
+}
+
+// ==================== ATOMICS ==================== //
+
+int64_t
+m_atomic_add64(volatile int64_t* piValue, int64_t iAmount)
+{
+#ifdef _WIN32
+    return InterlockedAdd64((volatile LONG64*)piValue, iAmount);
+#else
+    return __atomic_add_fetch(piValue, iAmount, __ATOMIC_SEQ_CST);
+#endif
+}
+
+int64_t
+m_atomic_load64(volatile int64_t* piValue)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchange64((volatile LONG64*)piValue, 0, 0);
+#else
+    return __atomic_load_n(piValue, __ATOMIC_SEQ_CST);
+#endif
+}
+
+void
+m_atomic_store64(volatile int64_t* piValue, int64_t iValue)
+{
+#ifdef _WIN32
+    InterlockedExchange64((volatile LONG64*)piValue, iValue);
+#else
+    __atomic_store_n(piValue, iValue, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// ==================== TIME ==================== //
+
+uint64_t
+m_get_time_ns(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER tFrequency = {0};
+    if(tFrequency.QuadPart == 0)
+        QueryPerformanceFrequency(&tFrequency);
+
+    LARGE_INTEGER tCounter;
+    QueryPerformanceCounter(&tCounter);
+
+    // split to avoid overflowing 64 bits on long uptimes
+    uint64_t uSeconds   = (uint64_t)(tCounter.QuadPart / tFrequency.QuadPart);
+    uint64_t uRemainder = (uint64_t)(tCounter.QuadPart % tFrequency.QuadPart);
+    return uSeconds * 1000000000ull + (uRemainder * 1000000000ull) / (uint64_t)tFrequency.QuadPart;
+#else
+    struct timespec tNow;
+    clock_gettime(CLOCK_MONOTONIC, &tNow);
+    return (uint64_t)tNow.tv_sec * 1000000000ull + (uint64_t)tNow.tv_nsec;
+#endif
+}
+
+// ==================== MEMORY ==================== //
+
+size_t
+m_get_peak_rss(void)
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS tCounters;
+    if(!K32GetProcessMemoryInfo(GetCurrentProcess(), &tCounters, sizeof(tCounters)))
+        return 0;
+    return tCounters.PeakWorkingSetSize;
+#else
+    struct rusage tUsage;
+    if(getrusage(RUSAGE_SELF, &tUsage) != 0)
+        return 0;
+    #ifdef __APPLE__
+        return (size_t)tUsage.ru_maxrss; // bytes
+    #else
+        return (size_t)tUsage.ru_maxrss * 1024; // kilobytes
+    #endif
+#endif
+}
+
+// ==================== FILES ==================== //
+
+#ifdef _WIN32
+
+static bool
+m__map_file_view(mMappedFile* ptFile, size_t szSize)
+{
+    // the mapping object sets the file size
+    ptFile->pMapping = CreateFileMappingA((HANDLE)ptFile->pFile, NULL, PAGE_READWRITE, (DWORD)((uint64_t)szSize >> 32), (DWORD)(szSize & 0xFFFFFFFF), NULL);
+    if(!ptFile->pMapping)
+        return false;
+    ptFile->pData = MapViewOfFile((HANDLE)ptFile->pMapping, FILE_MAP_WRITE, 0, 0, szSize);
+    if(!ptFile->pData)
+    {
+        CloseHandle((HANDLE)ptFile->pMapping);
+        ptFile->pMapping = NULL;
+        return false;
+    }
+    ptFile->szSize = szSize;
+    return true;
+}
+
+static void
+m__map_file_unview(mMappedFile* ptFile)
+{
+    if(ptFile->pData)
+        UnmapViewOfFile(ptFile->pData);
+    if(ptFile->pMapping)
+        CloseHandle((HANDLE)ptFile->pMapping);
+    ptFile->pData    = NULL;
+    ptFile->pMapping = NULL;
+}
+
+#else
+
+static bool
+m__map_file_view(mMappedFile* ptFile, size_t szSize)
+{
+    if(ftruncate(ptFile->iFile, (off_t)szSize) != 0)
+        return false;
+    void* pData = mmap(NULL, szSize, PROT_READ | PROT_WRITE, MAP_SHARED, ptFile->iFile, 0);
+    if(pData == MAP_FAILED)
+        return false;
+    ptFile->pData  = pData;
+    ptFile->szSize = szSize;
+    return true;
+}
+
+static void
+m__map_file_unview(mMappedFile* ptFile)
+{
+    if(ptFile->pData)
+        munmap(ptFile->pData, ptFile->szSize);
+    ptFile->pData = NULL;
+}
+
+#endif
+
+bool
+m_map_file_create(mMappedFile* ptFile, const char* pcPath, size_t szSize)
+{
+    memset(ptFile, 0, sizeof(mMappedFile));
+#ifdef _WIN32
+    HANDLE tHandle = CreateFileA(pcPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(tHandle == INVALID_HANDLE_VALUE)
+        return false;
+    ptFile->pFile = tHandle;
+#else
+    ptFile->iFile = open(pcPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(ptFile->iFile < 0)
+        return false;
+#endif
+    if(!m__map_file_view(ptFile, szSize))
+    {
+        m_map_file_close(ptFile, 0);
+        return false;
+    }
+    return true;
+}
+
+bool
+m_map_file_resize(mMappedFile* ptFile, size_t szSize)
+{
+    // remap from scratch, simpler than growing a view in place on every os
+    m__map_file_unview(ptFile);
+    return m__map_file_view(ptFile, szSize);
+}
+
+bool
+m_map_file_close(mMappedFile* ptFile, size_t szFinalSize)
+{
+    bool bOk = true;
+    m__map_file_unview(ptFile);
+#ifdef _WIN32
+    if(ptFile->pFile)
+    {
+        LARGE_INTEGER tSize;
+        tSize.QuadPart = (LONGLONG)szFinalSize;
+        bOk = SetFilePointerEx((HANDLE)ptFile->pFile, tSize, NULL, FILE_BEGIN) && SetEndOfFile((HANDLE)ptFile->pFile);
+        CloseHandle((HANDLE)ptFile->pFile);
+    }
+    ptFile->pFile = NULL;
+#else
+    if(ptFile->iFile >= 0)
+    {
+        bOk = ftruncate(ptFile->iFile, (off_t)szFinalSize) == 0;
+        close(ptFile->iFile);
+    }
+    ptFile->iFile = -1;
+#endif
+    ptFile->szSize = 0;
+    return bOk;
+}
@@ -0,0 +1,105 @@
+#ifndef MONOPOLY_PLATFORM_H
+#define MONOPOLY_PLATFORM_H
+
+#include <stdint.h> // uint
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+
+// small os layer for headless tools (server, simulators) that run without pilot light
+
+#ifdef _MSC_VER
+    #define M_THREAD_LOCAL __declspec(thread)
+#else
+    #define M_THREAD_LOCAL _Thread_local
+#endif
+
+// ==================== STRUCTS ==================== //
+
+#ifdef _WIN32
+
+// SRWLOCK and CONDITION_VARIABLE are both a single pointer (keeps windows.h out of this header)
+typedef struct _mMutex
+{
+    void* pHandle;
+} mMutex;
+
+typedef struct _mCondition
+{
+    void* pHandle;
+} mCondition;
+
+#else
+
+#include <pthread.h>
+
+typedef struct _mMutex
+{
+    pthread_mutex_t tHandle;
+} mMutex;
+
+typedef struct _mCondition
+{
+    pthread_cond_t tHandle;
+} mCondition;
+
+#endif
+
+// file mapped into memory for writing
+typedef struct _mMappedFile
+{
+    void*  pData;
+    size_t szSize;
+#ifdef _WIN32
+    void*  pFile;
+    void*  pMapping;
+#else
+    int    iFile;
+#endif
+} mMappedFile;
+
+typedef struct _mThread mThread;
+
+// thread entry point
+typedef void (*fThreadFunc)(void* pData);
+
+// ==================== THREADS ==================== //
+
+mThread* m_thread_create(fThreadFunc pfFunc, void* pData);
+void     m_thread_join(mThread* ptThread); // also frees the thread
+uint32_t m_get_hardware_thread_count(void);
+void     m_sleep_ms(uint32_t uMilliseconds);
+
+// ==================== SYNCHRONIZATION ==================== //
+
+void m_mutex_init(mMutex* ptMutex);
+void m_mutex_cleanup(mMutex* ptMutex);
+void m_mutex_lock(mMutex* ptMutex);
+void m_mutex_unlock(mMutex* ptMutex);
+
+void m_condition_init(mCondition* ptCondition);
+void m_condition_cleanup(mCondition* ptCondition);
+void m_condition_wait(mCondition* ptCondition, mMutex* ptMutex, uint32_t uTimeoutMs);
+void m_condition_wake_one(mCondition* ptCondition);
+void m_condition_wake_all(mCondition* ptCondition);
+
+// ==================== ATOMICS ==================== //
+
+int64_t m_atomic_add64(volatile int64_t* piValue, int64_t iAmount); // returns new value
+int64_t m_atomic_load64(volatile int64_t* piValue);
+void    m_atomic_store64(volatile int64_t* piValue, int64_t iValue);
+
+// ==================== TIME ==================== //
+
+uint64_t m_get_time_ns(void); // monotonic, high resolution
+
+// ==================== MEMORY ==================== //
+
+size_t m_get_peak_rss(void); // bytes, 0 if unknown
+
+// ==================== FILES ==================== //
+
+bool m_map_file_create(mMappedFile* ptFile, const char* pcPath, size_t szSize); // creates or truncates
+bool m_map_file_resize(mMappedFile* ptFile, size_t szSize); // contents kept, pData may move
+bool m_map_file_close(mMappedFile* ptFile, size_t szFinalSize); // trims the file to szFinalSize
+
+#endif // MONOPOLY_PLATFORM_H
@@ -0,0 +1,182 @@
+#include "monopoly_profile.h"
+
+#ifdef M_ENABLE_PROFILING
+
+#include <stdio.h> // fopen, fprintf
+#include <stdlib.h> // malloc, free
+#include "monopoly_platform.h"
+
+// ==================== CONSTANTS ==================== //
+
+#define M_PROFILE_MAX_DEPTH 32
+
+// ==================== STRUCTS ==================== //
+
+typedef enum _eProfileEventType
+{
+    PROFILE_EVENT_SCOPE,
+    PROFILE_EVENT_COUNTER
+} eProfileEventType;
+
+typedef struct _mProfileEvent
+{
+    const char* pcName;
+    uint64_t    uStartNs;
+    int64_t     iValue;   // duration in ns for scopes, new total for counters
+    uint32_t    uThread;
+    uint32_t    uType;    // eProfileEventType
+} mProfileEvent;
+
+typedef struct _mProfileState
+{
+    mProfileEvent*   atEvents; // NULL until m_profile_init
+    uint32_t         uCapacity;
+    uint64_t         uStartNs;
+    volatile int64_t iEventCount; // slots handed out, can run past capacity
+    volatile int64_t iThreadCount;
+    volatile int64_t aiCounters[PROFILE_COUNTER_COUNT];
+} mProfileState;
+
+static const char* gapcCounterNames[PROFILE_COUNTER_COUNT] = {
+    "rents paid",
+    "cards drawn",
+    "allocations"
+};
+
+static mProfileState gtProfile;
+
+// each thread keeps its own open scopes, only finished events touch shared state
+static M_THREAD_LOCAL uint32_t    guThreadId; // 0 until the thread records something
+static M_THREAD_LOCAL uint32_t    guScopeDepth;
+static M_THREAD_LOCAL const char* gapcScopeNames[M_PROFILE_MAX_DEPTH];
+static M_THREAD_LOCAL uint64_t    gauScopeStarts[M_PROFILE_MAX_DEPTH];
+
+// ==================== RECORDING ==================== //
+
+static uint32_t
+m__profile_thread_id(void)
+{
+    if(guThreadId == 0)
+        guThreadId = (uint32_t)m_atomic_add64(&gtProfile.iThreadCount, 1);
+    return guThreadId;
+}
+
+static void
+m__profile_push_event(eProfileEventType eType, const char* pcName, uint64_t uStartNs, int64_t iValue)
+{
+    int64_t iSlot = m_atomic_add64(&gtProfile.iEventCount, 1) - 1;
+    if(iSlot >= (int64_t)gtProfile.uCapacity)
+        return;
+
+    mProfileEvent* ptEvent = &gtProfile.atEvents[iSlot];
+    ptEvent->pcName   = pcName;
+    ptEvent->uStartNs = uStartNs;
+    ptEvent->iValue   = iValue;
+    ptEvent->uThread  = m__profile_thread_id();
+    ptEvent->uType    = (uint32_t)eType;
+}
+
+void
+m_profile_init(uint32_t uMaxEvents)
+{
+    m_profile_cleanup();
+    gtProfile.atEvents  = malloc(sizeof(mProfileEvent) * uMaxEvents);
+    gtProfile.uCapacity = gtProfile.atEvents ? uMaxEvents : 0;
+    gtProfile.uStartNs  = m_get_time_ns();
+}
+
+void
+m_profile_cleanup(void)
+{
+    free(gtProfile.atEvents);
+    gtProfile.atEvents  = NULL;
+    gtProfile.uCapacity = 0;
+    m_atomic_store64(&gtProfile.iEventCount, 0);
+    for(uint32_t i = 0; i < PROFILE_COUNTER_COUNT; i++)
+        m_atomic_store64(&gtProfile.aiCounters[i], 0);
+}
+
+void
+m_profile_begin(const char* pcName)
+{
+    if(!gtProfile.atEvents)
+        return;
+
+    // scopes past the depth limit still count so begin/end stay paired
+    if(guScopeDepth < M_PROFILE_MAX_DEPTH)
+    {
+        gapcScopeNames[guScopeDepth] = pcName;
+        gauScopeStarts[guScopeDepth] = m_get_time_ns();
+    }
+    guScopeDepth++;
+}
+
+void
+m_profile_end(void)
+{
+    if(!gtProfile.atEvents || guScopeDepth == 0)
+        return;
+
+    guScopeDepth--;
+    if(guScopeDepth >= M_PROFILE_MAX_DEPTH)
+        return;
+
+    uint64_t uStartNs = gauScopeStarts[guScopeDepth];
+    m__profile_push_event(PROFILE_EVENT_SCOPE, gapcScopeNames[guScopeDepth], uStartNs, (int64_t)(m_get_time_ns() - uStartNs));
+}
+
+void
+m_profile_count(eProfileCounter eCounter, int64_t iAmount)
+{
+    int64_t iTotal = m_atomic_add64(&gtProfile.aiCounters[eCounter], iAmount);
+    if(gtProfile.atEvents)
+        m__profile_push_event(PROFILE_EVENT_COUNTER, gapcCounterNames[eCounter], m_get_time_ns(), iTotal);
+}
+
+int64_t
+m_profile_get_counter(eProfileCounter eCounter)
+{
+    return m_atomic_load64(&gtProfile.aiCounters[eCounter]);
+}
+
+// ==================== EXPORT ==================== //
+
+// call once recording threads are done, events still being written aren't waited for
+bool
+m_profile_write_chrome_trace(const char* pcPath)
+{
+    FILE* ptFile = fopen(pcPath, "w");
+    if(!ptFile)
+        return false;
+
+    int64_t iCount = m_atomic_load64(&gtProfile.iEventCount);
+    if(iCount > (int64_t)gtProfile.uCapacity)
+    {
+        printf("profile: %lld events dropped, raise the event limit\n", (long long)(iCount - (int64_t)gtProfile.uCapacity));
+        iCount = (int64_t)gtProfile.uCapacity;
+    }
+
+    // trace timestamps are microseconds since m_profile_init
+    fprintf(ptFile, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for(int64_t i = 0; i < iCount; i++)
+    {
+        const mProfileEvent* ptEvent = &gtProfile.atEvents[i];
+        double dTimestamp = (double)(ptEvent->uStartNs - gtProfile.uStartNs) / 1000.0;
+        const char* pcSeparator = i + 1 < iCount ? "," : "";
+        if(ptEvent->uType == PROFILE_EVENT_SCOPE)
+        {
+            fprintf(ptFile, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                ptEvent->pcName, ptEvent->uThread, dTimestamp, (double)ptEvent->iValue / 1000.0, pcSeparator);
+        }
+        else
+        {
+            fprintf(ptFile, "{\"name\":\"%s\",\"ph\":\"C\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}%s\n",
+                ptEvent->pcName, ptEvent->uThread, dTimestamp, (long long)ptEvent->iValue, pcSeparator);
+        }
+    }
+    fprintf(ptFile, "]}\n");
+    fclose(ptFile);
+    return true;
+}
+
+#endif // M_ENABLE_PROFILING
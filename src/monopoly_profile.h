@@ -0,0 +1,55 @@
+#ifndef MONOPOLY_PROFILE_H
+#define MONOPOLY_PROFILE_H
+
+#include <stdint.h> // uint
+#include <stdbool.h> // bool
+
+// optional instrumentation for the core and the app. everything here is compiled out unless
+// the build defines M_ENABLE_PROFILING, in which case the macros record timed scopes and
+// counters into one preallocated event buffer that can be saved as a chrome trace
+// (chrome://tracing or ui.perfetto.dev). scopes nest per thread and must be closed in order.
+
+// ==================== ENUMS ==================== //
+
+typedef enum _eProfileCounter
+{
+    PROFILE_COUNTER_RENTS_PAID,
+    PROFILE_COUNTER_CARDS_DRAWN,
+    PROFILE_COUNTER_ALLOCATIONS,
+
+    PROFILE_COUNTER_COUNT
+} eProfileCounter;
+
+// ==================== MACROS ==================== //
+
+#ifdef M_ENABLE_PROFILING
+    #define M_PROFILE_INIT(uMaxEvents)         m_profile_init(uMaxEvents)
+    #define M_PROFILE_CLEANUP()                m_profile_cleanup()
+    #define M_PROFILE_BEGIN(pcName)            m_profile_begin(pcName)
+    #define M_PROFILE_END()                    m_profile_end()
+    #define M_PROFILE_COUNT(eCounter, iAmount) m_profile_count(eCounter, iAmount)
+    #define M_PROFILE_WRITE_TRACE(pcPath)      m_profile_write_chrome_trace(pcPath)
+#else
+    #define M_PROFILE_INIT(uMaxEvents)         ((void)0)
+    #define M_PROFILE_CLEANUP()                ((void)0)
+    #define M_PROFILE_BEGIN(pcName)            ((void)0)
+    #define M_PROFILE_END()                    ((void)0)
+    #define M_PROFILE_COUNT(eCounter, iAmount) ((void)0)
+    #define M_PROFILE_WRITE_TRACE(pcPath)      ((void)0)
+#endif
+
+// ==================== PROFILE FUNCTIONS ==================== //
+
+#ifdef M_ENABLE_PROFILING
+
+void    m_profile_init(uint32_t uMaxEvents); // nothing is recorded before this, events past the limit are dropped
+void    m_profile_cleanup(void);
+void    m_profile_begin(const char* pcName); // name must outlive the trace (string literals)
+void    m_profile_end(void);
+void    m_profile_count(eProfileCounter eCounter, int64_t iAmount);
+int64_t m_profile_get_counter(eProfileCounter eCounter);
+bool    m_profile_write_chrome_trace(const char* pcPath);
+
+#endif
+
+#endif // MONOPOLY_PROFILE_H
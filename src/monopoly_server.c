@@ -0,0 +1,505 @@
+#include "monopoly_server.h"
+#include "monopoly_init.h"
+#include "monopoly_platform.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// ==================== STRUCTS ==================== //
+
+typedef struct _mServerTable
+{
+    mGameData* pGame;
+    mGameFlow  tFlow;
+
+    // pending input ring (guarded by tLock)
+    mMutex   tLock;
+    int      aiInputQueue[M_SERVER_INPUT_QUEUE_SIZE];
+    uint32_t uInputHead;
+    uint32_t uInputCount;
+    bool     bScheduled; // queued on (or being run by) a worker
+
+    // stats (only touched by the worker that owns the table)
+    mServerTableStats tStats;
+} mServerTable;
+
+// per worker deque of table ids: owner pushes/pops the back, thieves take the front
+typedef struct _mServerWorker
+{
+    mServer*  ptServer;
+    mThread*  ptThread;
+    uint32_t  uIndex;
+    mMutex    tLock;
+    uint32_t* auTables;
+    uint32_t  uHead;
+    uint32_t  uCount;
+} mServerWorker;
+
+typedef struct _mServer
+{
+    mServerSettings tSettings;
+    mServerTable*   atTables;
+    mServerWorker   atWorkers[M_SERVER_MAX_WORKERS];
+    uint32_t        uWorkerCount;
+
+    volatile int64_t iRunning;
+    volatile int64_t iQueuedTables;    // sitting in a deque
+    volatile int64_t iScheduledTables; // queued or being stepped
+
+    // sleeping workers and idle waiters
+    mMutex     tSignalLock;
+    mCondition tWorkAvailable;
+    mCondition tIdle;
+} mServer;
+
+// ==================== INTERNAL HELPERS ==================== //
+
+static void
+m__server_push(mServerWorker* ptWorker, uint32_t uTableId)
+{
+    mServer* ptServer = ptWorker->ptServer;
+
+    m_mutex_lock(&ptWorker->tLock);
+    uint32_t uSlot = (ptWorker->uHead + ptWorker->uCount) % ptServer->tSettings.uTableCount;
+    ptWorker->auTables[uSlot] = uTableId;
+    ptWorker->uCount++;
+    m_mutex_unlock(&ptWorker->tLock);
+
+    // counter is bumped before taking the signal lock so sleeping workers can't miss it
+    m_atomic_add64(&ptServer->iQueuedTables, 1);
+    m_mutex_lock(&ptServer->tSignalLock);
+    m_condition_wake_one(&ptServer->tWorkAvailable);
+    m_mutex_unlock(&ptServer->tSignalLock);
+}
+
+static bool
+m__server_pop(mServerWorker* ptWorker, uint32_t* puTableIdOut)
+{
+    bool bFound = false;
+
+    m_mutex_lock(&ptWorker->tLock);
+    if(ptWorker->uCount > 0)
+    {
+        ptWorker->uCount--;
+        uint32_t uSlot = (ptWorker->uHead + ptWorker->uCount) % ptWorker->ptServer->tSettings.uTableCount;
+        *puTableIdOut = ptWorker->auTables[uSlot];
+        bFound = true;
+    }
+    m_mutex_unlock(&ptWorker->tLock);
+
+    if(bFound)
+        m_atomic_add64(&ptWorker->ptServer->iQueuedTables, -1);
+    return bFound;
+}
+
+static bool
+m__server_steal(mServerWorker* ptVictim, uint32_t* puTableIdOut)
+{
+    bool bFound = false;
+
+    m_mutex_lock(&ptVictim->tLock);
+    if(ptVictim->uCount > 0)
+    {
+        *puTableIdOut = ptVictim->auTables[ptVictim->uHead];
+        ptVictim->uHead = (ptVictim->uHead + 1) % ptVictim->ptServer->tSettings.uTableCount;
+        ptVictim->uCount--;
+        bFound = true;
+    }
+    m_mutex_unlock(&ptVictim->tLock);
+
+    if(bFound)
+        m_atomic_add64(&ptVictim->ptServer->iQueuedTables, -1);
+    return bFound;
+}
+
+static size_t
+m__server_table_footprint(const mServerTable* ptTable)
+{
+    size_t szBytes = sizeof(mServerTable) + sizeof(mGameData);
+
+    const mGameFlow* pFlow = &ptTable->tFlow;
+    if(pFlow->pCurrentPhaseData)
+        szBytes += m_get_phase_data_size(pFlow->pfCurrentPhase);
+    for(int i = 0; i < pFlow->iStackDepth; i++)
+    {
+        if(pFlow->apPhaseDataStack[i])
+            szBytes += m_get_phase_data_size(pFlow->apPhaseStack[i]);
+    }
+    return szBytes;
+}
+
+static uint32_t
+m__server_histogram_bucket(uint64_t uNanoseconds)
+{
+    uint32_t uBucket = 0;
+    while(uNanoseconds > 1 && uBucket < M_SERVER_HISTOGRAM_BUCKETS - 1)
+    {
+        uNanoseconds >>= 1;
+        uBucket++;
+    }
+    return uBucket;
+}
+
+// runs phases until the input is consumed, then a few more ticks so automatic steps
+// (moving after a roll, landing, bankruptcy) finish before the client is asked again
+static void
+m__server_settle(mServerTable* ptTable)
+{
+    mGameFlow* pFlow = &ptTable->tFlow;
+
+    for(uint32_t i = 0; i < M_SERVER_SETTLE_TICKS && pFlow->bInputReceived; i++)
+        m_run_current_phase(pFlow, 0.0f);
+
+    // phase never read it (e.g. menu not shown yet), drop it rather than leak into the next phase
+    if(pFlow->bInputReceived)
+        m_clear_input(pFlow);
+
+    for(uint32_t i = 0; i < M_SERVER_SETTLE_TICKS; i++)
+        m_run_current_phase(pFlow, 0.0f);
+
+    if(!ptTable->pGame->bIsRunning || m_check_game_over(ptTable->pGame))
+        ptTable->tStats.bGameOver = true;
+}
+
+static void
+m__server_step_table(mServerTable* ptTable, int iInput)
+{
+    uint64_t uStart = m_get_time_ns();
+
+    m_set_input_int(&ptTable->tFlow, iInput);
+    m__server_settle(ptTable);
+
+    uint64_t uElapsed = m_get_time_ns() - uStart;
+
+    mServerTableStats* ptStats = &ptTable->tStats;
+    ptStats->uSteps++;
+    ptStats->uTotalStepNs += uElapsed;
+    if(uElapsed > ptStats->uMaxStepNs)
+        ptStats->uMaxStepNs = uElapsed;
+    ptStats->auLatencyHistogram[m__server_histogram_bucket(uElapsed)]++;
+}
+
+static void
+m__server_notify_client(mServer* ptServer, uint32_t uTableId)
+{
+    mServerTable* ptTable = &ptServer->atTables[uTableId];
+    if(ptTable->tStats.bGameOver || !ptServer->tSettings.pfClient)
+        return;
+    ptServer->tSettings.pfClient(ptServer, uTableId, &ptTable->tFlow, ptServer->tSettings.pClientData);
+}
+
+static void
+m__server_run_table(mServerWorker* ptWorker, uint32_t uTableId)
+{
+    mServer* ptServer = ptWorker->ptServer;
+    mServerTable* ptTable = &ptServer->atTables[uTableId];
+
+    for(uint32_t uSlice = 0; uSlice < M_SERVER_INPUTS_PER_SLICE; uSlice++)
+    {
+        m_mutex_lock(&ptTable->tLock);
+        if(ptTable->uInputCount == 0)
+        {
+            // nothing left, table goes back to sleep until the next submit
+            ptTable->bScheduled = false;
+            m_mutex_unlock(&ptTable->tLock);
+
+            if(m_atomic_add64(&ptServer->iScheduledTables, -1) == 0)
+            {
+                m_mutex_lock(&ptServer->tSignalLock);
+                m_condition_wake_all(&ptServer->tIdle);
+                m_mutex_unlock(&ptServer->tSignalLock);
+            }
+            return;
+        }
+        int iInput = ptTable->aiInputQueue[ptTable->uInputHead];
+        ptTable->uInputHead = (ptTable->uInputHead + 1) % M_SERVER_INPUT_QUEUE_SIZE;
+        ptTable->uInputCount--;
+        m_mutex_unlock(&ptTable->tLock);
+
+        m__server_step_table(ptTable, iInput);
+        m__server_notify_client(ptServer, uTableId);
+    }
+
+    // used up its slice, requeue locally so other tables get a turn
+    m__server_push(ptWorker, uTableId);
+}
+
+static void
+m__server_worker_main(void* pData)
+{
+    mServerWorker* ptWorker = (mServerWorker*)pData;
+    mServer* ptServer = ptWorker->ptServer;
+
+    while(m_atomic_load64(&ptServer->iRunning))
+    {
+        uint32_t uTableId = 0;
+        bool bFound = m__server_pop(ptWorker, &uTableId);
+
+        // own deque empty, try to steal from the others
+        for(uint32_t i = 1; !bFound && i < ptServer->uWorkerCount; i++)
+        {
+            mServerWorker* ptVictim = &ptServer->atWorkers[(ptWorker->uIndex + i) % ptServer->uWorkerCount];
+            bFound = m__server_steal(ptVictim, &uTableId);
+        }
+
+        if(bFound)
+        {
+            m__server_run_table(ptWorker, uTableId);
+            continue;
+        }
+
+        // nothing anywhere, sleep until a push (timeout guards shutdown)
+        m_mutex_lock(&ptServer->tSignalLock);
+        if(m_atomic_load64(&ptServer->iQueuedTables) == 0 && m_atomic_load64(&ptServer->iRunning))
+            m_condition_wait(&ptServer->tWorkAvailable, &ptServer->tSignalLock, 50);
+        m_mutex_unlock(&ptServer->tSignalLock);
+    }
+}
+
+// ==================== SERVER FUNCTIONS ==================== //
+
+mServer*
+m_server_create(const mServerSettings* ptSettings)
+{
+    if(!ptSettings || ptSettings->uTableCount == 0) return NULL;
+
+    mServer* ptServer = calloc(1, sizeof(mServer));
+    if(!ptServer) return NULL;
+
+    ptServer->tSettings = *ptSettings;
+    ptServer->uWorkerCount = ptSettings->uWorkerCount ? ptSettings->uWorkerCount : m_get_hardware_thread_count();
+    if(ptServer->uWorkerCount > M_SERVER_MAX_WORKERS)
+        ptServer->uWorkerCount = M_SERVER_MAX_WORKERS;
+
+    m_mutex_init(&ptServer->tSignalLock);
+    m_condition_init(&ptServer->tWorkAvailable);
+    m_condition_init(&ptServer->tIdle);
+
+    for(uint32_t i = 0; i < ptServer->uWorkerCount; i++)
+    {
+        mServerWorker* ptWorker = &ptServer->atWorkers[i];
+        ptWorker->ptServer = ptServer;
+        ptWorker->uIndex   = i;
+        ptWorker->auTables = malloc(sizeof(uint32_t) * ptSettings->uTableCount);
+        m_mutex_init(&ptWorker->tLock);
+    }
+    for(uint32_t i = 0; i < ptServer->uWorkerCount; i++)
+    {
+        if(!ptServer->atWorkers[i].auTables)
+        {
+            m_server_destroy(ptServer);
+            return NULL;
+        }
+    }
+
+    // load game data once and stamp it into every table (avoids re-reading json per table)
+    mGameData* pTemplate = m_init_game(ptSettings->tGameSettings);
+    if(!pTemplate)
+    {
+        printf("Failed to create server template game\n");
+        m_server_destroy(ptServer);
+        return NULL;
+    }
+
+    ptServer->atTables = calloc(ptSettings->uTableCount, sizeof(mServerTable));
+    if(!ptServer->atTables)
+    {
+        m_free_game(pTemplate);
+        m_server_destroy(ptServer);
+        return NULL;
+    }
+
+    // every table lock exists before any game is allocated, so m_server_destroy can clean up a partial server
+    for(uint32_t i = 0; i < ptSettings->uTableCount; i++)
+        m_mutex_init(&ptServer->atTables[i].tLock);
+
+    for(uint32_t i = 0; i < ptSettings->uTableCount; i++)
+    {
+        mServerTable* ptTable = &ptServer->atTables[i];
+        ptTable->pGame = M_ALLOC(sizeof(mGameData)); // released by m_free_game
+        if(!ptTable->pGame)
+        {
+            m_free_game(pTemplate);
+            m_server_destroy(ptServer);
+            return NULL;
+        }
+        memcpy(ptTable->pGame, pTemplate, sizeof(mGameData));
+        m_shuffle_deck(&ptTable->pGame->tChanceDeck);
+        m_shuffle_deck(&ptTable->pGame->tCommunityChestDeck);
+
+        m_init_game_flow(&ptTable->tFlow, ptTable->pGame, NULL);
+        ptTable->tFlow.pfAuctionResolver    = ptSettings->pfAuctionResolver;
+        ptTable->tFlow.pAuctionResolverData = ptSettings->pAuctionResolverData;
+        m__server_settle(ptTable); // show the first pre-roll menu
+    }
+    m_free_game(pTemplate);
+
+    return ptServer;
+}
+
+void
+m_server_start(mServer* ptServer)
+{
+    if(!ptServer || m_atomic_load64(&ptServer->iRunning)) return;
+
+    // first client callbacks run here, before any worker exists, so nothing races them
+    for(uint32_t i = 0; i < ptServer->tSettings.uTableCount; i++)
+        m__server_notify_client(ptServer, i);
+
+    m_atomic_store64(&ptServer->iRunning, 1);
+    for(uint32_t i = 0; i < ptServer->uWorkerCount; i++)
+        ptServer->atWorkers[i].ptThread = m_thread_create(m__server_worker_main, &ptServer->atWorkers[i]);
+}
+
+void
+m_server_stop(mServer* ptServer)
+{
+    if(!ptServer || !m_atomic_load64(&ptServer->iRunning)) return;
+
+    m_atomic_store64(&ptServer->iRunning, 0);
+    m_mutex_lock(&ptServer->tSignalLock);
+    m_condition_wake_all(&ptServer->tWorkAvailable);
+    m_mutex_unlock(&ptServer->tSignalLock);
+
+    for(uint32_t i = 0; i < ptServer->uWorkerCount; i++)
+    {
+        m_thread_join(ptServer->atWorkers[i].ptThread);
+        ptServer->atWorkers[i].ptThread = NULL;
+    }
+}
+
+void
+m_server_destroy(mServer* ptServer)
+{
+    if(!ptServer) return;
+
+    m_server_stop(ptServer);
+
+    if(ptServer->atTables)
+    {
+        for(uint32_t i = 0; i < ptServer->tSettings.uTableCount; i++)
+        {
+            mServerTable* ptTable = &ptServer->atTables[i];
+            m_cleanup_game_flow(&ptTable->tFlow);
+            m_free_game(ptTable->pGame);
+            m_mutex_cleanup(&ptTable->tLock);
+        }
+        free(ptServer->atTables);
+    }
+
+    for(uint32_t i = 0; i < ptServer->uWorkerCount; i++)
+    {
+        free(ptServer->atWorkers[i].auTables);
+        m_mutex_cleanup(&ptServer->atWorkers[i].tLock);
+    }
+
+    m_condition_cleanup(&ptServer->tIdle);
+    m_condition_cleanup(&ptServer->tWorkAvailable);
+    m_mutex_cleanup(&ptServer->tSignalLock);
+    free(ptServer);
+}
+
+bool
+m_server_submit_input(mServer* ptServer, uint32_t uTableId, int iValue)
+{
+    if(!ptServer || uTableId >= ptServer->tSettings.uTableCount) return false;
+
+    mServerTable* ptTable = &ptServer->atTables[uTableId];
+    bool bNeedsSchedule = false;
+
+    m_mutex_lock(&ptTable->tLock);
+    if(ptTable->uInputCount >= M_SERVER_INPUT_QUEUE_SIZE)
+    {
+        m_mutex_unlock(&ptTable->tLock);
+        return false;
+    }
+    uint32_t uSlot = (ptTable->uInputHead + ptTable->uInputCount) % M_SERVER_INPUT_QUEUE_SIZE;
+    ptTable->aiInputQueue[uSlot] = iValue;
+    ptTable->uInputCount++;
+    if(!ptTable->bScheduled)
+    {
+        ptTable->bScheduled = true;
+        bNeedsSchedule = true;
+    }
+    m_mutex_unlock(&ptTable->tLock);
+
+    if(bNeedsSchedule)
+    {
+        m_atomic_add64(&ptServer->iScheduledTables, 1);
+
+        // tables have a home worker, stealing spreads the load from there
+        m__server_push(&ptServer->atWorkers[uTableId % ptServer->uWorkerCount], uTableId);
+    }
+    return true;
+}
+
+bool
+m_server_wait_idle(mServer* ptServer, uint32_t uTimeoutMs)
+{
+    if(!ptServer) return true;
+
+    uint64_t uDeadline = m_get_time_ns() + (uint64_t)uTimeoutMs * 1000000ull;
+
+    m_mutex_lock(&ptServer->tSignalLock);
+    while(m_atomic_load64(&ptServer->iScheduledTables) > 0 && m_get_time_ns() < uDeadline)
+        m_condition_wait(&ptServer->tIdle, &ptServer->tSignalLock, 10);
+    m_mutex_unlock(&ptServer->tSignalLock);
+
+    return m_atomic_load64(&ptServer->iScheduledTables) == 0;
+}
+
+uint32_t
+m_server_get_table_count(mServer* ptServer)
+{
+    return ptServer ? ptServer->tSettings.uTableCount : 0;
+}
+
+void
+m_server_get_table_stats(mServer* ptServer, uint32_t uTableId, mServerTableStats* ptStatsOut)
+{
+    if(!ptServer || !ptStatsOut || uTableId >= ptServer->tSettings.uTableCount) return;
+
+    mServerTable* ptTable = &ptServer->atTables[uTableId];
+    *ptStatsOut = ptTable->tStats;
+    ptStatsOut->szMemoryFootprint = m__server_table_footprint(ptTable);
+}
+
+void
+m_server_get_total_stats(mServer* ptServer, mServerTableStats* ptStatsOut)
+{
+    if(!ptServer || !ptStatsOut) return;
+
+    memset(ptStatsOut, 0, sizeof(mServerTableStats));
+    ptStatsOut->bGameOver = true;
+
+    for(uint32_t i = 0; i < ptServer->tSettings.uTableCount; i++)
+    {
+        mServerTableStats tTable;
+        m_server_get_table_stats(ptServer, i, &tTable);
+
+        ptStatsOut->uSteps            += tTable.uSteps;
+        ptStatsOut->uTotalStepNs      += tTable.uTotalStepNs;
+        ptStatsOut->szMemoryFootprint += tTable.szMemoryFootprint;
+        ptStatsOut->bGameOver         &= tTable.bGameOver;
+        if(tTable.uMaxStepNs > ptStatsOut->uMaxStepNs)
+            ptStatsOut->uMaxStepNs = tTable.uMaxStepNs;
+        for(uint32_t j = 0; j < M_SERVER_HISTOGRAM_BUCKETS; j++)
+            ptStatsOut->auLatencyHistogram[j] += tTable.auLatencyHistogram[j];
+    }
+}
+
+uint64_t
+m_server_get_histogram_percentile(const mServerTableStats* ptStats, float fPercentile)
+{
+    if(!ptStats || ptStats->uSteps == 0) return 0;
+
+    uint64_t uTarget = (uint64_t)((double)ptStats->uSteps * (double)fPercentile);
+    uint64_t uSeen = 0;
+    for(uint32_t i = 0; i < M_SERVER_HISTOGRAM_BUCKETS; i++)
+    {
+        uSeen += ptStats->auLatencyHistogram[i];
+        if(uSeen >= uTarget && uSeen > 0)
+            return 1ull << (i + 1);
+    }
+    return ptStats->uMaxStepNs;
+}
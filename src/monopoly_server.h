@@ -0,0 +1,69 @@
+#ifndef MONOPOLY_SERVER_H
+#define MONOPOLY_SERVER_H
+
+#include "monopoly.h"
+
+// headless multi-table host: owns many mGameData/mGameFlow pairs and steps them on a
+// worker pool. a table is only scheduled while it has pending input, so thousands of
+// idle tables cost nothing but memory.
+
+// ==================== CONSTANTS ==================== //
+
+#define M_SERVER_MAX_WORKERS        64
+#define M_SERVER_INPUT_QUEUE_SIZE   16  // pending inputs per table (power of two)
+#define M_SERVER_HISTOGRAM_BUCKETS  32  // log2(ns) buckets, bucket 31 catches everything >= 2^31 ns
+#define M_SERVER_INPUTS_PER_SLICE   8   // inputs processed before a table yields its worker
+#define M_SERVER_SETTLE_TICKS       4   // extra phase ticks after an input so automatic steps run
+
+// ==================== STRUCTS ==================== //
+
+typedef struct _mServer mServer;
+
+// called on a worker thread whenever a table settles and is waiting for input. the
+// table is owned by the calling worker for the duration of the call, so the flow and
+// game data can be read freely. answer with m_server_submit_input (or don't, to park
+// the table).
+typedef void (*fServerClientFunc)(mServer* ptServer, uint32_t uTableId, const mGameFlow* pFlow, void* pUserData);
+
+typedef struct _mServerSettings
+{
+    uint32_t          uTableCount;
+    uint32_t          uWorkerCount;   // 0 = one per hardware thread
+    mGameSettings     tGameSettings;
+    fServerClientFunc pfClient;       // loopback client, may be NULL for externally driven tables
+    void*             pClientData;
+    fAuctionResolver  pfAuctionResolver; // optional, set on every table's flow
+    void*             pAuctionResolverData;
+} mServerSettings;
+
+typedef struct _mServerTableStats
+{
+    uint64_t uSteps;
+    uint64_t uTotalStepNs;
+    uint64_t uMaxStepNs;
+    uint64_t auLatencyHistogram[M_SERVER_HISTOGRAM_BUCKETS]; // step count per log2(ns) bucket
+    size_t   szMemoryFootprint;                              // bytes owned by the table right now
+    bool     bGameOver;
+} mServerTableStats;
+
+// ==================== SERVER FUNCTIONS ==================== //
+
+// lifetime
+mServer* m_server_create(const mServerSettings* ptSettings);
+void     m_server_start(mServer* ptServer); // spawns workers and gives every table its first client callback
+void     m_server_stop(mServer* ptServer);  // joins workers, pending inputs are dropped
+void     m_server_destroy(mServer* ptServer);
+
+// input (thread safe)
+bool m_server_submit_input(mServer* ptServer, uint32_t uTableId, int iValue);
+
+// waits until no table has pending input (or the timeout passes), returns true if idle
+bool m_server_wait_idle(mServer* ptServer, uint32_t uTimeoutMs);
+
+// stats (only consistent while the server is idle or stopped)
+uint32_t m_server_get_table_count(mServer* ptServer);
+void     m_server_get_table_stats(mServer* ptServer, uint32_t uTableId, mServerTableStats* ptStatsOut);
+void     m_server_get_total_stats(mServer* ptServer, mServerTableStats* ptStatsOut); // summed over all tables
+uint64_t m_server_get_histogram_percentile(const mServerTableStats* ptStats, float fPercentile); // upper bound in ns
+
+#endif // MONOPOLY_SERVER_H
@@ -0,0 +1,269 @@
+#include "monopoly_stats.h"
+#include <stdio.h> // fopen, fprintf, snprintf
+
+// ==================== AGGREGATION ==================== //
+
+void
+m_stats_add_game(mStatsAggregate* ptAggregate, const mGameData* pGame)
+{
+    const mGameStats* pStats = &pGame->tStats;
+
+    ptAggregate->uGames++;
+    ptAggregate->uTurns += pStats->uTurns;
+    if(pGame->uActivePlayers <= 1)
+        ptAggregate->uFinishedGames++;
+
+    for(uint32_t i = 0; i < TOTAL_PROPERTIES; i++)
+    {
+        ptAggregate->auPropertyRent[i]      += pStats->auPropertyRent[i];
+        ptAggregate->auPropertyRentCount[i] += pStats->auPropertyRentCount[i];
+    }
+    for(uint32_t i = 0; i < TOTAL_CHANCE_CARDS; i++)
+        ptAggregate->auChanceDrawn[i] += pStats->auChanceDrawn[i];
+    for(uint32_t i = 0; i < TOTAL_COMMUNITY_CHEST_CARDS; i++)
+        ptAggregate->auCommunityChestDrawn[i] += pStats->auCommunityChestDrawn[i];
+
+    uint32_t uFirstMonopolyTurn = 0;
+    uint8_t  uFirstMonopolist   = BANK_PLAYER_INDEX;
+    for(uint8_t i = 0; i < pGame->uPlayerCount; i++)
+    {
+        ptAggregate->auRentPaid[i]     += pStats->auRentPaid[i];
+        ptAggregate->auRentReceived[i] += pStats->auRentReceived[i];
+        ptAggregate->auJailVisits[i]   += pStats->auJailVisits[i];
+        ptAggregate->auJailTurns[i]    += pStats->auJailTurns[i];
+
+        if(pGame->amPlayers[i].bIsBankrupt)
+            ptAggregate->auBankruptcies[i][pStats->auBankruptcyCause[i] % BANKRUPTCY_CAUSE_COUNT]++;
+        else if(pGame->uActivePlayers == 1)
+            ptAggregate->auWins[i]++;
+
+        uint32_t uTurn = pStats->auFirstMonopolyTurn[i];
+        if(uTurn != 0 && (uFirstMonopolyTurn == 0 || uTurn < uFirstMonopolyTurn))
+        {
+            uFirstMonopolyTurn = uTurn;
+            uFirstMonopolist   = i;
+        }
+    }
+
+    if(uFirstMonopolist != BANK_PLAYER_INDEX)
+    {
+        uint32_t uBucket = (uFirstMonopolyTurn - 1) / M_STATS_TURN_BUCKET_WIDTH;
+        if(uBucket >= M_STATS_TURN_BUCKETS)
+            uBucket = M_STATS_TURN_BUCKETS - 1;
+
+        ptAggregate->uGamesWithMonopoly++;
+        ptAggregate->uFirstMonopolyTurnSum += uFirstMonopolyTurn;
+        ptAggregate->auFirstMonopolyTurns[uBucket]++;
+        ptAggregate->auFirstMonopolies[uFirstMonopolist]++;
+    }
+}
+
+void
+m_stats_merge(mStatsAggregate* ptInto, const mStatsAggregate* ptFrom)
+{
+    uint64_t* puInto = (uint64_t*)ptInto;
+    const uint64_t* puFrom = (const uint64_t*)ptFrom;
+    for(size_t i = 0; i < sizeof(mStatsAggregate) / sizeof(uint64_t); i++)
+        puInto[i] += puFrom[i];
+}
+
+// ==================== TABLES ==================== //
+
+// both exports walk the same description of the aggregate
+typedef enum _eStatsTable
+{
+    STATS_TABLE_SUMMARY,
+    STATS_TABLE_PROPERTY,
+    STATS_TABLE_CHANCE,
+    STATS_TABLE_COMMUNITY_CHEST,
+    STATS_TABLE_SEAT,
+    STATS_TABLE_FIRST_MONOPOLY,
+
+    STATS_TABLE_COUNT
+} eStatsTable;
+
+typedef struct _mStatsColumn
+{
+    eStatsTable     eTable;
+    const char*     pcName;
+    const uint64_t* puData;
+    uint32_t        uStride; // in uint64_t, for the 2d bankruptcy counts
+} mStatsColumn;
+
+static const char* gapcStatsTableNames[STATS_TABLE_COUNT] = {
+    "summary", "property", "chance", "community_chest", "seat", "first_monopoly"
+};
+
+static const uint32_t gauStatsTableRows[STATS_TABLE_COUNT] = {
+    1, TOTAL_PROPERTIES, TOTAL_CHANCE_CARDS, TOTAL_COMMUNITY_CHEST_CARDS, MAX_PLAYERS, M_STATS_TURN_BUCKETS
+};
+
+#define M_STATS_MAX_COLUMNS 24
+
+static uint32_t
+m__stats_columns(const mStatsAggregate* ptAggregate, mStatsColumn* atColumns)
+{
+    uint32_t uCount = 0;
+    #define M_STATS_COLUMN(eTable, pcName, puData, uStride) atColumns[uCount++] = (mStatsColumn){eTable, pcName, puData, uStride}
+
+    M_STATS_COLUMN(STATS_TABLE_SUMMARY, "games",                  &ptAggregate->uGames, 1);
+    M_STATS_COLUMN(STATS_TABLE_SUMMARY, "finished_games",         &ptAggregate->uFinishedGames, 1);
+    M_STATS_COLUMN(STATS_TABLE_SUMMARY, "turns",                  &ptAggregate->uTurns, 1);
+    M_STATS_COLUMN(STATS_TABLE_SUMMARY, "games_with_monopoly",    &ptAggregate->uGamesWithMonopoly, 1);
+    M_STATS_COLUMN(STATS_TABLE_SUMMARY, "first_monopoly_turn_sum", &ptAggregate->uFirstMonopolyTurnSum, 1);
+
+    M_STATS_COLUMN(STATS_TABLE_PROPERTY, "rent",       ptAggregate->auPropertyRent, 1);
+    M_STATS_COLUMN(STATS_TABLE_PROPERTY, "rent_count", ptAggregate->auPropertyRentCount, 1);
+
+    M_STATS_COLUMN(STATS_TABLE_CHANCE,          "drawn", ptAggregate->auChanceDrawn, 1);
+    M_STATS_COLUMN(STATS_TABLE_COMMUNITY_CHEST, "drawn", ptAggregate->auCommunityChestDrawn, 1);
+
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "rent_paid",        ptAggregate->auRentPaid, 1);
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "rent_received",    ptAggregate->auRentReceived, 1);
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "jail_visits",      ptAggregate->auJailVisits, 1);
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "jail_turns",       ptAggregate->auJailTurns, 1);
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "wins",             ptAggregate->auWins, 1);
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "first_monopolies", ptAggregate->auFirstMonopolies, 1);
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "bankrupt_rent",    &ptAggregate->auBankruptcies[0][BANKRUPTCY_CAUSE_RENT], BANKRUPTCY_CAUSE_COUNT);
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "bankrupt_tax",     &ptAggregate->auBankruptcies[0][BANKRUPTCY_CAUSE_TAX], BANKRUPTCY_CAUSE_COUNT);
+    M_STATS_COLUMN(STATS_TABLE_SEAT, "bankrupt_card",    &ptAggregate->auBankruptcies[0][BANKRUPTCY_CAUSE_CARD], BANKRUPTCY_CAUSE_COUNT);
+
+    M_STATS_COLUMN(STATS_TABLE_FIRST_MONOPOLY, "games", ptAggregate->auFirstMonopolyTurns, 1);
+
+    #undef M_STATS_COLUMN
+    return uCount;
+}
+
+static void
+m__stats_row_name(eStatsTable eTable, uint32_t uRow, const mGameData* pNames, char* pcOut)
+{
+    switch(eTable)
+    {
+        case STATS_TABLE_SUMMARY:
+            snprintf(pcOut, M_STATS_NAME_SIZE, "all");
+            return;
+        case STATS_TABLE_PROPERTY:
+            if(pNames) { snprintf(pcOut, M_STATS_NAME_SIZE, "%s", pNames->amProperties[uRow].cName); return; }
+            break;
+        case STATS_TABLE_CHANCE:
+            if(pNames) { snprintf(pcOut, M_STATS_NAME_SIZE, "%s", pNames->amChanceCards[uRow].cDescription); return; }
+            break;
+        case STATS_TABLE_COMMUNITY_CHEST:
+            if(pNames) { snprintf(pcOut, M_STATS_NAME_SIZE, "%s", pNames->amCommunityChestCards[uRow].cDescription); return; }
+            break;
+        case STATS_TABLE_SEAT:
+            snprintf(pcOut, M_STATS_NAME_SIZE, "player %u", uRow + 1);
+            return;
+        case STATS_TABLE_FIRST_MONOPOLY:
+            if(uRow + 1 == M_STATS_TURN_BUCKETS)
+                snprintf(pcOut, M_STATS_NAME_SIZE, "turn %u+", uRow * M_STATS_TURN_BUCKET_WIDTH + 1);
+            else
+                snprintf(pcOut, M_STATS_NAME_SIZE, "turns %u-%u", uRow * M_STATS_TURN_BUCKET_WIDTH + 1, (uRow + 1) * M_STATS_TURN_BUCKET_WIDTH);
+            return;
+        default:
+            break;
+    }
+    snprintf(pcOut, M_STATS_NAME_SIZE, "%u", uRow);
+}
+
+// ==================== EXPORT ==================== //
+
+// long format, one value per line: table,row,name,column,value
+bool
+m_stats_write_csv(const mStatsAggregate* ptAggregate, const mGameData* pNames, const char* pcPath)
+{
+    FILE* ptFile = fopen(pcPath, "w");
+    if(!ptFile)
+        return false;
+
+    mStatsColumn atColumns[M_STATS_MAX_COLUMNS];
+    uint32_t uColumnCount = m__stats_columns(ptAggregate, atColumns);
+
+    fprintf(ptFile, "table,row,name,column,value\n");
+    for(uint32_t i = 0; i < uColumnCount; i++)
+    {
+        const mStatsColumn* ptColumn = &atColumns[i];
+        for(uint32_t uRow = 0; uRow < gauStatsTableRows[ptColumn->eTable]; uRow++)
+        {
+            char acName[M_STATS_NAME_SIZE];
+            m__stats_row_name(ptColumn->eTable, uRow, pNames, acName);
+
+            // names are quoted, embedded quotes doubled
+            fprintf(ptFile, "%s,%u,\"", gapcStatsTableNames[ptColumn->eTable], uRow);
+            for(const char* pc = acName; *pc; pc++)
+            {
+                if(*pc == '"')
+                    fputc('"', ptFile);
+                fputc(*pc, ptFile);
+            }
+            fprintf(ptFile, "\",%s,%llu\n", ptColumn->pcName, (unsigned long long)ptColumn->puData[uRow * ptColumn->uStride]);
+        }
+    }
+
+    // a short write (full disk) only shows up here
+    bool bOk = !ferror(ptFile);
+    if(fclose(ptFile) != 0)
+        bOk = false;
+    return bOk;
+}
+
+static void
+m__stats_write_column_header(FILE* ptFile, const char* pcTable, const char* pcColumn, eStatsColumnType eType, uint32_t uRows)
+{
+    char acName[M_STATS_NAME_SIZE] = {0};
+    snprintf(acName, sizeof(acName), "%s.%s", pcTable, pcColumn);
+    uint32_t auHeader[2] = { (uint32_t)eType, uRows };
+    fwrite(acName, 1, sizeof(acName), ptFile);
+    fwrite(auHeader, sizeof(uint32_t), 2, ptFile);
+}
+
+bool
+m_stats_write_columns(const mStatsAggregate* ptAggregate, const mGameData* pNames, const char* pcPath)
+{
+    FILE* ptFile = fopen(pcPath, "wb");
+    if(!ptFile)
+        return false;
+
+    mStatsColumn atColumns[M_STATS_MAX_COLUMNS];
+    uint32_t uColumnCount = m__stats_columns(ptAggregate, atColumns);
+
+    // every table also gets a name column
+    uint32_t auHeader[2] = { M_STATS_FILE_VERSION, uColumnCount + STATS_TABLE_COUNT };
+    fwrite("MSTA", 1, 4, ptFile);
+    fwrite(auHeader, sizeof(uint32_t), 2, ptFile);
+
+    for(uint32_t uTable = 0; uTable < STATS_TABLE_COUNT; uTable++)
+    {
+        uint32_t uRows = gauStatsTableRows[uTable];
+        m__stats_write_column_header(ptFile, gapcStatsTableNames[uTable], "name", STATS_COLUMN_NAME, uRows);
+        for(uint32_t uRow = 0; uRow < uRows; uRow++)
+        {
+            char acName[M_STATS_NAME_SIZE] = {0};
+            m__stats_row_name((eStatsTable)uTable, uRow, pNames, acName);
+            fwrite(acName, 1, sizeof(acName), ptFile);
+        }
+
+        for(uint32_t i = 0; i < uColumnCount; i++)
+        {
+            const mStatsColumn* ptColumn = &atColumns[i];
+            if(ptColumn->eTable != (eStatsTable)uTable)
+                continue;
+
+            m__stats_write_column_header(ptFile, gapcStatsTableNames[uTable], ptColumn->pcName, STATS_COLUMN_U64, uRows);
+            if(ptColumn->uStride == 1)
+            {
+                fwrite(ptColumn->puData, sizeof(uint64_t), uRows, ptFile);
+            }
+            else
+            {
+                for(uint32_t uRow = 0; uRow < uRows; uRow++)
+                    fwrite(&ptColumn->puData[uRow * ptColumn->uStride], sizeof(uint64_t), 1, ptFile);
+            }
+        }
+    }
+
+    bool bOk = !ferror(ptFile);
+    if(fclose(ptFile) != 0)
+        bOk = false;
+    return bOk;
+}
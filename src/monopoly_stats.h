@@ -0,0 +1,69 @@
+#ifndef MONOPOLY_STATS_H
+#define MONOPOLY_STATS_H
+
+#include "monopoly.h"
+
+// sums the per game counters (mGameStats) of any number of finished games. aggregates are
+// plain structs of uint64_t, so each simulator thread keeps its own and merges at the end.
+// results can be written as long format csv or as a columnar binary file:
+//
+//   header  "MSTA", uint32 version, uint32 column count
+//   column  char name[48] ("table.column"), uint32 type (eStatsColumnType), uint32 rows, data
+//
+// values are in native byte order, u64 columns hold rows * 8 bytes, name columns rows * 48 bytes
+
+// ==================== CONSTANTS ==================== //
+
+#define M_STATS_FILE_VERSION      1
+#define M_STATS_NAME_SIZE         48
+#define M_STATS_TURN_BUCKETS      50 // first monopoly histogram, the last bucket is open ended
+#define M_STATS_TURN_BUCKET_WIDTH 5
+
+// ==================== ENUMS ==================== //
+
+typedef enum _eStatsColumnType
+{
+    STATS_COLUMN_U64,
+    STATS_COLUMN_NAME
+} eStatsColumnType;
+
+// ==================== STRUCTS ==================== //
+
+// every field is a uint64_t (m_stats_merge relies on it)
+typedef struct _mStatsAggregate
+{
+    uint64_t uGames;
+    uint64_t uFinishedGames; // one player left
+    uint64_t uTurns;
+
+    // by property / card index
+    uint64_t auPropertyRent[TOTAL_PROPERTIES];
+    uint64_t auPropertyRentCount[TOTAL_PROPERTIES];
+    uint64_t auChanceDrawn[TOTAL_CHANCE_CARDS];
+    uint64_t auCommunityChestDrawn[TOTAL_COMMUNITY_CHEST_CARDS];
+
+    // by seat
+    uint64_t auRentPaid[MAX_PLAYERS];
+    uint64_t auRentReceived[MAX_PLAYERS];
+    uint64_t auJailVisits[MAX_PLAYERS];
+    uint64_t auJailTurns[MAX_PLAYERS];
+    uint64_t auWins[MAX_PLAYERS];
+    uint64_t auFirstMonopolies[MAX_PLAYERS]; // games where this seat completed a group first
+    uint64_t auBankruptcies[MAX_PLAYERS][BANKRUPTCY_CAUSE_COUNT];
+
+    // turns until anyone owned a full street color group
+    uint64_t uGamesWithMonopoly;
+    uint64_t uFirstMonopolyTurnSum;
+    uint64_t auFirstMonopolyTurns[M_STATS_TURN_BUCKETS];
+} mStatsAggregate;
+
+// ==================== STATS FUNCTIONS ==================== //
+
+void m_stats_add_game(mStatsAggregate* ptAggregate, const mGameData* pGame);
+void m_stats_merge(mStatsAggregate* ptInto, const mStatsAggregate* ptFrom);
+
+// pNames supplies property names and card descriptions, NULL writes indices only
+bool m_stats_write_csv(const mStatsAggregate* ptAggregate, const mGameData* pNames, const char* pcPath);
+bool m_stats_write_columns(const mStatsAggregate* ptAggregate, const mGameData* pNames, const char* pcPath);
+
+#endif // MONOPOLY_STATS_H
@@ -0,0 +1,54 @@
+#ifndef MONOPOLY_TEXTURE_H
+#define MONOPOLY_TEXTURE_H
+
+#include <stdint.h> // uint
+
+// cooked texture container (.mtex), written offline by monopoly_cook and streamed by the app
+// without decoding. layout:
+//
+//   mTextureFileHeader
+//   mTextureFileMip      x uMipCount, largest first
+//   mip data             starts at uDataOffset, every mip aligned to M_TEXTURE_FILE_ALIGNMENT
+//
+// the data block can be copied into a staging buffer as is (at an aligned offset) and every mip
+// copied to the texture from its own offset. values are in native byte order
+
+// ==================== CONSTANTS ==================== //
+
+#define M_TEXTURE_FILE_MAGIC     0x5845544D // "MTEX"
+#define M_TEXTURE_FILE_VERSION   1
+#define M_TEXTURE_FILE_ALIGNMENT 256
+#define M_TEXTURE_MAX_MIPS       16
+
+// ==================== ENUMS ==================== //
+
+typedef enum _eTextureFileFormat
+{
+    TEXTURE_FILE_FORMAT_RGBA8_UNORM, // block compressed formats go here once the cooker has an encoder
+
+    TEXTURE_FILE_FORMAT_COUNT
+} eTextureFileFormat;
+
+// ==================== STRUCTS ==================== //
+
+typedef struct _mTextureFileHeader
+{
+    uint32_t uMagic;
+    uint32_t uVersion;
+    uint32_t uFormat; // eTextureFileFormat
+    uint32_t uWidth;
+    uint32_t uHeight;
+    uint32_t uMipCount;
+    uint64_t uDataOffset; // from the start of the file
+    uint64_t uDataSize;
+} mTextureFileHeader;
+
+typedef struct _mTextureFileMip
+{
+    uint64_t uOffset; // from uDataOffset
+    uint64_t uSize;
+    uint32_t uWidth;
+    uint32_t uHeight;
+} mTextureFileMip;
+
+#endif // MONOPOLY_TEXTURE_H
@@ -0,0 +1,321 @@
+/*
+   server_app.c - headless multi-table host
+
+   runs many monopoly tables in one process with scripted loopback clients answering
+   every prompt, then reports throughput, per-table memory and step latency. every seat
+   is a computer player, so auctions are settled in one step by monopoly_ai.
+
+   with -net every prompt and every state change goes through the delta protocol over
+   loopback links instead: one client per seat plus optional spectators, each checking
+   its replicated state against the server's after every step.
+
+   usage: monopoly_server [-tables N] [-workers N] [-players N] [-rounds N] [-timeout SECONDS]
+                          [-net] [-spectators N] [-trace FILE]
+
+   -trace saves a chrome trace of the run (needs a build with M_ENABLE_PROFILING)
+*/
+
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "monopoly.h"
+#include "monopoly_server.h"
+#include "monopoly_platform.h"
+#include "monopoly_net.h"
+#include "monopoly_ai.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] structs
+//-----------------------------------------------------------------------------
+
+// per table protocol state for -net (only touched by the worker stepping the table)
+typedef struct _mNetTable
+{
+    bool         bInitialized;
+    mNetServer   tServer;
+    mNetLoopback atLinks[M_NET_MAX_CLIENTS];
+    mNetClient   atClients[M_NET_MAX_CLIENTS]; // seats first, then spectators
+    uint32_t     uClientCount;
+    uint64_t     uStateMismatches;
+} mNetTable;
+
+typedef struct _mScriptedClientData
+{
+    uint64_t         uMaxRounds; // table is parked once it reaches this many rounds
+    volatile int64_t iInputsSent;
+
+    // -net
+    mNetTable* atNetTables;
+    uint32_t   uSpectatorCount;
+} mScriptedClientData;
+
+//-----------------------------------------------------------------------------
+// [SECTION] scripted client
+//-----------------------------------------------------------------------------
+
+// answers whatever the current phase is waiting for, the same way the ui buttons would
+static int
+scripted_client_choose_input(const mGameFlow* pFlow)
+{
+    mGameData* pGame = pFlow->pGame;
+    mPlayer* pPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
+
+    if(pFlow->pfCurrentPhase == m_phase_pre_roll)
+    {
+        return 3; // roll dice
+    }
+    else if(pFlow->pfCurrentPhase == m_phase_jail)
+    {
+        if(pPlayer->bHasJailFreeCard)
+            return 2;
+        if(m_can_afford(pPlayer, pGame->uJailFine))
+            return 1;
+        return 3; // roll for doubles
+    }
+    else if(pFlow->pfCurrentPhase == m_phase_post_roll)
+    {
+        mPostRollData* pPostRoll = (mPostRollData*)pFlow->pCurrentPhaseData;
+        if(!pPostRoll->bHandledLanding && pPostRoll->eSquareType == SQUARE_PROPERTY &&
+           pPostRoll->uPropertyIndex != BANK_PLAYER_INDEX &&
+           pGame->amProperties[pPostRoll->uPropertyIndex].uOwnerIndex == BANK_PLAYER_INDEX)
+        {
+            mProperty* pProp = &pGame->amProperties[pPostRoll->uPropertyIndex];
+            return m_can_afford(pPlayer, pProp->uPrice) ? 1 : 2; // buy, or pass to auction
+        }
+        return 3; // end turn
+    }
+
+    // auction, trade and property management: pass / back out
+    return 0;
+}
+
+static void
+scripted_client(mServer* ptServer, uint32_t uTableId, const mGameFlow* pFlow, void* pUserData)
+{
+    mScriptedClientData* ptClient = (mScriptedClientData*)pUserData;
+
+    if(pFlow->pGame->uRoundCount >= ptClient->uMaxRounds)
+        return; // park the table
+
+    if(m_server_submit_input(ptServer, uTableId, scripted_client_choose_input(pFlow)))
+        m_atomic_add64(&ptClient->iInputsSent, 1);
+}
+
+static void
+net_client(mServer* ptServer, uint32_t uTableId, const mGameFlow* pFlow, void* pUserData)
+{
+    mScriptedClientData* ptClient = (mScriptedClientData*)pUserData;
+    mNetTable* ptNet = &ptClient->atNetTables[uTableId];
+
+    if(!ptNet->bInitialized)
+    {
+        m_net_server_init(&ptNet->tServer, pFlow);
+        uint32_t uSeats = pFlow->pGame->uPlayerCount;
+        ptNet->uClientCount = uSeats + ptClient->uSpectatorCount;
+        for(uint32_t i = 0; i < ptNet->uClientCount; i++)
+        {
+            m_net_loopback_init(&ptNet->atLinks[i]);
+            m_net_client_init(&ptNet->atClients[i], &ptNet->atLinks[i]);
+            m_net_server_add_client(&ptNet->tServer, &ptNet->atLinks[i], i < uSeats ? (uint8_t)i : M_NET_SPECTATOR);
+        }
+        ptNet->bInitialized = true;
+    }
+
+    // push the settled state out and make sure every replica matches it
+    m_net_server_broadcast(&ptNet->tServer);
+
+    mNetSnapshot tAuthoritative;
+    m_net_capture_snapshot(pFlow, &tAuthoritative);
+    for(uint32_t i = 0; i < ptNet->uClientCount; i++)
+    {
+        m_net_client_receive(&ptNet->atClients[i]);
+        if(!m_net_snapshots_equal(&ptNet->atClients[i].tState, &tAuthoritative))
+            ptNet->uStateMismatches++;
+    }
+
+    // the seat the game is waiting on answers over its link
+    if(pFlow->pGame->uRoundCount < ptClient->uMaxRounds)
+    {
+        uint8_t uSeat = m_net_get_input_player(pFlow);
+        m_net_client_send_input(&ptNet->atClients[uSeat], scripted_client_choose_input(pFlow));
+    }
+
+    // drains acks as well as inputs
+    int iValue = 0;
+    while(m_net_server_poll_input(&ptNet->tServer, &iValue))
+    {
+        if(m_server_submit_input(ptServer, uTableId, iValue))
+            m_atomic_add64(&ptClient->iInputsSent, 1);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] main
+//-----------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t uTableCount  = 1000;
+    uint32_t uWorkerCount = 0;
+    uint32_t uPlayerCount = 4;
+    uint32_t uMaxRounds   = 100;
+    uint32_t uTimeoutSec  = 60;
+    uint32_t uSpectators  = 0;
+    bool     bNet         = false;
+    const char* pcTrace   = NULL;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-net") == 0)
+        {
+            bNet = true;
+            continue;
+        }
+        if(i == argc - 1)
+            break;
+
+        if(strcmp(argv[i], "-tables") == 0)       uTableCount  = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-workers") == 0) uWorkerCount = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-players") == 0) uPlayerCount = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-rounds") == 0)  uMaxRounds   = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-timeout") == 0) uTimeoutSec  = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-spectators") == 0) uSpectators = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-trace") == 0)   pcTrace      = argv[++i];
+    }
+
+#ifndef M_ENABLE_PROFILING
+    if(pcTrace)
+        printf("-trace ignored, build with M_ENABLE_PROFILING to record one\n");
+#endif
+    if(pcTrace)
+        M_PROFILE_INIT(1 << 22); // ~128 MB, later events are dropped
+
+    if(uPlayerCount < 2) uPlayerCount = 2;
+    if(uPlayerCount > MAX_PLAYERS) uPlayerCount = MAX_PLAYERS;
+    if(uPlayerCount + uSpectators > M_NET_MAX_CLIENTS) uSpectators = M_NET_MAX_CLIENTS - uPlayerCount;
+
+    mScriptedClientData tClient = {
+        .uMaxRounds      = uMaxRounds,
+        .uSpectatorCount = uSpectators
+    };
+
+    if(bNet)
+    {
+        tClient.atNetTables = calloc(uTableCount, sizeof(mNetTable));
+        if(!tClient.atNetTables)
+            return 1;
+    }
+
+    mAiModel tAiModel;
+    m_ai_init_model(&tAiModel);
+    mAiPlayers tAiPlayers = {
+        .ptModel          = &tAiModel,
+        .uComputerPlayers = (uint8_t)((1u << MAX_PLAYERS) - 1)
+    };
+
+    mServerSettings tSettings = {
+        .uTableCount  = uTableCount,
+        .uWorkerCount = uWorkerCount,
+        .tGameSettings = {
+            .uStartingMoney = 1500,
+            .uJailFine      = 50,
+            .uPlayerCount   = (uint8_t)uPlayerCount
+        },
+        .pfClient             = bNet ? net_client : scripted_client,
+        .pClientData          = &tClient,
+        .pfAuctionResolver    = m_ai_auction_resolver,
+        .pAuctionResolverData = &tAiPlayers
+    };
+
+    mServer* ptServer = m_server_create(&tSettings);
+    if(!ptServer)
+        return 1;
+
+    uint64_t uStart = m_get_time_ns();
+    m_server_start(ptServer);
+    bool bIdle = m_server_wait_idle(ptServer, uTimeoutSec * 1000);
+    uint64_t uElapsed = m_get_time_ns() - uStart;
+    m_server_stop(ptServer);
+
+    // report
+    mServerTableStats tTotal;
+    m_server_get_total_stats(ptServer, &tTotal);
+
+    uint32_t uFinishedGames = 0;
+    for(uint32_t i = 0; i < uTableCount; i++)
+    {
+        mServerTableStats tTable;
+        m_server_get_table_stats(ptServer, i, &tTable);
+        if(tTable.bGameOver)
+            uFinishedGames++;
+    }
+
+    double dSeconds = (double)uElapsed / 1e9;
+    printf("tables:            %u (%u players, %u round cap)\n", uTableCount, uPlayerCount, uMaxRounds);
+    printf("finished games:    %u\n", uFinishedGames);
+    printf("completed:         %s\n", bIdle ? "yes" : "no (timed out)");
+    printf("wall time:         %.3f s\n", dSeconds);
+    printf("inputs:            %lld\n", (long long)m_atomic_load64(&tClient.iInputsSent));
+    printf("steps:             %llu (%.0f steps/s)\n", (unsigned long long)tTotal.uSteps, (double)tTotal.uSteps / dSeconds);
+    printf("memory per table:  %zu bytes avg\n", tTotal.szMemoryFootprint / uTableCount);
+    if(tTotal.uSteps > 0)
+    {
+        printf("step latency:      avg %llu ns, p50 <= %llu ns, p99 <= %llu ns, max %llu ns\n",
+            (unsigned long long)(tTotal.uTotalStepNs / tTotal.uSteps),
+            (unsigned long long)m_server_get_histogram_percentile(&tTotal, 0.5f),
+            (unsigned long long)m_server_get_histogram_percentile(&tTotal, 0.99f),
+            (unsigned long long)tTotal.uMaxStepNs);
+    }
+
+    printf("latency histogram:\n");
+    for(uint32_t i = 0; i < M_SERVER_HISTOGRAM_BUCKETS; i++)
+    {
+        if(tTotal.auLatencyHistogram[i] == 0)
+            continue;
+        printf("  < %10llu ns: %llu\n", 1ull << (i + 1), (unsigned long long)tTotal.auLatencyHistogram[i]);
+    }
+
+    if(bNet)
+    {
+        uint64_t uBytes = 0;
+        uint64_t uPackets = 0;
+        uint64_t uMismatches = 0;
+        uint64_t uRejected = 0;
+        uint64_t uClients = 0;
+        for(uint32_t i = 0; i < uTableCount; i++)
+        {
+            mNetTable* ptNet = &tClient.atNetTables[i];
+            for(uint32_t j = 0; j < ptNet->tServer.uClientCount; j++)
+            {
+                uBytes   += ptNet->tServer.atClients[j].uBytesSent;
+                uPackets += ptNet->tServer.atClients[j].uPacketsSent;
+            }
+            uClients    += ptNet->uClientCount;
+            uMismatches += ptNet->uStateMismatches;
+            uRejected   += ptNet->tServer.uRejectedInputs;
+        }
+
+        printf("net clients:       %llu (%u spectators per table)\n", (unsigned long long)uClients, uSpectators);
+        printf("state packets:     %llu (%.1f bytes avg)\n", (unsigned long long)uPackets, uPackets ? (double)uBytes / (double)uPackets : 0.0);
+        printf("state bytes:       %llu (%.1f per step per client)\n", (unsigned long long)uBytes,
+            tTotal.uSteps && uClients ? (double)uBytes / (double)tTotal.uSteps / ((double)uClients / (double)uTableCount) : 0.0);
+        printf("replica mismatch:  %llu\n", (unsigned long long)uMismatches);
+        printf("rejected inputs:   %llu\n", (unsigned long long)uRejected);
+        free(tClient.atNetTables);
+    }
+
+    if(pcTrace)
+    {
+        M_PROFILE_WRITE_TRACE(pcTrace);
+        M_PROFILE_CLEANUP();
+    }
+
+    m_server_destroy(ptServer);
+    return bIdle ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+/*
+   test_liquidation.c - bankruptcy liquidation regression tests
+
+   a player who can cover a debt by mortgaging must never be declared bankrupt, even when
+   the planner has to count the debt in coarse units (house supply tracked, big shortfall)
+   and finds no plan.
+
+   usage: monopoly_test_liquidation [DATA_DIRECTORY]
+*/
+
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "monopoly.h"
+#include "monopoly_init.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#define TEST_CHECK(bCondition, ...)                        \
+    do {                                                   \
+        if(!(bCondition))                                  \
+        {                                                  \
+            printf("FAILED %s:%d: ", __FILE__, __LINE__);  \
+            printf(__VA_ARGS__);                           \
+            printf("\n");                                  \
+            guFailures++;                                  \
+        }                                                  \
+    } while(0)
+
+//-----------------------------------------------------------------------------
+// [SECTION] globals
+//-----------------------------------------------------------------------------
+
+static uint32_t    guFailures = 0;
+static const char* gpcDataDirectory = "game_data";
+
+//-----------------------------------------------------------------------------
+// [SECTION] fixture
+//-----------------------------------------------------------------------------
+
+// player 1 holds hotels on green and dark blue with no houses left in the bank (so none
+// of them can be sold) and $770 of bare property to mortgage: railroads, utilities,
+// light blue and brown. player 2 is the creditor
+static mGameData*
+test_create_fixture(void)
+{
+    mGameSettings tSettings = {
+        .uStartingMoney  = 1500,
+        .uJailFine       = 50,
+        .uPlayerCount    = 2,
+        .pcDataDirectory = gpcDataDirectory
+    };
+    mGameData* pGame = m_init_game(tSettings);
+    if(!pGame)
+        return NULL;
+
+    static const uint8_t auHotels[] = {
+        PACIFIC_AVENUE_PROPERTY_ARRAY_INDEX, NORTH_CAROLINA_AVENUE_PROPERTY_ARRAY_INDEX,
+        PENNSYLVANIA_AVENUE_PROPERTY_ARRAY_INDEX, PARK_PLACE_PROPERTY_ARRAY_INDEX,
+        BOARDWALK_PROPERTY_ARRAY_INDEX
+    };
+    static const uint8_t auBare[] = {
+        READING_RAILROAD_PROPERTY_ARRAY_INDEX, PENNSYLVANIA_RAILROAD_PROPERTY_ARRAY_INDEX,
+        BO_RAILROAD_PROPERTY_ARRAY_INDEX, SHORT_LINE_RAILROAD_PROPERTY_ARRAY_INDEX,
+        ELECTRIC_COMPANY_PROPERTY_ARRAY_INDEX, WATER_WORKS_PROPERTY_ARRAY_INDEX,
+        ORIENTAL_AVENUE_PROPERTY_ARRAY_INDEX, VERMONT_AVENUE_PROPERTY_ARRAY_INDEX,
+        CONNECTICUT_AVENUE_PROPERTY_ARRAY_INDEX, MEDITERRANEAN_AVENUE_PROPERTY_ARRAY_INDEX,
+        BALTIC_AVENUE_PROPERTY_ARRAY_INDEX
+    };
+    for(uint32_t i = 0; i < sizeof(auHotels); i++)
+    {
+        m_set_property_owner(pGame, auHotels[i], 0);
+        m_set_property_hotel(pGame, auHotels[i], true);
+    }
+    for(uint32_t i = 0; i < sizeof(auBare); i++)
+        m_set_property_owner(pGame, auBare[i], 0);
+
+    m_set_house_supply(pGame, 0);
+    m_set_hotel_supply(pGame, pGame->uGlobalHotelSupply - (uint32_t)sizeof(auHotels));
+    m_set_player_money(pGame, 0, 0);
+    m_set_player_money(pGame, 1, 0);
+    return pGame;
+}
+
+// runs the bankruptcy phase for a rent debt from player 1 to player 2
+static void
+test_run_bankruptcy(mGameData* pGame, uint32_t uAmountOwed)
+{
+    mGameFlow tFlow;
+    m_init_game_flow(&tFlow, pGame, NULL);
+
+    mBankruptcyData* pBankruptcy = M_ALLOC(sizeof(mBankruptcyData));
+    memset(pBankruptcy, 0, sizeof(mBankruptcyData));
+    pBankruptcy->eBankruptPlayer = PLAYER_ONE_ARRAY_INDEX;
+    pBankruptcy->uCreditor       = 1;
+    pBankruptcy->uAmountOwed     = uAmountOwed;
+    pBankruptcy->eCause          = BANKRUPTCY_CAUSE_RENT;
+    pBankruptcy->uPropertyIndex  = BOARDWALK_PROPERTY_ARRAY_INDEX;
+    m_push_phase(&tFlow, m_phase_bankruptcy, pBankruptcy);
+
+    m_run_current_phase(&tFlow, 0.0f);
+    m_cleanup_game_flow(&tFlow);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] tests
+//-----------------------------------------------------------------------------
+
+// every debt the mortgages cover gets paid, whether or not the planner finds a plan
+static void
+test_mortgages_cover_debt(void)
+{
+    for(uint32_t uDebt = 710; uDebt <= 770; uDebt += 10)
+    {
+        mGameData* pGame = test_create_fixture();
+        TEST_CHECK(pGame, "couldn't load game data from %s", gpcDataDirectory);
+        if(!pGame)
+            return;
+
+        test_run_bankruptcy(pGame, uDebt);
+        TEST_CHECK(!pGame->amPlayers[0].bIsBankrupt, "debt $%u: player 1 went bankrupt with $770 to mortgage", uDebt);
+
+        // what's left is exactly what the mortgages raised minus the debt
+        uint32_t uMortgaged = 0;
+        for(uint8_t i = 0; i < TOTAL_PROPERTIES; i++)
+        {
+            if(pGame->amProperties[i].uOwnerIndex == 0 && pGame->amProperties[i].bIsMortgaged)
+                uMortgaged += pGame->amProperties[i].uMortgageValue;
+        }
+        TEST_CHECK(pGame->amPlayers[0].uMoney + uDebt == uMortgaged, "debt $%u: player 1 has $%u left after mortgaging $%u", 
+            uDebt, pGame->amPlayers[0].uMoney, uMortgaged);
+        TEST_CHECK(pGame->amPlayers[1].uMoney == uDebt, "debt $%u: creditor got $%u", uDebt, pGame->amPlayers[1].uMoney);
+        for(uint8_t i = PACIFIC_AVENUE_PROPERTY_ARRAY_INDEX; i <= BOARDWALK_PROPERTY_ARRAY_INDEX; i++)
+            TEST_CHECK(pGame->amProperties[i].bHasHotel, "debt $%u: hotel on %s was sold", uDebt, pGame->amProperties[i].cName);
+        m_free_game(pGame);
+    }
+}
+
+// the hotels count toward the liquidation value but can't be sold, so a debt above the
+// mortgages still ends in bankruptcy with the assets handed over
+static void
+test_unsellable_hotels_bankrupt(void)
+{
+    mGameData* pGame = test_create_fixture();
+    if(!pGame)
+        return;
+
+    TEST_CHECK(m_get_liquidation_value(pGame, 0) >= 780, "fixture liquidation value is $%u", m_get_liquidation_value(pGame, 0));
+    test_run_bankruptcy(pGame, 780);
+    TEST_CHECK(pGame->amPlayers[0].bIsBankrupt, "debt $780: player 1 should be bankrupt");
+    TEST_CHECK(pGame->amProperties[BOARDWALK_PROPERTY_ARRAY_INDEX].uOwnerIndex == 1, "debt $780: assets didn't go to the creditor");
+    m_free_game(pGame);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] main
+//-----------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+    if(argc > 1)
+        gpcDataDirectory = argv[1];
+
+    test_mortgages_cover_debt();
+    test_unsellable_hotels_bankrupt();
+
+    if(guFailures > 0)
+    {
+        printf("%u check(s) failed\n", guFailures);
+        return 1;
+    }
+    printf("all liquidation tests passed\n");
+    return 0;
+}
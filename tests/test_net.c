@@ -0,0 +1,269 @@
+/*
+   test_net.c - delta protocol tests over a loopback link
+
+   snapshots survive full and delta encoding, and a state packet or ack lost on the
+   way is made good by the bounded resend instead of leaving the replica behind.
+
+   usage: monopoly_test_net [DATA_DIRECTORY]
+*/
+
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "monopoly.h"
+#include "monopoly_init.h"
+#include "monopoly_net.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#define TEST_CHECK(bCondition, ...)                        \
+    do {                                                   \
+        if(!(bCondition))                                  \
+        {                                                  \
+            printf("FAILED %s:%d: ", __FILE__, __LINE__);  \
+            printf(__VA_ARGS__);                           \
+            printf("\n");                                  \
+            guFailures++;                                  \
+        }                                                  \
+    } while(0)
+
+//-----------------------------------------------------------------------------
+// [SECTION] structs
+//-----------------------------------------------------------------------------
+
+// one table with a single seat connected over loopback
+typedef struct _mTestTable
+{
+    mGameData*   pGame;
+    mGameFlow    tFlow;
+    mNetServer   tServer;
+    mNetLoopback tLink;
+    mNetClient   tClient;
+} mTestTable;
+
+//-----------------------------------------------------------------------------
+// [SECTION] globals
+//-----------------------------------------------------------------------------
+
+static uint32_t    guFailures = 0;
+static const char* gpcDataDirectory = "game_data";
+
+//-----------------------------------------------------------------------------
+// [SECTION] helpers
+//-----------------------------------------------------------------------------
+
+static bool
+test_table_init(mTestTable* ptTable)
+{
+    memset(ptTable, 0, sizeof(mTestTable));
+    mGameSettings tSettings = {
+        .uStartingMoney  = 1500,
+        .uJailFine       = 50,
+        .uPlayerCount    = 2,
+        .pcDataDirectory = gpcDataDirectory
+    };
+    ptTable->pGame = m_init_game(tSettings);
+    TEST_CHECK(ptTable->pGame, "couldn't load game data from %s", gpcDataDirectory);
+    if(!ptTable->pGame)
+        return false;
+
+    m_init_game_flow(&ptTable->tFlow, ptTable->pGame, NULL);
+    m_net_server_init(&ptTable->tServer, &ptTable->tFlow);
+    m_net_loopback_init(&ptTable->tLink);
+    m_net_client_init(&ptTable->tClient, &ptTable->tLink);
+    m_net_server_add_client(&ptTable->tServer, &ptTable->tLink, 0);
+    return true;
+}
+
+static void
+test_table_cleanup(mTestTable* ptTable)
+{
+    m_cleanup_game_flow(&ptTable->tFlow);
+    m_free_game(ptTable->pGame);
+}
+
+// drops everything in flight on one direction of the link, returns the packet count
+static uint32_t
+test_drop_packets(mNetQueue* ptQueue)
+{
+    mNetPacket tPacket;
+    uint32_t uDropped = 0;
+    while(m_net_queue_pop(ptQueue, &tPacket))
+        uDropped++;
+    return uDropped;
+}
+
+static uint32_t
+test_queued_packets(const mNetQueue* ptQueue)
+{
+    return ptQueue->uTail - ptQueue->uHead;
+}
+
+static bool
+test_replica_matches(mTestTable* ptTable)
+{
+    mNetSnapshot tAuthoritative;
+    m_net_capture_snapshot(&ptTable->tFlow, &tAuthoritative);
+    return ptTable->tClient.bHasState && m_net_snapshots_equal(&ptTable->tClient.tState, &tAuthoritative);
+}
+
+// the broadcasts after a send that stay quiet before an unacked state goes out again
+static void
+test_expect_resend(mTestTable* ptTable, const char* pcWhat)
+{
+    for(uint32_t i = 1; i < M_NET_RESEND_BROADCASTS; i++)
+    {
+        m_net_server_broadcast(&ptTable->tServer);
+        TEST_CHECK(test_queued_packets(&ptTable->tLink.tToClient) == 0, "%s: resent after %u broadcasts, expected %u",
+            pcWhat, i, M_NET_RESEND_BROADCASTS);
+    }
+    m_net_server_broadcast(&ptTable->tServer);
+    TEST_CHECK(test_queued_packets(&ptTable->tLink.tToClient) == 1, "%s: not resent after %u broadcasts", pcWhat, M_NET_RESEND_BROADCASTS);
+}
+
+// an acked client on an idle table is sent nothing
+static void
+test_expect_quiet(mTestTable* ptTable, const char* pcWhat)
+{
+    int iValue = 0;
+    while(m_net_server_poll_input(&ptTable->tServer, &iValue)) {}
+
+    for(uint32_t i = 0; i < M_NET_RESEND_BROADCASTS * 2; i++)
+        m_net_server_broadcast(&ptTable->tServer);
+    TEST_CHECK(test_queued_packets(&ptTable->tLink.tToClient) == 0, "%s: acked client still sent state", pcWhat);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] tests
+//-----------------------------------------------------------------------------
+
+// a full snapshot and a delta against an older one decode to the same state
+static void
+test_delta_round_trip(void)
+{
+    mTestTable tTable;
+    if(!test_table_init(&tTable))
+        return;
+    mGameData* pGame = tTable.pGame;
+
+    mNetSnapshot tBase;
+    m_net_capture_snapshot(&tTable.tFlow, &tBase);
+
+    m_set_player_money(pGame, 0, 1234);
+    m_set_player_money(pGame, 1, 7);
+    m_set_player_position(pGame, 1, 39);
+    m_set_player_jail_turns(pGame, 0, 2);
+    m_set_property_owner(pGame, ORIENTAL_AVENUE_PROPERTY_ARRAY_INDEX, 0);
+    m_set_property_owner(pGame, VERMONT_AVENUE_PROPERTY_ARRAY_INDEX, 0);
+    m_set_property_houses(pGame, ORIENTAL_AVENUE_PROPERTY_ARRAY_INDEX, 3);
+    m_set_property_owner(pGame, BOARDWALK_PROPERTY_ARRAY_INDEX, 1);
+    m_set_property_mortgaged(pGame, BOARDWALK_PROPERTY_ARRAY_INDEX, true);
+
+    mNetSnapshot tCurrent;
+    m_net_capture_snapshot(&tTable.tFlow, &tCurrent);
+    TEST_CHECK(!m_net_snapshots_equal(&tBase, &tCurrent), "changes didn't reach the snapshot");
+
+    uint8_t auFull[M_NET_MAX_PACKET_SIZE] = {0};
+    mNetBitWriter tFullWriter = { .puData = auFull, .uCapacityBits = sizeof(auFull) * 8 };
+    uint32_t uFullBits = m_net_encode_delta(NULL, &tCurrent, &tFullWriter);
+    TEST_CHECK(!tFullWriter.bOverflow, "full snapshot overflowed %u bytes", M_NET_MAX_PACKET_SIZE);
+
+    uint8_t auDelta[M_NET_MAX_PACKET_SIZE] = {0};
+    mNetBitWriter tDeltaWriter = { .puData = auDelta, .uCapacityBits = sizeof(auDelta) * 8 };
+    uint32_t uDeltaBits = m_net_encode_delta(&tBase, &tCurrent, &tDeltaWriter);
+    TEST_CHECK(!tDeltaWriter.bOverflow, "delta overflowed %u bytes", M_NET_MAX_PACKET_SIZE);
+
+    mNetSnapshot tFromFull;
+    mNetBitReader tFullReader = { .puData = auFull, .uSizeBits = uFullBits };
+    TEST_CHECK(m_net_decode_delta(NULL, &tFullReader, &tFromFull), "full snapshot didn't decode");
+    TEST_CHECK(m_net_snapshots_equal(&tFromFull, &tCurrent), "full snapshot decoded to a different state");
+
+    mNetSnapshot tFromDelta;
+    mNetBitReader tDeltaReader = { .puData = auDelta, .uSizeBits = uDeltaBits };
+    TEST_CHECK(m_net_decode_delta(&tBase, &tDeltaReader, &tFromDelta), "delta didn't decode");
+    TEST_CHECK(m_net_snapshots_equal(&tFromDelta, &tFromFull), "delta and full snapshot decoded differently");
+
+    test_table_cleanup(&tTable);
+}
+
+// the first state is lost: nothing more is sent until the resend, which then lands
+static void
+test_dropped_state(void)
+{
+    mTestTable tTable;
+    if(!test_table_init(&tTable))
+        return;
+
+    m_net_server_broadcast(&tTable.tServer);
+    TEST_CHECK(test_drop_packets(&tTable.tLink.tToClient) == 1, "first broadcast didn't send a state");
+
+    test_expect_resend(&tTable, "dropped state");
+    TEST_CHECK(m_net_client_receive(&tTable.tClient), "resent state wasn't applied");
+    TEST_CHECK(test_replica_matches(&tTable), "replica differs after the resend");
+    test_expect_quiet(&tTable, "dropped state");
+
+    // same again for a delta: the change is lost, the resend is against the acked state
+    m_set_player_money(tTable.pGame, 1, 99);
+    m_set_property_owner(tTable.pGame, PARK_PLACE_PROPERTY_ARRAY_INDEX, 1);
+    m_net_server_broadcast(&tTable.tServer);
+    TEST_CHECK(test_drop_packets(&tTable.tLink.tToClient) == 1, "change wasn't sent");
+    TEST_CHECK(!test_replica_matches(&tTable), "replica changed without a packet");
+
+    test_expect_resend(&tTable, "dropped delta");
+    TEST_CHECK(m_net_client_receive(&tTable.tClient), "resent delta wasn't applied");
+    TEST_CHECK(test_replica_matches(&tTable), "replica differs after the resent delta");
+    test_expect_quiet(&tTable, "dropped delta");
+
+    test_table_cleanup(&tTable);
+}
+
+// the state arrives but its ack is lost: the resend is acked again and the server settles
+static void
+test_dropped_ack(void)
+{
+    mTestTable tTable;
+    if(!test_table_init(&tTable))
+        return;
+
+    m_net_server_broadcast(&tTable.tServer);
+    TEST_CHECK(m_net_client_receive(&tTable.tClient), "first state wasn't applied");
+    TEST_CHECK(test_drop_packets(&tTable.tLink.tToServer) == 1, "first state wasn't acked");
+
+    test_expect_resend(&tTable, "dropped ack");
+    TEST_CHECK(!m_net_client_receive(&tTable.tClient), "duplicate state counted as a change");
+    TEST_CHECK(test_queued_packets(&tTable.tLink.tToServer) == 1, "duplicate state wasn't acked again");
+    TEST_CHECK(test_replica_matches(&tTable), "replica differs after the duplicate");
+    test_expect_quiet(&tTable, "dropped ack");
+
+    test_table_cleanup(&tTable);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] main
+//-----------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+    if(argc > 1)
+        gpcDataDirectory = argv[1];
+
+    test_delta_round_trip();
+    test_dropped_state();
+    test_dropped_ack();
+
+    if(guFailures > 0)
+    {
+        printf("%u check(s) failed\n", guFailures);
+        return 1;
+    }
+    printf("all net tests passed\n");
+    return 0;
+}
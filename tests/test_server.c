@@ -0,0 +1,232 @@
+/*
+   test_server.c - multi-table server tests
+
+   a handful of tables on a small worker pool, every seat and a spectator replicated over
+   the delta protocol. every accepted input must be stepped exactly once, the server must
+   go idle, and every replica must match its table after every step.
+
+   usage: monopoly_test_server [DATA_DIRECTORY]
+*/
+
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "monopoly.h"
+#include "monopoly_server.h"
+#include "monopoly_platform.h"
+#include "monopoly_net.h"
+#include "monopoly_ai.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#define TEST_TABLES       16
+#define TEST_WORKERS      4
+#define TEST_PLAYERS      3
+#define TEST_SPECTATORS   1
+#define TEST_MAX_ROUNDS   20
+#define TEST_MAX_INPUTS   4000 // per table, a stuck game parks instead of spinning
+#define TEST_TIMEOUT_MS   30000
+
+#define TEST_CHECK(bCondition, ...)                        \
+    do {                                                   \
+        if(!(bCondition))                                  \
+        {                                                  \
+            printf("FAILED %s:%d: ", __FILE__, __LINE__);  \
+            printf(__VA_ARGS__);                           \
+            printf("\n");                                  \
+            guFailures++;                                  \
+        }                                                  \
+    } while(0)
+
+//-----------------------------------------------------------------------------
+// [SECTION] structs
+//-----------------------------------------------------------------------------
+
+// per table protocol state (only touched by the worker stepping the table)
+typedef struct _mTestTable
+{
+    bool         bInitialized;
+    mNetServer   tServer;
+    mNetLoopback atLinks[M_NET_MAX_CLIENTS];
+    mNetClient   atClients[M_NET_MAX_CLIENTS]; // seats first, then spectators
+    uint32_t     uClientCount;
+    uint64_t     uInputsAccepted;
+    uint64_t     uStateMismatches;
+} mTestTable;
+
+//-----------------------------------------------------------------------------
+// [SECTION] globals
+//-----------------------------------------------------------------------------
+
+static uint32_t    guFailures = 0;
+static const char* gpcDataDirectory = "game_data";
+
+//-----------------------------------------------------------------------------
+// [SECTION] client
+//-----------------------------------------------------------------------------
+
+// same answers as the scripted client in server_app.c
+static int
+test_choose_input(const mGameFlow* pFlow)
+{
+    mGameData* pGame = pFlow->pGame;
+    mPlayer* pPlayer = &pGame->amPlayers[pGame->uCurrentPlayerIndex];
+
+    if(pFlow->pfCurrentPhase == m_phase_pre_roll)
+        return 3;
+    if(pFlow->pfCurrentPhase == m_phase_jail)
+    {
+        if(pPlayer->bHasJailFreeCard)
+            return 2;
+        return m_can_afford(pPlayer, pGame->uJailFine) ? 1 : 3;
+    }
+    if(pFlow->pfCurrentPhase == m_phase_post_roll)
+    {
+        mPostRollData* pPostRoll = (mPostRollData*)pFlow->pCurrentPhaseData;
+        if(!pPostRoll->bHandledLanding && pPostRoll->eSquareType == SQUARE_PROPERTY &&
+           pPostRoll->uPropertyIndex != BANK_PLAYER_INDEX &&
+           pGame->amProperties[pPostRoll->uPropertyIndex].uOwnerIndex == BANK_PLAYER_INDEX)
+        {
+            mProperty* pProp = &pGame->amProperties[pPostRoll->uPropertyIndex];
+            return m_can_afford(pPlayer, pProp->uPrice) ? 1 : 2;
+        }
+        return 3;
+    }
+    return 0;
+}
+
+static void
+test_net_client(mServer* ptServer, uint32_t uTableId, const mGameFlow* pFlow, void* pUserData)
+{
+    mTestTable* ptTable = &((mTestTable*)pUserData)[uTableId];
+
+    if(!ptTable->bInitialized)
+    {
+        m_net_server_init(&ptTable->tServer, pFlow);
+        uint32_t uSeats = pFlow->pGame->uPlayerCount;
+        ptTable->uClientCount = uSeats + TEST_SPECTATORS;
+        for(uint32_t i = 0; i < ptTable->uClientCount; i++)
+        {
+            m_net_loopback_init(&ptTable->atLinks[i]);
+            m_net_client_init(&ptTable->atClients[i], &ptTable->atLinks[i]);
+            m_net_server_add_client(&ptTable->tServer, &ptTable->atLinks[i], i < uSeats ? (uint8_t)i : M_NET_SPECTATOR);
+        }
+        ptTable->bInitialized = true;
+    }
+
+    m_net_server_broadcast(&ptTable->tServer);
+
+    mNetSnapshot tAuthoritative;
+    m_net_capture_snapshot(pFlow, &tAuthoritative);
+    for(uint32_t i = 0; i < ptTable->uClientCount; i++)
+    {
+        m_net_client_receive(&ptTable->atClients[i]);
+        if(!m_net_snapshots_equal(&ptTable->atClients[i].tState, &tAuthoritative))
+            ptTable->uStateMismatches++;
+    }
+
+    if(pFlow->pGame->uRoundCount < TEST_MAX_ROUNDS && ptTable->uInputsAccepted < TEST_MAX_INPUTS)
+    {
+        uint8_t uSeat = m_net_get_input_player(pFlow);
+        m_net_client_send_input(&ptTable->atClients[uSeat], test_choose_input(pFlow));
+    }
+
+    int iValue = 0;
+    while(m_net_server_poll_input(&ptTable->tServer, &iValue))
+    {
+        if(m_server_submit_input(ptServer, uTableId, iValue))
+            ptTable->uInputsAccepted++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] tests
+//-----------------------------------------------------------------------------
+
+static void
+test_tables_replicate(void)
+{
+    mTestTable* atTables = calloc(TEST_TABLES, sizeof(mTestTable));
+    TEST_CHECK(atTables, "out of memory");
+    if(!atTables)
+        return;
+
+    mAiModel tAiModel;
+    m_ai_init_model(&tAiModel);
+    mAiPlayers tAiPlayers = {
+        .ptModel          = &tAiModel,
+        .uComputerPlayers = (uint8_t)((1u << MAX_PLAYERS) - 1)
+    };
+
+    mServerSettings tSettings = {
+        .uTableCount  = TEST_TABLES,
+        .uWorkerCount = TEST_WORKERS,
+        .tGameSettings = {
+            .uStartingMoney  = 1500,
+            .uJailFine       = 50,
+            .uPlayerCount    = TEST_PLAYERS,
+            .pcDataDirectory = gpcDataDirectory
+        },
+        .pfClient             = test_net_client,
+        .pClientData          = atTables,
+        .pfAuctionResolver    = m_ai_auction_resolver,
+        .pAuctionResolverData = &tAiPlayers
+    };
+
+    mServer* ptServer = m_server_create(&tSettings);
+    TEST_CHECK(ptServer, "couldn't create the server (game data in %s?)", gpcDataDirectory);
+    if(!ptServer)
+    {
+        free(atTables);
+        return;
+    }
+
+    m_server_start(ptServer);
+    bool bIdle = m_server_wait_idle(ptServer, TEST_TIMEOUT_MS);
+    m_server_stop(ptServer);
+    TEST_CHECK(bIdle, "tables still had input after %u ms", TEST_TIMEOUT_MS);
+
+    for(uint32_t i = 0; i < TEST_TABLES; i++)
+    {
+        mTestTable* ptTable = &atTables[i];
+        mServerTableStats tStats;
+        m_server_get_table_stats(ptServer, i, &tStats);
+
+        TEST_CHECK(ptTable->bInitialized, "table %u never asked its client for input", i);
+        TEST_CHECK(tStats.uSteps > 0, "table %u never stepped", i);
+        TEST_CHECK(tStats.uSteps == ptTable->uInputsAccepted, "table %u stepped %llu times for %llu inputs", i,
+            (unsigned long long)tStats.uSteps, (unsigned long long)ptTable->uInputsAccepted);
+        TEST_CHECK(ptTable->uStateMismatches == 0, "table %u: %llu replica mismatches", i, (unsigned long long)ptTable->uStateMismatches);
+    }
+
+    m_server_destroy(ptServer);
+    free(atTables);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] main
+//-----------------------------------------------------------------------------
+
+int
+main(int argc, char* argv[])
+{
+    if(argc > 1)
+        gpcDataDirectory = argv[1];
+
+    test_tables_replicate();
+
+    if(guFailures > 0)
+    {
+        printf("%u check(s) failed\n", guFailures);
+        return 1;
+    }
+    printf("all server tests passed\n");
+    return 0;
+}